@@ -124,7 +124,6 @@ namespace CASM {
     // primclex.generate_global_orbitree();
     primclex.populate_cluster_basis_function_tables();
     primclex.generate_full_nlist();
-    primclex.generate_supercell_nlists();
     std::cout << "  global orbitree basis set size: " << primclex.get_global_orbitree().basis_set_size() << std::endl;
     std::cout << "  DONE." << std::endl << std::endl;
 
@@ -4,6 +4,7 @@
 
 #include "casm_functions.hh"
 #include "casm/CASM_classes.hh"
+#include "casm/system/ParallelFor.hh"
 
 namespace CASM {
 
@@ -18,6 +19,7 @@ namespace CASM {
     //- enumerate supercells and configs and hop local configurations
 
     int min_vol = 1, max_vol;
+    Index num_threads;
     std::vector<std::string> scellname_list;
     //double tol;
     COORD_TYPE coordtype = CASM::CART;
@@ -33,7 +35,9 @@ namespace CASM {
     ("scellname,n", po::value<std::vector<std::string> >(&scellname_list)->multitoken(), "Enumerate configs for given supercells")
     ("all,a", "Enumerate configurations for all supercells")
     ("supercells,s", "Enumerate supercells")
-    ("configs,c", "Enumerate configurations");
+    ("configs,c", "Enumerate configurations")
+    ("threads,t", po::value<Index>(&num_threads)->default_value(1), "Number of threads used to enumerate supercells, or configurations in different supercells (0 uses all available cores)")
+    ("orderly", "Enumerate configurations using a symmetry-pruned search (faster for large supercells, but adds configurations in a different order)");
 
     // currently unused...
     //("tol", po::value<double>(&tol)->default_value(CASM::TOL), "Tolerance used for checking symmetry")
@@ -110,7 +114,7 @@ namespace CASM {
       std::cout << "\n***************************\n" << std::endl;
 
       std::cout << "Generating supercells from " << min_vol << " to " << max_vol << std::endl << std::endl;
-      primclex.generate_supercells(min_vol, max_vol, true);
+      primclex.generate_supercells(min_vol, max_vol, true, num_threads);
       std::cout << "\n  DONE." << std::endl << std::endl;
 
       std::cout << "Write SCEL." << std::endl << std::endl;
@@ -118,30 +122,22 @@ namespace CASM {
 
     }
     else if(vm.count("configs")) {
+      std::vector<Index> scel_indices;
+
       if(vm.count("all")) {
         std::cout << "\n***************************\n" << std::endl;
 
         std::cout << "Enumerate all configurations" << std::endl << std::endl;
         for(int j = 0; j < primclex.get_supercell_list().size(); j++) {
-          std::cout << "  Enumerate configurations for " << primclex.get_supercell(j).get_name() << " ... " << std::flush;
-          primclex.get_supercell(j).enumerate_all_occupation_configurations();
-          std::cout << primclex.get_supercell(j).get_config_list().size() << " configs." << std::endl;
+          scel_indices.push_back(j);
         }
-        std::cout << "  DONE." << std::endl << std::endl;
-
       }
       else {
-        bool found_any = false;
-
         if(vm.count("max")) {
           std::cout << "Enumerate configurations from volume " << min_vol << " to " << max_vol << std::endl << std::endl;
           for(int j = 0; j < primclex.get_supercell_list().size(); j++) {
             if(primclex.get_supercell(j).volume() >= min_vol && primclex.get_supercell(j).volume() <= max_vol) {
-              found_any = true;
-
-              std::cout << "  Enumerate configurations for " << primclex.get_supercell(j).get_name() << " ... " << std::flush;
-              primclex.get_supercell(j).enumerate_all_occupation_configurations();
-              std::cout << primclex.get_supercell(j).get_config_list().size() << " configs." << std::endl;
+              scel_indices.push_back(j);
             }
           }
         }
@@ -154,25 +150,39 @@ namespace CASM {
               std::cout << "Error in 'casm enum'. Did not find supercell: " << scellname_list[i] << std::endl;
               return 1;
             }
-
-            found_any = true;
-
-            std::cout << "  Enumerate configurations for " << primclex.get_supercell(index).get_name() << " ... " << std::flush;
-            primclex.get_supercell(index).enumerate_all_occupation_configurations();
-            std::cout << primclex.get_supercell(index).get_config_list().size() << " configs." << std::endl;
+            if(std::find(scel_indices.begin(), scel_indices.end(), index) == scel_indices.end()) {
+              scel_indices.push_back(index);
+            }
           }
         }
 
-        if(found_any) {
-          std::cout << "\n  DONE." << std::endl << std::endl;
-        }
-        else {
+        if(!scel_indices.size()) {
           std::cout << "Did not find any supercells. Make sure to 'casm enum --supercells' first!" << std::endl << std::endl;
 
           return 1;
         }
       }
 
+      primclex.set_num_threads(num_threads);
+      if(resolve_num_threads(num_threads) == 1) {
+        for(Index i = 0; i < scel_indices.size(); i++) {
+          std::cout << "  Enumerate configurations for " << primclex.get_supercell(scel_indices[i]).get_name() << " ... " << std::flush;
+          primclex.enumerate_occupation_configurations(std::vector<Index>(1, scel_indices[i]), vm.count("orderly"));
+          std::cout << primclex.get_supercell(scel_indices[i]).get_config_list().size() << " configs." << std::endl;
+        }
+      }
+      else {
+        std::cout << "  Enumerate configurations for " << scel_indices.size() << " supercells using "
+                  << resolve_num_threads(num_threads) << " threads ... " << std::flush;
+        primclex.enumerate_occupation_configurations(scel_indices, vm.count("orderly"));
+        std::cout << std::endl;
+        for(Index i = 0; i < scel_indices.size(); i++) {
+          std::cout << "  " << primclex.get_supercell(scel_indices[i]).get_name() << ": "
+                    << primclex.get_supercell(scel_indices[i]).get_config_list().size() << " configs." << std::endl;
+        }
+      }
+      std::cout << "\n  DONE." << std::endl << std::endl;
+
       //BP::BP_Write enumfile("ENUM");
       //enumfile.newfile();
       //primclex.print_enum_info(enumfile.get_ostream());
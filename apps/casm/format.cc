@@ -22,7 +22,7 @@ namespace CASM {
       ("dir,d", "CASM project directory structure summary")
       ("project_settings", "Description and location of 'project_settings' file")
       ("prim", "Description and location of 'prim.json' and 'PRIM' files")
-      ("config_list", "Description and location of 'config_list.json' file")
+      ("config_list", "Description and location of the 'config_list' files")
       ("sym", "Description and location of 'lattice_point_group.json', 'factor_group.json' and 'crystal_point_group.json' files")
       ("vasp", "Description and location of VASP settings files")
       ("comp", "Description and location of 'composition_axes.json' file")
@@ -75,7 +75,10 @@ namespace CASM {
       std::cout << "                                                                    \n";
       std::cout << "    $ROOT/.casm                                                     \n";
       std::cout << "      project_settings.json                                         \n";
-      std::cout << "      config_list.json                                              \n";
+      std::cout << "      config_list/                                                  \n";
+      std::cout << "        SCELNAME.json                                               \n";
+      std::cout << "      cache/                                                        \n";
+      std::cout << "        bset.$CURR_BSET.corr  (binary correlations cache)           \n";
       std::cout << "    $ROOT/                                                          \n";
       std::cout << "      prim.json                                                     \n";
       std::cout << "      (PRIM)                                                        \n";
@@ -245,15 +248,19 @@ Direct\n\
     }
 
     if(vm.count("config_list")) {
-      std::cout << "\n### config_list.json ##################\n\n";
+      std::cout << "\n### config_list #######################\n\n";
 
       std::cout << "LOCATION WHEN GENERATED:\n";
-      std::cout << "$ROOT/.casm/config_list.json\n\n\n";
+      std::cout << "$ROOT/.casm/config_list/SCELNAME.json\n\n\n";
 
       std::cout << "DESCRIPTION:\n";
-      std::cout << "A list of generated configurations. This file is generated at the   \n";
-      std::cout << "project level once 'casm enum' has been used to generate            \n";
-      std::cout << "configurations.                                                     \n";
+      std::cout << "A list of generated configurations. One file is generated for each  \n";
+      std::cout << "supercell once 'casm enum' has been used to generate configurations.\n";
+      std::cout << "Only the files for supercells whose configurations were modified    \n";
+      std::cout << "are rewritten. Projects with a single                               \n";
+      std::cout << "'$ROOT/.casm/config_list.json' are converted the next time the      \n";
+      std::cout << "configurations are written, and the old file is kept as             \n";
+      std::cout << "'config_list.json.bak'.                                             \n";
       std::cout << "                                                                    \n";
       std::cout << "Contains basic information describing the configuration:            \n\n" <<
 
@@ -1,10 +1,13 @@
 #include "import.hh"
 
 #include <cstring>
+#include <chrono>
+#include <iomanip>
 
 #include "casm_functions.hh"
 #include "casm/clex/ConfigMapping.hh"
 #include "casm/casm_io/FileSystemInterface.hh"
+#include "casm/system/ParallelFor.hh"
 
 namespace CASM {
 
@@ -23,6 +26,8 @@ namespace CASM {
     COORD_TYPE coordtype = FRAC;
     double vol_tol(0.25);
     double lattice_weight(0.5);
+    Index jobs(1);
+    Index k_best(1);
     std::vector<fs::path> pos_paths;
     fs::path dft_path, batch_path;
     bool same_dir(false), no_import(true);
@@ -39,6 +44,8 @@ namespace CASM {
     ("batch,b", po::value<fs::path>(&batch_path), "Path to batch file, which should list one structure file path per line (can be used in combination with --pos)")
     ("rotate,r", "Rotate structure to be consistent with setting of PRIM")
     ("ideal,i", "Assume imported structures are unstrained (ideal) for faster importing. Can be slower if used on deformed structures, in which case more robust methods will be used")
+    ("jobs,j", po::value<Index>(&jobs)->default_value(1), "Map up to this many structures at once (0 uses all available cores). Structures are still added to the project one at a time, in order.")
+    ("k-best", po::value<Index>(&k_best)->default_value(1), "Report this many of the lowest cost mappings of each structure, including the one used.")
     //("strict,s", "Request that symmetrically equivalent configurations be treated as distinct.")
     ("data,d", "Attempt to extract calculation data from the enclosing directory of the structure files.");
 
@@ -138,17 +145,15 @@ namespace CASM {
     std::map<std::string, std::vector<std::pair<std::string, std::vector<double> > > > import_map;
     std::vector<std::string > error_log;
     Index n_unique(0);
-    // iterate over structure files
-    std::cout << "  Beginning import of " << pos_paths.size() << " configuration" << (pos_paths.size() > 1 ? "s" : "") << "...\n" << std::endl;
-    for(auto it = pos_paths.begin(); it != pos_paths.end(); ++it) {
-      if(it != pos_paths.begin())
-        std::cout << "\n***************************\n" << std::endl;
 
-      fs::path pos_path, import_path;
-
-      pos_path = fs::absolute(*it);
-      std::string imported_name;
-      BasicStructure<Site> import_struc;
+    // read all structure files, so that they can be mapped concurrently
+    std::cout << "  Reading " << pos_paths.size() << " structure" << (pos_paths.size() > 1 ? "s" : "") << "...\n" << std::endl;
+    std::vector<fs::path> import_pos_paths(pos_paths.size());
+    std::vector<std::string> read_error(pos_paths.size());
+    std::vector<Index> struc_index(pos_paths.size(), -1);
+    std::vector<BasicStructure<Site> > import_strucs;
+    for(Index i = 0; i < pos_paths.size(); i++) {
+      fs::path pos_path = fs::absolute(pos_paths[i]);
 
       // If user requested data import, try to get structural data from properties.calc.json, instead of POS, etc.
       // Since properties.calc.json would be used during 'casm update' to validate relaxation
@@ -167,13 +172,10 @@ namespace CASM {
         if(!dft_path.empty())
           pos_path = dft_path;
       }
+      import_pos_paths[i] = pos_path;
 
-
-      //Import structure and make note of path
-      bool new_import = false;
-      jsonParser relax_data;
       try {
-
+        BasicStructure<Site> import_struc;
         if(pos_path.extension() == ".json" || pos_path.extension() == ".JSON") {
           from_json(simple_json(import_struc, "relaxed_"), jsonParser(pos_path));
         }
@@ -181,16 +183,56 @@ namespace CASM {
           fs::ifstream struc_stream(pos_path);
           import_struc.read(struc_stream);
         }
+        struc_index[i] = import_strucs.size();
+        import_strucs.push_back(import_struc);
+      }
+      catch(std::exception &e) {
+        read_error[i] = e.what();
+      }
+    }
+
+    // map structures onto the PRIM concurrently; only adding them to the primclex is serial
+    std::cout << "  Mapping " << import_strucs.size() << " structure" << (import_strucs.size() > 1 ? "s" : "")
+              << " using " << std::min(resolve_num_threads(jobs), std::max(long(import_strucs.size()), 1L)) << " thread(s)...\n" << std::endl;
+    auto map_begin = std::chrono::steady_clock::now();
+    std::vector<StructureMapping> mappings = map_structures_occupation(import_strucs, primclex, !vm.count("ideal"), vm.count("rotate"), tol, lattice_weight, vol_tol, jobs, k_best);
+    double map_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - map_begin).count();
 
+    // per-structure report: {result, configuration name}, indexed like pos_paths
+    std::vector<std::pair<std::string, std::string> > report(pos_paths.size());
 
-        if(import_structure_occupation(import_struc, primclex, imported_name, relax_data, !vm.count("ideal"), vm.count("rotate"), vm.count("strict"), tol, lattice_weight, vol_tol)) {
+    // iterate over structure files
+    std::cout << "  Beginning import of " << pos_paths.size() << " configuration" << (pos_paths.size() > 1 ? "s" : "") << "...\n" << std::endl;
+    for(auto it = pos_paths.begin(); it != pos_paths.end(); ++it) {
+      if(it != pos_paths.begin())
+        std::cout << "\n***************************\n" << std::endl;
+
+      Index i = it - pos_paths.begin();
+      fs::path pos_path = import_pos_paths[i], import_path;
+      std::string imported_name;
+
+
+      //Import structure and make note of path
+      bool new_import = false;
+      jsonParser relax_data;
+      try {
+
+        if(!valid_index(struc_index[i])) {
+          throw std::runtime_error(read_error[i]);
+        }
+        const StructureMapping &mapping = mappings[struc_index[i]];
+
+        if(insert_structure_occupation(mapping, nullptr, primclex, imported_name, vm.count("strict"), tol)) {
           std::cout << "  " << pos_path << "\nwas imported successfully as " << imported_name << std::endl << std::endl;
           n_unique++;
           new_import = true;
+          report[i] = std::make_pair("new", imported_name);
         }
         else {
           std::cout << "  " << pos_path << "\n  mapped onto pre-existing equivalent structure " << imported_name << std::endl << std::endl;
+          report[i] = std::make_pair("existing", imported_name);
         }
+        relax_data = mapping.relaxation_properties;
         std::cout << "  Relaxation stats -> lattice_deformation = " << relax_data["lattice_deformation"].get<double>()
                   << "      basis_deformation = " << relax_data["basis_deformation"].get<double>() << std::endl << std::endl;;
       }
@@ -198,6 +240,7 @@ namespace CASM {
         std::cerr << "  ERROR: Unable to import " << pos_path << " because \n"
                   << "    -> " << e.what() << "\n\n";
         error_log.push_back(it->string() + "\n     -> " + e.what());
+        report[i] = std::make_pair("error", "-");
         if(it != pos_paths.cend()) {
           std::cout << "  Continuing...\n";
         }
@@ -284,6 +327,45 @@ namespace CASM {
       std::cout << " (only " << n_unique << " of these " << (n_unique == 1 ? "is" : "are") << " new and unique)";
     std::cout << "." <<  std::endl;
 
+    // timing and cost of mapping each structure
+    std::cout << "  Mapping report:\n"
+              << "    " << std::setw(10) << "time(s)" << std::setw(22) << "lattice_deformation" << std::setw(20) << "basis_deformation"
+              << std::setw(10) << "result" << "   configuration   structure\n";
+    double total_seconds(0.0);
+    for(Index i = 0; i < pos_paths.size(); i++) {
+      std::cout << "    ";
+      if(valid_index(struc_index[i])) {
+        const StructureMapping &mapping = mappings[struc_index[i]];
+        total_seconds += mapping.seconds;
+        std::cout << std::setw(10) << std::fixed << std::setprecision(3) << mapping.seconds;
+        if(mapping.success) {
+          std::cout << std::setw(22) << std::setprecision(6) << mapping.relaxation_properties["lattice_deformation"].get<double>()
+                    << std::setw(20) << mapping.relaxation_properties["basis_deformation"].get<double>();
+        }
+        else {
+          std::cout << std::setw(22) << "-" << std::setw(20) << "-";
+        }
+      }
+      else {
+        std::cout << std::setw(10) << "-" << std::setw(22) << "-" << std::setw(20) << "-";
+      }
+      std::cout << std::setw(10) << report[i].first << "   " << report[i].second << "   " << pos_paths[i].string() << "\n";
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+    std::cout << "    Mapping took " << map_seconds << " s (" << total_seconds << " s summed over structures)\n" << std::endl;
+
+    if(k_best > 1) {
+      std::cout << "  Lowest cost mappings:\n";
+      for(Index i = 0; i < pos_paths.size(); i++) {
+        if(valid_index(struc_index[i]) && mappings[struc_index[i]].success) {
+          std::cout << "    " << pos_paths[i].string() << ":\n";
+          print_mappings(import_strucs[struc_index[i]], mappings[struc_index[i]], primclex, lattice_weight, std::cout, "    ");
+        }
+      }
+      std::cout << std::endl;
+    }
+
     //Update directories
     std::cout << "  Writing SCEL..." << std::endl;
     primclex.print_supercells();
@@ -0,0 +1,228 @@
+#include "monte.hh"
+
+#include <memory>
+#include <string>
+
+#include "casm_functions.hh"
+#include "casm/CASM_classes.hh"
+#include "casm/app/ProjectSettings.hh"
+#include "casm/casm_io/jsonStream.hh"
+#include "casm/monte_carlo/MonteCarlo.hh"
+#include "casm/monte_carlo/MonteDriver.hh"
+
+namespace CASM {
+
+  void monte_help(std::ostream &_stream) {
+    _stream << "Runs canonical or semi-grand canonical Metropolis Monte Carlo, using the cluster" << std::endl
+            << "expansion of the formation energy for the current basis set and ECI." << std::endl
+            << std::endl
+            << "Conditions are run in order, along a path of temperature and parametric chemical" << std::endl
+            << "potential, each starting from the final state of the previous one. At each condition," << std::endl
+            << "equilibration is detected automatically and sampling continues until the requested" << std::endl
+            << "precision or the maximum number of samples is reached." << std::endl
+            << std::endl
+            << "Output, written to the output directory as each condition completes:" << std::endl
+            << "  results.json: means and standard errors of observables at each condition" << std::endl
+            << "  samples.json: every sample, if \"write_samples\" is true" << std::endl
+            << std::endl
+            << "Example settings file:" << std::endl
+            << "{" << std::endl
+            << "  \"ensemble\" : \"semi_grand_canonical\",    // or \"canonical\"" << std::endl
+            << "  \"supercell\" : [[10, 0, 0], [0, 10, 0], [0, 0, 10]],   // or a supercell name" << std::endl
+            << "  \"initial_config\" : \"SCEL.../0\",         // optional, a configuration of the supercell" << std::endl
+            << "  \"param_composition\" : {\"a\" : 0.25},     // optional, canonical only" << std::endl
+            << "  \"conditions\" : {" << std::endl
+            << "    \"initial\" : {\"temperature\" : 1000.0, \"param_chem_pot\" : {\"a\" : -0.1}}," << std::endl
+            << "    \"final\" : {\"temperature\" : 100.0}," << std::endl
+            << "    \"increment\" : {\"temperature\" : -100.0}" << std::endl
+            << "  }," << std::endl
+            << "  \"passes_per_sample\" : 1," << std::endl
+            << "  \"check_period\" : 100," << std::endl
+            << "  \"min_samples\" : 100," << std::endl
+            << "  \"max_samples\" : 10000," << std::endl
+            << "  \"precision\" : 0.001,    // standard error of potential energy per unit cell" << std::endl
+            << "  \"seed\" : 0," << std::endl
+            << "  \"write_samples\" : false" << std::endl
+            << "}" << std::endl
+            << std::endl;
+  }
+
+  int monte_command(int argc, char *argv[]) {
+
+    fs::path settings_path, out_dir;
+    po::variables_map vm;
+
+    po::options_description desc("'casm monte' usage");
+    // Set command line options using boost program_options
+    desc.add_options()
+    ("help,h", "Print help message")
+    ("settings,s", po::value<fs::path>(&settings_path)->required(), "Monte Carlo settings file")
+    ("output,o", po::value<fs::path>(&out_dir)->default_value("."), "Directory to write results to")
+    ("force,f", "Overwrite output files");
+
+    try {
+
+      po::store(po::parse_command_line(argc, argv, desc), vm); // can throw
+
+      /** --help option
+       */
+      if(vm.count("help")) {
+        std::cout << std::endl << desc << std::endl;
+        monte_help(std::cout);
+        return 0;
+      }
+
+      po::notify(vm); // throws on error, so do after help in case
+      // there are any problems
+
+    }
+    catch(po::error &e) {
+      std::cerr << desc << std::endl;
+      std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+      return 1;
+    }
+    catch(std::exception &e) {
+      std::cerr << desc << std::endl;
+      std::cerr << "ERROR: "  << e.what() << std::endl;
+      return 1;
+    }
+
+    // want absolute paths
+    settings_path = fs::absolute(settings_path);
+    out_dir = fs::absolute(out_dir);
+
+    fs::path root = find_casmroot(fs::current_path());
+    if(root.empty()) {
+      std::cerr << "Error in 'casm monte': No casm project found." << std::endl;
+      return 1;
+    }
+
+    if(!fs::exists(settings_path)) {
+      std::cerr << "Error in 'casm monte': " << settings_path << " not found." << std::endl;
+      return 1;
+    }
+
+    fs::path results_path = out_dir / "results.json";
+    fs::path samples_path = out_dir / "samples.json";
+    if(!vm.count("force") && (fs::exists(results_path) || fs::exists(samples_path))) {
+      std::cerr << "Error in 'casm monte': " << results_path << " or " << samples_path
+                << " already exists. Use --force to force overwrite." << std::endl;
+      return 1;
+    }
+
+    std::cout << "\n***************************\n" << std::endl;
+
+    // initialize primclex
+    std::cout << "Initialize primclex: " << root << std::endl << std::endl;
+    PrimClex primclex(root, std::cout);
+    std::cout << "  DONE." << std::endl << std::endl;
+
+    const DirectoryStructure &dir = primclex.dir();
+    ProjectSettings &set = primclex.settings();
+
+    if(!fs::exists(dir.clexulator_src(set.name(), set.bset()))) {
+      std::cerr << "Error in 'casm monte': No basis set found. Please use 'casm bset' first." << std::endl;
+      return 1;
+    }
+    fs::path eci_path = dir.eci_out(set.clex(), set.calctype(), set.ref(), set.bset(), set.eci());
+    if(!fs::exists(eci_path)) {
+      std::cerr << "Error in 'casm monte': " << eci_path << " not found. Please fit ECI first." << std::endl;
+      return 1;
+    }
+
+    try {
+
+      MonteSettings monte_settings(jsonParser(settings_path), primclex);
+
+      primclex.read_global_orbitree(dir.clust(set.bset()));
+      primclex.generate_full_nlist();
+
+      // -- supercell ----------------
+      Index scel_index;
+      if(!monte_settings.supercell.empty()) {
+        if(!primclex.contains_supercell(monte_settings.supercell, scel_index)) {
+          std::cerr << "Error in 'casm monte': supercell " << monte_settings.supercell << " not found." << std::endl;
+          return 1;
+        }
+      }
+      else {
+        Eigen::Matrix3d U = primclex.get_prim().lattice().lat_column_mat();
+        scel_index = primclex.add_supercell(Lattice(U * monte_settings.transf_mat.cast<double>()));
+      }
+      const Supercell &scel = primclex.get_supercell(scel_index);
+      std::cout << "Supercell: " << scel.get_name() << ", " << scel.num_sites() << " sites" << std::endl << std::endl;
+
+      // -- initial occupation -------
+      ConfigDoF configdof(scel.num_sites());
+      if(!monte_settings.initial_config.empty()) {
+        const Configuration &config = primclex.configuration(monte_settings.initial_config);
+        if(&config.get_supercell() != &scel) {
+          std::cerr << "Error in 'casm monte': initial_config " << monte_settings.initial_config
+                    << " is not a configuration of supercell " << scel.get_name() << "." << std::endl;
+          return 1;
+        }
+        configdof = config.configdof();
+      }
+      else {
+        configdof.set_occupation(Array<int>(scel.num_sites(), 0));
+      }
+      if(monte_settings.param_composition.size()) {
+        MTRand twister(monte_settings.seed);
+        set_random_occupation(configdof, scel, monte_settings.param_composition, twister);
+      }
+
+      // -- Monte Carlo --------------
+      std::cout << "Reading ECI: " << eci_path << std::endl << std::endl;
+      ECIContainer eci(eci_path);
+
+      std::unique_ptr<MonteCarlo> mc;
+      if(monte_settings.is_canonical) {
+        mc.reset(new Canonical(scel, configdof, primclex.global_clexulator(), eci, monte_settings.seed));
+      }
+      else {
+        mc.reset(new SemiGrandCanonical(scel, configdof, primclex.global_clexulator(), eci, monte_settings.seed));
+      }
+
+      // evaluate energies with the ECI folded in, if the energy clexulator can be generated
+      if(set.clexulator_type() != "table") {
+        try {
+          mc->set_energy_clexulator(primclex.global_energy_clexulator(set.clex()));
+        }
+        catch(std::exception &e) {
+          std::cerr << "Warning: could not use energy clexulator, using correlations: " << e.what() << std::endl << std::endl;
+        }
+      }
+
+      fs::create_directories(out_dir);
+      fs::ofstream results_file(results_path);
+      jsonStreamWriter results(results_file);
+
+      fs::ofstream samples_file;
+      std::unique_ptr<jsonStreamWriter> samples;
+      if(monte_settings.write_samples) {
+        samples_file.open(samples_path);
+        samples.reset(new jsonStreamWriter(samples_file));
+      }
+
+      std::cout << "Running " << (monte_settings.is_canonical ? "canonical" : "semi-grand canonical")
+                << " Monte Carlo, " << monte_settings.path.size() << " conditions" << std::endl;
+
+      MonteDriver driver(*mc, monte_settings, std::cout);
+      driver.run(results, samples.get());
+
+      std::cout << "  DONE." << std::endl << std::endl;
+      std::cout << "Wrote: " << results_path << std::endl;
+      if(samples) {
+        std::cout << "Wrote: " << samples_path << std::endl;
+      }
+      std::cout << std::endl;
+    }
+    catch(std::exception &e) {
+      std::cerr << "Error in 'casm monte': " << e.what() << std::endl;
+      return 1;
+    }
+
+    return 0;
+  };
+
+}
@@ -0,0 +1,10 @@
+#ifndef MONTE_HH
+#define MONTE_HH
+
+namespace CASM {
+
+  int monte_command(int argc, char *argv[]);
+
+}
+
+#endif
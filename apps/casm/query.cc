@@ -25,6 +25,7 @@ namespace CASM {
     std::vector<std::string> columns;
     po::variables_map vm;
     bool json_flag(false), no_header(false), verbatim_flag(false);
+    Index num_threads;
 
     po::options_description desc("'casm query' usage");
     // Set command line options using boost program_options
@@ -36,7 +37,8 @@ namespace CASM {
     ("verbatim,v", po::value(&verbatim_flag)->zero_tokens(), "Print exact properties specified, without prepending 'name' and 'selected' entries")
     ("output,o", po::value<fs::path>(&out_path), "Name for output file")
     //("force,f", po::value(&force)->zero_tokens(), "Overrwrite output file")
-    ("no-header,n", po::value(&no_header)->zero_tokens(), "Print without header (CSV only)");
+    ("no-header,n", po::value(&no_header)->zero_tokens(), "Print without header (CSV only)")
+    ("threads,t", po::value<Index>(&num_threads)->default_value(1), "Number of threads used to evaluate correlations and cluster expansions (0 uses all available cores)");
 
 
     try {
@@ -86,6 +88,7 @@ namespace CASM {
     // initialize primclex
     std::cout << "Initialize primclex: " << root << std::endl << std::endl;
     PrimClex primclex(root, std::cout);
+    primclex.set_num_threads(num_threads);
     std::cout << "  DONE." << std::endl << std::endl;
 
     out_path = fs::absolute(out_path);
@@ -109,8 +112,6 @@ namespace CASM {
     if(fs::exists(dir.clexulator_src(set.name(), set.bset()))) {
       primclex.read_global_orbitree(dir.clust(set.bset()));
       primclex.generate_full_nlist();
-      primclex.generate_supercell_nlists();
-
     }
 
 
@@ -131,17 +132,17 @@ namespace CASM {
     // JSON output block
     try {
       if(json_flag || out_path.extension() == ".json" || out_path.extension() == ".JSON") {
-        jsonParser json;
+        // write one configuration at a time
+        jsonStreamWriter json(output_stream);
         if(vm.count("config")) {
           ConstConfigSelection selection(primclex, fs::absolute(config_path));
           //std::cout << "Read in config selection... it is:\n" << selection;
 
-          json = ConfigIOParser::parse(all_columns)(selection.selected_config_begin(), selection.selected_config_end());
+          to_json(ConfigIOParser::parse(all_columns)(selection.selected_config_begin(), selection.selected_config_end()), json);
         }
         else {
-          json =  ConfigIOParser::parse(all_columns)(primclex.selected_config_begin(), primclex.selected_config_end());
+          to_json(ConfigIOParser::parse(all_columns)(primclex.selected_config_begin(), primclex.selected_config_end()), json);
         }
-        output_stream << json;
       }
       // CSV output block
       else {
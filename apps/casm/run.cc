@@ -2,12 +2,106 @@
 
 #include<cstring>
 #include<unistd.h>
+#include<sys/wait.h>
+#include<chrono>
+#include<iomanip>
+#include<mutex>
 
 #include "casm/CASM_classes.hh"
+#include "casm/system/ParallelFor.hh"
 #include "casm_functions.hh"
 
 namespace CASM {
 
+  namespace {
+
+    /// Record of one 'casm run --jobs' command, for one configuration
+    struct RunJob {
+      std::string name;
+      fs::path path;
+      std::string command;
+      bool skipped = false;
+      int exit_status = -1;
+      double wall_time = 0.0;
+    };
+
+    /// Path to the output of 'casm run --jobs' for one configuration
+    fs::path run_log_path(const fs::path &config_path) {
+      return config_path / "casm_run.log";
+    }
+
+    /// Path to the record of 'casm run --jobs' for one configuration
+    fs::path run_record_path(const fs::path &config_path) {
+      return config_path / "casm_run.json";
+    }
+
+    /// True if the same command already succeeded for this configuration
+    bool run_succeeded(const RunJob &job) {
+      if(!fs::is_regular_file(run_record_path(job.path))) {
+        return false;
+      }
+      try {
+        jsonParser json(run_record_path(job.path));
+        std::string command;
+        int exit_status;
+        return json.get_if(command, "command") && command == job.command
+               && json.get_if(exit_status, "exit_status") && exit_status == 0;
+      }
+      catch(std::exception &e) {
+        return false;
+      }
+    }
+
+    /// Run 'job.command', writing output to the log file and the record when complete
+    void run_job(RunJob &job) {
+      auto start = std::chrono::steady_clock::now();
+
+      try {
+        fs::create_directories(job.path);
+        fs::ofstream log(run_log_path(job.path));
+        Popen process;
+        process.popen(job.command + " 2>&1", log);
+        job.exit_status = WIFEXITED(process.status()) ? WEXITSTATUS(process.status()) : -1;
+      }
+      catch(std::exception &e) {
+        job.exit_status = -1;
+      }
+
+      job.wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      jsonParser json;
+      json["command"] = job.command;
+      json["exit_status"] = job.exit_status;
+      json["wall_time"] = job.wall_time;
+      json.write(run_record_path(job.path));
+    }
+
+    /// Print wall time and exit status for each job
+    void print_run_summary(const std::vector<RunJob> &jobs, double total_time, std::ostream &sout) {
+      Index N_ok = 0, N_failed = 0, N_skipped = 0;
+      sout << std::setw(40) << std::left << "CONFIGURATION" << std::setw(12) << "STATUS" << "WALL TIME (s)" << std::endl;
+      for(const RunJob &job : jobs) {
+        sout << std::setw(40) << std::left << job.name;
+        if(job.skipped) {
+          N_skipped++;
+          sout << std::setw(12) << "skipped" << "-" << std::endl;
+          continue;
+        }
+        if(job.exit_status == 0) {
+          N_ok++;
+        }
+        else {
+          N_failed++;
+        }
+        sout << std::setw(12) << job.exit_status << std::fixed << std::setprecision(2) << job.wall_time << std::endl;
+      }
+      sout << std::right << "\n"
+           << "Succeeded: " << N_ok << "  Failed: " << N_failed << "  Skipped: " << N_skipped
+           << "  Total wall time (s): " << std::fixed << std::setprecision(2) << total_time << std::endl;
+    }
+
+  }
+
   // ///////////////////////////////////////
   // 'run' function for casm
   //    (add an 'if-else' statement in casm.cpp to call this)
@@ -15,6 +109,7 @@ namespace CASM {
   int run_command(int argc, char *argv[]) {
     std::string exec;
     double tol;
+    Index jobs;
     po::variables_map vm;
 
     try {
@@ -24,7 +119,9 @@ namespace CASM {
       desc.add_options()
       ("help,h", "Write help documentation")
       ("write-pos", "Write POS file for each selected configuration before executing the command")
-      ("exec,e", po::value<std::string>(&exec)->required(), "Command to execute");
+      ("exec,e", po::value<std::string>(&exec)->required(), "Command to execute")
+      ("jobs,j", po::value<Index>(&jobs), "Run up to this many commands at once, writing the output of each to a log file (0 uses all available cores)")
+      ("rerun", "With --jobs, also run configurations for which the same command already succeeded");
 
       try {
         po::store(po::parse_command_line(argc, argv, desc), vm); // can throw
@@ -44,7 +141,16 @@ namespace CASM {
                     << "        'vasp.relax $ROOT/training_data/$SCELNAME/$CONFIGID'\n"
                     << "      for each config selected in config_list\n"
                     << "    - The '--write-pos' option makes casm write the POS file  \n"
-                    << "      before executing the given command.                     \n\n";
+                    << "      before executing the given command.                     \n\n"
+
+                    << "    Example: casm run --exec \"vasp.relax\" --jobs 8\n"
+                    << "    - Runs up to 8 commands at once.                          \n"
+                    << "    - The output of each is written to                        \n"
+                    << "        '$ROOT/training_data/$SCELNAME/$CONFIGID/casm_run.log'\n"
+                    << "      and the exit status and wall time to 'casm_run.json'.   \n"
+                    << "    - A summary is printed when all commands are complete.    \n"
+                    << "    - Configurations for which the same command already       \n"
+                    << "      succeeded are skipped, unless '--rerun' is given.       \n\n";
 
 
 
@@ -84,6 +190,64 @@ namespace CASM {
     std::cout << "  DONE." << std::endl << std::endl;
 
 
+    if(vm.count("jobs")) {
+      std::vector<RunJob> job_list;
+
+      PrimClex::config_iterator it = primclex.config_begin();
+      for(; it != primclex.config_end(); ++it) {
+
+        if(!it->selected())
+          continue;
+
+        RunJob job;
+        job.name = it->name();
+        job.path = it->get_path();
+        job.command = exec + " " + it->get_path().string();
+        job.skipped = !vm.count("rerun") && run_succeeded(job);
+
+        if(!job.skipped && vm.count("write-pos")) {
+          it->write_pos();
+        }
+
+        job_list.push_back(job);
+      }
+
+      std::vector<Index> todo;
+      for(Index i = 0; i < job_list.size(); i++) {
+        if(!job_list[i].skipped) {
+          todo.push_back(i);
+        }
+      }
+
+      std::cout << "Run " << todo.size() << " of " << job_list.size() << " selected configurations, "
+                << resolve_num_threads(jobs) << " at a time" << std::endl << std::endl;
+
+      std::mutex print_mutex;
+      auto start = std::chrono::steady_clock::now();
+      parallel_for_chunks(todo.size(), 1, jobs, [&](long thread, long begin, long end) {
+        for(long i = begin; i < end; ++i) {
+          RunJob &job = job_list[todo[i]];
+          run_job(job);
+
+          std::lock_guard<std::mutex> lock(print_mutex);
+          std::cout << "  " << job.name << ": exit status " << job.exit_status
+                    << " (" << job.wall_time << " s)" << std::endl;
+        }
+      });
+      double total_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      std::cout << "\n***************************\n" << std::endl;
+      print_run_summary(job_list, total_time, std::cout);
+      std::cout << std::endl;
+
+      for(const RunJob &job : job_list) {
+        if(!job.skipped && job.exit_status != 0) {
+          return 1;
+        }
+      }
+      return 0;
+    }
+
     PrimClex::config_iterator it = primclex.config_begin();
     for(; it != primclex.config_end(); ++it) {
 
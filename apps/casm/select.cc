@@ -239,8 +239,6 @@ namespace CASM {
       if(fs::exists(dir.clexulator_src(set.name(), set.bset()))) {
         primclex.read_global_orbitree(dir.clust(set.bset()));
         primclex.generate_full_nlist();
-        primclex.generate_supercell_nlists();
-
       }
 
       if(!vm.count("config") || (selection.size() == 1 && selection[0] == "MASTER")) {
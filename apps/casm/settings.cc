@@ -50,6 +50,8 @@ namespace CASM {
 
     std::cout << "SO settings: '" << set.so_options() << "'\n\n";
 
+    std::cout << "Clexulator type: '" << set.clexulator_type() << "'\n\n";
+
 
   }
 
@@ -80,7 +82,8 @@ namespace CASM {
       ("set-ref", po::value<std::vector<std::string> >(&multi_input)->multitoken(), "Set the current calculation reference")
       ("set-eci", po::value<std::string>(&single_input), "Set the current effective clust interactions (ECI)")
       ("set-compile-options", po::value<std::string>(&single_input), "Set the compiler options.")
-      ("set-so-options", po::value<std::string>(&single_input), "Set the options for generating shared libraries.");
+      ("set-so-options", po::value<std::string>(&single_input), "Set the options for generating shared libraries.")
+      ("set-clexulator-type", po::value<std::string>(&single_input), "Set how basis functions are evaluated: 'compiled' or 'table'.");
 
       try {
         po::store(po::parse_command_line(argc, argv, desc), vm); // can throw
@@ -89,7 +92,7 @@ namespace CASM {
 
         std::vector<std::string> all_opt = {"list", "new-bset", "new-calctype", "new-ref", "new-eci",
                                             "set-bset", "set-calctype", "set-ref", "set-eci",
-                                            "set-compile-options", "set-so-options"
+                                            "set-compile-options", "set-so-options", "set-clexulator-type"
                                            };
         int option_count = 0;
         for(int i = 0; i < all_opt.size(); i++) {
@@ -151,7 +154,14 @@ namespace CASM {
                     "        'other_ref'. Otherwise it is required.               \n" <<
                     "      - For --set-ref, 'other_calctype' is optional if among \n" <<
                     "        all calctype there is no other reference called      \n" <<
-                    "        'other_ref'. Otherwise it is required.               \n" <<
+                    "        'other_ref'. Otherwise it is required.               \n\n" <<
+
+                    "      casm settings --set-clexulator-type 'table'            \n" <<
+                    "      - 'compiled' (default): basis functions are evaluated  \n" <<
+                    "        by compiling the generated Clexulator source.        \n" <<
+                    "      - 'table': basis functions are evaluated from tables   \n" <<
+                    "        constructed from the basis set, so no compiler is    \n" <<
+                    "        needed and there is no wait to compile.              \n" <<
                     "\n";
 
           if(call_help)
@@ -485,6 +495,19 @@ namespace CASM {
       return 0;
     }
 
+    // set clexulator type
+    else if(vm.count("set-clexulator-type")) {
+      if(set.set_clexulator_type(single_input)) {
+        set.commit();
+        std::cout << "Set clexulator type to: '" << set.clexulator_type() << "'\n\n";
+        return 0;
+      }
+      else {
+        std::cout << "Could not set clexulator type to '" << single_input << "'. Use 'compiled' or 'table'.\n\n";
+        return 1;
+      }
+    }
+
     std::cout << std::endl;
 
     return 0;
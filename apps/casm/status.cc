@@ -100,12 +100,13 @@ namespace CASM {
   (units: number of primitive cells).                                  \n\
 - Execute: 'casm enum --configs --scellname NAME' to enumerate         \n\
   configurations for a particular supercell.                           \n\
-- Generated configurations are listed in the 'config_list.json' file.  \n\
-  This file should not usually be edited manually.                     \n\n";
+- Generated configurations are listed in the '.casm/config_list/'     \n\
+  directory, with one file per supercell. These files should not       \n\
+  usually be edited manually.                                          \n\n";
 
     std::cout <<
-              "- See 'casm format' for a description and location of   \n\
-   the 'config_list.json' file.                                        \n\
+              "- See 'casm format --config_list' for a description and  \n\
+   location of the 'config_list' files.                                \n\
  - See 'casm format' for a description and location of                 \n\
    the data files related to a particular configuration.\n\n";
 
@@ -125,8 +126,8 @@ Instructions for volume relaxed VASP energies:                         \n\n\
 - Select which configurations to calculate properties for using the    \n\
   'casm select' command. Use 'casm select --set on' to select all      \n\
   configurations. By default, the 'is selected?' state of each         \n\
-  configuration is stored by CASM in the master config_list.json file, \n\
-  located in the hidden '.casm' directory. You can also save additional\n\
+  configuration is stored by CASM in the config_list files, located in\n\
+  the hidden '.casm/config_list' directory. You can also save additional\n\
   selection using the 'casm select -o' option to write a selection to a\n\
   file. Selections may be operated on to create new selections that    \n\
   are subsets, unions, or intersections of existing selections.        \n\
@@ -442,23 +443,18 @@ Instructions for fitting ECI:                                          \n\n\
     int tot_calc = 0;
     int tot_sel = 0;
 
+    // count from the config list summary where possible, so that config lists are not read
     for(int i = 0; i < primclex.get_supercell_list().size(); i++) {
-      int gen = primclex.get_supercell(i).get_config_list().size();
-      int calc = 0, sel = 0;
-      const Supercell &scel = primclex.get_supercell(i);
-      for(int j = 0; j < scel.get_config_list().size(); j++) {
-        if(scel.get_config(j).selected()) {
-          sel++;
-        }
-        if(scel.get_config(j).calc_properties().contains("relaxed_energy")) {
-          calc++;
-        }
-      }
+      Index gen, sel, calc;
+      primclex.get_supercell(i).count_configs(gen, sel, calc);
       tot_gen += gen;
       tot_calc += calc;
       tot_sel += sel;
     }
 
+    // config lists that had to be read are counted in the summary, for next time
+    primclex.write_config_list_summary();
+
     std::cout << "- Number of supercells generated: " << primclex.get_supercell_list().size() << "\n";
     std::cout << "- Number of configurations generated: " << tot_gen << "\n";
     std::cout << "- Number of configurations currently selected: " << tot_sel << "\n";
@@ -511,17 +507,8 @@ Instructions for fitting ECI:                                          \n\n\
         int tot_calc = 0;
         int tot_sel = 0;
 
-        int gen = primclex.get_supercell(i).get_config_list().size();
-        int calc = 0, sel = 0;
-        const Supercell &scel = primclex.get_supercell(i);
-        for(int j = 0; j < scel.get_config_list().size(); j++) {
-          if(scel.get_config(j).selected()) {
-            sel++;
-          }
-          if(scel.get_config(j).calc_properties().contains("relaxed_energy")) {
-            calc++;
-          }
-        }
+        Index gen, sel, calc;
+        primclex.get_supercell(i).count_configs(gen, sel, calc);
         tot_gen += gen;
         tot_calc += calc;
         tot_sel += sel;
@@ -561,8 +548,10 @@ Instructions for fitting ECI:                                          \n\n\
     int N_ref_unset = 0;
     for(int i = 0; i < primclex.get_supercell_list().size(); i++) {
       const Supercell &scel = primclex.get_supercell(i);
-      for(int j = 0; j < scel.get_config_list().size(); j++) {
-        fs::path dir = scel.get_config(j).get_reference_state_dir();
+      Index gen, sel, calc;
+      scel.count_configs(gen, sel, calc);
+      for(Index j = 0; j < gen; j++) {
+        fs::path dir = reference_state_dir(primclex, scel.get_name() + "/" + std::to_string(j));
         if(dir == fs::path()) {
           N_ref_unset++;
         }
@@ -586,8 +575,10 @@ Instructions for fitting ECI:                                          \n\n\
 
           for(int i = 0; i < primclex.get_supercell_list().size(); i++) {
             const Supercell &scel = primclex.get_supercell(i);
-            for(int j = 0; j < scel.get_config_list().size(); j++) {
-              fs::path dir = scel.get_config(j).get_reference_state_dir();
+            Index gen, sel, calc;
+            scel.count_configs(gen, sel, calc);
+            for(Index j = 0; j < gen; j++) {
+              fs::path dir = reference_state_dir(primclex, scel.get_name() + "/" + std::to_string(j));
               if(dir == fs::path()) {
                 std::cout << std::setw(30) << scel.get_name() << "/" << j << std::endl;
               }
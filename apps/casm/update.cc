@@ -1,10 +1,13 @@
 #include "update.hh"
 
 #include <cstring>
+#include <chrono>
+#include <iomanip>
 
 #include "casm/crystallography/jsonStruc.hh"
 #include "casm/clex/ConfigMapping.hh"
 #include "casm/CASM_classes.hh"
+#include "casm/system/ParallelFor.hh"
 //#include "casm/misc/Time.hh"
 #include "casm_functions.hh"
 
@@ -24,6 +27,8 @@ namespace CASM {
     double tol(TOL);
     double vol_tol(0.25);
     double lattice_weight(0.5);
+    Index jobs(1);
+    Index k_best(1);
     po::options_description desc("'casm update' usage");
     desc.add_options()
     ("help,h", "Write help documentation")
@@ -31,6 +36,8 @@ namespace CASM {
      "Adjusts cost function for mapping optimization (cost=w*lattice_deformation+(1-w)*basis_deformation)")
     ("max-vol-change", po::value<double>(&vol_tol)->default_value(0.25),
      "Adjusts range of SCEL volumes searched while mapping imported structure onto ideal crystal (only necessary if the presence of vacancies makes the volume ambiguous). Default is +/- 25% of relaxed_vol/prim_vol. Smaller values yield faster import, larger values may yield more accurate mapping.")
+    ("jobs,j", po::value<Index>(&jobs)->default_value(1), "Map up to this many relaxed structures at once (0 uses all available cores). Configurations are still updated one at a time, in order.")
+    ("k-best", po::value<Index>(&k_best)->default_value(1), "Report this many of the lowest cost mappings of each relaxed structure, including the one used.")
     ("force,f", "Force all configurations to update (otherwise, use timestamps to determine which configurations to update)");
 
     try {
@@ -81,8 +88,12 @@ namespace CASM {
     std::cout << "Reading calculation data... " << std::endl << std::endl;
     std::vector<std::string> bad_config_report;
     std::vector<std::string> prop_names = primclex.get_curr_property();
+
+    // find the configurations with new data and read their relaxed structures, so that they can be
+    // mapped concurrently
+    std::vector<std::string> update_names;
+    std::vector<BasicStructure<Site> > relaxed_strucs;
     PrimClex::config_iterator it = primclex.config_begin();
-    Index num_updated(0);
     for(; it != primclex.config_end(); ++it) {
       /// Read properties.calc.json file containing externally calculated properties
       ///   location: casmroot/supercells/SCEL_NAME/CONFIG_ID/CURR_CALCTYPE/properties.calc.json
@@ -96,7 +107,6 @@ namespace CASM {
       ///   Currently only loading those properties that have references
       fs::path filepath = it->calc_properties_path();
       // determine if there is fresh data to read and put it in 'calc_properties'
-      jsonParser parsed_props;
       if(fs::exists(filepath)) {
         time_t datatime, filetime;
         // Compare 'datatime', from config_list database to 'filetime', from filesystem timestamp
@@ -106,118 +116,168 @@ namespace CASM {
         if(!vm.count("force") && filetime == datatime) {
           continue;
         }
-        num_updated++;
-        std::cout << std::endl << "***************************" << std::endl << std::endl;
-        std::cout << "Working on " << filepath.string() << "\n";
-
-        //json relax_data;
-        it->read_calc_properties(parsed_props);
-        bool new_config_flag;
-        std::string imported_name;
-
-        {
-          //Convert relaxed structure into a configuration, merge calculation data
-          BasicStructure<Site> relaxed_struc;
-          jsonParser json(filepath);
-          from_json(simple_json(relaxed_struc, "relaxed_"), json);
-
-          json.put_obj();
-          try {
-            new_config_flag = import_structure_occupation(relaxed_struc, &(*it), primclex, imported_name, json, true, true, false, tol, lattice_weight, vol_tol);
-          }
-          catch(std::exception &e) {
-            std::cerr << "\nError: Unable to map relaxed structure data contained in " << filepath << " onto PRIM.\n"
-                      << "       " << e.what() << std::endl;
-            //throw std::runtime_error(std::string("Unable to map relaxed structure data contained in ") + filepath.string() + " onto PRIM.\n");
-            return 1;
-          }
 
-          //copy data over
-          for(auto jit = json.cbegin(); jit != json.cend(); ++jit) {
-            parsed_props[jit.name()] = *jit;
-          }
+        //Convert relaxed structure into a configuration, merge calculation data
+        BasicStructure<Site> relaxed_struc;
+        from_json(simple_json(relaxed_struc, "relaxed_"), jsonParser(filepath));
+
+        update_names.push_back(it->name());
+        relaxed_strucs.push_back(relaxed_struc);
+      }
+    }
+
+    // map relaxed structures onto the PRIM concurrently; only adding them to the primclex is serial
+    if(relaxed_strucs.size()) {
+      std::cout << "Mapping " << relaxed_strucs.size() << " relaxed structure" << (relaxed_strucs.size() > 1 ? "s" : "")
+                << " using " << std::min(resolve_num_threads(jobs), long(relaxed_strucs.size())) << " thread(s)... " << std::endl << std::endl;
+    }
+    auto map_begin = std::chrono::steady_clock::now();
+    std::vector<StructureMapping> mappings = map_structures_occupation(relaxed_strucs, primclex, true, true, tol, lattice_weight, vol_tol, jobs, k_best);
+    double map_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - map_begin).count();
+
+    Index num_updated(0);
+    for(Index i = 0; i < update_names.size(); i++) {
+      Configuration *config = &primclex.configuration(update_names[i]);
+      fs::path filepath = config->calc_properties_path();
+      jsonParser parsed_props;
+
+      num_updated++;
+      std::cout << std::endl << "***************************" << std::endl << std::endl;
+      std::cout << "Working on " << filepath.string() << "\n";
+
+      //json relax_data;
+      config->read_calc_properties(parsed_props);
+      bool new_config_flag;
+      std::string imported_name;
+
+      {
+        jsonParser json;
+        try {
+          new_config_flag = insert_structure_occupation(mappings[i], config, primclex, imported_name, false, tol);
+          json = mappings[i].relaxation_properties;
         }
-        if(imported_name == it->name()) {
-          it->set_calc_properties(parsed_props);
-          continue;
+        catch(std::exception &e) {
+          std::cerr << "\nError: Unable to map relaxed structure data contained in " << filepath << " onto PRIM.\n"
+                    << "       " << e.what() << std::endl;
+          //throw std::runtime_error(std::string("Unable to map relaxed structure data contained in ") + filepath.string() + " onto PRIM.\n");
+          return 1;
         }
 
-        Configuration &imported_config = primclex.configuration(imported_name);
-        // Structure is mechanically unstable!
-        std::cout << "Configuration " << it->name() << " appears to be mechanically unstable!\n"
-                  << "After relaxation, it most closely maps onto " << " configuration " << imported_name << ", which"
-                  << (new_config_flag ?
-                      " has been automatically added to"
-                      : " already exists in")
-                  << " your project.\n";
-        // Note the instability:
-        it->push_back_source(json_unit("mechanically_unstable"));
-        it->push_back_source(json_pair("relaxed_to", imported_name));
-        imported_config.push_back_source(json_pair("relaxation_of", it->name()));
-        bad_config_report.push_back(std::string("  - ") + it->name() + " relaxed to " + imported_name);
+        //copy data over
+        for(auto jit = json.cbegin(); jit != json.cend(); ++jit) {
+          parsed_props[jit.name()] = *jit;
+        }
+      }
 
-        // if imported_config has no properties, copy them over
-        if(!fs::exists(imported_config.calc_properties_path())
-           && (imported_config.calc_properties().is_null() || imported_config.calc_properties().size() == 0)) {
-          std::cout << "Because no calculation data exists for configuration " << imported_name << ",\n"
-                    << "it will assume the data from " << filepath << "\n";
+      // adding a configuration may move the configurations of its supercell
+      config = &primclex.configuration(update_names[i]);
 
-          if(!fs::exists(imported_config.get_pos_path()))
-            primclex.configuration(imported_name).write_pos();
+      if(imported_name == config->name()) {
+        config->set_calc_properties(parsed_props);
+        continue;
+      }
 
-          fs::path import_target = imported_config.calc_properties_path();
-          import_target.remove_filename();
-          if(!fs::exists(import_target))
-            fs::create_directories(import_target);
+      Configuration &imported_config = primclex.configuration(imported_name);
+      // Structure is mechanically unstable!
+      std::cout << "Configuration " << config->name() << " appears to be mechanically unstable!\n"
+                << "After relaxation, it most closely maps onto " << " configuration " << imported_name << ", which"
+                << (new_config_flag ?
+                    " has been automatically added to"
+                    : " already exists in")
+                << " your project.\n";
+      // Note the instability:
+      config->push_back_source(json_unit("mechanically_unstable"));
+      config->push_back_source(json_pair("relaxed_to", imported_name));
+      imported_config.push_back_source(json_pair("relaxation_of", config->name()));
+      bad_config_report.push_back(std::string("  - ") + config->name() + " relaxed to " + imported_name);
 
-          std::cout << "New file path is " << import_target << "\n";
-          fs::copy_file(filepath, imported_config.calc_properties_path());
+      // if imported_config has no properties, copy them over
+      if(!fs::exists(imported_config.calc_properties_path())
+         && (imported_config.calc_properties().is_null() || imported_config.calc_properties().size() == 0)) {
+        std::cout << "Because no calculation data exists for configuration " << imported_name << ",\n"
+                  << "it will assume the data from " << filepath << "\n";
 
+        if(!fs::exists(imported_config.get_pos_path()))
+          primclex.configuration(imported_name).write_pos();
 
-          parsed_props["data_timestamp"] = fs::last_write_time(imported_config.calc_properties_path());
+        fs::path import_target = imported_config.calc_properties_path();
+        import_target.remove_filename();
+        if(!fs::exists(import_target))
+          fs::create_directories(import_target);
 
-          imported_config.set_calc_properties(parsed_props);
-          imported_config.push_back_source(json_pair("data_inferred_from_mapping", it->name()));
+        std::cout << "New file path is " << import_target << "\n";
+        fs::copy_file(filepath, imported_config.calc_properties_path());
 
-          continue;
-        }
-        // prior data exist -- we won't copy data over, but do some validation to see if data are compatible
-        else {
-          const jsonParser &extant_props = imported_config.calc_properties();
-          bool data_mismatch = false;
-
-          auto prop_it = extant_props.cbegin(), prop_end = extant_props.cend();
-          for(; prop_it != prop_end; ++prop_it) {
-            if(!parsed_props.contains(prop_it.name())) {
-              data_mismatch = true;
-              continue;
-            }
 
-            // Try to ensure that the property is some sort of energy and convertible to scalar
-            if(!prop_it->is_number() || (prop_it.name()).find("energy") == std::string::npos)
-              continue;
+        parsed_props["data_timestamp"] = fs::last_write_time(imported_config.calc_properties_path());
+
+        imported_config.set_calc_properties(parsed_props);
+        imported_config.push_back_source(json_pair("data_inferred_from_mapping", config->name()));
+
+        continue;
+      }
+      // prior data exist -- we won't copy data over, but do some validation to see if data are compatible
+      else {
+        const jsonParser &extant_props = imported_config.calc_properties();
+        bool data_mismatch = false;
+
+        auto prop_it = extant_props.cbegin(), prop_end = extant_props.cend();
+        for(; prop_it != prop_end; ++prop_it) {
+          if(!parsed_props.contains(prop_it.name())) {
+            data_mismatch = true;
+            continue;
+          }
 
-            if(!almost_equal(prop_it->get<double>(), parsed_props[prop_it.name()].get<double>(), 1e-4)) {
-              if(parsed_props[prop_it.name()].get<double>() < prop_it->get<double>()) {
-                std::cout << "\nWARNING: Mapped configuration " << imported_name << " has \n"
-                          << "                    " << prop_it.name() << "=" << prop_it->get<double>() << "\n"
-                          << "         Which is higher than the relaxed value for mechanically unstable configuration " << it->name() << " which is\n"
-                          << "                    " << prop_it.name() << "=" << parsed_props[prop_it.name()].get<double>() << "\n"
-                          << "         This suggests that " << imported_name << " may be a metastable minimum.  Please investigate further.\n";
-                bad_config_report.back() += ", **which may be metastable**";
-                continue;
-              }
-              data_mismatch = true;
+          // Try to ensure that the property is some sort of energy and convertible to scalar
+          if(!prop_it->is_number() || (prop_it.name()).find("energy") == std::string::npos)
+            continue;
+
+          if(!almost_equal(prop_it->get<double>(), parsed_props[prop_it.name()].get<double>(), 1e-4)) {
+            if(parsed_props[prop_it.name()].get<double>() < prop_it->get<double>()) {
+              std::cout << "\nWARNING: Mapped configuration " << imported_name << " has \n"
+                        << "                    " << prop_it.name() << "=" << prop_it->get<double>() << "\n"
+                        << "         Which is higher than the relaxed value for mechanically unstable configuration " << config->name() << " which is\n"
+                        << "                    " << prop_it.name() << "=" << parsed_props[prop_it.name()].get<double>() << "\n"
+                        << "         This suggests that " << imported_name << " may be a metastable minimum.  Please investigate further.\n";
+              bad_config_report.back() += ", **which may be metastable**";
+              continue;
             }
+            data_mismatch = true;
           }
-          if(data_mismatch)
-            std::cout << "WARNING: The data parsed from \n"
-                      << "             " << filepath << "\n"
-                      << "         is incompatible with existing data for configuration " << imported_name << "\n"
-                      << "         even though " << it->name() << " was found to relax to " << imported_name << "\n";
         }
+        if(data_mismatch)
+          std::cout << "WARNING: The data parsed from \n"
+                    << "             " << filepath << "\n"
+                    << "         is incompatible with existing data for configuration " << imported_name << "\n"
+                    << "         even though " << config->name() << " was found to relax to " << imported_name << "\n";
+      }
 
-        std::cout << std::endl;
+      std::cout << std::endl;
+    }
+
+    if(mappings.size()) {
+      // timing and cost of mapping each relaxed structure
+      std::cout << std::endl << "***************************" << std::endl << std::endl;
+      std::cout << "Mapping report:\n"
+                << "  " << std::setw(10) << "time(s)" << std::setw(22) << "lattice_deformation" << std::setw(20) << "basis_deformation"
+                << "   configuration\n";
+      double total_seconds(0.0);
+      for(Index i = 0; i < mappings.size(); i++) {
+        total_seconds += mappings[i].seconds;
+        std::cout << "  " << std::setw(10) << std::fixed << std::setprecision(3) << mappings[i].seconds
+                  << std::setw(22) << std::setprecision(6) << mappings[i].relaxation_properties["lattice_deformation"].get<double>()
+                  << std::setw(20) << mappings[i].relaxation_properties["basis_deformation"].get<double>()
+                  << "   " << update_names[i] << "\n";
+      }
+      std::cout.unsetf(std::ios::floatfield);
+      std::cout << "  Mapping took " << map_seconds << " s (" << total_seconds << " s summed over structures)" << std::endl;
+
+      if(k_best > 1) {
+        std::cout << std::endl << "Lowest cost mappings:\n";
+        for(Index i = 0; i < mappings.size(); i++) {
+          std::cout << "  " << update_names[i] << ":\n";
+          print_mappings(relaxed_strucs[i], mappings[i], primclex, lattice_weight, std::cout, "  ");
+        }
       }
     }
     std::cout << std::endl << "***************************" << std::endl << std::endl;
@@ -227,7 +287,7 @@ namespace CASM {
     else {
       std::cout <<  "Analyzed new data for " << num_updated << " configurations." << std::endl << std::endl;
       std::cout << "Generating references... " << std::endl << std::endl;
-      /// This also re-writes the config_list.json
+      /// This also re-writes the config_list files of modified supercells
       primclex.generate_references();
       std::cout << "  DONE" << std::endl << std::endl;
       if(bad_config_report.size() > 0) {
@@ -7,6 +7,7 @@
 
 #include <iostream>
 #include "BP_Parse.hh"
+#include "casm/casm_io/CorrCache.hh"
 #include "Correlation.hh"
 #include "ECISet.hh"
 #include "EnergySet.hh"
@@ -24,6 +25,7 @@ Correlation::Correlation(std::string corr_in_filename) {
     int Ncon;
     std::string s1;
     BP::BP_Vec<double> list;
+    BP::BP_Vec< BP::BP_Vec<double> > rows;
 
     s1 = file.getline();
     Nclust = BP::next_int(s1);
@@ -38,31 +40,38 @@ Correlation::Correlation(std::string corr_in_filename) {
     s1 = file.getline();
 
     // data
+    rows.capacity(Ncon);
     do {
       list = file.getline_double();
       if(list.size() != 0)
-        add(list);
+        rows.add(list);
     }
     while(file.eof() == false);
 
     //std::cout << "val.size: " << val.size() << std::endl;
-    if(size() != Ncon) {
-      std::cout << "Error reading '" << corr_in_filename << "': stated #configurations == " << Ncon << ", but found #configurations == " << size() << std::endl;
+    if(rows.size() != Ncon) {
+      std::cout << "Error reading '" << corr_in_filename << "': stated #configurations == " << Ncon << ", but found #configurations == " << rows.size() << std::endl;
       exit(1);
     }
 
-    for(int i = 0; i < size(); i++) {
+    for(int i = 0; i < rows.size(); i++) {
       //std::cout << "val[i].size(): " << val[i].size() << std::endl;
-      if((*this)[i].size() != Nclust) {
-        std::cout << "Error: the eci.in file stated #clusters == " << Nclust << ", but reading '" << corr_in_filename << "' found #clusters == " << (*this)[i].size() << " for configuration " << i << std::endl;
+      if(rows[i].size() != Nclust) {
+        std::cout << "Error: the eci.in file stated #clusters == " << Nclust << ", but reading '" << corr_in_filename << "' found #clusters == " << rows[i].size() << " for configuration " << i << std::endl;
         exit(1);
       }
     }
+
+    set(rows);
   }
   else if(m_format == "json") {
     CASM::jsonParser json(corr_in_filename);
     from_json(*this, json);
   }
+  else if(m_format == "cache") {
+    std::cout << "Error reading '" << corr_in_filename << "': correlations cache files can only be used together with an 'energy' file" << std::endl;
+    exit(1);
+  }
   else {
     std::cout << "Unexpected format option for Correlation constructor" << std::endl;
     std::cout << "  Expected 'text' or 'json', but received: " << m_format << std::endl;
@@ -72,44 +81,116 @@ Correlation::Correlation(std::string corr_in_filename) {
 
 }
 
+// Construct from 'corr' file, or from a correlations cache file ('.corr') using the
+// configuration names in 'nrg_set' to select rows
+Correlation::Correlation(std::string corr_in_filename, const EnergySet &nrg_set) {
+
+  if(get_format_from_ext(corr_in_filename) != "cache") {
+    *this = Correlation(corr_in_filename);
+    return;
+  }
+
+  m_format = "cache";
+
+  CASM::CorrCache cache;
+  try {
+    cache.open_read_only(corr_in_filename);
+  }
+  catch(std::exception &e) {
+    std::cout << e.what() << std::endl;
+    exit(1);
+  }
+
+  // the cache is memory mapped, rows are copied directly from it
+  m_matrix.resize(nrg_set.size(), cache.corr_size());
+  for(int i = 0; i < nrg_set.size(); i++) {
+    const double *corr = cache.find(nrg_set.get_config_name(i));
+    if(corr == nullptr) {
+      std::cout << "Error reading '" << corr_in_filename << "': no correlations for configuration '" << nrg_set.get_config_name(i) << "'" << std::endl;
+      exit(1);
+    }
+    m_matrix.row(i) = Eigen::Map<const Eigen::RowVectorXd>(corr, cache.corr_size());
+  }
+
+}
+
 std::string Correlation::format() const {
   return m_format;
 }
 
-// reduce this to only including the subset of clusters indicated by their indices in 'index_list'
-void Correlation::cluster_subset(BP::BP_Vec<int> &index_list) {
+// set the correlation matrix, checking that every row has the same number of clusters
+void Correlation::set(const BP::BP_Vec< BP::BP_Vec<double> > &rows) {
   unsigned long int i, j;
+  unsigned long int Nclust = (rows.size() == 0) ? 0 : rows[0].size();
 
-  BP::BP_Vec< BP::BP_Vec< double> > tmp = (*this);
+  m_matrix.resize(rows.size(), Nclust);
+  for(i = 0; i < rows.size(); i++) {
+    if(rows[i].size() != Nclust) {
+      std::cout << "Error in Correlation: found #clusters == " << rows[i].size() << " for configuration " << i << ", but #clusters == " << Nclust << " for configuration 0" << std::endl;
+      exit(1);
+    }
+    for(j = 0; j < Nclust; j++) {
+      m_matrix(i, j) = rows[i][j];
+    }
+  }
+}
 
-  for(i = 0; i < (*this).size(); i++)
-    (*this)[i].clear();
+// set A to the weighted correlations of the structures with weight != 0 in 'nrg_set' and
+//   the clusters in 'cols'
+void Correlation::gather(Eigen::MatrixXd &A, const EnergySet &nrg_set, const std::vector<int> &cols) const {
+  unsigned long int i, in_i, in_j;
+
+  std::vector<unsigned long int> rows;
+  Eigen::VectorXd W(nrg_set.get_Nstruct_on());
+  for(i = 0; i < nrg_set.size(); i++) {
+    if(nrg_set.get_weight(i) != 0) {
+      W(rows.size()) = nrg_set.get_weight(i);
+      rows.push_back(i);
+    }
+  }
 
-  for(i = 0; i < tmp.size(); i++) {
-    for(j = 0; j < index_list.size(); j++) {
-      (*this)[i].add(tmp[i][ index_list[j]]);
+  // column-major, so each column is gathered from one contiguous block
+  if(rows.size() == size()) {
+    for(in_j = 0; in_j < cols.size(); in_j++) {
+      A.col(in_j) = W.cwiseProduct(m_matrix.col(cols[in_j]));
+    }
+  }
+  else {
+    for(in_j = 0; in_j < cols.size(); in_j++) {
+      const double *col = m_matrix.data() + cols[in_j] * m_matrix.rows();
+      for(in_i = 0; in_i < rows.size(); in_i++) {
+        A(in_i, in_j) = W(in_i) * col[rows[in_i]];
+      }
     }
   }
+}
 
+// reduce this to only including the subset of clusters indicated by their indices in 'index_list'
+void Correlation::cluster_subset(BP::BP_Vec<int> &index_list) {
+  Eigen::MatrixXd tmp(m_matrix.rows(), index_list.size());
+  for(unsigned long int j = 0; j < index_list.size(); j++) {
+    tmp.col(j) = m_matrix.col(index_list[j]);
+  }
+  m_matrix.swap(tmp);
 }
 
 // write a 'corr' file
 void Correlation::write(const std::string &filename, std::string format) const {
 
   if(format == "default")
-    format = m_format;
+    format = (m_format == "cache") ? "text" : m_format;
 
   if(format == "text") {
     unsigned long int i, j;
     BP::BP_Write file(rm_json_ext(filename));
     file.newfile();
 
-    file << (*this)[0].size() << " # number of clusters" << std::endl;
-    file << (*this).size() << " # number of configurations" << std::endl;
+    file << Nclust() << " # number of clusters" << std::endl;
+    file << size() << " # number of configurations" << std::endl;
     file << "clusters" << std::endl;
     for(i = 0; i < size(); i++) {
-      for(j = 0; j < (*this)[i].size(); j++) {
-        file << "   " << (*this)[i][j] ;
+      for(j = 0; j < Nclust(); j++) {
+        file << "   " << m_matrix(i, j) ;
       }
       file << "\n";
     }
@@ -142,7 +223,7 @@ void Correlation::write_covar(const ECISet &eci_in, const EnergySet &nrg_set, co
 
 
   if(format == "default")
-    format = m_format;
+    format = (m_format == "cache") ? "text" : m_format;
 
   if(format == "text") {
 
@@ -188,11 +269,19 @@ void Correlation::write_covar(const ECISet &eci_in, const EnergySet &nrg_set, co
 }
 
 CASM::jsonParser &to_json(const Correlation &corr, CASM::jsonParser &json) {
-  return to_json((BP::BP_Vec< BP::BP_Vec< double> > &) corr, json);
+  BP::BP_Vec< BP::BP_Vec< double> > rows(corr.size(), BP::BP_Vec<double>(corr.Nclust(), 0.0));
+  for(unsigned long int i = 0; i < corr.size(); i++) {
+    for(unsigned long int j = 0; j < corr.Nclust(); j++) {
+      rows[i][j] = corr(i, j);
+    }
+  }
+  return to_json(rows, json);
 }
 
 void from_json(Correlation &corr, const CASM::jsonParser &json) {
-  from_json((BP::BP_Vec< BP::BP_Vec< double> > &) corr, json);
+  BP::BP_Vec< BP::BP_Vec< double> > rows;
+  from_json(rows, json);
+  corr.set(rows);
 }
 
 #endif // Correlation_CC
@@ -6,6 +6,7 @@
 #define Correlation_HH
 
 #include <string>
+#include <vector>
 #include "jsonParser.hh"
 #include "BP_Vec.hh"
 #include "casm/external/Eigen/Dense"
@@ -13,11 +14,21 @@
 class ECISet;
 class EnergySet;
 
-class Correlation : public BP::BP_Vec< BP::BP_Vec< double> > {
+// The correlations of the training structures, stored once as a contiguous, column-major
+//   (Nconfig x Nclust) matrix
+//
+// Fits gather the weighted rows of the structures on and the columns of the clusters on from
+//   this matrix (see 'gather'), so each column is read contiguously. ECISet, Minimize, and
+//   Population only hold a const pointer or reference to one Correlation, so it is shared
+//   read-only by every ECISet being fit.
+class Correlation {
 
-  /// detected input file format: "text" or "json"
+  /// detected input file format: "text", "json", or "cache"
   std::string m_format;
 
+  // m_matrix(i, j): correlation j of configuration i
+  Eigen::MatrixXd m_matrix;
+
 public:
 
   //Correlation() {}
@@ -25,8 +36,39 @@ public:
   // Construct from 'corr' file
   Correlation(std::string corr_in_filename);
 
+  // Construct from 'corr' file, or from a correlations cache file ('.corr') using the
+  // configuration names in 'nrg_set' to select rows
+  Correlation(std::string corr_in_filename, const EnergySet &nrg_set);
+
   std::string format() const;
 
+  // number of configurations
+  unsigned long int size() const {
+    return m_matrix.rows();
+  }
+
+  // number of clusters
+  unsigned long int Nclust() const {
+    return m_matrix.cols();
+  }
+
+  // correlation 'j' of configuration 'i'
+  double operator()(unsigned long int i, unsigned long int j) const {
+    return m_matrix(i, j);
+  }
+
+  const Eigen::MatrixXd &matrix() const {
+    return m_matrix;
+  }
+
+  // set the correlation matrix, checking that every row has the same number of clusters
+  void set(const BP::BP_Vec< BP::BP_Vec<double> > &rows);
+
+  // set A to the weighted correlations of the structures with weight != 0 in 'nrg_set' and
+  //   the clusters in 'cols'
+  //   A(in_i, in_j) = weight(i) * corr(i, cols[in_j]), assumes A is already the right size
+  void gather(Eigen::MatrixXd &A, const EnergySet &nrg_set, const std::vector<int> &cols) const;
+
   // reduce this to only including the subset of clusters indicated by their indices in 'index_list'
   void cluster_subset(BP::BP_Vec<int> &index_list);
 
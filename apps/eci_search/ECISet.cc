@@ -5,8 +5,10 @@
 #ifndef ECISet_CC
 #define ECISet_CC
 
+#include <vector>
 #include "ECISet.hh"
 #include "Functions.hh"
+#include "casm/system/ParallelFor.hh"
 
 ECI::ECI(const CASM::jsonParser &json) {
   from_json(*this, json);
@@ -672,8 +674,8 @@ void ECISet::fit(const Correlation &_corr, const EnergySet &nrg_set, bool &_sing
   // X is corr_matrix
   // X_i is row i of X
 
-  // -- compute cv_a_i = X_i*((X^T*X)^-1)*X_i^T ahead of time
-  BP::BP_Vec<double> cv_a = set_cv_a(corr_matrix, nrg_set);
+  // -- cv_a_i = X_i*((X^T*X)^-1)*X_i^T, the diagonal of the hat matrix, from the svd already done
+  BP::BP_Vec<double> cv_a = set_cv_a(svd.matrixU());
 
   //std::cout << " calc rms and cv" << std::endl;
   rms = 0.0;
@@ -697,47 +699,130 @@ void ECISet::fit(const Correlation &_corr, const EnergySet &nrg_set, bool &_sing
   return;
 }
 
-void ECISet::check_cv(const Correlation &_corr, const EnergySet &_nrg_set, bool &_singular) {
-  fit(_corr, _nrg_set, _singular);
+void ECISet::check_cv(const Correlation &_corr, const EnergySet &nrg_set, bool &_singular, int k, int num_threads) {
+  fit(_corr, nrg_set, _singular);
   double fitted_cv = cv;
   std::cout << "fitted_cv: " << fitted_cv << "  fitted_rms: " << rms << std::endl;
 
-  // for each data in nrg_set, leave it out, fit, calculate predicted value
-  BP::BP_Vec<double> nrg_data;
-  BP::BP_Vec<double> nrg_fit;
-  double orig_weight;
+  // for each data in nrg_set, the prediction of the fit with its fold left out
+  Eigen::VectorXd held_out_err;
+  kfold_cv(_corr, nrg_set, k, num_threads, _singular, &held_out_err);
+  if(_singular) {
+    std::cout << "error, singular" << std::endl;
+    return;
+  }
 
-  EnergySet nrg_set = _nrg_set;
   double sqr_sum = 0.0;
   double wsqr_sum = 0.0;
-
+  int ii = 0;
   for(int i = 0; i < nrg_set.size(); i++) {
+    double weight = nrg_set.get_weight(i);
+    if(weight != 0.0) {
+
+      // held_out_err is weighted, like the rows of the correlation matrix
+      double data = nrg_set.get_Ef(i);
+      double held_out_fit = data + held_out_err(ii) / weight;
+
+      std::cout << "i: " << i << " data: " << data << "  fit: " << held_out_fit << std::endl;
+      sqr_sum += BP::sqr(data - held_out_fit);
+      wsqr_sum += BP::sqr(weight * (data - held_out_fit));
+      ii++;
+    }
+  }
+  std::string name = (k <= 0 || k >= ii) ? "LOOCV" : (std::to_string(k) + "-fold CV");
+  std::cout << "nFit: " << ii << std::endl;
+  std::cout << name << ": " << sqrt(sqr_sum / ii) << "  fitted_cv: " << fitted_cv << std::endl;
+  std::cout << "w" << name << ": " << sqrt(wsqr_sum / ii) << "  fitted_cv: " << fitted_cv << std::endl;
+}
+
+double ECISet::kfold_cv(const Correlation &_corr, const EnergySet &nrg_set, int k, int num_threads, bool &_singular, Eigen::VectorXd *held_out_err) const {
+  // k-fold cross validation score, with every held out residual calculated from a single
+  // factorization of the fit to all the data
+  //
+  // For the rows S of one fold, the residuals of a fit that leaves S out are:
+  //   e_S(held out) = (I - H_SS)^-1 * e_S
+  // e is the residual of the fit to all rows
+  // H_SS = U_S*U_S^T is the block of the hat matrix X*((X^T*X)^-1)*X^T for rows S,
+  //   and U_S are rows S of U from the svd X = U*S*V^T
+  //
+  // With one row per fold this is the LOOCV expression used by 'fit': e_i / (1 - X_i*((X^T*X)^-1)*X_i^T)
+  //
+  // Input:
+  //   k: number of folds, rows are assigned to folds round-robin. k <= 0 or k >= Nstruct gives LOOCV
+  //   num_threads: folds are evaluated in parallel
+  //
+  // Output:
+  //   returns cv score, sqrt(mean(e_held_out^2)), using weighted residuals like 'fit'
+  //   held_out_err, if not NULL, is set to the weighted held out residuals of the fitted structures
+  //   singular if the fit, or the fit leaving out some fold, is singular
 
-    // remove
-    orig_weight = nrg_set.get_weight(i);
-    if(orig_weight != 0.0) {
+  double inf = 1.0e20;
+  int N = nrg_set.get_Nstruct_on();
+  int Nclust = get_Nclust_on();
+  if(k <= 0 || k > N) {
+    k = N;
+  }
 
-      nrg_data.add(nrg_set.get_Ef(i));
-      nrg_set.set_weight(i, 0.0);
-      nrg_set.set_E_vec();
+  Eigen::MatrixXd corr_matrix(N, Nclust);
+  set_correlation_matrix(corr_matrix, _corr, nrg_set);
 
-      // fit
-      fit(_corr, nrg_set, _singular);
+  Eigen::JacobiSVD<Eigen::MatrixXd> svd(corr_matrix, Eigen::ComputeThinU | Eigen::ComputeThinV);
+  _singular = check_if_singular(svd.singularValues());
+  if(_singular) {
+    return inf;
+  }
 
-      // calc clex nrg
-      nrg_fit.add(EnergySet::calc_clex(_corr, *this, i));
+  if(!nrg_set.E_vec_is_ready()) {
+    std::cout << "Error in ECISet::kfold_cv.  nrg_set.E_vec is not ready." << std::endl;
+    exit(1);
+  }
 
-      // reset
-      nrg_set.set_weight(i, orig_weight);
+  Eigen::VectorXd Err = corr_matrix * svd.solve(nrg_set.get_E_vec()) - nrg_set.get_E_vec();
+  const Eigen::MatrixXd &U = svd.matrixU();
 
-      std::cout << "i: " << i << " data: " << nrg_data.last() << "  fit: " << nrg_fit.last() << std::endl;
-      sqr_sum += BP::sqr(nrg_data.last() - nrg_fit.last());
-      wsqr_sum += BP::sqr(orig_weight * (nrg_data.last() - nrg_fit.last()));
+  // each fold writes only its own rows, so no locking is needed
+  Eigen::VectorXd cv_err(N);
+  std::vector<char> fold_singular(k, 0);
+
+  CASM::parallel_for_chunks(k, 1, num_threads, [&](long thread, long begin, long end) {
+    for(long f = begin; f < end; f++) {
+      std::vector<int> rows;
+      for(int ii = f; ii < N; ii += k) {
+        rows.push_back(ii);
+      }
+
+      Eigen::MatrixXd U_S(rows.size(), U.cols());
+      Eigen::VectorXd e_S(rows.size());
+      for(int r = 0; r < rows.size(); r++) {
+        U_S.row(r) = U.row(rows[r]);
+        e_S(r) = Err(rows[r]);
+      }
+
+      Eigen::MatrixXd A = Eigen::MatrixXd::Identity(rows.size(), rows.size()) - U_S * U_S.transpose();
+      Eigen::FullPivLU<Eigen::MatrixXd> lu(A);
+      if(!lu.isInvertible()) {
+        fold_singular[f] = 1;
+        continue;
+      }
+
+      Eigen::VectorXd e_held_out = lu.solve(e_S);
+      for(int r = 0; r < rows.size(); r++) {
+        cv_err(rows[r]) = e_held_out(r);
+      }
+    }
+  });
+
+  for(int f = 0; f < k; f++) {
+    if(fold_singular[f]) {
+      _singular = true;
+      return inf;
     }
   }
-  std::cout << "nFit: " << nrg_data.size() << std::endl;
-  std::cout << "LOOCV: " << sqrt(sqr_sum / nrg_data.size()) << "  fitted_cv: " << fitted_cv << std::endl;
-  std::cout << "wLOOCV: " << sqrt(wsqr_sum / nrg_data.size()) << "  fitted_cv: " << fitted_cv << std::endl;
+
+  if(held_out_err != NULL) {
+    *held_out_err = cv_err;
+  }
+  return sqrt(cv_err.squaredNorm() / N);
 }
 
 void *ECISet::fit_threaded(void *arg) {
@@ -749,23 +834,14 @@ void ECISet::set_correlation_matrix(Eigen::MatrixXd &A, const Correlation &_corr
   // set A to be the correlation matrix, including weights, and only the rows and columns being fit
   // assumes A is already the right size
 
-  int i, j, in_i, in_j;
-
-  in_i = 0;
-  for(i = 0; i < nrg_set.size(); i++) {
-    if(nrg_set.get_weight(i) != 0) {
-      in_j = 0;
-      for(j = 0; j < _corr[i].size(); j++) {
-        if(this->get_weight(j) != 0) {
-          A(in_i, in_j) = nrg_set.get_weight(i) * _corr[i][j];
-          in_j++;
-        }
-      }
-      in_i++;
+  std::vector<int> cols;
+  for(int j = 0; j < _corr.Nclust(); j++) {
+    if(this->get_weight(j) != 0) {
+      cols.push_back(j);
     }
   }
 
-  //std::cout << " in_i: " << in_i << " in_j: " << in_j << std::endl;
+  _corr.gather(A, nrg_set, cols);
 }
 
 // private:
@@ -777,22 +853,18 @@ bool ECISet::check_if_singular(const Eigen::VectorXd &S) const {
   return false;
 }
 
-BP::BP_Vec<double> ECISet::set_cv_a(const Eigen::MatrixXd &C, const EnergySet &nrg_set) const {
+BP::BP_Vec<double> ECISet::set_cv_a(const Eigen::MatrixXd &U) const {
   //cout << "begin set_cv_a()" << endl;
   // -- compute a_i = X_i*((X^T*X)^-1)*X_i^T ahead of time, once per corr
+  //
+  // With the thin svd X = U*S*V^T, X*((X^T*X)^-1)*X^T = U*U^T, so a_i is the squared norm
+  // of row i of U. This avoids forming and inverting X^T*X.
 
-  Eigen::MatrixXd XTXinv;
-  unsigned long int i, ii;
-  BP::BP_Vec<double> cv_a(0, nrg_set.get_Nstruct_on());
+  BP::BP_Vec<double> cv_a(0, U.rows());
 
-  XTXinv = (C.transpose() * C).inverse();
+  for(unsigned long int ii = 0; ii < U.rows(); ii++)
+    cv_a.add(U.row(ii).squaredNorm());
 
-  ii = 0;
-  for(i = 0; i < nrg_set.size(); i++)
-    if(nrg_set.get_weight(i) != 0) {
-      cv_a.add(C.row(ii) * XTXinv * C.row(ii).transpose());
-      ii++;
-    }
   return cv_a;
 }
 
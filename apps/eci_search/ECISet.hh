@@ -218,7 +218,11 @@ public:
 
   void fit(const Correlation &_corr, const EnergySet &nrg_set, bool &_singular);
 
-  void check_cv(const Correlation &_corr, const EnergySet &_nrg_set, bool &_singular);
+  // fit, then print the held out prediction for each structure, using k-fold cv (k <= 0 for LOOCV)
+  void check_cv(const Correlation &_corr, const EnergySet &nrg_set, bool &_singular, int k = 0, int num_threads = 1);
+
+  // k-fold cv score (k <= 0 for LOOCV), with all held out residuals calculated from one factorization
+  double kfold_cv(const Correlation &_corr, const EnergySet &nrg_set, int k, int num_threads, bool &_singular, Eigen::VectorXd *held_out_err = NULL) const;
 
   static void *fit_threaded(void *arg);
 
@@ -231,7 +235,7 @@ private:
 
   bool check_if_singular(const Eigen::VectorXd &S) const;
 
-  BP::BP_Vec<double> set_cv_a(const Eigen::MatrixXd &C, const EnergySet &nrg_set) const;
+  BP::BP_Vec<double> set_cv_a(const Eigen::MatrixXd &U) const;
 
 
 };
@@ -131,20 +131,25 @@ std::string EnergySet::format() const {
 double EnergySet::calc_clex(const Correlation &corr, const ECISet &eci, unsigned long int i) {
   unsigned long int j;
   double Ef = 0;
-  for(j = 0; j < corr[i].size(); j++) {
-    Ef += corr[i][j] * eci.get_value(j);
+  for(j = 0; j < corr.Nclust(); j++) {
+    Ef += corr(i, j) * eci.get_value(j);
   }
   return Ef;
 }
 
 void EnergySet::calc_clex(const Correlation &corr, const ECISet &eci) {
   unsigned long int i, j;
+
+  // one matrix-vector product over the contiguous correlation matrix
+  Eigen::VectorXd values(corr.Nclust());
+  for(j = 0; j < corr.Nclust(); j++) {
+    values(j) = eci.get_value(j);
+  }
+  Eigen::VectorXd Ef = corr.matrix() * values;
+
   for(i = 0; i < size(); i++) {
-    (*this)[i].Ef = 0;
-    for(j = 0; j < corr[i].size(); j++) {
-      (*this)[i].Ef += corr[i][j] * eci.get_value(j);
-      (*this)[i].dist_from_hull = 0.0;
-    }
+    (*this)[i].Ef = Ef(i);
+    (*this)[i].dist_from_hull = 0.0;
   }
 }
 
@@ -161,9 +166,9 @@ void EnergySet::calc_nrg_diff(BP::BP_Vec<int> &index_list, const Correlation &co
     //cout << "Ef: " << (*this)[i].Ef << endl;
     double tmp = 0;
     for(j = 0; j < index_list.size(); j++) {
-      //cout << "j: " << j << "  corr: " << corr[i][index_list[j] ] << "  weight: " << eci.get_weight(j) << "  value: " << eci.get_value(j) << "  contribution: " << corr[i][index_list[j] ]*eci.get_weight(j)*eci.get_value(j) << endl;
-      tmp += corr[i][index_list[j] ] * eci.get_weight(j) * eci.get_value(j);
-      (*this)[i].Ef -= corr[i][index_list[j] ] * eci.get_weight(j) * eci.get_value(j);
+      //cout << "j: " << j << "  corr: " << corr(i, index_list[j]) << "  weight: " << eci.get_weight(j) << "  value: " << eci.get_value(j) << "  contribution: " << corr(i, index_list[j])*eci.get_weight(j)*eci.get_value(j) << endl;
+      tmp += corr(i, index_list[j]) * eci.get_weight(j) * eci.get_value(j);
+      (*this)[i].Ef -= corr(i, index_list[j]) * eci.get_weight(j) * eci.get_value(j);
       (*this)[i].dist_from_hull = 0.0;
     }
 
@@ -275,6 +280,10 @@ double EnergySet::get_dist_from_hull(unsigned long int i) const {
   return (*this)[i].dist_from_hull;
 }
 
+std::string EnergySet::get_config_name(unsigned long int i) const {
+  return (*this)[i].name;
+}
+
 std::string EnergySet::get_name() const {
   return name;
 }
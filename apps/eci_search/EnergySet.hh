@@ -119,6 +119,8 @@ public:
 
   double get_dist_from_hull(unsigned long int i) const;
 
+  std::string get_config_name(unsigned long int i) const;
+
   std::string get_name() const;
 
   double find_energy_min();
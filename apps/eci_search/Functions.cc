@@ -17,8 +17,8 @@
 ////----------------------------
 /// main functions
 void calc_eci(std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename, BP::BP_Vec<ECISet> &population, double hulltol) {
-  Correlation corr(corr_in_filename);
   EnergySet DFT_nrg(energy_filename);
+  Correlation corr(corr_in_filename, DFT_nrg);
   ECISet eci_in(eci_in_filename);
 
 
@@ -153,11 +153,26 @@ void calc_eci(std::string energy_filename, std::string eci_in_filename, std::str
 
 }
 
+void calc_check_cv(std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename, BP::BP_Vec<ECISet> &population, int k, int num_threads) {
+  EnergySet DFT_nrg(energy_filename);
+  Correlation corr(corr_in_filename, DFT_nrg);
+  ECISet eci_in(eci_in_filename);
+
+  bool singular;
+
+  if(population.size() == 1)
+    eci_in = population[0];
+
+  eci_in.check_cv(corr, DFT_nrg, singular, k, num_threads);
+
+  std::cout << std::endl << std::endl;
+}
+
 void calc_cs_eci(std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename, const BP::BP_Vec<double> &mu, int alg, double hulltol) {
   // solve E = Corr*ECI, for ECI using compressive sensing L1 norm minimization (plus L2 norm in practice)
 
-  Correlation corr(corr_in_filename);
   EnergySet DFT_nrg(energy_filename);
+  Correlation corr(corr_in_filename, DFT_nrg);
   ECISet eci_in(eci_in_filename);
   ECISet eci_CS = eci_in;
 
@@ -300,8 +315,8 @@ void calc_cs_eci(std::string energy_filename, std::string eci_in_filename, std::
 }
 
 void calc_ecistats(std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename, BP::BP_Vec<ECISet> &population) {
-  Correlation corr(corr_in_filename);
   EnergySet DFT_nrg(energy_filename);
+  Correlation corr(corr_in_filename, DFT_nrg);
   //ECISet eci_in(eci_in_filename);
   BP::BP_Vec<double> eci_value_list;
   BP::BP_Vec<double> eci_nonzero_value_list;
@@ -352,8 +367,8 @@ void calc_ecistats(std::string energy_filename, std::string eci_in_filename, std
 
 void calc_all_eci(int N, std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename) {
 
-  Correlation corr(corr_in_filename);
   EnergySet DFT_nrg(energy_filename);
+  Correlation corr(corr_in_filename, DFT_nrg);
   ECISet eci_in(eci_in_filename);
   ECISet eci_min_B = eci_in;
   bool singular;
@@ -404,8 +419,8 @@ void calc_all_eci(int N, std::string energy_filename, std::string eci_in_filenam
 }
 
 void calc_directmin_eci(int Nrand, int Nmin, int Nmax, std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename, BP::BP_Vec<ECISet> &population) {
-  Correlation corr(corr_in_filename);
   EnergySet DFT_nrg(energy_filename);
+  Correlation corr(corr_in_filename, DFT_nrg);
   ECISet eci_in(eci_in_filename);
 
   double cv_score;
@@ -464,8 +479,8 @@ void calc_directmin_eci(int Nrand, int Nmin, int Nmax, std::string energy_filena
 }
 
 void calc_dfsmin_eci(int Nrand, int Nstop, int Nmin, int Nmax, std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename, BP::BP_Vec<ECISet> &population) {
-  Correlation corr(corr_in_filename);
   EnergySet DFT_nrg(energy_filename);
+  Correlation corr(corr_in_filename, DFT_nrg);
   ECISet eci_in(eci_in_filename);
 
   // set fix so only up to triplets are used
@@ -564,8 +579,8 @@ void calc_dfsmin_eci(int Nrand, int Nstop, int Nmin, int Nmax, std::string energ
 }
 
 void calc_ga_eci(int Npopulation, int Nmin, int Nmax, int Nchildren, int Nmutations, std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename, BP::BP_Vec<ECISet> &population) {
-  Correlation corr(corr_in_filename);
   EnergySet DFT_nrg(energy_filename);
+  Correlation corr(corr_in_filename, DFT_nrg);
   ECISet eci_in(eci_in_filename);
   MTRand mtrand;
   bool singular;
@@ -641,8 +656,8 @@ void calc_ga_eci(int Npopulation, int Nmin, int Nmax, int Nchildren, int Nmutati
 }
 
 void calc_ga_dir_eci(int Npopulation, int Nmin, int Nmax, int Nchildren, int Nmutations, std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename, BP::BP_Vec<ECISet> &population) {
-  Correlation corr(corr_in_filename);
   EnergySet DFT_nrg(energy_filename);
+  Correlation corr(corr_in_filename, DFT_nrg);
   ECISet eci_in(eci_in_filename);
   MTRand mtrand;
   bool singular;
@@ -691,8 +706,8 @@ void calc_ga_dir_eci(int Npopulation, int Nmin, int Nmax, int Nchildren, int Nmu
 }
 
 void calc_ga_dfs_eci(int Npopulation, int Nmin, int Nmax, int Nchildren, int Nmutations, int Nstop, std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename, BP::BP_Vec<ECISet> &population) {
-  Correlation corr(corr_in_filename);
   EnergySet DFT_nrg(energy_filename);
+  Correlation corr(corr_in_filename, DFT_nrg);
   ECISet eci_in(eci_in_filename);
   MTRand mtrand;
   bool singular;
@@ -1004,7 +1019,7 @@ ECISet calc_FPC_eci(double mu, double prec_shrink, double prec_ECI, const ECISet
     if(nrg_set.get_weight(i) != 0) {
       jj = 0;
       for(j = 0; j < eci_set.size(); j++) {
-        C(ii, jj) = nrg_set.get_weight(i) * corr[i][j];		// include weight!?
+        C(ii, jj) = nrg_set.get_weight(i) * corr(i, j);		// include weight!?
         jj++;
       }
       ii++;
@@ -1107,7 +1122,7 @@ ECISet calc_BI_eci(double mu, double prec_shrink, double prec_ECI, const ECISet
     if(nrg_set.get_weight(i) != 0) {
       jj = 0;
       for(j = 0; j < eci_set.size(); j++) {
-        C(ii, jj) = nrg_set.get_weight(i) * corr[i][j];		// include weight!?
+        C(ii, jj) = nrg_set.get_weight(i) * corr(i, j);		// include weight!?
         jj++;
       }
       ii++;
@@ -1508,6 +1523,8 @@ std::string rm_json_ext(std::string filename) {
 }
 
 std::string get_format_from_ext(std::string filename) {
+  if(filename.size() > 5 && filename.substr(filename.size() - 5) == ".corr")
+    return "cache";
   if(rm_json_ext(filename) == filename)
     return "text";
   return "json";
@@ -9,6 +9,7 @@ bool TEST = false;
 bool NEW = false;
 int PTHREADS = -1;
 int MTHREADS = -1;
+int KFOLD = 0;
 double HULLTOL = 1.0e-14;
 
 #include <string>
@@ -26,6 +27,7 @@ class GeneticAlgorithm;
 
 /// Function declarations
 void calc_eci(std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename, BP::BP_Vec<ECISet> &population, double hulltol = 1.0e1 - 4);
+void calc_check_cv(std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename, BP::BP_Vec<ECISet> &population, int k, int num_threads);
 void calc_cs_eci(std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename, const BP::BP_Vec<double> &mu, int alg, double hulltol = 1.0e1 - 4);
 void calc_all_eci(int N, std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename);
 void calc_directmin_eci(int Nrand, int Nmin, int Nmax, std::string energy_filename, std::string eci_in_filename, std::string corr_in_filename, BP::BP_Vec<ECISet> &population);
@@ -0,0 +1,211 @@
+/*
+ *  IncrementalFit.cc
+ */
+
+#ifndef IncrementalFit_CC
+#define IncrementalFit_CC
+
+#include "IncrementalFit.hh"
+#include "ECISet.hh"
+#include "EnergySet.hh"
+#include "Correlation.hh"
+
+IncrementalFit::IncrementalFit() : Nupdate(0) {}
+
+IncrementalFit::IncrementalFit(const Correlation &_corr, const EnergySet &nrg_set) : Nupdate(0) {
+
+  if(!nrg_set.E_vec_is_ready()) {
+    std::cout << "Error in IncrementalFit.  nrg_set.E_vec is not ready." << std::endl;
+    exit(1);
+  }
+  E = nrg_set.get_E_vec();
+
+  int Nclust = _corr.Nclust();
+  X.resize(E.size(), Nclust);
+
+  std::vector<int> all_cols(Nclust);
+  for(int j = 0; j < Nclust; j++) {
+    all_cols[j] = j;
+  }
+  _corr.gather(X, nrg_set, all_cols);
+
+  Q.resize(X.rows(), Nclust);
+  R.resize(Nclust, Nclust);
+  QtE.resize(Nclust);
+}
+
+bool IncrementalFit::initialized() const {
+  return X.size() != 0;
+}
+
+void IncrementalFit::fit(ECISet &eci, bool &_singular) {
+  double inf = 1.0e20;
+
+  // recompute the factorization from scratch if more than this many columns change,
+  //   or after this many updates, to limit accumulated round-off
+  const int max_toggle = 8;
+  const int max_update = 256;
+
+  // the clusters on, and how they differ from the current factorization
+  std::vector<int> new_cols;
+  std::vector<char> is_on(X.cols(), 0), is_curr(X.cols(), 0);
+  for(int i = 0; i < eci.size(); i++) {
+    if(eci.get_weight(i) != 0) {
+      new_cols.push_back(i);
+      is_on[i] = 1;
+    }
+  }
+  std::vector<int> removed, added;
+  for(int j = 0; j < cols.size(); j++) {
+    is_curr[cols[j]] = 1;
+    if(!is_on[cols[j]]) {
+      removed.push_back(j);
+    }
+  }
+  for(int j = 0; j < new_cols.size(); j++) {
+    if(!is_curr[new_cols[j]]) {
+      added.push_back(new_cols[j]);
+    }
+  }
+
+  int Ntoggle = removed.size() + added.size();
+  _singular = false;
+  if(Ntoggle > max_toggle || Nupdate + Ntoggle > max_update) {
+    _singular = !refactor(new_cols);
+  }
+  else {
+    // remove from the back so the remaining positions stay valid
+    for(int j = removed.size() - 1; j >= 0; j--) {
+      remove_column(removed[j]);
+    }
+    for(int j = 0; j < added.size(); j++) {
+      if(!add_column(added[j])) {
+        _singular = true;
+        break;
+      }
+    }
+    Nupdate += Ntoggle;
+  }
+
+  eci.set_Nstruct(E.size());
+
+  if(_singular || check_if_singular()) {
+    _singular = true;
+    eci.set_cv(inf);
+    eci.set_rms(inf);
+    return;
+  }
+
+  int p = cols.size();
+  Eigen::VectorXd b = R.topLeftCorner(p, p).triangularView<Eigen::Upper>().solve(QtE.head(p));
+
+  // residuals, and LOOCV using the hat matrix diagonal h_i = |Q_i|^2
+  Eigen::VectorXd Err = Q.leftCols(p) * QtE.head(p) - E;
+  double rms = 0.0;
+  double cv = 0.0;
+  for(int ii = 0; ii < E.size(); ii++) {
+    rms += Err(ii) * Err(ii);
+    cv += BP::sqr(Err(ii) / (1.0 - Q.row(ii).head(p).squaredNorm()));
+  }
+  eci.set_rms(sqrt(rms / E.size()));
+  eci.set_cv(sqrt(cv / E.size()));
+
+  // eci values in cluster order
+  Eigen::VectorXd value = Eigen::VectorXd::Zero(X.cols());
+  for(int j = 0; j < p; j++) {
+    value(cols[j]) = b(j);
+  }
+  Eigen::VectorXd ECI(p);
+  for(int j = 0; j < p; j++) {
+    ECI(j) = value(new_cols[j]);
+  }
+  eci.set_values(ECI);
+}
+
+bool IncrementalFit::refactor(const std::vector<int> &new_cols) {
+  cols.clear();
+  Nupdate = 0;
+  for(int j = 0; j < new_cols.size(); j++) {
+    if(!add_column(new_cols[j])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IncrementalFit::add_column(int i) {
+  int p = cols.size();
+  if(p == X.rows()) {
+    return false;
+  }
+
+  // classical Gram-Schmidt, repeated once, is orthogonal to working precision
+  Eigen::VectorXd v = X.col(i);
+  double norm0 = v.norm();
+  Eigen::VectorXd r = Eigen::VectorXd::Zero(p);
+  if(p > 0) {
+    for(int pass = 0; pass < 2; pass++) {
+      Eigen::VectorXd s = Q.leftCols(p).transpose() * v;
+      v -= Q.leftCols(p) * s;
+      r += s;
+    }
+  }
+
+  double rho = v.norm();
+  if(norm0 == 0.0 || rho <= 1.0e-10 * norm0) {
+    return false;
+  }
+
+  Q.col(p) = v / rho;
+  R.row(p).head(p).setZero();
+  R.col(p).head(p) = r;
+  R(p, p) = rho;
+  QtE(p) = Q.col(p).dot(E);
+  cols.push_back(i);
+  return true;
+}
+
+void IncrementalFit::remove_column(int j) {
+  int p = cols.size();
+
+  // deleting column j leaves R upper Hessenberg in columns j..p-2
+  for(int c = j; c < p - 1; c++) {
+    R.col(c).head(p) = R.col(c + 1).head(p);
+  }
+  cols.erase(cols.begin() + j);
+
+  // restore upper triangular R, applying the same rotations to Q and Q^T*E
+  for(int c = j; c < p - 1; c++) {
+    Eigen::JacobiRotation<double> G;
+    G.makeGivens(R(c, c), R(c + 1, c));
+    R.applyOnTheLeft(c, c + 1, G.adjoint());
+    R(c + 1, c) = 0.0;
+    Q.applyOnTheRight(c, c + 1, G);
+    QtE.applyOnTheLeft(c, c + 1, G.adjoint());
+  }
+}
+
+bool IncrementalFit::check_if_singular() {
+  int p = cols.size();
+  if(p == 0) {
+    return false;
+  }
+
+  // the singular values of X[:,cols] are those of R
+  // - smallest singular value <= min |R(i,i)|
+  if(R.topLeftCorner(p, p).diagonal().cwiseAbs().minCoeff() < 1.0e-4) {	// CONSTANT, as in ECISet
+    return true;
+  }
+
+  // - smallest singular value >= 1/|R^-1|_F
+  Eigen::MatrixXd Rinv = R.topLeftCorner(p, p).triangularView<Eigen::Upper>().solve(Eigen::MatrixXd::Identity(p, p));
+  if(1.0 / Rinv.norm() >= 1.0e-4) {
+    return false;
+  }
+
+  // - otherwise use the svd of R
+  Eigen::JacobiSVD<Eigen::MatrixXd> svd(R.topLeftCorner(p, p));
+  return svd.singularValues()(p - 1) < 1.0e-4;
+}
+
+#endif // IncrementalFit_CC
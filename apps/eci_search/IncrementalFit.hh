@@ -0,0 +1,78 @@
+/*
+ *  IncrementalFit.hh
+ */
+
+#ifndef IncrementalFit_HH
+#define IncrementalFit_HH
+
+#include <vector>
+#include "casm/external/Eigen/Dense"
+
+class ECISet;
+class EnergySet;
+class Correlation;
+
+// Least squares fit of the weighted energies to the clusters that are on in an ECISet,
+//   keeping a thin QR factorization of the weighted correlation matrix between fits
+//
+// When the clusters on differ from the previous fit by a few toggles, the factorization is
+//   updated instead of recomputed:
+//   - turning a cluster on appends a column, by Gram-Schmidt with reorthogonalization, O(Nstruct*Nclust)
+//   - turning a cluster off deletes a column and restores R with Givens rotations, O(Nstruct*Nclust)
+//   - the eci, rms, and LOOCV score (the hat matrix diagonal is the squared row norms of Q)
+//     then cost O(Nstruct*Nclust + Nclust^2)
+//
+// Results are the same as ECISet::fit, including the singular check (smallest singular
+//   value < 1e-4), which uses bounds from R and falls back to an svd of R only if they are
+//   inconclusive
+//
+// Each thread should use its own IncrementalFit
+class IncrementalFit {
+
+  // weighted correlation matrix, all clusters, rows for structures with weight != 0
+  Eigen::MatrixXd X;
+
+  // weighted energies
+  Eigen::VectorXd E;
+
+  // X.col(cols[j]) is column j of the current factorization
+  std::vector<int> cols;
+
+  // X[:,cols] = Q.leftCols(p)*R.topLeftCorner(p,p), with p = cols.size()
+  Eigen::MatrixXd Q;
+  Eigen::MatrixXd R;
+
+  // Q^T*E for the current columns
+  Eigen::VectorXd QtE;
+
+  // number of updates since the factorization was last recomputed from scratch
+  int Nupdate;
+
+public:
+
+  IncrementalFit();
+
+  IncrementalFit(const Correlation &_corr, const EnergySet &nrg_set);
+
+  bool initialized() const;
+
+  // fit the clusters on in 'eci', setting its eci values, cv, and rms, like ECISet::fit
+  void fit(ECISet &eci, bool &_singular);
+
+private:
+
+  // recompute the factorization for 'new_cols', returns false if they are linearly dependent
+  bool refactor(const std::vector<int> &new_cols);
+
+  // append column X.col(i), returns false if it is linearly dependent on the current columns
+  bool add_column(int i);
+
+  // delete column j of the factorization
+  void remove_column(int j);
+
+  // smallest singular value of X[:,cols] < 1e-4
+  bool check_if_singular();
+
+};
+
+#endif // IncrementalFit_HH
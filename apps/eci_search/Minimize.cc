@@ -6,7 +6,6 @@
 #define Minimize_CC
 
 #include "Minimize.hh"
-#include "BP_ThreadPool.hh"
 
 void DirectMinStep::run() {
   Nchoice = 0;
@@ -15,11 +14,14 @@ void DirectMinStep::run() {
   best_state = eci.get_state();
   double last_cv = best_state.cv;
 
+  if(!fitter.initialized())
+    fitter = IncrementalFit(*corr, *nrg);
+
   for(int i = 0; i < toggle.size(); i++) {
     eci.toggle_clust(toggle[i]);
 
     // find fit/cv score
-    eci.fit(*corr, *nrg, singular);
+    fitter.fit(eci, singular);
 
     if(eci.get_cv() < last_cv) {
       Nchoice++;
@@ -36,17 +38,15 @@ void DirectMinStep::run() {
   }
 }
 
-void *DirectMinStep::run_threaded(void *_this) {
-  ((DirectMinStep *) _this)->run();
-  return NULL;
-}
-
 void DFSMinStep::run() {
   bool singular;
   double last_cv = eci.get_cv();
   improved_state.clear();
   new_bit_string_list.clear();
 
+  if(!fitter.initialized())
+    fitter = IncrementalFit(*corr, *nrg);
+
   for(int i = 0; i < toggle.size(); i++) {
     eci.toggle_clust(toggle[i]);
 
@@ -54,7 +54,7 @@ void DFSMinStep::run() {
       new_bit_string_list.add(eci.get_bit_string());
 
       // find fit/cv score
-      eci.fit(*corr, *nrg, singular);
+      fitter.fit(eci, singular);
 
       if(eci.get_cv() < last_cv) {
         improved_state.add(eci.get_state());
@@ -65,11 +65,6 @@ void DFSMinStep::run() {
   }
 }
 
-void *DFSMinStep::run_threaded(void *_this) {
-  ((DFSMinStep *) _this)->run();
-  return NULL;
-}
-
 
 
 void Minimize::direct() {
@@ -79,9 +74,6 @@ void Minimize::direct() {
   eci.fit(*corr, *nrg, singular);
   ECISetState best_state = eci.get_state();
 
-  // create a threadpool
-  BP::ThreadPool pool(Nthreads);
-
   // we'll be toggling each eci on/off
   //   so to parallelize, break eciset into portions
   BP::BP_Vec<DirectMinStep> portion;
@@ -114,9 +106,16 @@ void Minimize::direct() {
     }
 
     // run the step
-    for(i = 0; i < portion.size(); i++)
-      pool.add_work(DirectMinStep::run_threaded, (void *) &portion[i]);
-    pool.finish();
+    {
+      CASM::TaskGroup group(*scheduler);
+      for(i = 0; i < portion.size(); i++) {
+        DirectMinStep *p = &portion[i];
+        group.run([p]() {
+          p->run();
+        });
+      }
+      group.wait();
+    }
 
     cont = false;
     Nchoice = 0;
@@ -171,9 +170,6 @@ void Minimize::dfs() {
   //queue.add(best_state);
   bit_string_list.add(eci.get_bit_string());
 
-  // create a threadpool
-  BP::ThreadPool pool(Nthreads);
-
   // we'll be toggling each eci on/off
   //   so to parallelize, break eciset into portions
   BP::BP_Vec<DFSMinStep> portion;
@@ -209,9 +205,16 @@ void Minimize::dfs() {
     //ss.str("");
 
     // run the step
-    for(i = 0; i < portion.size(); i++)
-      pool.add_work(DFSMinStep::run_threaded, (void *) &portion[i]);
-    pool.finish();
+    {
+      CASM::TaskGroup group(*scheduler);
+      for(i = 0; i < portion.size(); i++) {
+        DFSMinStep *p = &portion[i];
+        group.run([p]() {
+          p->run();
+        });
+      }
+      group.wait();
+    }
 
     Nchoice = 0;
     // add the new_bit_string_list's to bit_string_list
@@ -8,7 +8,9 @@
 #include "EnergySet.hh"
 #include "ECISet.hh"
 #include "Correlation.hh"
+#include "IncrementalFit.hh"
 #include "BP_Vec.hh"
+#include "casm/system/TaskScheduler.hh"
 #include <string>
 #include <sstream>
 
@@ -21,6 +23,9 @@ public:
   const Correlation *corr;
   BP::BP_Vec<int> toggle;
 
+  // updated, rather than refit, as clusters are toggled
+  IncrementalFit fitter;
+
   // for direct minimization
   int Nchoice;
   bool cont;  // continue?
@@ -31,7 +36,6 @@ public:
   }
 
   void run();
-  static void *run_threaded(void *_this);
 };
 
 
@@ -45,6 +49,9 @@ public:
   const BP::BP_Vec<std::string> *bit_string_list;
   BP::BP_Vec<int> toggle;
 
+  // updated, rather than refit, as clusters are toggled
+  IncrementalFit fitter;
+
   // for dfs minimization
   BP::BP_Vec<std::string> new_bit_string_list;
   BP::BP_Vec<ECISetState> improved_state;
@@ -57,19 +64,23 @@ public:
   }
 
   void run();
-  static void *run_threaded(void *_this);
 
 
 };
 
 
 
+// Minimizations run their steps as tasks on a shared TaskScheduler, so a population of
+//   Minimize run in parallel on the same scheduler share its threads
 class Minimize {
 
   const EnergySet *nrg;
   ECISet eci;
   const Correlation *corr;
+  CASM::TaskScheduler *scheduler;
   std::string sout;
+
+  // number of tasks each minimization step is split into
   int Nthreads;
 
   int step;
@@ -80,8 +91,8 @@ class Minimize {
   int finished;
 
 public:
-  Minimize(const EnergySet &_nrg, const ECISet &_eci, const Correlation &_corr, int _Nthreads = 1, bool _print_steps = false):
-    nrg(&_nrg), eci(_eci), corr(&_corr), Nthreads(_Nthreads), step(0), print_steps(_print_steps), finished(false) {
+  Minimize(const EnergySet &_nrg, const ECISet &_eci, const Correlation &_corr, CASM::TaskScheduler &_scheduler, int _Nthreads = 1, bool _print_steps = false):
+    nrg(&_nrg), eci(_eci), corr(&_corr), scheduler(&_scheduler), Nthreads(_Nthreads), step(0), print_steps(_print_steps), finished(false) {
   }
 
   void direct();
@@ -91,16 +102,6 @@ public:
     Nstop = _Nstop;
   }
 
-  static void *direct_threaded(void *_this) {
-    ((Minimize *) _this)->direct();
-    return NULL;
-  }
-
-  static void *dfs_threaded(void *_this) {
-    ((Minimize *) _this)->dfs();
-    return NULL;
-  }
-
   const ECISet &get_eci() const {
     return eci;
   }
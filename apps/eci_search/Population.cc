@@ -107,26 +107,31 @@ void Population::direct(int pthreads, int mthreads) {
   }
 
   // determine the number of threads
-  int ncore = sysconf(_SC_NPROCESSORS_ONLN);
-
-  if(pthreads == -1)
-    pthreads = ncore < population.size() ? ncore : population.size() ;
-  if(mthreads == -1)
-    while(mthreads * pthreads < ncore)
-      mthreads++;
+  //   all minimizations share one scheduler with 'pthreads' threads, and each minimization step
+  //   is split into 'mthreads' tasks, enough to keep every thread busy if the population is small
+  if(pthreads <= 0)
+    pthreads = CASM::resolve_num_threads(0);
+  if(mthreads <= 0)
+    mthreads = (pthreads + population.size() - 1) / population.size();
 
   if(TEST) std::cout << "pthreads: " << pthreads << " mthreads: " << mthreads << std::endl << std::endl;
 
-  // create a ThreadPool
-  BP::ThreadPool pool(pthreads);
+  CASM::TaskScheduler scheduler(pthreads);
 
   // create minimization objects for each ECISet in the population & run the minimization
   BP::BP_Vec<Minimize> minimization;
   BP::BP_Vec<bool> completed;
   for(int i = 0; i < population.size(); i++) {
     completed.add(false);
-    minimization.add(Minimize(nrg, population[i], corr, mthreads, false));
-    pool.add_work(Minimize::direct_threaded, (void *) &minimization[i]);
+    minimization.add(Minimize(nrg, population[i], corr, scheduler, mthreads, false));
+  }
+
+  CASM::TaskGroup group(scheduler);
+  for(int i = 0; i < minimization.size(); i++) {
+    Minimize *m = &minimization[i];
+    group.run([m]() {
+      m->direct();
+    });
   }
 
   // while the minimizations are ongoing, print results of completed fits
@@ -136,9 +141,11 @@ void Population::direct(int pthreads, int mthreads) {
     std::cout << minimization_status(minimization, completed);
     std::cout << flush;
   }
-  while(!pool.is_finished());
+  while(!group.is_finished());
+  group.wait();
 
   std::cout << minimization_status(minimization, completed);
+  std::cout << scheduler_status(scheduler);
   std::cout << flush;
 
   // set the final, minimized population
@@ -165,27 +172,32 @@ void Population::dfs(int Nstop, int pthreads, int mthreads) {
   }
 
   // determine the number of threads
-  int ncore = sysconf(_SC_NPROCESSORS_ONLN);
-
-  if(pthreads == -1)
-    pthreads = ncore < population.size() ? ncore : population.size();
-  if(mthreads == -1)
-    while(mthreads * pthreads < ncore)
-      mthreads++;
+  //   all minimizations share one scheduler with 'pthreads' threads, and each minimization step
+  //   is split into 'mthreads' tasks, enough to keep every thread busy if the population is small
+  if(pthreads <= 0)
+    pthreads = CASM::resolve_num_threads(0);
+  if(mthreads <= 0)
+    mthreads = (pthreads + population.size() - 1) / population.size();
 
   if(TEST) std::cout << "pthreads: " << pthreads << " mthreads: " << mthreads << std::endl;
 
-  // create a ThreadPool
-  BP::ThreadPool pool(pthreads);
+  CASM::TaskScheduler scheduler(pthreads);
 
   // create minimization objects for each ECISet in the population & run the minimization
   BP::BP_Vec<Minimize> minimization;
   BP::BP_Vec<bool> completed;
   for(int i = 0; i < population.size(); i++) {
     completed.add(false);
-    minimization.add(Minimize(nrg, population[i], corr, mthreads, false));
+    minimization.add(Minimize(nrg, population[i], corr, scheduler, mthreads, false));
     minimization[i].set_Nstop(Nstop);
-    pool.add_work(Minimize::dfs_threaded, (void *) &minimization[i]);
+  }
+
+  CASM::TaskGroup group(scheduler);
+  for(int i = 0; i < minimization.size(); i++) {
+    Minimize *m = &minimization[i];
+    group.run([m]() {
+      m->dfs();
+    });
   }
 
   // while the minimizations are ongoing, print results of completed fits
@@ -195,9 +207,11 @@ void Population::dfs(int Nstop, int pthreads, int mthreads) {
     std::cout << minimization_status(minimization, completed);
     std::cout << flush;
   }
-  while(!pool.is_finished());
+  while(!group.is_finished());
+  group.wait();
 
   std::cout << minimization_status(minimization, completed);
+  std::cout << scheduler_status(scheduler);
   std::cout << flush;
 
   // set the final, minimized population
@@ -244,16 +258,11 @@ void Population::ga(int Ngen, int Nmut, int pthreads, int mode, int Nstop) {
   }
 
   // determine the number of threads
-  int ncore = sysconf(_SC_NPROCESSORS_ONLN);
-  int ga_pthreads;
-
-  if(pthreads <= 0)
-    ga_pthreads = ncore;
+  int ga_pthreads = CASM::resolve_num_threads(pthreads);
 
   if(TEST) std::cout << "pthreads: " << pthreads << std::endl;
 
-  // create ThreadPool
-  BP::ThreadPool pool(ga_pthreads);
+  CASM::TaskScheduler scheduler(ga_pthreads);
 
   // create gene pool
   BP::BP_Vec<ECISetState> gene_pool;
@@ -297,10 +306,14 @@ void Population::ga(int Ngen, int Nmut, int pthreads, int mode, int Nstop) {
       dfs(Nstop, pthreads);
     }
     else {
+      CASM::TaskGroup group(scheduler);
       for(int i = 0; i < population.size(); i++) {
-        pool.add_work(ECISet::fit_threaded, (void *) &population[i]);
+        ECISet *eci = &population[i];
+        group.run([eci]() {
+          eci->fit();
+        });
       }
-      pool.finish();
+      group.wait();
     }
 
     // prune to best Npop unique ECISets of last 2 generations
@@ -327,6 +340,8 @@ void Population::ga(int Ngen, int Nmut, int pthreads, int mode, int Nstop) {
 
   std::cout << "\nFinal Population:" << std::endl;
   std::cout << population_status();
+  if(mode == 0)
+    std::cout << scheduler_status(scheduler);
 
   //std::cout << "finish Population::ga" << std::endl;
 
@@ -352,23 +367,25 @@ void Population::calc(int pthreads) {
   }
 
   // determine the number of threads
-  int ncore = sysconf(_SC_NPROCESSORS_ONLN);
-
-  if(pthreads == -1)
-    pthreads = ncore < population.size() ? ncore : population.size();
+  if(pthreads <= 0)
+    pthreads = std::min(CASM::resolve_num_threads(0), (long) population.size());
 
   if(TEST) std::cout << "pthreads: " << pthreads << std::endl;
 
-  // create Threadpool
-  BP::ThreadPool pool(pthreads);
+  CASM::TaskScheduler scheduler(pthreads);
 
   // fit each ECISet in the population
+  CASM::TaskGroup group(scheduler);
   for(int i = 0; i < population.size(); i++) {
-    pool.add_work(ECISet::fit_threaded, &population[i]);
+    ECISet *eci = &population[i];
+    group.run([eci]() {
+      eci->fit();
+    });
   }
-  pool.finish();
+  group.wait();
 
   std::cout << population_status();
+  std::cout << scheduler_status(scheduler);
 
   //std::cout << "finish Population::calc" << std::endl;
 }
@@ -383,15 +400,11 @@ void Population::calc_all(int N, int pthreads) {
   std::cout << "Beginning calculation of cv score for all combinations with " << N << " eci." << std::endl << std::endl;
 
   // determine the number of threads
-  int ncore = sysconf(_SC_NPROCESSORS_ONLN);
-
-  if(pthreads <= 0)
-    pthreads = ncore;
+  pthreads = CASM::resolve_num_threads(pthreads);
 
   if(TEST) std::cout << "pthreads: " << pthreads << std::endl;
 
-  // create the ThreadPool
-  BP::ThreadPool pool(pthreads);
+  CASM::TaskScheduler scheduler(pthreads);
 
   bool singular;
   int bestsofar = 0;
@@ -418,17 +431,21 @@ void Population::calc_all(int N, int pthreads) {
   do {
 
     // Fit the current Npop ECISets
+    CASM::TaskGroup group(scheduler);
     for(int i = 0; i < Npop; i++) {
       population[i] = combs;
       count[i] = combs.get_count();
-      pool.add_work(ECISet::fit_threaded, &population[i]);
+      ECISet *eci = &population[i];
+      group.run([eci]() {
+        eci->fit();
+      });
       combs.increment();
       if(combs.complete()) {
         max = i;
         break;
       }
     }
-    pool.finish();
+    group.wait();
 
     // Track the best cv score
     for(int i = 0; i < max; i++) {
@@ -459,6 +476,7 @@ void Population::calc_all(int N, int pthreads) {
             << " Best:" << std::setw(12) << count[zero] << " "
             << "   cv:" << std::setw(12) << population[zero].get_cv() << " "
             << "   rms:" << std::setw(12) << population[zero].get_rms() << " " << std::endl;
+  std::cout << scheduler_status(scheduler);
 
   //std::cout << "finish Population::calc_all" << std::endl;
 }
@@ -860,5 +878,19 @@ std::string Population::gene_pool_status(const BP::BP_Vec<ECISetState> &gene_poo
   return result;
 }
 
+std::string Population::scheduler_status(const CASM::TaskScheduler &scheduler) const {
+
+  // returns a string containing the work done by the scheduler's threads:
+  //   tasks run, tasks stolen from another thread's queue, and total idle time
+
+  CASM::TaskSchedulerStats stats = scheduler.stats();
+
+  stringstream ss;
+  ss << "Scheduler:  threads: " << stats.num_threads << "  tasks: " << stats.tasks << "  steals: " << stats.steals
+     << "  idle (s): " << std::setprecision(3) << std::fixed << stats.idle_seconds << std::endl;
+
+  return ss.str();
+}
+
 
 #endif // Population_CC
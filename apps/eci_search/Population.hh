@@ -117,6 +117,9 @@ private:
   // Return a string containing the status of the gene pool
   std::string gene_pool_status(const BP::BP_Vec<ECISetState> &gene_pool) const;
 
+  // Return a string containing the number of tasks, steals, and idle time of a scheduler
+  std::string scheduler_status(const CASM::TaskScheduler &scheduler) const;
+
 };
 
 #endif // Population_HH
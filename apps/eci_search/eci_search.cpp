@@ -43,11 +43,12 @@ namespace CASM {
 #include "BP_Geo.cc"
 #include "BP_Parse.cc"
 #include "BP_StopWatch.cc"
-#include "BP_ThreadPool.cc"
+#include "CorrCache.cc"
 #include "Correlation.cc"
 #include "ECISet.cc"
 #include "EnergySet.cc"
 #include "GeneticAlgorithm.cc"
+#include "IncrementalFit.cc"
 #include "Functions.cc"
 #include "Minimize.cc"
 #include "Population.cc"
@@ -98,6 +99,9 @@ void print_convert_man() {
 void print_calc_cs_fpc_man() {
   std::cout << "  eci_search -calc_cs_fpc energy eci.in corr.in mu" << std::endl;
 }
+void print_check_cv_man() {
+  std::cout << "  eci_search -check_cv energy eci.in corr.in [bitstring | bitstring_file]" << std::endl;
+}
 void print_calc_cs_bi_man() {
   std::cout << "  eci_search -calc_cs_bi energy eci.in corr.in mu" << std::endl;
 }
@@ -135,6 +139,20 @@ void print_calc_full_man() {
   std::cout << "      contains a list of the structures in 'energy.clex' which are below the " << std::endl;
   std::cout << "      green line. These correspond to the structures that the cluster        " << std::endl;
   std::cout << "      expansion wrongly predicts to be below the hull.                       " << std::endl;
+  std::cout << "                                                                             " << std::endl;
+  std::cout << "      For all fitting methods, 'corr.in' may also be a correlations cache    " << std::endl;
+  std::cout << "      file ('.casm/cache/bset.*.corr', written by 'casm query'). Then the    " << std::endl;
+  std::cout << "      correlations are looked up by the configuration names in 'energy'.     " << std::endl;
+  std::cout << std::endl << std::endl;
+}
+void print_check_cv_full_man() {
+  std::cout << "  eci_search -check_cv energy eci.in corr.in [bitstring | bitstring_file]" << std::endl;
+  std::cout << "      This fits the eciset in eci.in (or given as a bitstring), and prints   " << std::endl;
+  std::cout << "      the prediction for each structure from the fit with its fold left out, " << std::endl;
+  std::cout << "      and the resulting cv score. With '-kfold K', structures are assigned to" << std::endl;
+  std::cout << "      K folds round-robin. Otherwise, leave-one-out cv is used. All held out " << std::endl;
+  std::cout << "      predictions are calculated from a single factorization of the fit, and " << std::endl;
+  std::cout << "      folds are evaluated in parallel using '-mthreads X' threads.           " << std::endl;
   std::cout << std::endl << std::endl;
 }
 void print_ecistats_full_man() {
@@ -334,6 +352,7 @@ void print_eci_search_quick_man() {
   std::cout << "*** eci_search quick manual ***" << std::endl;
   std::cout << "  eci_search -help" << std::endl;
   print_calc_man();
+  print_check_cv_man();
   print_ecistats_man();
   print_calc_all_man();
   print_calc_directmin_man();
@@ -352,12 +371,14 @@ void print_eci_search_quick_man() {
 
   std::cout << "\n\n  Note: Use 'FixOn' or 'FixOff' for the 'weight' in the 'eci.in' file to set particular eci on/off manually." << std::endl << std::endl;
 
-  std::cout << "  Note: Use '-pthreads X' to specify number of threads used for parallel processing ECISets in a population. Default is number of cores." << std::endl << std::endl;
+  std::cout << "  Note: Use '-pthreads X' to specify number of threads shared by all ECISets in a population. Default is number of cores." << std::endl << std::endl;
 
-  std::cout << "  Note: Use '-mthreads X' to specify number of threads to use for each minimization step. Default is generally 1, but more if population size is less than pthreads." << std::endl << std::endl;
+  std::cout << "  Note: Use '-mthreads X' to specify number of parallel tasks each minimization step is split into. Default is generally 1, but more if population size is less than pthreads." << std::endl << std::endl;
 
   std::cout << "  Note: Use '-tol X' to set hull finding tolerances. Default is 1.0e-14." << std::endl << std::endl;
 
+  std::cout << "  Note: Use '-kfold K' to use K-fold cv for '-check_cv'. Default is leave-one-out." << std::endl << std::endl;
+
   std::cout << "  Note: Use '-old' to use deprecated serial functions." << std::endl << std::endl;
 
 
@@ -371,15 +392,18 @@ void print_eci_search_man() {
 
   std::cout << "  Note: Use 'FixOn' or 'FixOff' for the 'weight' in the 'eci.in' file to set particular eci on/off manually." << std::endl << std::endl;
 
-  std::cout << "  Note: Use '-pthreads X' to specify number of threads used for parallel processing ECISets in a population. Default is number of cores." << std::endl << std::endl;
+  std::cout << "  Note: Use '-pthreads X' to specify number of threads shared by all ECISets in a population. Default is number of cores." << std::endl << std::endl;
 
-  std::cout << "  Note: Use '-mthreads X' to specify number of threads to use for each minimization step. Default is generally 1, but more if population size is less than pthreads." << std::endl << std::endl;
+  std::cout << "  Note: Use '-mthreads X' to specify number of parallel tasks each minimization step is split into. Default is generally 1, but more if population size is less than pthreads." << std::endl << std::endl;
 
   std::cout << "  Note: Use '-tol X' to set hull finding tolerances. Default is 1.0e-14." << std::endl << std::endl;
 
+  std::cout << "  Note: Use '-kfold K' to use K-fold cv for '-check_cv'. Default is leave-one-out." << std::endl << std::endl;
+
   std::cout << "  Note: Use '-old' to use deprecated serial functions." << std::endl << std::endl;
 
   print_calc_full_man();
+  print_check_cv_full_man();
   print_ecistats_full_man();
   print_calc_all_full_man();
   print_calc_directmin_full_man();
@@ -437,6 +461,13 @@ int main(int argc, char *argv[]) {
       HULLTOL = BP::stod(string(argv[i]));
       argc_adjustment += 2;
     }
+    else if(std::string(argv[i]) == "-kfold") {
+      // number of folds for -check_cv (default is leave-one-out)
+      i++;
+      std::cout << argv[i] << " ";
+      KFOLD = BP::stoi(string(argv[i]));
+      argc_adjustment += 2;
+    }
     else if(std::string(argv[i]) == "-old") {
       // use original functions
       NEW = false;
@@ -530,6 +561,32 @@ int main(int argc, char *argv[]) {
       }
 
     }
+    else if(args[1] == "-check_cv") {
+      //eci_search -check_cv energy eci.in corr.in [bitstring | bitstring_file]
+      if(argc == 5 || argc == 6) {
+        BP::BP_Vec<ECISet> population;
+        if(argc == 6) {
+          if(is_bitstring(args[5])) {
+            ECISet eci_in(args[3]);
+            eci_in.set_bit_string(args[5]);
+            population.add(eci_in);
+          }
+          else {
+            population = read_bit_strings_file(ECISet(args[3]), args[5]);
+            if(population.size() != 1) {
+              std::cout << "error, the file " << args[5] << " has multiple bit strings." << std::endl;
+              exit(1);
+            }
+          }
+        }
+
+        calc_check_cv(args[2], args[3], args[4], population, KFOLD, (MTHREADS > 0) ? MTHREADS : 1);
+      }
+      else {
+        print_check_cv_man();
+        return 1;
+      }
+    }
     else if(args[1] == "-convert-to-text") {
       //eci_search -convert-to-text energy.json eci.in.json corr.in.json
       if(argc == 5) {
@@ -301,6 +301,7 @@ namespace BP {
     double		CH_dist_to_hull(int);				// Distance to 'closest_facet'
     Eigen::VectorXd	CH_vec_to_hull(int);				// Vector to 'closest_facet'
     double		CH_dist_to_hull(const Eigen::VectorXd &)const;		// Distance to 'closest_facet' of given point
+    void		CH_dist_to_hull(const Eigen::MatrixXd &, Eigen::VectorXd &, Eigen::VectorXi &)const;	// Distances of given points (each col is a point), as above, and index of the supporting facet of each
     //Eigen::VectorXd	CH_vec_to_hull( const Eigen::VectorXd &);
 
     // functions to get data on any facets
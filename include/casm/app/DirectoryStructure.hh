@@ -106,6 +106,21 @@ namespace CASM {
       return m_root / m_casm_dir / "config_list.json";
     }
 
+    /// \brief Return directory containing a config_list file for each supercell
+    fs::path config_list_dir() const {
+      return m_root / m_casm_dir / "config_list";
+    }
+
+    /// \brief Return config_list file path for one supercell
+    fs::path config_list(std::string scelname) const {
+      return config_list_dir() / (scelname + ".json");
+    }
+
+    /// \brief Return file path for the number of configurations in each supercell
+    fs::path config_list_summary() const {
+      return config_list_dir() / "summary.json";
+    }
+
 
     // -- Symmetry --------
 
@@ -181,6 +196,16 @@ namespace CASM {
       return bset_dir(bset) / "prim_nlist.json";
     }
 
+    /// \brief Returns path to the binary correlations cache for a basis set, in hidden .casm directory
+    fs::path corr_cache(std::string bset) const {
+      return casm_dir() / "cache" / (_bset(bset) + ".corr");
+    }
+
+    /// \brief Returns path to a stored convex hull, in hidden .casm directory
+    fs::path hull_cache(std::string name) const {
+      return casm_dir() / "cache" / (name + ".hull");
+    }
+
 
     // -- Calculations and reference --------
 
@@ -284,6 +309,11 @@ namespace CASM {
       return eci_dir(clex, calctype, ref, bset, eci) / "corr.in";
     }
 
+    /// \brief Returns path to energy clexulator source file, generated with the ECI in eci_out
+    fs::path energy_clexulator_src(std::string project, std::string clex, std::string calctype, std::string ref, std::string bset, std::string eci) const {
+      return eci_dir(clex, calctype, ref, bset, eci) / (project + "_Energy_Clexulator.cc");
+    }
+
 
     // -- other maybe temporary --------------------------
 
@@ -30,7 +30,8 @@ namespace CASM {
     ///
     explicit ProjectSettings(fs::path root, std::string name) :
       m_dir(root),
-      m_name(name) {
+      m_name(name),
+      m_clexulator_type("compiled") {
 
       if(fs::exists(m_dir.casm_dir())) {
         throw std::runtime_error(
@@ -62,6 +63,7 @@ namespace CASM {
           from_json(m_eci, settings["curr_eci"]);
           settings.get_else(m_compile_options, "compile_options", RuntimeLibrary::default_compile_options());
           settings.get_else(m_so_options, "so_options", RuntimeLibrary::default_so_options());
+          settings.get_else(m_clexulator_type, "clexulator_type", std::string("compiled"));
           from_json(m_name, settings["name"]);
           from_json(m_tol, settings["tol"]);
         }
@@ -125,6 +127,14 @@ namespace CASM {
       return m_so_options;
     }
 
+    /// \brief Get how basis functions are evaluated: "compiled" or "table"
+    ///
+    /// - "compiled": Compile the generated Clexulator source into a runtime library
+    /// - "table": Construct a TableClexulator from the basis set, no compiler is needed
+    std::string clexulator_type() const {
+      return m_clexulator_type;
+    }
+
     /// \brief Get current project tol
     double tol() const {
       return m_tol;
@@ -137,6 +147,10 @@ namespace CASM {
       return name() + "_Clexulator";
     }
 
+    std::string energy_clexulator() const {
+      return name() + "_Energy_Clexulator";
+    }
+
 
     // ** Add directories for additional project data **
 
@@ -268,6 +282,15 @@ namespace CASM {
       return true;
     }
 
+    /// \brief Set how basis functions are evaluated to 'type', if it is "compiled" or "table"
+    bool set_clexulator_type(std::string type) {
+      if(type == "compiled" || type == "table") {
+        m_clexulator_type = type;
+        return true;
+      }
+      return false;
+    }
+
     /// \brief Set shared library options to 'opt'
     bool set_tol(double _tol) {
       m_tol = _tol;
@@ -299,6 +322,9 @@ namespace CASM {
     std::string m_compile_options;
     std::string m_so_options;
 
+    // How basis functions are evaluated: "compiled" or "table"
+    std::string m_clexulator_type;
+
     // Default tolerance
     double m_tol;
 
@@ -317,6 +343,7 @@ namespace CASM {
     json["curr_eci"] = set.eci();
     json["compile_options"] = set.compile_options();
     json["so_options"] = set.so_options();
+    json["clexulator_type"] = set.clexulator_type();
     json["tol"] = set.tol();
 
     return json;
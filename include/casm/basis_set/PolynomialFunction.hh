@@ -74,6 +74,21 @@ namespace CASM {
     double leading_coefficient(Index &index) const;
     double get_coefficient(Index i) const;
 
+    /// \brief Number of arguments, the variables of the monomials
+    Index num_args() const {
+      return m_argument.size();
+    }
+
+    /// \brief Argument 'i'
+    const Function *argument(Index i) const {
+      return m_argument[i];
+    }
+
+    /// \brief Coefficient of each monomial, keyed by the exponent of each argument
+    const PolyTrie<double> &poly_coeffs() const {
+      return m_coeffs;
+    }
+
     void make_formula() const;
     void make_formula(double prefactor) const;
     int class_ID() const {
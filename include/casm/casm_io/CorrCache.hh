@@ -0,0 +1,162 @@
+#ifndef CASM_CorrCache
+#define CASM_CorrCache
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <boost/filesystem.hpp>
+
+#include "casm/misc/Hash.hh"
+
+namespace CASM {
+
+  /// \brief Binary, append-only, memory-mapped file of correlations, one row per configuration
+  ///
+  /// File layout, in native byte order:
+  /// - 64 byte header: "CASMCORR", format version, header size, corr_size, basis set hash
+  /// - rows: (configname hash, DoF hash, corr_size doubles), all 8 byte aligned
+  ///
+  /// Usage:
+  /// - The file is memory mapped and 'find' returns a pointer into the mapping, so correlations
+  ///   are read without parsing or copying
+  /// - Rows are only ever appended. If the DoF of a configuration change, the new correlations are
+  ///   appended and the last row for a configname is the one found.
+  /// - When opened for writing, an existing file with a different format version, corr_size,
+  ///   or basis set hash is discarded and a new file is started
+  /// - A partially written final row, for example from an interrupted run, is ignored, and
+  ///   truncated when the file is next opened for writing
+  /// - Rows added with 'append' are written, and become visible to 'find', on 'flush'
+  ///
+  /// Not safe for writing by more than one process at a time.
+  ///
+  class CorrCache {
+
+  public:
+
+    static const std::uint32_t format_version = 1;
+
+    CorrCache() {}
+
+    /// \brief Open, or create, the cache in 'filename' for reading and appending
+    CorrCache(const boost::filesystem::path &filename, std::uint64_t basis_hash, std::size_t corr_size) {
+      open(filename, basis_hash, corr_size);
+    }
+
+    CorrCache(const CorrCache &) = delete;
+    CorrCache &operator=(const CorrCache &) = delete;
+
+    /// \brief Flushes pending rows, ignoring errors; use 'close' to check for them
+    ~CorrCache();
+
+    /// \brief Open, or create, the cache in 'filename' for reading and appending
+    ///
+    /// \param filename Cache file, created with its parent directories if necessary
+    /// \param basis_hash Identifies the basis set, for example the hash of the Clexulator source
+    /// \param corr_size Number of correlations per row
+    ///
+    void open(const boost::filesystem::path &filename, std::uint64_t basis_hash, std::size_t corr_size);
+
+    /// \brief Open an existing cache for reading only, using the basis set hash and corr_size in the file
+    ///
+    /// \throws std::runtime_error if 'filename' does not exist or is not a valid cache file
+    void open_read_only(const boost::filesystem::path &filename);
+
+    /// \brief Flush pending rows and unmap the file
+    void close();
+
+    bool is_open() const {
+      return m_is_open;
+    }
+
+    const boost::filesystem::path &filename() const {
+      return m_filename;
+    }
+
+    std::uint64_t basis_hash() const {
+      return m_basis_hash;
+    }
+
+    std::size_t corr_size() const {
+      return m_corr_size;
+    }
+
+    /// \brief Number of rows in the file, including rows superseded by later rows
+    std::size_t size() const {
+      return m_N_rows;
+    }
+
+    /// \brief Number of distinct configurations in the file
+    std::size_t num_configs() const {
+      return m_index.size();
+    }
+
+    /// \brief Pointer to the last correlations stored for 'configname', or nullptr if there are none
+    const double *find(const std::string &configname) const;
+
+    /// \brief Pointer to the correlations stored for 'configname' with DoF hash 'dof_hash', or nullptr
+    ///        if there are none or they were calculated for different DoF
+    const double *find(const std::string &configname, std::uint64_t dof_hash) const;
+
+    /// \brief Queue a row of 'corr_size()' correlations for 'configname' to be written on 'flush'
+    void append(const std::string &configname, std::uint64_t dof_hash, const double *corr);
+
+    /// \brief Write queued rows to the end of the file and remap it
+    void flush();
+
+  private:
+
+    struct Header {
+      char magic[8];
+      std::uint32_t version;
+      std::uint32_t header_size;
+      std::uint64_t corr_size;
+      std::uint64_t basis_hash;
+      char reserved[32];
+    };
+
+    struct IndexEntry {
+      std::size_t row;
+      std::uint64_t dof_hash;
+    };
+
+    std::size_t _row_size() const {
+      return 2 * sizeof(std::uint64_t) + m_corr_size * sizeof(double);
+    }
+
+    const double *_row(std::size_t row) const {
+      return reinterpret_cast<const double *>(m_data + sizeof(Header) + row * _row_size() + 2 * sizeof(std::uint64_t));
+    }
+
+    /// \brief Read the header of 'm_filename', returns false if the file is not a cache file
+    bool _read_header(Header &header) const;
+
+    /// \brief Create 'm_filename', containing only a header
+    void _write_header() const;
+
+    /// \brief (Re)map 'm_filename' and index rows not yet indexed
+    void _map();
+
+    void _unmap();
+
+    boost::filesystem::path m_filename;
+    bool m_is_open = false;
+    bool m_read_only = true;
+    std::uint64_t m_basis_hash = 0;
+    std::size_t m_corr_size = 0;
+
+    const char *m_data = nullptr;
+    std::size_t m_mapped_size = 0;
+    std::size_t m_N_rows = 0;
+
+    /// configname hash -> last row for that configname
+    std::unordered_map<std::uint64_t, IndexEntry> m_index;
+
+    /// rows queued by 'append'
+    std::vector<char> m_pending;
+
+  };
+
+}
+
+#endif
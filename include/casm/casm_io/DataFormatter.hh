@@ -10,6 +10,7 @@
 #include "casm/CASM_global_definitions.hh"
 #include "casm/misc/CASM_math.hh"
 #include "casm/casm_io/jsonParser.hh"
+#include "casm/casm_io/jsonStream.hh"
 #include "casm/casm_io/DataStream.hh"
 #include "casm/casm_io/FormatFlag.hh"
 
@@ -52,6 +53,10 @@ namespace CASM {
 
     class FormattedObject;
   public:
+
+    /// Maximum number of objects passed together to BaseDatumFormatter::prefetch when formatting a range
+    static const Index batch_size = 1024;
+
     DataFormatter(int _sep = 4, int _precision = 12, std::string _comment = "#") :
       m_initialized(false), m_prec(_precision), m_sep(_sep), m_indent(0), m_comment(_comment) {}
 
@@ -116,6 +121,9 @@ namespace CASM {
     /// Verify that _obj has valid data for all portions of query
     bool validate(const DataObject &_obj) const;
 
+    ///Allow each DatumFormatter to precompute data for a batch of DataObjects that will be output next
+    void prefetch(const std::vector<const DataObject *> &_objs) const;
+
     ///Output selected data from DataObject to DataStream
     void inject(const DataObject &_obj, DataStream &_stream) const;
 
@@ -244,6 +252,14 @@ namespace CASM {
       return name();
     };
 
+    /// Optionally precompute data for a batch of objects that are about to be printed, injected, or written to json, in order.
+    /// When a range of objects is formatted, DataFormatter passes them in batches of up to DataFormatter::batch_size
+    /// so that DatumFormatters with expensive per-object calculations can evaluate them together.
+    /// Data for an object that was not prefetched must still be calculated on request.
+    virtual void prefetch(const std::vector<const DataObject *> &_data_objs) const {
+
+    };
+
     /// If data must be printed on multiple rows, returns number of rows needed to output all data from _data_obj
     /// DataFormatter class will subsequently pass over _data_obj multiple times to complete printing (if necessary)
     virtual Index num_passes(const DataObject &_data_obj) const {
@@ -310,6 +326,7 @@ namespace CASM {
     virtual void inject(DataStream &stream)const = 0;
     virtual void print(std::ostream &stream)const = 0;
     virtual jsonParser &to_json(jsonParser &json)const = 0;
+    virtual jsonStreamWriter &to_json(jsonStreamWriter &json)const = 0;
   };
 
 
@@ -330,8 +347,12 @@ namespace CASM {
       // hack: always print header to initialize things, like Clexulator, but in this case throw it away
       std::stringstream _ss;
       m_formatter_ptr->print_header(*m_begin_it, _ss);
-      for(IteratorType it(m_begin_it); it != m_end_it; ++it)
-        m_formatter_ptr->inject(*it, _stream);
+      std::vector<const DataObject *> batch;
+      for(IteratorType it(m_begin_it); it != m_end_it;) {
+        _next_batch(it, batch);
+        for(Index i = 0; i < batch.size(); i++)
+          m_formatter_ptr->inject(*batch[i], _stream);
+      }
     }
 
     void print(std::ostream &_stream) const {
@@ -348,17 +369,51 @@ namespace CASM {
       }
       format.print_header(false);
       _stream << format;
-      for(IteratorType it(m_begin_it); it != m_end_it; ++it)
-        m_formatter_ptr->print(*it, _stream);
+      std::vector<const DataObject *> batch;
+      for(IteratorType it(m_begin_it); it != m_end_it;) {
+        _next_batch(it, batch);
+        for(Index i = 0; i < batch.size(); i++)
+          m_formatter_ptr->print(*batch[i], _stream);
+      }
     }
 
     jsonParser &to_json(jsonParser &json) const {
       json.put_array();
-      for(IteratorType it(m_begin_it); it != m_end_it; ++it)
-        json.push_back((*m_formatter_ptr)(*it));
+      std::vector<const DataObject *> batch;
+      for(IteratorType it(m_begin_it); it != m_end_it;) {
+        _next_batch(it, batch);
+        for(Index i = 0; i < batch.size(); i++)
+          json.push_back((*m_formatter_ptr)(*batch[i]));
+      }
       return json;
     }
 
+    /// Write as a JSON array, one object at a time, rather than building the whole array
+    jsonStreamWriter &to_json(jsonStreamWriter &json) const {
+      json.begin_array();
+      std::vector<const DataObject *> batch;
+      jsonParser obj_json;
+      for(IteratorType it(m_begin_it); it != m_end_it;) {
+        _next_batch(it, batch);
+        for(Index i = 0; i < batch.size(); i++) {
+          obj_json.put_obj();
+          m_formatter_ptr->to_json(*batch[i], obj_json);
+          json.value(obj_json);
+        }
+      }
+      json.end_array();
+      return json;
+    }
+
+  private:
+    /// Collect the next batch of objects, starting from 'it', and let the DataFormatter prefetch their data
+    void _next_batch(IteratorType &it, std::vector<const DataObject *> &batch) const {
+      batch.clear();
+      for(; it != m_end_it && batch.size() < DataFormatter<DataObject>::batch_size; ++it)
+        batch.push_back(&(*it));
+      m_formatter_ptr->prefetch(batch);
+    }
+
   };
 
   //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -390,6 +445,12 @@ namespace CASM {
       m_formatter_ptr->to_json(*m_obj_ptr, json);
       return json;
     }
+
+    jsonStreamWriter &to_json(jsonStreamWriter &json) const {
+      jsonParser obj_json;
+      m_formatter_ptr->to_json(*m_obj_ptr, obj_json);
+      return json.value(obj_json);
+    }
   };
 
   //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -519,6 +580,10 @@ namespace CASM {
     return _obj.to_json(json);
   }
 
+  inline jsonStreamWriter &to_json(const FormattedPrintable &_obj, jsonStreamWriter &json) {
+    return _obj.to_json(json);
+  }
+
   //******************************************************************************
   inline std::ostream &operator<<(std::ostream &_stream, const FormattedPrintable &_formatted) {
     _formatted.print(_stream);
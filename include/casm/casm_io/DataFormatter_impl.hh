@@ -53,6 +53,18 @@ namespace CASM {
 
   //******************************************************************************
 
+  template<typename DataObject>
+  void DataFormatter<DataObject>::prefetch(const std::vector<const DataObject *> &_objs) const {
+    if(_objs.size() == 0)
+      return;
+    if(!m_initialized)
+      _initialize(*_objs[0]);
+    for(Index i = 0; i < m_data_formatters.size(); i++)
+      m_data_formatters[i]->prefetch(_objs);
+  }
+
+  //******************************************************************************
+
   template<typename DataObject>
   void DataFormatter<DataObject>::inject(const DataObject &_obj, DataStream &_stream) const {
     if(!m_initialized)
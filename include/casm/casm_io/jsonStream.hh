@@ -0,0 +1,218 @@
+#ifndef CASM_JSONSTREAM_HH
+#define CASM_JSONSTREAM_HH
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "casm/casm_io/jsonParser.hh"
+
+namespace CASM {
+
+  /// jsonStreamReader reads JSON from a stream one event at a time, without building the
+  /// whole document in memory
+  ///
+  /// Each call to 'next' consumes one event:
+  ///   BEGIN_OBJECT, END_OBJECT, BEGIN_ARRAY, END_ARRAY: start or end of an object or array
+  ///   KEY: name of the next member of an object, available from 'key()'
+  ///   VALUE: a string, number, bool, or null, available from 'value()'
+  ///   END_OF_STREAM: the top-level value is complete
+  ///
+  /// Parts of the document may still be read as jsonParser, using 'read', or skipped, using 'skip'.
+  /// Values are read as jsonParser::read would read them.
+  ///
+  /// Usage, to process each member of a large top-level object:
+  ///
+  ///     boost::filesystem::ifstream file("myfile.json");
+  ///     jsonStreamReader reader(file);
+  ///     reader.expect(jsonStreamReader::BEGIN_OBJECT);
+  ///     while(reader.next() == jsonStreamReader::KEY) {
+  ///       jsonParser json;
+  ///       reader.read(json);   // reads the value of member 'reader.key()'
+  ///       ...
+  ///     }
+  ///
+  /// Throws std::runtime_error, with the line number, if the JSON is not valid
+  ///
+  class jsonStreamReader {
+
+  public:
+
+    enum Event {BEGIN_OBJECT, END_OBJECT, BEGIN_ARRAY, END_ARRAY, KEY, VALUE, END_OF_STREAM};
+
+    explicit jsonStreamReader(std::istream &stream);
+
+    /// Consume the next event
+    Event next();
+
+    /// Consume the next event, and throw if it is not 'expected'
+    void expect(Event expected);
+
+    /// The last event
+    Event event() const {
+      return m_event;
+    }
+
+    /// Member name, after a KEY event
+    const std::string &key() const {
+      return m_key;
+    }
+
+    /// String, number, bool, or null, after a VALUE event
+    const jsonParser &value() const {
+      return m_value;
+    }
+
+    /// Number of objects and arrays that are open
+    std::size_t depth() const {
+      return m_level.size();
+    }
+
+    /// Current line of the stream, counting from 1
+    std::size_t line() const {
+      return m_line;
+    }
+
+    /// Read the next complete value, which may be an object or array, into 'json'
+    void read(jsonParser &json);
+
+    /// Skip the next complete value, which may be an object or array
+    void skip();
+
+  private:
+
+    struct Level {
+      bool is_object;
+      bool first;
+    };
+
+    int _peek();
+    int _get();
+    void _skip_ws();
+    void _expect_char(char c);
+    [[noreturn]] void _error(const std::string &what) const;
+
+    /// Read a value that starts at the next non-whitespace character
+    Event _read_value();
+    void _read_string(std::string &str);
+    void _read_number();
+    void _read_literal(const char *literal);
+    void _close_level();
+
+    /// Read the rest of the value whose first event was 'first' into 'json'
+    void _read(Event first, json_spirit::mValue &json);
+
+    std::streambuf *m_buf;
+    std::size_t m_line;
+
+    std::vector<Level> m_level;
+    bool m_after_key;
+    bool m_done;
+
+    Event m_event;
+    std::string m_key;
+    jsonParser m_value;
+    std::string m_number;
+
+  };
+
+  /// jsonStreamWriter writes JSON to a stream as it is generated, without building the whole
+  /// document in memory
+  ///
+  /// Output is formatted as jsonParser::print formats it, except that arrays opened with
+  /// 'begin_array' are always printed one element per line. Object members are printed in the
+  /// order they are written.
+  ///
+  /// Usage:
+  ///
+  ///     jsonStreamWriter writer(std::cout);
+  ///     writer.begin_object();
+  ///     writer.key("name").value("SCEL1_1_1_1_0_0_0");
+  ///     writer.key("configs").begin_array();
+  ///     for(...) {
+  ///       jsonParser json;
+  ///       ...
+  ///       writer.value(json);
+  ///     }
+  ///     writer.end_array();
+  ///     writer.end_object();
+  ///
+  /// Throws std::runtime_error if events are out of order, for example a value in an object
+  /// without a key
+  ///
+  class jsonStreamWriter {
+
+  public:
+
+    explicit jsonStreamWriter(std::ostream &stream, unsigned int indent = 2, unsigned int prec = 12);
+
+    jsonStreamWriter &begin_object();
+
+    jsonStreamWriter &end_object();
+
+    jsonStreamWriter &begin_array();
+
+    jsonStreamWriter &end_array();
+
+    /// Name of the next member of the current object
+    jsonStreamWriter &key(const std::string &name);
+
+    /// Write a complete value
+    jsonStreamWriter &value(const jsonParser &json);
+
+    /// Write a complete value, using 'to_json(const T&, jsonParser&)'
+    template<typename T>
+    jsonStreamWriter &value(const T &t) {
+      jsonParser json;
+      to_json(t, json);
+      return value(json);
+    }
+
+    /// Number of objects and arrays that are open
+    std::size_t depth() const {
+      return m_level.size();
+    }
+
+    /// True once a complete top-level value has been written
+    bool complete() const {
+      return m_done;
+    }
+
+    /// Flush the stream, for example so that output written so far can be read while the
+    /// rest is generated
+    jsonStreamWriter &flush() {
+      m_stream.flush();
+      return *this;
+    }
+
+  private:
+
+    struct Level {
+      bool is_object;
+      bool first;
+    };
+
+    void _before_value(const std::string &what);
+    void _after_value();
+    void _new_line(std::size_t level);
+    [[noreturn]] void _error(const std::string &what) const;
+
+    std::ostream &m_stream;
+    unsigned int m_indent;
+    unsigned int m_prec;
+
+    std::vector<Level> m_level;
+    bool m_after_key;
+    bool m_done;
+
+    /// reused to print values before indenting them
+    std::stringstream m_ss;
+
+  };
+
+}
+
+#endif
@@ -1,11 +1,13 @@
 #ifndef CLEXULATOR_HH
 #define CLEXULATOR_HH
 #include <cstddef>
+#include <cstdint>
 
 #define BOOST_NO_SCOPED_ENUMS
 #define BOOST_NO_CXX11_SCOPED_ENUMS
 #include <boost/filesystem.hpp>
 #include "casm/system/RuntimeLibrary.hh"
+#include "casm/clex/ClexulatorCache.hh"
 
 namespace CASM {
 
@@ -18,6 +20,8 @@ namespace CASM {
 
       typedef unsigned int size_type;
 
+      /// \brief Type of the Supercell linear indices in a neighbor list, see SuperNeighborList
+      typedef std::uint32_t nlist_index_type;
 
       Base(size_type _nlist_size, size_type _corr_size) :
         m_nlist_size(_nlist_size),
@@ -59,10 +63,11 @@ namespace CASM {
       /// \code
       /// UnitCellCoord bijk(b,i,j,k);           // UnitCellCoord of site in Configuration
       /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+      /// std::vector<SuperNeighborList::value_type> nlist_buffer(my_supercell.nlist().nlist_size());
+      /// myclexulator.set_nlist(my_supercell.nlist().sites(l_index % my_supercell.volume(), nlist_buffer.data()));
       /// \endcode
       ///
-      void set_nlist(const long int *_nlist_ptr) {
+      void set_nlist(const nlist_index_type *_nlist_ptr) {
         m_nlist_ptr = _nlist_ptr;
         return;
       };
@@ -76,7 +81,7 @@ namespace CASM {
       /// myclexulator.set_config_occ(my_configdof.occupation().begin());
       /// UnitCellCoord bijk(0,i,j,k);           // i,j,k of unit cell to get contribution from
       /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+      /// myclexulator.set_nlist(my_supercell.nlist().sites(l_index % my_supercell.volume(), nlist_buffer.data()));
       /// myclexulator.calc_global_corr_contribution(correlation_array.begin());
       /// \endcode
       ///
@@ -92,7 +97,7 @@ namespace CASM {
       /// myclexulator.set_config_occ(my_configdof.occupation().begin());
       /// UnitCellCoord bijk(0,i,j,k);           // i,j,k of unit cell to get contribution from
       /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+      /// myclexulator.set_nlist(my_supercell.nlist().sites(l_index % my_supercell.volume(), nlist_buffer.data()));
       /// std::vector<int> ind_list = {0, 2, 4, 6}; // Get contribution to correlations 0, 2, 4, and 6
       /// myclexulator.calc_restricted_global_corr_contribution(correlation_array.begin(), ind_list.begin(), ind_list.end());
       /// \endcode
@@ -109,7 +114,7 @@ namespace CASM {
       /// myclexulator.set_config_occ(my_configdof.occupation().begin());
       /// UnitCellCoord bijk(b,i,j,k);           // b,i,j,k of site to get point correlations
       /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+      /// myclexulator.set_nlist(my_supercell.nlist().sites(l_index % my_supercell.volume(), nlist_buffer.data()));
       /// myclexulator.calc_point_corr(b, correlation_array.begin());
       /// \endcode
       ///
@@ -126,7 +131,7 @@ namespace CASM {
       /// myclexulator.set_config_occ(my_configdof.occupation().begin());
       /// UnitCellCoord bijk(b,i,j,k);           // b,i,j,k of site to get point correlations
       /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+      /// myclexulator.set_nlist(my_supercell.nlist().sites(l_index % my_supercell.volume(), nlist_buffer.data()));
       /// std::vector<int> ind_list = {0, 2, 4, 6}; // Get contribution to correlations 0, 2, 4, and 6
       /// myclexulator.calc_restricted_point_corr(b, correlation_array.begin(), ind_list.begin(), ind_list.end());
       /// \endcode
@@ -144,7 +149,7 @@ namespace CASM {
       /// myclexulator.set_config_occ(my_configdof.occupation().begin());
       /// UnitCellCoord bijk(b,i,j,k);           // b,i,j,k of site to get delta point correlations
       /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+      /// myclexulator.set_nlist(my_supercell.nlist().sites(l_index % my_supercell.volume(), nlist_buffer.data()));
       /// int occ_i=0, occ_f=1;  // Swap from occupant 0 to occupant 1
       /// myclexulator.calc_delta_point_corr(b, occ_i, occ_f, correlation_array.begin());
       /// \endcode
@@ -163,7 +168,7 @@ namespace CASM {
       /// myclexulator.set_config_occ(my_configdof.occupation().begin());
       /// UnitCellCoord bijk(b,i,j,k);           // b,i,j,k of site to get delta point correlations
       /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-      /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+      /// myclexulator.set_nlist(my_supercell.nlist().sites(l_index % my_supercell.volume(), nlist_buffer.data()));
       /// int occ_i=0, occ_f=1;  // Swap from occupant 0 to occupant 1
       /// std::vector<int> ind_list = {0, 2, 4, 6}; // Get contribution to correlations 0, 2, 4, and 6
       /// myclexulator.calc_restricted_delta_point_corr(b, occ_i, occ_f, correlation_array.begin(), ind_list.begin(), ind_list.end());
@@ -194,9 +199,140 @@ namespace CASM {
       const int *m_occ_ptr;
 
       /// \brief Pointer to neighbor list
-      const long int *m_nlist_ptr;
+      const nlist_index_type *m_nlist_ptr;
 
     };
+
+    /// \brief Abstract base class for cluster expansion energy calculations
+    ///
+    /// Generated with the ECI of one cluster expansion folded in, so that the value of the
+    /// cluster expansion, or its change, is calculated directly rather than by calculating
+    /// correlations and multiplying by the ECI afterwards.
+    class EnergyBase {
+
+    public:
+
+      typedef Base::size_type size_type;
+
+      typedef Base::nlist_index_type nlist_index_type;
+
+
+      EnergyBase(size_type _nlist_size) :
+        m_nlist_size(_nlist_size) {}
+
+      virtual ~EnergyBase() {}
+
+      /// \brief Neighbor list size
+      size_type nlist_size() const {
+        return m_nlist_size;
+      }
+
+      /// \brief Clone the EnergyBase
+      std::unique_ptr<EnergyBase> clone() const {
+        return std::unique_ptr<EnergyBase>(_clone());
+      }
+
+      /// \brief Set pointer to data structure containing occupation variables
+      void set_config_occ(const int *_occ_ptr) {
+        m_occ_ptr = _occ_ptr;
+      }
+
+      /// \brief Set pointer to neighbor list
+      void set_nlist(const nlist_index_type *_nlist_ptr) {
+        m_nlist_ptr = _nlist_ptr;
+      }
+
+      /// \brief Calculate contribution to the cluster expansion from one unit cell
+      ///
+      /// The sum over all unit cells of a Configuration, divided by the number of unit cells, is
+      /// the value of the cluster expansion per unit cell, i.e. eci*correlations.
+      ///
+      /// Call using:
+      /// \code
+      /// myclexulator.set_config_occ(my_configdof.occupation().begin());
+      /// UnitCellCoord bijk(0,i,j,k);           // i,j,k of unit cell to get contribution from
+      /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
+      /// myclexulator.set_nlist(my_supercell.nlist().sites(l_index % my_supercell.volume(), nlist_buffer.data()));
+      /// double e = myclexulator.calc_energy();
+      /// \endcode
+      ///
+      virtual double calc_energy() const = 0;
+
+      /// \brief Calculate the change in the cluster expansion due to changing an occupant
+      ///
+      /// \brief b_index Basis site index of the changing site
+      /// \brief occ_i,occ_f Initial and final occupant variable
+      ///
+      /// Returns the change in the value of the cluster expansion of the entire Configuration,
+      /// i.e. eci*(delta point correlations).
+      ///
+      /// Call using:
+      /// \code
+      /// myclexulator.set_config_occ(my_configdof.occupation().begin());
+      /// UnitCellCoord bijk(b,i,j,k);           // b,i,j,k of the changing site
+      /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
+      /// myclexulator.set_nlist(my_supercell.nlist().sites(l_index % my_supercell.volume(), nlist_buffer.data()));
+      /// int occ_i=0, occ_f=1;  // Swap from occupant 0 to occupant 1
+      /// double de = myclexulator.calc_delta_energy(b, occ_i, occ_f);
+      /// \endcode
+      ///
+      virtual double calc_delta_energy(int b_index, int occ_i, int occ_f) const = 0;
+
+
+    private:
+
+      /// \brief Clone the EnergyBase
+      virtual EnergyBase *_clone() const = 0;
+
+      /// \brief The neighbor list size
+      size_type m_nlist_size;
+
+    protected:
+
+      /// \brief Pointer to beginning of data structure containing occupation variables
+      const int *m_occ_ptr;
+
+      /// \brief Pointer to neighbor list
+      const nlist_index_type *m_nlist_ptr;
+
+    };
+
+    /// \brief Load the library for 'dirpath/name.cc', from the build cache or compiling it first
+    ///        if necessary, and construct a BaseType using the library factory function 'make_name'
+    ///
+    /// \param what Used in error messages
+    ///
+    /// - Uses build_clexulator with the options of 'lib', so the library is rebuilt whenever the
+    ///   source or options change
+    /// - If there is no source, loads a prebuilt 'dirpath/name.so'
+    ///
+    template<typename BaseType>
+    BaseType *load(std::string name, boost::filesystem::path dirpath, RuntimeLibrary &lib, std::string what) {
+
+      namespace fs = boost::filesystem;
+
+      fs::path lib_base;
+      if(fs::exists(dirpath / (name + ".cc"))) {
+        lib_base = build_clexulator(name, dirpath, lib.compile_options(), lib.so_options());
+      }
+      else if(fs::exists(dirpath / (name + ".so"))) {
+        lib_base = dirpath / name;
+      }
+      else {
+        throw std::runtime_error(
+          std::string("Error in ") + what + " constructor\n" +
+          "  Could not find '" + dirpath.string() + "/" + name + ".so' or '" + dirpath.string() + "/" + name + ".cc'");
+      }
+
+      // Load the library
+      lib.load(lib_base.string());
+
+      // Get the factory function
+      std::function<BaseType* (void)> factory;
+      factory = lib.get_function<BaseType* (void)>("make_" + name);
+
+      return factory();
+    }
   }
 
   class Clexulator {
@@ -205,6 +341,8 @@ namespace CASM {
 
     typedef Clexulator_impl::Base::size_type size_type;
 
+    typedef Clexulator_impl::Base::nlist_index_type nlist_index_type;
+
 
     Clexulator() {}
 
@@ -212,13 +350,14 @@ namespace CASM {
     ///
     /// \param name Class name for the Clexulator, typically 'X_Clexulator', with X
     ///             referring to the system of interest (i.e. 'NiAl_Clexulator')
-    /// \param dirpath Directory containing the source code and compiled object file.
+    /// \param dirpath Directory containing the source code
     /// \param compile_options Compilation options, by default "g++ -O3 -Wall -fPIC"
     /// \param so_options Shared library compilation options, by default "g++ -shared"
     ///
     /// If 'name' is 'X_Clexulator', and 'dirpath' is '/path/to':
-    /// - Looks for '/path/to/X_Clexulator.so' and tries to load it.
-    /// - If not found, looks for 'path/to/X_Clexulator.cc' and tries to compile and load it.
+    /// - Looks for '/path/to/X_Clexulator.cc', and loads the library built from it with these
+    ///   options from the build cache, compiling it first if necessary (see build_clexulator).
+    /// - If there is no source, looks for '/path/to/X_Clexulator.so' and tries to load it.
     /// - If unsuccesful, will throw std::runtime_error.
     ///
     /// The Clexulator has shared ownership of the loaded library,
@@ -230,47 +369,13 @@ namespace CASM {
                std::string compile_options = RuntimeLibrary::default_compile_options(),
                std::string so_options = RuntimeLibrary::default_so_options()) {
 
-      namespace fs = boost::filesystem;
-
       try {
 
         // Construct the RuntimeLibrary that will store the loaded clexulator library
         m_lib = std::make_shared<RuntimeLibrary>(compile_options, so_options);
 
-        // If the shared library doesn't exist
-        if(!fs::exists(dirpath / (name + ".so"))) {
-
-          // But the library source code does
-          if(fs::exists(dirpath / (name + ".cc"))) {
-
-            // Compile it
-            m_lib->compile((dirpath / name).string());
-          }
-          else {
-            throw std::runtime_error(
-              std::string("Error in Clexulator constructor\n") +
-              "  Could not find '" + dirpath.string() + "/" + name + ".so' or '" + dirpath.string() + "/" + name + ".cc'");
-          }
-        }
-
-        // If the shared library exists
-        if(fs::exists(dirpath / (name + ".so"))) {
-
-          // Load the library with the Clexulator
-          m_lib->load((dirpath / name).string());
-
-          // Get the Clexulator factory function
-          std::function<Clexulator_impl::Base* (void)> factory;
-          factory = m_lib->get_function<Clexulator_impl::Base* (void)>("make_" + name);
-
-          // Use the factory to construct the clexulator and store it in m_clex
-          m_clex.reset(factory());
-        }
-        else {
-          throw std::runtime_error(
-            std::string("Error in Clexulator constructor\n") +
-            "  Did not find '" + dirpath.string() + "/" + name + ".cc'");
-        }
+        // Use the factory to construct the clexulator and store it in m_clex
+        m_clex.reset(Clexulator_impl::load<Clexulator_impl::Base>(name, dirpath, *m_lib, "Clexulator"));
       }
       catch(const std::exception &e) {
         std::cout << "Error in Clexulator constructor" << std::endl;
@@ -280,6 +385,17 @@ namespace CASM {
 
     }
 
+    /// \brief Construct a Clexulator from an implementation that does not need a runtime library
+    ///
+    /// \param name Class name for the Clexulator, as for the library constructor
+    /// \param clex The Clexulator implementation, which the Clexulator takes ownership of
+    ///
+    /// For example, a TableClexulator, which evaluates basis functions without compiling them.
+    ///
+    Clexulator(std::string name, std::unique_ptr<Clexulator_impl::Base> clex) :
+      m_name(name),
+      m_clex(std::move(clex)) {}
+
 
     /// \brief Copy constructor
     Clexulator(const Clexulator &B) :
@@ -319,9 +435,9 @@ namespace CASM {
       swap(first.m_lib, second.m_lib);
     }
 
-    /// \brief Is runtime library loaded?
+    /// \brief Is the Clexulator implementation constructed?
     bool initialized()const {
-      return m_lib.get() != nullptr;
+      return m_clex.get() != nullptr;
     }
 
     /// \brief Name
@@ -360,10 +476,11 @@ namespace CASM {
     /// \code
     /// UnitCellCoord bijk(b,i,j,k);           // UnitCellCoord of site in Configuration
     /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+    /// std::vector<SuperNeighborList::value_type> nlist_buffer(my_supercell.nlist().nlist_size());
+    /// myclexulator.set_nlist(my_supercell.nlist().sites(l_index % my_supercell.volume(), nlist_buffer.data()));
     /// \endcode
     ///
-    void set_nlist(const long int *_nlist_ptr) {
+    void set_nlist(const nlist_index_type *_nlist_ptr) {
       return m_clex->set_nlist(_nlist_ptr);
     };
 
@@ -376,7 +493,7 @@ namespace CASM {
     /// myclexulator.set_config_occ(my_configdof.occupation().begin());
     /// UnitCellCoord bijk(0,i,j,k);           // i,j,k of unit cell to get contribution from
     /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+    /// myclexulator.set_nlist(my_supercell.nlist().sites(l_index % my_supercell.volume(), nlist_buffer.data()));
     /// myclexulator.calc_global_corr_contribution(correlation_array.begin());
     /// \endcode
     ///
@@ -394,7 +511,7 @@ namespace CASM {
     /// myclexulator.set_config_occ(my_configdof.occupation().begin());
     /// UnitCellCoord bijk(0,i,j,k);           // i,j,k of unit cell to get contribution from
     /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+    /// myclexulator.set_nlist(my_supercell.nlist().sites(l_index % my_supercell.volume(), nlist_buffer.data()));
     /// std::vector<int> ind_list = {0, 2, 4, 6}; // Get contribution to correlations 0, 2, 4, and 6
     /// myclexulator.calc_restricted_global_corr_contribution(correlation_array.begin(), ind_list.begin(), ind_list.end());
     /// \endcode
@@ -413,7 +530,7 @@ namespace CASM {
     /// myclexulator.set_config_occ(my_configdof.occupation().begin());
     /// UnitCellCoord bijk(b,i,j,k);           // b,i,j,k of site to get point correlations
     /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+    /// myclexulator.set_nlist(my_supercell.nlist().sites(l_index % my_supercell.volume(), nlist_buffer.data()));
     /// myclexulator.calc_point_corr(b, correlation_array.begin());
     /// \endcode
     ///
@@ -432,7 +549,7 @@ namespace CASM {
     /// myclexulator.set_config_occ(my_configdof.occupation().begin());
     /// UnitCellCoord bijk(b,i,j,k);           // b,i,j,k of site to get point correlations
     /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+    /// myclexulator.set_nlist(my_supercell.nlist().sites(l_index % my_supercell.volume(), nlist_buffer.data()));
     /// std::vector<int> ind_list = {0, 2, 4, 6}; // Get contribution to correlations 0, 2, 4, and 6
     /// myclexulator.calc_restricted_point_corr(b, correlation_array.begin(), ind_list.begin(), ind_list.end());
     /// \endcode
@@ -452,7 +569,7 @@ namespace CASM {
     /// myclexulator.set_config_occ(my_configdof.occupation().begin());
     /// UnitCellCoord bijk(b,i,j,k);           // b,i,j,k of site to get delta point correlations
     /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+    /// myclexulator.set_nlist(my_supercell.nlist().sites(l_index % my_supercell.volume(), nlist_buffer.data()));
     /// int occ_i=0, occ_f=1;  // Swap from occupant 0 to occupant 1
     /// myclexulator.calc_delta_point_corr(b, occ_i, occ_f, correlation_array.begin());
     /// \endcode
@@ -473,7 +590,7 @@ namespace CASM {
     /// myclexulator.set_config_occ(my_configdof.occupation().begin());
     /// UnitCellCoord bijk(b,i,j,k);           // b,i,j,k of site to get delta point correlations
     /// int l_index = my_supercell.find(bijk); // Linear index of site in Configuration
-    /// myclexulator.set_nlist(my_supercell.get_nlist(l_index).begin());
+    /// myclexulator.set_nlist(my_supercell.nlist().sites(l_index % my_supercell.volume(), nlist_buffer.data()));
     /// int occ_i=0, occ_f=1;  // Swap from occupant 0 to occupant 1
     /// std::vector<int> ind_list = {0, 2, 4, 6}; // Get contribution to correlations 0, 2, 4, and 6
     /// myclexulator.calc_restricted_delta_point_corr(b, occ_i, occ_f, correlation_array.begin(), ind_list.begin(), ind_list.end());
@@ -497,7 +614,128 @@ namespace CASM {
 
   };
 
+  /// \brief Evaluates a cluster expansion, with ECI folded in, from a generated EnergyBase
+  ///
+  /// Loaded, and shared, like a Clexulator. See PrimClex::global_energy_clexulator and
+  /// print_energy_clexulator.
+  ///
+  class EnergyClexulator {
+
+  public:
+
+    typedef Clexulator_impl::EnergyBase::size_type size_type;
+
+    typedef Clexulator_impl::EnergyBase::nlist_index_type nlist_index_type;
+
+
+    EnergyClexulator() {}
+
+    /// \brief Construct an EnergyClexulator
+    ///
+    /// \param name Class name, typically 'X_Energy_Clexulator'
+    /// \param dirpath Directory containing the source code and compiled object file.
+    /// \param compile_options Compilation options, by default "g++ -O3 -Wall -fPIC"
+    /// \param so_options Shared library compilation options, by default "g++ -shared"
+    ///
+    /// Loads or compiles like Clexulator. If unsuccesful, will throw std::runtime_error.
+    ///
+    EnergyClexulator(std::string name,
+                     boost::filesystem::path dirpath,
+                     std::string compile_options = RuntimeLibrary::default_compile_options(),
+                     std::string so_options = RuntimeLibrary::default_so_options()) :
+      m_name(name) {
+
+      try {
+        m_lib = std::make_shared<RuntimeLibrary>(compile_options, so_options);
+        m_clex.reset(Clexulator_impl::load<Clexulator_impl::EnergyBase>(name, dirpath, *m_lib, "EnergyClexulator"));
+      }
+      catch(const std::exception &e) {
+        std::cout << "Error in EnergyClexulator constructor" << std::endl;
+        std::cout << e.what() << std::endl;
+        throw e;
+      }
+    }
+
+    /// \brief Copy constructor
+    EnergyClexulator(const EnergyClexulator &B) :
+      m_name(B.name()),
+      m_lib(B.m_lib) {
+
+      if(B.m_clex.get() != nullptr) {
+        m_clex.reset(B.m_clex->clone().release());
+      }
+    }
+
+    /// \brief Move constructor
+    EnergyClexulator(EnergyClexulator &&B) {
+      swap(*this, B);
+    }
+
+    ~EnergyClexulator() {
+      // ensure EnergyBase is deleted before library
+      delete m_clex.release();
+    }
+
+    /// \brief Assignment operator
+    EnergyClexulator &operator=(EnergyClexulator B) {
+      swap(*this, B);
+      return *this;
+    }
+
+    /// \brief Swap
+    friend void swap(EnergyClexulator &first, EnergyClexulator &second) {
+
+      using std::swap;
+
+      swap(first.m_name, second.m_name);
+      swap(first.m_clex, second.m_clex);
+      swap(first.m_lib, second.m_lib);
+    }
+
+    /// \brief Is runtime library loaded?
+    bool initialized() const {
+      return m_lib.get() != nullptr;
+    }
+
+    /// \brief Name
+    std::string name() const {
+      return m_name;
+    }
+
+    /// \brief Neighbor list size
+    size_type nlist_size() const {
+      return m_clex->nlist_size();
+    }
+
+    /// \brief Set pointer to data structure containing occupation variables
+    void set_config_occ(const int *_occ_ptr) {
+      return m_clex->set_config_occ(_occ_ptr);
+    }
+
+    /// \brief Set pointer to neighbor list
+    void set_nlist(const nlist_index_type *_nlist_ptr) {
+      return m_clex->set_nlist(_nlist_ptr);
+    }
+
+    /// \brief Calculate contribution to the cluster expansion from one unit cell
+    double calc_energy() const {
+      return m_clex->calc_energy();
+    }
+
+    /// \brief Calculate the change in the cluster expansion due to changing an occupant
+    double calc_delta_energy(int b_index, int occ_i, int occ_f) const {
+      return m_clex->calc_delta_energy(b_index, occ_i, occ_f);
+    }
+
+
+  private:
+
+    std::string m_name;
+    std::unique_ptr<Clexulator_impl::EnergyBase> m_clex;
+    std::shared_ptr<RuntimeLibrary> m_lib;
+
+  };
+
 }
 
 #endif
-
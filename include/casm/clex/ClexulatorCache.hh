@@ -0,0 +1,78 @@
+#ifndef CLEXULATORCACHE_HH
+#define CLEXULATORCACHE_HH
+
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+namespace CASM {
+
+  namespace Clexulator_impl {
+
+    /// \brief Line prefix that starts a new translation unit in generated Clexulator source
+    ///
+    /// Generated source is split at lines starting with this prefix, followed by a label. The text
+    /// before the first such line is included at the beginning of every translation unit, so it
+    /// should contain only declarations, such as the Clexulator class definition.
+    inline std::string translation_unit_prefix() {
+      return "// -- translation unit: ";
+    }
+
+    /// \brief Version of the Clexulator_impl::Base and EnergyBase interface
+    ///
+    /// Included in the build cache key, so that libraries built against an earlier Clexulator.hh
+    /// are not reused. Increment when the data members or virtual functions of Base or EnergyBase
+    /// change.
+    ///
+    /// - 2: Neighbor list indices are Base::nlist_index_type, 32-bit
+    inline int abi_version() {
+      return 2;
+    }
+
+    /// \brief Split Clexulator source into translation units
+    ///
+    /// \param source Source code text
+    /// \param source_path Used in '#line' directives, so that compiler messages refer to the
+    ///        lines of the original source
+    ///
+    /// - Source without any translation_unit_prefix lines is a single translation unit
+    std::vector<std::string> split_translation_units(const std::string &source, const boost::filesystem::path &source_path);
+
+    /// \brief Directory of the Clexulator build cache
+    ///
+    /// - $CASM_CLEXULATOR_CACHE, if set, which may be shared by several users
+    /// - else $XDG_CACHE_HOME/casm/clexulator, if XDG_CACHE_HOME is set
+    /// - else $HOME/.cache/casm/clexulator, if HOME is set
+    /// - else empty
+    boost::filesystem::path clexulator_cache_dir();
+
+    /// \brief Find or build the shared library for Clexulator source 'dirpath/name.cc'
+    ///
+    /// \param compile_options, so_options As for RuntimeLibrary
+    /// \param num_threads Number of translation units to compile at once, see resolve_num_threads
+    ///
+    /// \returns Path of the shared library, without the ".so" extension, for RuntimeLibrary::load
+    ///
+    /// Libraries are stored in the clexulator_cache_dir(), or in 'dirpath' if that is empty, in a
+    /// directory named by a hash of the source text, 'compile_options', 'so_options', the
+    /// abi_version(), and the contents of the '#include "casm/..."' headers, found recursively in
+    /// the '-I' directories of 'compile_options'. So a library is only reused if it was built from
+    /// the same source with the same options against the same CASM headers, and projects with
+    /// identical basis sets share libraries.
+    ///
+    /// To build, the source is split into translation units with split_translation_units, which
+    /// are compiled concurrently and then linked. Builds are done in a temporary directory that
+    /// is renamed into place once complete, so concurrent builds of the same library by several
+    /// processes are safe. Throws std::runtime_error, including the compiler output, if a
+    /// command fails.
+    boost::filesystem::path build_clexulator(std::string name,
+                                             const boost::filesystem::path &dirpath,
+                                             std::string compile_options,
+                                             std::string so_options,
+                                             long num_threads = 0);
+
+  }
+
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef ConfigDoF_HH
 #define ConfigDoF_HH
 
+#include <cstdint>
 #include "casm/container/Array.hh"
 //#include "casm/symmetry/PermuteIterator.hh"
 
@@ -9,8 +10,13 @@ namespace CASM {
 
   class PermuteIterator;
   typedef Array<double> Correlation;
+
+  /// \brief Contiguous matrix of correlations, with one row per configuration
+  typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> CorrMatrix;
+
   class Supercell;
   class Clexulator;
+  class EnergyClexulator;
 
 
   /**
@@ -52,6 +58,18 @@ namespace CASM {
 
     bool operator==(const ConfigDoF &RHS) const;
 
+    /// \brief Hash for fast lookup of ConfigDoF that compare equal
+    ///
+    /// - Combines occupation() with a coarse-grained bucket of displacement() and deformation()
+    /// - ConfigDoF that compare equal are in the same or adjacent buckets, so a lookup should check
+    ///   hash(-1), hash(0), and hash(1)
+    std::size_t hash(long bucket_shift = 0) const;
+
+    /// \brief Exact, platform independent hash of all DoF values, for identifying ConfigDoF in files
+    ///
+    /// - Unlike hash(), ConfigDoF that compare equal within tolerance may have different fingerprints
+    std::uint64_t fingerprint() const;
+
     int &occ(Index i) {
       return m_occupation[i];
     };
@@ -196,6 +214,18 @@ namespace CASM {
   /// \brief Returns correlations using 'clexulator'. Supercell needs a correctly populated neighbor list.
   Correlation correlations(const ConfigDoF &configdof, const Supercell &scel, Clexulator &clexulator);
 
+  /// \brief Returns the cluster expansion per unit cell, eci*correlations, using an 'energy_clexulator'
+  ///        generated with the ECI. Supercell needs a correctly populated neighbor list.
+  double clex_energy(const ConfigDoF &configdof, const Supercell &scel, EnergyClexulator &energy_clexulator);
+
+  /// \brief Fills rows [row_begin, row_begin + configdof_list.size()) of 'corr_mat' with correlations
+  ///        for a batch of ConfigDoF that all belong to 'scel'
+  void correlations(const std::vector<const ConfigDoF *> &configdof_list,
+                    const Supercell &scel,
+                    Clexulator &clexulator,
+                    CorrMatrix &corr_mat,
+                    Index row_begin = 0);
+
 }
 
 #endif
@@ -1,12 +1,23 @@
 #ifndef CONFIGENUMALLOCCUPATIONS_HH
 #define CONFIGENUMALLOCCUPATIONS_HH
 
+#include <vector>
+
 #include "casm/clex/ConfigEnum.hh"
 #include "casm/container/Counter.hh"
 #include "casm/symmetry/PermuteIterator.hh"
 
 namespace CASM {
 
+  /// \brief Enumerate all primitive, canonical occupations of a Supercell
+  ///
+  /// Two modes are available:
+  /// - Default: step a Counter through every occupation and check each one with
+  ///   is_primitive and is_canonical
+  /// - Orderly: assign sites in order, starting at site 0, and skip every occupation that shares a
+  ///   prefix that no canonical occupation can have. Permutations are cached as index arrays. This is
+  ///   much faster in large supercells. It finds the same configurations, but in a different order.
+  ///
   template <typename ConfigType>
   class ConfigEnumAllOccupations : public ConfigEnum<ConfigType> {
   public:
@@ -35,8 +46,38 @@ namespace CASM {
     const PermuteIterator &_perm_end() {
       return m_perm_end;
     }
+
+    // **** Orderly enumeration ****
+    bool m_orderly;
+
+    /// m_perm_table[op][i] is PermuteIterator::permute_ind(i) for each non-identity op in [perm_begin, perm_end)
+    std::vector<std::vector<Index> > m_perm_table;
+
+    /// Range of allowed occupant values for each site
+    std::vector<int> m_occ_lower, m_occ_upper;
+
+    /// Occupation being constructed; only sites [0, m_depth) are assigned
+    Array<int> m_occ;
+    Index m_depth;
+
+    /// If true, the next step descends from the current prefix, else it moves to the next sibling
+    bool m_descend;
+
+    /// Set to false when orderly enumeration is complete
+    bool m_orderly_valid;
+
+    void _init_orderly();
+
+    bool _orderly_next();
+
+    bool _prefix_can_be_canonical(Index prefix_size) const;
+
   public:
-    ConfigEnumAllOccupations(const value_type &_initial, const value_type &_final, PermuteIterator perm_begin, PermuteIterator perm_end);
+    ConfigEnumAllOccupations(const value_type &_initial,
+                             const value_type &_final,
+                             PermuteIterator perm_begin,
+                             PermuteIterator perm_end,
+                             bool orderly = false);
 
     // **** Mutators ****
     // increment m_current and return a reference to it
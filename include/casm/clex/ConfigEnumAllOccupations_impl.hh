@@ -3,10 +3,12 @@ namespace CASM {
   template<typename ConfigType>
   ConfigEnumAllOccupations<ConfigType>::ConfigEnumAllOccupations(const ConfigEnumAllOccupations<ConfigType>::value_type &_initial,
                                                                  const ConfigEnumAllOccupations<ConfigType>::value_type &_final,
-                                                                 PermuteIterator _perm_begin, PermuteIterator _perm_end) :
+                                                                 PermuteIterator _perm_begin, PermuteIterator _perm_end,
+                                                                 bool orderly) :
     ConfigEnum<ConfigType>(_initial, _final, -1),
     m_counter(_initial.occupation(), _final.occupation(), Array<int>(_initial.size(), 1)),
-    m_perm_begin(_perm_begin), m_perm_end(_perm_end) {
+    m_perm_begin(_perm_begin), m_perm_end(_perm_end),
+    m_orderly(orderly) {
     //std::cout << "INITIALIZING OCCUPATION ENUMERATOR\n";
     //std::cout << "starting at: "<< current().occupation() << "\n";
     //std::cout << "running to: " << final().occupation() << "\n";
@@ -16,6 +18,12 @@ namespace CASM {
     // TODO: Add information about 'seed' configuration (_perm_begin)?
     _source() = "occupation_enumeration";
 
+    if(m_orderly) {
+      _init_orderly();
+      _step() = _orderly_next() ? 0 : -1;
+      return;
+    }
+
     // Make sure that current() has primitive canonical config
     if(!(current().is_primitive(_perm_begin) && current().is_canonical(_perm_begin, _perm_end))) {
       //std::cout << "INITIAL ENUMERATION STATE IS NOT CANONICAL!\n";
@@ -34,6 +42,14 @@ namespace CASM {
   // increment m_current and return a reference to it
   template<typename ConfigType>
   const typename ConfigEnumAllOccupations<ConfigType>::value_type &ConfigEnumAllOccupations<ConfigType>::increment() {
+    if(m_orderly) {
+      if(_orderly_next())
+        _step()++;
+      else
+        _step() = -1;
+      return current();
+    }
+
     bool is_valid_config(false);
     //std::cout << "Incrementing...\n";
     while(!is_valid_config && ++m_counter) {
@@ -65,5 +81,99 @@ namespace CASM {
     exit(1);
     return current();
   };
-}
 
+  //*******************************************************************************************
+  // **** Orderly enumeration ****
+
+  template<typename ConfigType>
+  void ConfigEnumAllOccupations<ConfigType>::_init_orderly() {
+    Index N = initial().occupation().size();
+
+    m_occ_lower.resize(N);
+    m_occ_upper.resize(N);
+    for(Index i = 0; i < N; i++) {
+      m_occ_lower[i] = std::min(initial().occupation()[i], final().occupation()[i]);
+      m_occ_upper[i] = std::max(initial().occupation()[i], final().occupation()[i]);
+    }
+
+    // cache permutations as index arrays, skipping the identity
+    m_perm_table.clear();
+    for(PermuteIterator it = m_perm_begin; it != m_perm_end; ++it) {
+      std::vector<Index> perm(N);
+      bool is_identity = true;
+      for(Index i = 0; i < N; i++) {
+        perm[i] = it.permute_ind(i);
+        if(perm[i] != i)
+          is_identity = false;
+      }
+      if(!is_identity)
+        m_perm_table.push_back(perm);
+    }
+
+    m_occ = Array<int>(N, 0);
+    m_depth = 0;
+    m_descend = true;
+    m_orderly_valid = true;
+  }
+
+  //*******************************************************************************************
+  /// Depth-first search over site occupations, with site 0 as the most significant digit.
+  /// Sets current() to the next primitive, canonical occupation and returns true, or returns false
+  /// when the search is complete.
+  template<typename ConfigType>
+  bool ConfigEnumAllOccupations<ConfigType>::_orderly_next() {
+    Index N = m_occ.size();
+
+    while(m_orderly_valid) {
+      if(m_descend && m_depth < N) {
+        // assign the next site
+        m_occ[m_depth] = m_occ_lower[m_depth];
+        m_depth++;
+      }
+      else {
+        // move to the next sibling, backtracking past exhausted sites
+        while(m_depth > 0 && m_occ[m_depth - 1] == m_occ_upper[m_depth - 1]) {
+          m_depth--;
+        }
+        if(m_depth == 0) {
+          m_orderly_valid = false;
+          break;
+        }
+        m_occ[m_depth - 1]++;
+      }
+
+      m_descend = _prefix_can_be_canonical(m_depth);
+
+      if(m_descend && m_depth == N) {
+        m_descend = false;
+        _current().set_occupation(m_occ);
+
+        // the occupation is canonical; also check translations and any other DoF
+        if(current().is_primitive(_perm_begin()) && current().is_canonical(_perm_begin(), _perm_end()))
+          return true;
+      }
+    }
+    return false;
+  }
+
+  //*******************************************************************************************
+  /// Returns false if every occupation beginning with m_occ[0, prefix_size) is non-canonical.
+  ///
+  /// For each permutation, sites are compared in order while both the site and its image are in the
+  /// prefix. If the first difference makes the permuted occupation larger, no completion of the
+  /// prefix can be canonical.
+  template<typename ConfigType>
+  bool ConfigEnumAllOccupations<ConfigType>::_prefix_can_be_canonical(Index prefix_size) const {
+    for(const auto &perm : m_perm_table) {
+      for(Index i = 0; i < prefix_size; i++) {
+        Index j = perm[i];
+        if(j >= prefix_size || m_occ[j] < m_occ[i])
+          break;
+        if(m_occ[j] > m_occ[i])
+          return false;
+      }
+    }
+    return true;
+  }
+
+}
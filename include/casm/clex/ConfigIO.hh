@@ -1,10 +1,13 @@
 #ifndef CONFIGIO_HH
 #define CONFIGIO_HH
 
+#include <unordered_map>
 #include "casm/casm_io/DataFormatter.hh"
 #include "casm/casm_io/DataFormatterTools.hh"
+#include "casm/casm_io/CorrCache.hh"
 #include "casm/clex/Clexulator.hh"
 #include "casm/clex/ECIContainer.hh"
+#include "casm/clex/ConfigDoF.hh"
 
 namespace CASM {
 
@@ -105,6 +108,43 @@ namespace CASM {
       mutable std::vector<std::string> m_mol_names;
     };
 
+    /// \brief Correlations for a batch of Configurations, evaluated together during DataFormatter::prefetch
+    ///
+    /// - If a CorrCache is set, correlations already in the cache are used in place, and only
+    ///   Configurations that are new or whose DoF changed are evaluated and appended to the cache
+    class CorrBatch {
+    public:
+
+      /// \brief Number of threads used to evaluate correlations (0 uses all available cores)
+      void set_num_threads(Index _num_threads) {
+        m_num_threads = _num_threads;
+      }
+
+      /// \brief Cache of correlations calculated with the Clexulator passed to 'prefetch', may be nullptr
+      void set_cache(CorrCache *_cache) {
+        m_cache = _cache;
+      }
+
+      /// \brief Evaluate correlations for all of '_configs'
+      void prefetch(const std::vector<const Configuration *> &_configs, Clexulator &clexulator);
+
+      /// \brief Find correlations for those of '_configs' that are already in the cache, without evaluating any
+      void prefetch_cached(const std::vector<const Configuration *> &_configs);
+
+      /// \brief Pointer to the correlations of '_config', or nullptr if it is not in the current batch
+      const double *find(const Configuration &_config) const {
+        auto it = m_row.find(&_config);
+        return it == m_row.end() ? nullptr : it->second;
+      }
+
+    private:
+
+      Index m_num_threads = 1;
+      CorrCache *m_cache = nullptr;
+      CorrMatrix m_corr;
+      std::unordered_map<const Configuration *, const double *> m_row;
+    };
+
     /*
      */
 
@@ -143,9 +183,16 @@ namespace CASM {
         return true;
       }
 
+      void prefetch(const std::vector<const Configuration *> &_configs) const override;
+
     private:
 
+      /// \brief Pointer to the correlations of '_config', calculating them if they were not prefetched
+      const double *_corr(const Configuration &_config) const;
+
       mutable Clexulator m_clexulator;
+      mutable CorrBatch m_batch;
+      mutable Correlation m_tcorr;
 
     };
 
@@ -171,10 +218,25 @@ namespace CASM {
       jsonParser &to_json(const Configuration &_config, jsonParser &json)const override;
 
       bool parse_args(const std::string &args);
+
+      void prefetch(const std::vector<const Configuration *> &_configs) const override;
+
     private:
+
+      /// \brief Evaluate the cluster expansion for '_config', using prefetched correlations or
+      ///        energies if possible, and otherwise the energy clexulator if available
+      double _clex(const Configuration &_config) const;
+
       mutable std::string m_clex_name;
       mutable Clexulator m_clexulator;
+      mutable EnergyClexulator m_energy_clexulator;
       mutable ECIContainer m_eci;
+      mutable CorrBatch m_batch;
+      mutable Index m_num_threads = 1;
+
+      /// \brief Energies of the current batch evaluated with the energy clexulator, for those
+      ///        Configurations without cached correlations
+      mutable std::unordered_map<const Configuration *, double> m_energy;
 
     };
 
@@ -1,10 +1,12 @@
 #ifndef CONFIGIOHULL_HH
 #define CONFIGIOHULL_HH
 
+#include <unordered_map>
 #include "casm/casm_io/DataFormatter.hh"
 #include "casm/clex/Clexulator.hh"
 #include "casm/clex/ECIContainer.hh"
 #include "casm/hull/Hull.hh"
+#include "casm/hull/IncrementalHull.hh"
 namespace CASM {
 
   class Configuration;
@@ -19,6 +21,9 @@ namespace CASM {
         BaseDatumFormatter<Configuration>(_name, _desc), m_dependent_prop(_dependent_prop) {}
 
       /// Initialize the convex hull and determine on-hull configurations
+      ///
+      /// The hull is stored in the project's .casm/cache directory, keyed by a hash of the selection,
+      /// properties, and projection, so later queries only update it for configurations whose data changed
       void init(const Configuration &_tmplt) const override;
 
       std::string short_header(const Configuration &_config) const override;
@@ -32,7 +37,7 @@ namespace CASM {
       bool parse_args(const std::string &args);
     protected:
       const BP::Geo &_hull() const {
-        return m_hull;
+        return m_hull.geo();
       }
       const DataFormatter<Configuration> &_format() const {
         return m_format;
@@ -49,9 +54,12 @@ namespace CASM {
       //const std::string &_dependent_prop const{ return m_dependent_prop;}
       //void _parse_args(const std::string &args, const std::string &_dep_prop);
     private:
+      /// Hash of what the hull is constructed from, used to key the stored hull
+      std::uint64_t _hull_key() const;
+
       // specifies the dependent property to use (e.g., formation_energy or clex(formation_energy) )
       const std::string m_dependent_prop;
-      mutable BP::Geo m_hull;
+      mutable IncrementalHull m_hull;
 
       // Matrix that describes subspace spanned by data
       mutable Eigen::MatrixXd m_projection;
@@ -109,6 +117,9 @@ namespace CASM {
 
       bool validate(const Configuration &_config) const override;
 
+      /// Evaluate the hull distance of all of _configs together, with one matrix product per block of configurations
+      void prefetch(const std::vector<const Configuration *> &_configs) const override;
+
       void inject(const Configuration &_config, DataStream &_stream, Index) const override;
 
       void print(const Configuration &_config, std::ostream &_stream, Index) const override;
@@ -120,6 +131,12 @@ namespace CASM {
       // const BP::Geo& _hull() const{ return m_hull;}
       // const std::map<std::string, bool> &_on_hull() const{ return m_on_hull;}
       // const std::vector<std::string> &_independent_props const{ return m_independent_props;}
+    private:
+      /// Hull distance of _config, using the prefetched value if possible, or NAN if data is missing
+      double _dist(const Configuration &_config) const;
+
+      // hull distances of the configurations in the current batch
+      mutable std::unordered_map<const Configuration *, double> m_dist;
     };
   }
 }
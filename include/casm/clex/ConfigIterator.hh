@@ -143,7 +143,9 @@ namespace CASM {
     //std::cout << "\n -increment-\n";
     _next_config();
     // don't increment past the end
-    while(m_scel_index <  m_primclex->get_supercell_list().size() && (m_selected && !(m_primclex->get_supercell(m_scel_index).get_config(m_config_index).selected()))) {
+    // const access, so that skipped configurations are not marked modified
+    const PrimClexType &primclex = *m_primclex;
+    while(m_scel_index <  primclex.get_supercell_list().size() && (m_selected && !(primclex.get_supercell(m_scel_index).get_config(m_config_index).selected()))) {
       _next_config();
     }
     //std::cout << "m_scel_index = " << m_scel_index << "; m_config_index = " << m_config_index << ";";
@@ -1,18 +1,62 @@
 #ifndef CONFIGMAPPING_HH
 #define CONFIGMAPPING_HH
 #include "casm/CASM_global_definitions.hh"
+#include "casm/casm_io/jsonParser.hh"
+#include "casm/clex/ConfigDoF.hh"
+#include "casm/crystallography/Lattice.hh"
+#include "casm/crystallography/BasicStructure.hh"
+#include "casm/crystallography/Site.hh"
+#include "casm/misc/CASM_math.hh"
 namespace CASM {
   class Supercell;
-  class Lattice;
+  class Configuration;
   class SymGroup;
   class PrimClex;
 
+  /// \brief One mapping of a structure onto a configuration of the PRIM, and its cost
+  struct ConfigDoFMapping {
+
+    /// \brief Mapped configuration, on the supercell with lattice 'mapped_lat'
+    ConfigDoF configdof;
+    Lattice mapped_lat;
+
+    /// \brief Integer transformation matrix N, such that the structure's lattice is
+    ///        F*mapped_lat*N, with F the deformation
+    Eigen::Matrix3d trans_mat;
+
+    /// \brief Lattice and basis costs, multiplied by their weights, and their sum
+    double strain_cost;
+    double basis_cost;
+    double cost;
+  };
+
+  /// \brief Result of mapping one structure onto the PRIM, before it is added to a PrimClex
+  struct StructureMapping {
+
+    /// \brief True if a mapping was found, else 'error' says why not
+    bool success = false;
+    std::string error;
+
+    /// \brief Mapped configuration, on the supercell with lattice 'mapped_lat'
+    ConfigDoF configdof;
+    Lattice mapped_lat;
+
+    /// \brief "basis_deformation", "lattice_deformation", "volume_relaxation", and "relaxation_strain"
+    jsonParser relaxation_properties;
+
+    /// \brief The next lowest cost mappings, in order of increasing cost, if more than one was
+    ///        requested and the structure was mapped as a deformed structure
+    std::vector<ConfigDoFMapping> alternatives;
+
+    /// \brief Time spent mapping, in seconds
+    double seconds = 0.0;
+  };
+
   Lattice find_nearest_super_lattice(const Lattice &prim_lat,
                                      const Lattice &relaxed_lat,
                                      const SymGroup &sym_group,
-                                     Eigen::MatrixXd &trans_mat,
                                      Eigen::MatrixXd &deformation,
-                                     double &best_cost,
+                                     Eigen::MatrixXd &trans_mat,
                                      Index min_vol,
                                      Index max_vol,
                                      double _tol);
@@ -39,6 +83,63 @@ namespace CASM {
                                    double lattice_weight = 0.5,
                                    double vol_tol = 0.25);
 
+  /// \brief Map the occupation of '_struc' onto the PRIM, without adding anything to 'pclex'
+  ///
+  /// - Failures, including exceptions, are reported by StructureMapping::success and
+  ///   StructureMapping::error rather than thrown
+  /// - Only reads 'pclex', so structures may be mapped concurrently, see map_structures_occupation
+  /// - If 'k_best' > 1, up to 'k_best' - 1 alternatives to the best mapping are found too, see
+  ///   deformed_struc_to_configdofs
+  StructureMapping map_structure_occupation(const BasicStructure<Site> &_struc,
+                                            PrimClex &pclex,
+                                            bool robust_flag,
+                                            bool rotate_flag,
+                                            double _tol,
+                                            double lattice_weight = 0.5,
+                                            double vol_tol = 0.25,
+                                            Index k_best = 1);
+
+  /// \brief Map the occupation of each of 'strucs' onto the PRIM, using 'num_threads' threads
+  ///
+  /// - result[i] is the mapping of strucs[i], as by map_structure_occupation
+  /// - 'num_threads' == 0 uses all available cores
+  /// - Add the results to 'pclex' with insert_structure_occupation, which is not thread safe
+  std::vector<StructureMapping> map_structures_occupation(const std::vector<BasicStructure<Site> > &strucs,
+                                                          PrimClex &pclex,
+                                                          bool robust_flag,
+                                                          bool rotate_flag,
+                                                          double _tol,
+                                                          double lattice_weight = 0.5,
+                                                          double vol_tol = 0.25,
+                                                          Index num_threads = 1,
+                                                          Index k_best = 1);
+
+  /// \brief Add the configuration found by map_structure_occupation to 'pclex'
+  ///
+  /// \returns true if the configuration is new
+  ///
+  /// - 'imported_name' is set to the name of the new or equivalent existing configuration
+  /// - If 'hint_ptr' is not null and the mapped occupation is equivalent to it, 'pclex' is not
+  ///   changed and 'imported_name' is the name of '*hint_ptr'
+  /// \throws std::runtime_error if 'mapping.success' is false
+  bool insert_structure_occupation(const StructureMapping &mapping,
+                                   const Configuration *hint_ptr,
+                                   PrimClex &pclex,
+                                   std::string &imported_name,
+                                   bool strict_flag,
+                                   double _tol);
+
+  /// \brief Print the mapping of '_struc' found by map_structure_occupation and its alternatives
+  ///
+  /// - One line per mapping, in order of increasing cost, with its total cost (using 'lattice_weight'),
+  ///   lattice and basis deformation, supercell, and occupation
+  void print_mappings(const BasicStructure<Site> &_struc,
+                      const StructureMapping &mapping,
+                      PrimClex &pclex,
+                      double lattice_weight,
+                      std::ostream &sout,
+                      std::string indent = "");
+
   bool import_structure_occupation(const BasicStructure<Site> &_struc,
                                    const Configuration *hint_ptr,
                                    PrimClex &pclex,
@@ -83,6 +184,20 @@ namespace CASM {
                           double lattice_weight = 0.5,
                           double vol_tol = 0.25);
 
+  /// \brief As above, and if the structure is mapped as a deformed structure, also find the next
+  ///        'k_best' - 1 lowest cost mappings, in order of increasing cost
+  bool struc_to_configdof(const BasicStructure<Site> &_struc,
+                          PrimClex &pclex,
+                          ConfigDoF &mapped_configdof,
+                          Lattice &mapped_lat,
+                          std::vector<ConfigDoFMapping> &alternatives,
+                          bool robust_flag,
+                          bool rotate_flag,
+                          double _tol,
+                          double lattice_weight,
+                          double vol_tol,
+                          Index k_best);
+
 
   bool ideal_struc_to_configdof(BasicStructure<Site> struc,
                                 PrimClex &pclex,
@@ -100,7 +215,20 @@ namespace CASM {
                                    double lattice_weight = 0.5,
                                    double vol_tol = 0.25);
 
-
+  /// \brief Find the 'k_best' lowest cost mappings of a deformed structure onto supercells of the PRIM
+  ///
+  /// - Returns mappings in order of increasing cost, or an empty vector if no mapping is possible
+  /// - deformed_struc_to_configdof uses the lowest cost mapping, found with 'k_best' == 1
+  /// - Lattice mappings are searched in order of increasing strain cost, and the basis assignment
+  ///   is only solved while the strain cost is below the k-th best total cost found, so larger
+  ///   'k_best' means more basis assignments
+  std::vector<ConfigDoFMapping> deformed_struc_to_configdofs(const BasicStructure<Site> &_struc,
+                                                             PrimClex &pclex,
+                                                             bool rotate_flag,
+                                                             double _tol,
+                                                             double lattice_weight = 0.5,
+                                                             double vol_tol = 0.25,
+                                                             Index k_best = 1);
 
   // Assignment Problem Routines
   // Find cost matrix for displacements between POS and relaxed structures.
@@ -110,6 +238,16 @@ namespace CASM {
                         const Coordinate &trans,
                         Eigen::MatrixXd &cost_matrix);
 
+  // Sparse version of calc_cost_matrix, with only the pairs of sites and relaxed atoms within 'max_dist' of each other,
+  // for sparse_assignment. 'complete' is set to true if no allowed pairs were left out.
+  // Returns false if lattices are incompatible
+  bool calc_sparse_cost_matrix(const Supercell &scel,
+                               const BasicStructure<Site> &rstruc,
+                               const Coordinate &trans,
+                               double max_dist,
+                               SparseCostMatrix &cost_matrix,
+                               bool &complete);
+
   //\JSB
 
 
@@ -325,6 +325,12 @@ namespace CASM {
     return _stream;
   }
 
+  /// \brief Fills 'corr_mat' with correlations using 'clexulator', one row per selected Configuration, in selection order
+  template<bool IsConst>
+  CorrMatrix &correlations(const ConfigSelection<IsConst> &selection, Clexulator &clexulator, CorrMatrix &corr_mat, Index num_threads = 1) {
+    return correlations(selection.selected_config_cbegin(), selection.selected_config_cend(), clexulator, corr_mat, num_threads);
+  }
+
   bool get_selection(const Array<std::string> &criteria, const Configuration &config, bool is_selected);
 
   namespace ConfigSelection_impl {
@@ -394,9 +394,40 @@ namespace CASM {
 
   };
 
+  /// \brief Returns the directory of the reference states of configuration 'configname', of the
+  ///   form "SCELNAME/CONFIGID", or an empty path if none are set. Does not read the configuration.
+  fs::path reference_state_dir(const PrimClex &primclex, const std::string &configname);
+
   /// \brief Returns correlations using 'clexulator'.
   Correlation correlations(const Configuration &config, Clexulator &clexulator);
 
+  /// \brief Fills 'corr_mat' with correlations using 'clexulator', one row per Configuration in 'config_list'
+  CorrMatrix &correlations(const std::vector<const Configuration *> &config_list,
+                           Clexulator &clexulator,
+                           CorrMatrix &corr_mat,
+                           Index num_threads = 1);
+
+  /// \brief Fills 'corr_mat' with correlations using 'clexulator', one row per Configuration in [begin, end)
+  template<typename ConfigIterType>
+  CorrMatrix &correlations(ConfigIterType begin,
+                           ConfigIterType end,
+                           Clexulator &clexulator,
+                           CorrMatrix &corr_mat,
+                           Index num_threads = 1) {
+    std::vector<const Configuration *> config_list;
+    for(; begin != end; ++begin) {
+      config_list.push_back(&(*begin));
+    }
+    return correlations(config_list, clexulator, corr_mat, num_threads);
+  }
+
+  /// \brief Fills 'energy' with the cluster expansion per unit cell using 'energy_clexulator', one
+  ///        value per Configuration in 'config_list'
+  std::vector<double> &clex_energy(const std::vector<const Configuration *> &config_list,
+                                   EnergyClexulator &energy_clexulator,
+                                   std::vector<double> &energy,
+                                   Index num_threads = 1);
+
 }
 
 #endif
@@ -38,6 +38,9 @@ namespace CASM {
 
   double operator*(const ECIContainer &_eci, const Correlation &_corr);
 
+  /// \brief Evaluate using correlations stored contiguously starting at '_corr_begin'
+  double operator*(const ECIContainer &_eci, double const *_corr_begin);
+
   namespace ECIContainer_impl {
     void populate_eci(const fs::path &filepath, ECIContainer::ScalarECI &mc_eci, Array<ECIContainer::size_type> &mc_eci_index);
   }
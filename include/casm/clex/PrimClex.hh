@@ -3,6 +3,8 @@
 
 #define BOOST_NO_SCOPED_ENUMS
 #define BOOST_NO_CXX11_SCOPED_ENUMS
+#include <memory>
+#include <unordered_map>
 #include <boost/filesystem.hpp>
 
 #include "casm/BP_C++/BP_Parse.hh"
@@ -12,6 +14,7 @@
 #include "casm/clex/ParamComposition.hh"
 #include "casm/clex/Supercell.hh"
 #include "casm/clex/Clexulator.hh"
+#include "casm/casm_io/CorrCache.hh"
 
 #include "casm/app/DirectoryStructure.hh"
 #include "casm/app/ProjectSettings.hh"
@@ -59,7 +62,15 @@ namespace CASM {
 
 
     /// Contains all the supercells that were involved in the enumeration.
-    boost::container::stable_vector< Supercell > supercell_list;
+    ///   Supercells read from SCEL are constructed on first access, see _construct_supercells()
+    mutable boost::container::stable_vector< Supercell > supercell_list;
+
+    /// Transformation matrix of each supercell. Supercells with index in
+    ///   [supercell_list.size(), m_scel_transf_mat.size()) have not been constructed yet
+    std::vector<Matrix3<int> > m_scel_transf_mat;
+
+    /// Index of each supercell by name, including supercells not constructed yet
+    std::unordered_map<std::string, Index> m_scel_index;
 
 
     /// CompositionConverter specifies parameteric composition axes and converts between
@@ -78,6 +89,23 @@ namespace CASM {
 
     Array<UnitCellCoord> prim_nlist;
 
+    /// Number of threads used for parallelized calculations, not saved with project settings
+    Index m_num_threads = 1;
+
+    /// Read on first access, see config_list_summary()
+    mutable jsonParser m_config_list_summary;
+    mutable bool m_config_list_summary_read = false;
+
+    /// Construct all supercells not constructed yet
+    void _construct_supercells() const;
+
+    /// Construct supercells not constructed yet, so that supercell_list.size() >= 'end'
+    void _construct_supercells(Index end) const;
+
+    /// Copy the data of each supercell in the single config_list.json to its own config_list
+    ///   file, unchanged, including data Configuration does not read
+    void _split_config_list() const;
+
   public:
 
     typedef ConfigIterator<Configuration, PrimClex> config_iterator;
@@ -120,6 +148,16 @@ namespace CASM {
       return settings().tol();
     }
 
+    /// Number of threads used for parallelized calculations, such as correlations (0 uses all available cores)
+    Index num_threads() const {
+      return m_num_threads;
+    }
+
+    /// Set number of threads used for parallelized calculations (0 uses all available cores)
+    void set_num_threads(Index _num_threads) {
+      m_num_threads = _num_threads;
+    }
+
     /// Return casm project directory path
     fs::path get_path() const;
 
@@ -259,12 +297,22 @@ namespace CASM {
     // **** IO ****
 
     ///Call Configuration::write on every configuration to update files
+    ///  - only supercells with Supercell::config_list_dirty() are written
     ///  - call update to also read all files
     void write_config_list();
 
+    /// Number of configurations in each supercell, and how many are selected and calculated, as
+    ///   of the last write_config_list, see Supercell::count_configs
+    const jsonParser &config_list_summary() const;
+
+    /// Update the config list summary with the Supercell whose config list has been read,
+    ///   called by write_config_list
+    void write_config_list_summary() const;
+
     /// \brief Set the primitive neighbor list explicitly, useful when it has been saved
     void set_prim_nlist(const Array<UnitCellCoord> &_prim_nlist) {
       prim_nlist = _prim_nlist;
+      generate_supercell_nlists();
     }
 
 
@@ -303,16 +351,25 @@ namespace CASM {
     void populate_cluster_basis_function_tables();
 
     //Generate supercells of a certain volume and store them in the array of supercells
-    void generate_supercells(int volStart, int volEnd, bool verbose);
+    //  - num_threads is the number of threads used to enumerate them (0 uses all available cores)
+    void generate_supercells(int volStart, int volEnd, bool verbose, long num_threads = 1);
 
     //Enumerate configurations for all the supercells that are stored in 'supercell_list'
     void enumerate_all_configurations();
+
+    /// Enumerate all occupations for each supercell in 'scel_indices', using num_threads() threads
+    /// - Supercells are enumerated concurrently, and results are added to each supercell's
+    ///   config_list in the same order as a serial run
+    /// - 'scel_indices' should not contain duplicates
+    void enumerate_occupation_configurations(const std::vector<Index> &scel_indices, bool orderly = false);
     void print_enum_info(std::ostream &stream);
     void print_supercells() const;
     void print_supercells(std::ostream &stream) const;
     void read_supercells(std::istream &stream);
     void print_clex_configurations();
 
+    /// Regenerate the neighbor lists of Supercell that have generated them, after prim_nlist
+    ///   changes. Called by generate_full_nlist and set_prim_nlist.
     void generate_supercell_nlists();
 
     //ParamComposition i/o and calculators in PrimClex
@@ -400,16 +457,34 @@ namespace CASM {
     ///   properties.delta.json
     void generate_references();
 
+    /// \brief Clexulator for the current basis set
+    ///
+    /// Depending on ProjectSettings::clexulator_type, either the generated Clexulator source is
+    /// compiled and loaded, or a TableClexulator is constructed from the basis set.
     Clexulator global_clexulator() const;
     ECIContainer global_eci(std::string clex_name) const;
+
+    /// \brief Clexulator with the ECI of 'clex_name' folded in, regenerated if the ECI or basis set change
+    EnergyClexulator global_energy_clexulator(std::string clex_name) const;
+
+    /// \brief Binary cache of correlations calculated with global_clexulator(), or nullptr if not available
+    CorrCache *global_corr_cache() const;
   private:
 
     /// Return the configuration closest in param_composition to the target_param_comp
     ///   Tie break returns configuration in smallest supercell (first found at that size)
     const Configuration &closest_calculated_config(const Eigen::VectorXd &target_param_comp) const;
 
+    /// Read the orbits of the current basis set from clust.json into 'tree', constructed with
+    ///   prim.lattice(), generate their basis functions, and expand the neighbor list 'nlist'
+    void _read_global_basis_functions(Structure &prim, SiteOrbitree &tree, Array<UnitCellCoord> &nlist) const;
+
 
     mutable Clexulator m_global_clexulator;
+    mutable EnergyClexulator m_global_energy_clexulator;
+    mutable fs::path m_global_energy_clexulator_src;
+    mutable std::shared_ptr<CorrCache> m_global_corr_cache;
+    mutable fs::path m_global_corr_cache_path;
   };
 
 
@@ -424,6 +499,14 @@ namespace CASM {
                         std::ostream &stream);
 
 
+  /// \brief Print clexulator with ECI folded into energy kernels
+  void print_energy_clexulator(const Structure &prim,
+                               SiteOrbitree &tree,
+                               const Array<UnitCellCoord> &nlist,
+                               const ECIContainer &eci,
+                               std::string class_name,
+                               std::ostream &stream);
+
   /// \brief Expand a neighbor list to include neighborhood of another SiteOrbitree
   void expand_nlist(const Structure &prim,
                     SiteOrbitree &tree,
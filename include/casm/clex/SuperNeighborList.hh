@@ -0,0 +1,122 @@
+#ifndef SUPERNEIGHBORLIST_HH
+#define SUPERNEIGHBORLIST_HH
+
+#include <cstdint>
+#include <vector>
+
+#include "casm/CASM_global_definitions.hh"
+
+namespace CASM {
+
+  template<typename T>
+  class Array;
+  class PrimGrid;
+  class UnitCellCoord;
+
+  /// \brief Neighbor lists of the unit cells of a Supercell
+  ///
+  /// The neighbor list of a site depends only on the unit cell that contains it, because the
+  /// neighbor list UnitCellCoord include the sublattice of the neighbor. So only one neighbor
+  /// list per unit cell is stored, as 32-bit Supercell linear indices in one contiguous array,
+  /// volume() x nlist_size(), which is what the Clexulator reads.
+  ///
+  /// For Supercell too large to tabulate, neighbor lists are instead calculated when needed from
+  /// the canonical (Smith Normal Form) indexing of the PrimGrid, using a buffer provided by the
+  /// caller:
+  /// \code
+  /// std::vector<SuperNeighborList::value_type> buffer(my_supercell.nlist().nlist_size());
+  /// myclexulator.set_nlist(my_supercell.nlist().sites(unitcell_index, buffer.data()));
+  /// \endcode
+  ///
+  class SuperNeighborList {
+
+  public:
+
+    /// \brief Type of Supercell linear indices, same as Clexulator_impl::Base::nlist_index_type
+    typedef std::uint32_t value_type;
+
+    /// \brief Neighbor lists are tabulated if they take no more than this many bytes (1 GiB)
+    static const Index default_max_table_bytes = Index(1) << 30;
+
+
+    SuperNeighborList() :
+      m_volume(0),
+      m_nlist_size(0) {}
+
+    /// \brief Construct neighbor lists for the unit cells of 'prim_grid'
+    ///
+    /// \param prim_grid The PrimGrid of the Supercell
+    /// \param prim_nlist The neighbor list of the origin unit cell, as in PrimClex::get_nlist_uccoord
+    /// \param max_table_bytes Neighbor lists are tabulated only if they take no more than this
+    ///        many bytes, else they are calculated in sites(Index, value_type*)
+    ///
+    /// Throws std::runtime_error if the Supercell has too many sites to index with value_type.
+    SuperNeighborList(const PrimGrid &prim_grid,
+                      const Array<UnitCellCoord> &prim_nlist,
+                      Index max_table_bytes = default_max_table_bytes);
+
+    /// \brief Number of unit cells in the Supercell
+    Index volume() const {
+      return m_volume;
+    }
+
+    /// \brief Number of sites in each neighbor list
+    Index nlist_size() const {
+      return m_nlist_size;
+    }
+
+    /// \brief True if all neighbor lists are stored, rather than calculated when needed
+    bool tabulated() const {
+      return m_table.size() == m_volume * m_nlist_size;
+    }
+
+    /// \brief Neighbor list of unit cell 'unitcell_index'
+    ///
+    /// \param unitcell_index Index of a unit cell in the PrimGrid, in [0, volume()). For a site
+    ///        with Supercell linear index 'l' this is 'l % volume()'.
+    /// \param buffer Space for nlist_size() indices, used if the neighbor lists are not tabulated
+    ///
+    /// \returns Pointer to nlist_size() Supercell linear indices, valid until 'buffer' is
+    ///          changed or *this is destroyed
+    const value_type *sites(Index unitcell_index, value_type *buffer) const {
+      if(tabulated()) {
+        return m_table.data() + unitcell_index * m_nlist_size;
+      }
+      _calc(unitcell_index, buffer);
+      return buffer;
+    }
+
+    /// \brief Supercell linear index of neighbor 'nlist_index' of unit cell 'unitcell_index'
+    value_type site(Index unitcell_index, Index nlist_index) const;
+
+    /// \brief True if the neighborhood overlaps its periodic image
+    ///
+    /// If any of the first 'basis_size' sites of the neighbor list, which are the sites of the
+    /// unit cell itself, is repeated, the neighborhood is larger than the Supercell. Neighbor
+    /// lists are translations of each other, so only unit cell 0 is checked.
+    bool overlaps(Index basis_size) const;
+
+  private:
+
+    /// \brief Calculate the neighbor list of unit cell 'unitcell_index' into 'nlist'
+    void _calc(Index unitcell_index, value_type *nlist) const;
+
+    Index m_volume;
+
+    Index m_nlist_size;
+
+    /// \brief Diagonal of the Smith Normal Form of the Supercell transformation matrix
+    long m_S[3];
+
+    /// \brief [4 * nlist_index + {0, 1, 2, 3}]: sublattice * volume, and the translation to the
+    ///        neighbor in canonical coordinates, each reduced into [0, m_S[i])
+    std::vector<long> m_delta;
+
+    /// \brief [volume() * nlist_size()]: the neighbor lists, if tabulated
+    std::vector<value_type> m_table;
+
+  };
+
+}
+
+#endif
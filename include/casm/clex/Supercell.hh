@@ -8,6 +8,11 @@
 #include "casm/clex/Configuration.hh"
 #include "casm/clex/ConfigEnumIterator.hh"
 #include "casm/clex/ConfigDoF.hh"
+#include "casm/clex/SuperNeighborList.hh"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
 
 namespace CASM {
 
@@ -16,6 +21,7 @@ namespace CASM {
   class PermuteIterator;
   class PrimClex;
   class Clexulator;
+  class jsonStreamReader;
 
   class Supercell {
 
@@ -137,11 +143,67 @@ namespace CASM {
     void generate_phase_factor(const Eigen::MatrixXd &shift_vectors, const Array<bool> &is_commensurate, const bool &override);
     ///************************************************************************************************
 
-    Array< Array<Index> >    nlists;  //[scell site][ nbor_indices]
+    /// A SuperNeighborList generated on first access, which may be by several threads
+    ///
+    /// Copies copy the neighbor list, not the mutex, so that Supercell stay copyable.
+    struct LazyNeighborList {
+
+      LazyNeighborList() {}
+
+      LazyNeighborList(const LazyNeighborList &RHS) :
+        value(RHS.value),
+        generated(RHS.generated.load()) {}
+
+      LazyNeighborList &operator=(const LazyNeighborList &RHS) {
+        value = RHS.value;
+        generated.store(RHS.generated.load());
+        return *this;
+      }
+
+      SuperNeighborList value;
+
+      /// True once 'value' has been generated
+      std::atomic<bool> generated{false};
+
+      /// Guards generating 'value'
+      std::mutex mutex;
+    };
+
+    /// Neighbor list of each unit cell, generated on first access, see nlist()
+    mutable LazyNeighborList m_nlist;
+
+    /// Generate m_nlist, if another thread has not already
+    void _generate_neighbor_list_once() const;
+
+    /// Generate m_nlist, with m_nlist.mutex locked
+    void _generate_neighbor_list(Index max_table_bytes) const;
 
     // Could hold either enumerated configurations or any 'saved' configurations
     ConfigList config_list;
 
+    /// If false, config_list has not been read from get_config_list_path() yet
+    mutable bool m_config_list_loaded = false;
+
+    /// If true, config_list has been modified since it was read or written, see config_list_dirty()
+    bool m_config_list_dirty = false;
+
+    /// Read config_list from get_config_list_path(), on first access
+    void _load_config_list() const;
+
+    /// Index of config_list by ConfigDoF::hash, for fast duplicate detection
+    /// - Holds config_list[0, m_config_index_size); configurations added since are indexed on the next lookup
+    mutable std::unordered_multimap<std::size_t, Index> m_config_index;
+    mutable Index m_config_index_size = 0;
+
+    /// Index configurations added to config_list since the last lookup
+    void _update_config_index() const;
+
+    /// Discard the index, for use when existing configurations are modified
+    void _reset_config_index() const;
+
+    /// Find the first configuration in config_list with configdof equal to '_configdof'
+    bool _find_config(const ConfigDoF &_configdof, Index &index) const;
+
     Matrix3 < int > transf_mat;
 
     double scaling;
@@ -278,30 +340,80 @@ namespace CASM {
 
     // get indices of neighbor sites ('nlist_index') in Configuration to some 'site'
     Index get_nlist_l(Index pivot_l, Index nlist_index) const {
-      return nlists[pivot_l][nlist_index];
+      return nlist().site(pivot_l % volume(), nlist_index);
     };
 
-    const Array<Index> &get_nlist(Index pivot_l) const {
-      return nlists[pivot_l];
+    /// Neighbor lists of the unit cells
+    ///
+    /// Generated from PrimClex::get_nlist_uccoord on first access, so that only the Supercell
+    ///   that are used pay for them. Safe to call from several threads.
+    const SuperNeighborList &nlist() const {
+      if(!m_nlist.generated.load(std::memory_order_acquire)) {
+        _generate_neighbor_list_once();
+      }
+      return m_nlist.value;
     };
 
+    /// True if the neighbor lists have been generated
+    bool nlist_generated() const {
+      return m_nlist.generated.load(std::memory_order_acquire);
+    }
+
 
+    /// Non-const access may change any configuration, so the whole config index is rebuilt on
+    ///   the next lookup
     ConfigList &get_config_list() {
+      _load_config_list();
+      m_config_list_dirty = true;
+      _reset_config_index();
       return config_list;
     };
 
     const ConfigList &get_config_list() const {
+      _load_config_list();
       return config_list;
     };
 
     const Configuration &get_config(Index i) const {
+      _load_config_list();
       return config_list[i];
     };
 
+    /// Non-const access may change the configuration's hash, so it is indexed again on the
+    ///   next lookup (stale index entries are harmless, as candidates are compared exactly)
     Configuration &get_config(Index i) {
+      _load_config_list();
+      m_config_list_dirty = true;
+      m_config_index_size = std::min(m_config_index_size, i);
       return config_list[i];
     }
 
+    /// True if config_list has been read from get_config_list_path()
+    bool config_list_loaded() const {
+      return m_config_list_loaded;
+    }
+
+    /// True if config_list may have been modified since it was read or written, and so needs
+    ///   to be written
+    ///
+    /// Set by adding configurations, and by any non-const access to existing configurations
+    bool config_list_dirty() const {
+      return m_config_list_dirty;
+    }
+
+    /// Count configurations, and how many are selected and have been calculated with the
+    ///   current calctype and ref
+    ///
+    /// If config_list has not been read, the counts in PrimClex::config_list_summary are used
+    ///   when they are up to date with get_config_list_path(), so that it need not be read
+    void count_configs(Index &generated, Index &selected, Index &calculated) const;
+
+    /// Write the counts of count_configs to 'json', keeping counts for other calctypes and refs
+    void write_config_list_summary(jsonParser &json) const;
+
+    /// Path to the file storing this Supercell's configurations
+    fs::path get_config_list_path() const;
+
     // begin and end iterators for iterating over configurations
     config_iterator config_begin();
     config_iterator config_end();
@@ -388,7 +500,10 @@ namespace CASM {
 
     //void fill_supercell();
     //void populate_bijk_l_map(Array< Array < Array <Array <Index > > > > &linear_index, UnitCellCoord &centering);
-    void generate_neighbor_list();
+    /// Populate the neighbor lists, which are tabulated if they take no more than 'max_table_bytes'
+    /// - Not necessary before nlist(), unless to regenerate them after the PrimClex neighbor list
+    ///   changes, or to use a non-default 'max_table_bytes'
+    void generate_neighbor_list(Index max_table_bytes = SuperNeighborList::default_max_table_bytes);
 
     ///Return true if the Supercell is smaller than the neighborhood of the sites, causing periodic overlap
     bool neighbor_image_overlaps() const;
@@ -421,8 +536,17 @@ namespace CASM {
     /// Loop over all configurations enumerated by some (invisible) enumerator from 'it_begin' to 'it_end', adding them to the Supercell, if they are not already present
     void add_enumerated_configurations(ConfigEnumIterator<Configuration> it_begin, ConfigEnumIterator<Configuration> it_end);
 
+    /// Add enumerated configurations, with sources already set, that were collected in 'buffer'
+    void add_enumerated_configurations(const std::vector<Configuration> &buffer);
+
     /// Enumerate all possible occupation configurations that are symmetrically equivalent and fit inside this supercell (but cannot be described by a smaller supercell)
-    void enumerate_all_occupation_configurations();
+    /// Enumerate all primitive, canonical occupations. If 'orderly', uses the pruned search of
+    ///   ConfigEnumAllOccupations, which is faster but adds configurations in a different order.
+    void enumerate_all_occupation_configurations(bool orderly = false);
+
+    /// Enumerate all primitive, canonical occupations into 'buffer', without modifying config_list.
+    ///   Call add_enumerated_configurations(buffer) to add them to config_list.
+    void enumerate_all_occupation_configurations(std::vector<Configuration> &buffer, bool orderly = false);
 
     /// Enumerate 'Nstep' configurations that linearly interpolate deformation and displacement from 'initial' configuration to 'final' configuration
     /// 'initial' and 'final' must either have the same occupation or have unspecified occupation
@@ -452,6 +576,10 @@ namespace CASM {
     bool add_canon_config(const Configuration &config, Index &index);
     void read_config_list(const jsonParser &json);
 
+    /// Read configurations one at a time from 'reader', which must be positioned just before
+    ///   the object json["supercells"][get_name()]
+    void read_config_list(jsonStreamReader &reader);
+
     template<typename ConfigIterType>
     void add_configs(ConfigIterType it_begin, ConfigIterType it_end);
 
@@ -507,6 +635,13 @@ namespace CASM {
     ///Call Configuration::write out every configuration in supercell
     jsonParser &write_config_list(jsonParser &json);
 
+    /// Write config_list to get_config_list_path(), keeping data already in the file for other
+    ///   calctypes and references
+    ///
+    /// The existing file is read and rewritten one configuration at a time. Afterwards,
+    ///   config_list_dirty() is false.
+    void write_config_list();
+
     //void printUCC(std::ostream &stream, COORD_TYPE mode, UnitCellCoord ucc);
     // this function finds the displacements of a structure defined by the CONTCAR passed by stream, and the real_super_lattice
     void findConfigDisplacements(Structure tstruc, Index config_num);
@@ -525,6 +660,9 @@ namespace CASM {
 
   };
 
+  /// \brief Name of the Supercell with transformation matrix 'transf_mat', of the form "SCELV_A_B_C_D_E_F"
+  std::string generate_scel_name(const Matrix3<int> &transf_mat);
+
   template<typename ConfigIterType>
   void Supercell::add_configs(ConfigIterType it_begin, ConfigIterType it_end) {
     if(ConfigIterType::is_canonical_iter()) {
@@ -0,0 +1,143 @@
+#ifndef TABLECLEXULATOR_HH
+#define TABLECLEXULATOR_HH
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "casm/clex/Clexulator.hh"
+#include "casm/container/Array.hh"
+#include "casm/crystallography/Structure.hh"
+#include "casm/crystallography/UnitCellCoord.hh"
+
+namespace CASM {
+
+  /// \brief Clexulator_impl::Base that evaluates basis functions from tables, so no compiler is needed
+  ///
+  /// Constructed from the same basis functions that print_clexulator writes as source code. Each
+  /// basis function is stored as flat arrays of clusters, monomial coefficients, and the
+  /// occupation functions that are multiplied together. To evaluate, the occupation functions
+  /// (and any powers of them) used by a table are first gathered from the neighborhood into a
+  /// contiguous array, and then the monomials are summed over it.
+  ///
+  /// Coefficients are rounded and summed in the same way as the generated source, so
+  /// correlations match the compiled Clexulator to round-off.
+  ///
+  /// Only occupation basis functions are supported.
+  ///
+  class TableClexulator : public Clexulator_impl::Base {
+
+  public:
+
+    /// \brief Construct from the basis functions of 'tree', with neighbor list indices set by expand_nlist
+    ///
+    /// As for print_clexulator, the neighbor list indices of the clusters of 'tree' are changed.
+    TableClexulator(const Structure &prim, SiteOrbitree &tree, const Array<UnitCellCoord> &nlist);
+
+    /// \brief Flattened basis functions, for one set of functions
+    ///
+    /// value(func) = sum over groups of func:
+    ///                 delta(group)*(sum over clusters of group:
+    ///                                 sum over terms of cluster: coeff(term)*product of factors)/divisor(group)
+    ///
+    /// where delta is the change in an occupation function of the changing site, or 1.
+    struct Table {
+
+      /// Index into the occupation function table, for each gathered variable
+      std::vector<std::uint32_t> var_occ_func;
+
+      /// Neighbor list index, for each gathered variable
+      std::vector<std::uint32_t> var_nlist;
+
+      /// Power the occupation function is raised to, for each gathered variable
+      std::vector<int> var_pow;
+
+      /// Groups of each function, as [func_group[f], func_group[f+1])
+      std::vector<std::uint32_t> func_group;
+
+      /// Occupation function of the changing site that scales each group, or -1
+      std::vector<int> group_delta;
+
+      std::vector<double> group_divisor;
+
+      /// Clusters of each group, as [group_cluster[g], group_cluster[g+1])
+      std::vector<std::uint32_t> group_cluster;
+
+      /// Terms of each cluster, as [cluster_term[c], cluster_term[c+1])
+      std::vector<std::uint32_t> cluster_term;
+
+      std::vector<double> term_coeff;
+
+      /// Factors of each term, as [term_factor[t], term_factor[t+1])
+      std::vector<std::uint32_t> term_factor;
+
+      /// Gathered variable index of each factor
+      std::vector<std::uint32_t> factor;
+
+    };
+
+    /// \brief Calculate contribution to global correlations from one unit cell
+    void calc_global_corr_contribution(double *corr_begin) const override;
+
+    /// \brief Calculate contribution to select global correlations from one unit cell
+    void calc_restricted_global_corr_contribution(double *corr_begin, size_type const *ind_list_begin, size_type const *ind_list_end) const override;
+
+    /// \brief Calculate point correlations about basis site 'b_index'
+    void calc_point_corr(int b_index, double *corr_begin) const override;
+
+    /// \brief Calculate select point correlations about basis site 'b_index'
+    void calc_restricted_point_corr(int b_index, double *corr_begin, size_type const *ind_list_begin, size_type const *ind_list_end) const override;
+
+    /// \brief Calculate the change in point correlations due to changing an occupant
+    void calc_delta_point_corr(int b_index, int occ_i, int occ_f, double *corr_begin) const override;
+
+    /// \brief Calculate the change in select point correlations due to changing an occupant
+    void calc_restricted_delta_point_corr(int b_index,
+                                          int occ_i,
+                                          int occ_f,
+                                          double *corr_begin,
+                                          size_type const *ind_list_begin,
+                                          size_type const *ind_list_end) const override;
+
+  private:
+
+    /// \brief Clone the TableClexulator
+    TableClexulator *_clone() const override {
+      return new TableClexulator(*this);
+    }
+
+    /// \brief Gather the occupation functions used by 'table' from the current neighborhood
+    void _gather(const Table &table) const;
+
+    /// \brief Value of function 'func' of 'table', using gathered variables and m_delta
+    double _eval(const Table &table, size_type func) const;
+
+    /// \brief Set m_delta for changing the occupant of basis site 'b_index'
+    void _set_delta(int b_index, int occ_i, int occ_f) const;
+
+    /// \brief Tables, shared between clones
+    struct Data {
+
+      /// Occupation function values, m_occ_func_b_f[occ] is at occ_func[occ_func_begin[b][f] + occ]
+      std::vector<double> occ_func;
+      std::vector<std::vector<std::uint32_t> > occ_func_begin;
+
+      Table orbit;
+      std::vector<Table> flower;
+      std::vector<Table> delta;
+
+    };
+
+    std::shared_ptr<const Data> m_data;
+
+    /// Gathered variables, sized for the largest table
+    mutable std::vector<double> m_var;
+
+    /// Change in each occupation function of the changing site
+    mutable std::vector<double> m_delta;
+
+  };
+
+}
+
+#endif
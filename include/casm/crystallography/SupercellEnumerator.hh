@@ -1,8 +1,13 @@
 #ifndef SupercellEnumerator_HH
 #define SupercellEnumerator_HH
 
+#include <climits>
+#include <stdexcept>
+#include <vector>
+
 #include "casm/external/Eigen/Dense"
 
+#include "casm/system/ParallelFor.hh"
 #include "casm/symmetry/SymGroup.hh"
 #include "casm/crystallography/Lattice.hh"
 #include "casm/crystallography/BasicStructure.hh"
@@ -12,6 +17,22 @@ namespace CASM {
 
   template <typename UnitType> class SupercellEnumerator;
 
+  /// \brief Point group operations as integer transformations of supercell matrices, U.inverse()*op*U
+  std::vector<Eigen::Matrix3i> integer_point_group(const Lattice &unit, const SymGroup &point_grp);
+
+  /// \brief Check if a supercell matrix in hermite normal form is canonical
+  bool is_canonical_hnf(const Eigen::Matrix3i &T, const std::vector<Eigen::Matrix3i> &int_point_grp);
+
+  /// \brief Diagonals (H00, H11, H22) of supercell matrices in hermite normal form with volume in
+  ///        [begin_volume, end_volume), in the order SupercellIterator visits them
+  std::vector<Eigen::Vector3i> hnf_diagonals(int begin_volume, int end_volume);
+
+  /// \brief Append the canonical supercell matrices with diagonal 'diag' to 'result', in the order
+  ///        SupercellIterator visits them
+  void canonical_hnf_block(const Eigen::Vector3i &diag,
+                           const std::vector<Eigen::Matrix3i> &int_point_grp,
+                           std::vector<Eigen::Matrix3i> &result);
+
   /// \brief Iterators used with SupercellEnumerator
   ///
   /// Allows iterating over unique supercells of a UnitType object (may be Lattice, eventually BasicStructure, or Structure)
@@ -147,6 +168,9 @@ namespace CASM {
     /// \brief Access the unit point group
     const SymGroup &point_group() const;
 
+    /// \brief Access the unit point group as integer transformations of supercell matrices
+    const std::vector<Eigen::Matrix3i> &int_point_group() const;
+
     /// \brief Set the beginning volume
     void begin_volume(size_type _begin_volume);
 
@@ -190,6 +214,9 @@ namespace CASM {
 
     /// \brief The past-the-last volume supercells to be iterated over (what cend uses)
     int m_end_volume;
+
+    /// \brief The point group of the unit cell, as U.inverse()*op*U, calculated once on construction
+    std::vector<Eigen::Matrix3i> m_int_point_group;
   };
 
 
@@ -252,6 +279,11 @@ namespace CASM {
     return &m_super;
   }
 
+  template<typename UnitType>
+  const Eigen::Matrix3i &SupercellIterator<UnitType>::matrix() const {
+    return m_current;
+  }
+
   template<typename UnitType>
   const SupercellEnumerator<UnitType> &SupercellIterator<UnitType>::enumerator() const {
     return *m_enum;
@@ -284,59 +316,7 @@ namespace CASM {
 
   template<typename UnitType>
   bool SupercellIterator<UnitType>::_is_canonical() const {
-
-    Eigen::Matrix3i H, V;
-
-    // apply point group operations to the supercell matrix to check if it is canonical form
-    // S: supercell lattice column vectors,  U: unit cell lattice column vectors,  T: supercell transformation matrix
-    //
-    // S = U*T  and  op*S = U*T', solve for T' = f(T)
-    //
-    // op*U*T = U*T'
-    // U.inv*op*U*T = T'
-
-    for(int i = 0; i < m_enum->point_group().size(); i++) {
-
-      Eigen::Matrix3d U = m_enum->lattice().lat_column_mat();
-      Eigen::Matrix3d op = m_enum->point_group()[i].get_matrix(CART);
-
-      Eigen::Matrix3i transformed = iround(U.inverse() * op * U) * m_current;
-
-      H = hermite_normal_form(transformed).first;
-
-      // canonical only if m_current is '>' H, so if H '>' m_current, return false
-      if(H(0, 0) > m_current(0, 0))
-        return false;
-      if(H(0, 0) < m_current(0, 0))
-        continue;
-
-      if(H(1, 1) > m_current(1, 1))
-        return false;
-      if(H(1, 1) < m_current(1, 1))
-        continue;
-
-      if(H(2, 2) > m_current(2, 2))
-        return false;
-      if(H(2, 2) < m_current(2, 2))
-        continue;
-
-      if(H(1, 2) > m_current(1, 2))
-        return false;
-      if(H(1, 2) < m_current(1, 2))
-        continue;
-
-      if(H(0, 2) > m_current(0, 2))
-        return false;
-      if(H(0, 2) < m_current(0, 2))
-        continue;
-
-      if(H(0, 1) > m_current(0, 1))
-        return false;
-      if(H(0, 1) < m_current(0, 1))
-        continue;
-
-    }
-    return true;
+    return is_canonical_hnf(m_current, m_enum->int_point_group());
   }
 
   template<typename UnitType>
@@ -411,6 +391,11 @@ namespace CASM {
     return m_point_group;
   }
 
+  template<typename UnitType>
+  const std::vector<Eigen::Matrix3i> &SupercellEnumerator<UnitType>::int_point_group() const {
+    return m_int_point_group;
+  }
+
   template<typename UnitType>
   void SupercellEnumerator<UnitType>::begin_volume(size_type _begin_volume) {
     m_begin_volume = _begin_volume;
@@ -471,6 +456,60 @@ namespace CASM {
                                                     size_type begin_volume,
                                                     size_type end_volume);
 
+  /// \brief Call 'f(const Eigen::Matrix3i &T)' for each canonical supercell matrix of 'enumerator'
+  ///
+  /// \param enumerator Provides the unit, point group, and the volume range, which must be finite
+  /// \param f Function with signature 'void f(const Eigen::Matrix3i &T)', where the supercell is
+  ///        make_supercell(enumerator.unit(), T)
+  /// \param num_threads Number of threads used to check supercell matrices, see resolve_num_threads
+  ///
+  /// - Supercell matrices are visited in the same order as with SupercellEnumerator iterators, and 'f'
+  ///   is always called on the calling thread
+  /// - The supercell matrices with the same volume and diagonal are checked together, so that
+  ///   batches of these blocks can be checked in parallel. Only the canonical matrices of one batch
+  ///   are held at a time.
+  ///
+  template<typename UnitType, typename Function>
+  void for_each_supercell_matrix(const SupercellEnumerator<UnitType> &enumerator, Function f, long num_threads = 1) {
+
+    if(enumerator.end_volume() > INT_MAX) {
+      throw std::runtime_error("Error in for_each_supercell_matrix: the end volume must be set");
+    }
+
+    std::vector<Eigen::Vector3i> diag = hnf_diagonals(enumerator.begin_volume(), enumerator.end_volume());
+
+    num_threads = resolve_num_threads(num_threads);
+    long batch_size = 8 * num_threads;
+    std::vector<std::vector<Eigen::Matrix3i> > block(batch_size);
+
+    for(long batch_begin = 0; batch_begin < long(diag.size()); batch_begin += batch_size) {
+      long batch_end = std::min(batch_begin + batch_size, long(diag.size()));
+      parallel_for_chunks(batch_end - batch_begin, 1, num_threads, [&](long thread, long begin, long end) {
+        for(long i = begin; i < end; ++i) {
+          block[i].clear();
+          canonical_hnf_block(diag[batch_begin + i], enumerator.int_point_group(), block[i]);
+        }
+      });
+      for(long i = 0; i < batch_end - batch_begin; ++i) {
+        for(const auto &T : block[i]) {
+          f(T);
+        }
+      }
+    }
+  }
+
+  /// \brief Canonical supercell matrices of 'enumerator', in the same order as with SupercellEnumerator iterators
+  ///
+  /// \see for_each_supercell_matrix
+  template<typename UnitType>
+  std::vector<Eigen::Matrix3i> enumerate_supercell_matrices(const SupercellEnumerator<UnitType> &enumerator, long num_threads = 1) {
+    std::vector<Eigen::Matrix3i> result;
+    for_each_supercell_matrix(enumerator, [&](const Eigen::Matrix3i & T) {
+      result.push_back(T);
+    }, num_threads);
+    return result;
+  }
+
   /// \brief Return canonical hermite normal form of the supercell matrix, and op used to find it
   std::pair<Eigen::MatrixXi, Eigen::MatrixXd>
   canonical_hnf(const Eigen::MatrixXi &T, const BasicStructure<Site> &unitcell);
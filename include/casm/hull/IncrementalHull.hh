@@ -0,0 +1,167 @@
+#ifndef CASM_IncrementalHull
+#define CASM_IncrementalHull
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+#include "casm/BP_C++/BP_Geo.hh"
+#include "casm/CASM_global_definitions.hh"
+
+namespace CASM {
+
+  /// \brief Convex hull of a set of labeled points, updated as points are inserted, erased, or changed
+  ///
+  /// The hull is kept as a BP::Geo built only from the 'support' points, the vertices of the
+  /// convex hull of all points. Points that are not support points do not change the hull, so:
+  /// - Inserting points that are strictly inside the current hull does not change it
+  /// - Inserting other points rebuilds the hull from the support points and the new points
+  /// - Erasing or changing a point that is not a support point does not change the hull
+  /// - Only erasing or changing a support point rebuilds the hull from all points
+  ///
+  /// The BP::Geo is filtered with CH_bottom, so distances are measured along the 'bottom' direction.
+  ///
+  /// Usage:
+  /// \code
+  /// IncrementalHull hull(bottom);
+  /// hull.read(filename, key);              // reuse points and support from a previous run, if any
+  /// hull.assign(labels, points);           // insert, erase, or change only the points that differ
+  /// if(!hull.update()) { ...error... }
+  /// double dist = hull.geo().CH_dist_to_hull(x);
+  /// hull.write(filename, key);
+  /// \endcode
+  ///
+  class IncrementalHull {
+
+  public:
+
+    static const std::uint32_t format_version = 1;
+
+    /// \brief Construct an empty hull
+    ///
+    /// \param _bottom Direction that is 'down', as for BP::Geo::CH_bottom. Sets the dimension of points.
+    /// \param _tol Points closer than this to the hull are not considered strictly inside it
+    explicit IncrementalHull(const Eigen::VectorXd &_bottom = Eigen::VectorXd(), double _tol = 1e-8);
+
+    /// \brief Copies points and support, and rebuilds the BP::Geo, which can not be copied
+    IncrementalHull(const IncrementalHull &RHS);
+
+    IncrementalHull &operator=(const IncrementalHull &RHS);
+
+    /// \brief Dimension of points
+    Index dim() const {
+      return m_bottom.size();
+    }
+
+    /// \brief Number of points
+    Index size() const {
+      return m_point.size();
+    }
+
+    const Eigen::VectorXd &bottom() const {
+      return m_bottom;
+    }
+
+    /// \brief Insert a point, or change the position of the point with this label
+    void insert(const std::string &label, const Eigen::VectorXd &pos);
+
+    /// \brief Erase the point with this label, if it exists
+    void erase(const std::string &label);
+
+    /// \brief Make the points equal to columns of 'pos', with labels 'labels'
+    ///
+    /// Points are only inserted, erased, or changed if they differ from the current points
+    void assign(const std::vector<std::string> &labels, const Eigen::MatrixXd &pos);
+
+    /// \brief True if points were inserted, erased, or changed since the last 'read' or 'write'
+    bool modified() const {
+      return m_modified;
+    }
+
+    /// \brief Update the hull to include changes to the points
+    ///
+    /// \returns false if the hull could not be constructed, for example if there are too few points
+    bool update();
+
+    /// \brief The hull, as of the last successful 'update'
+    const BP::Geo &geo() const {
+      return *m_geo;
+    }
+
+    /// \brief Labels of the vertices of the bottom of the hull, as of the last successful 'update'
+    std::vector<std::string> vertices() const;
+
+    /// \brief Number of times the hull was built from all points
+    Index num_full_builds() const {
+      return m_num_full_builds;
+    }
+
+    /// \brief Number of times the hull was built from the support points and new points
+    Index num_partial_builds() const {
+      return m_num_partial_builds;
+    }
+
+    /// \brief Write the points and support to a binary file, tagged with 'key'
+    ///
+    /// \param filename File to write, its parent directories are created if necessary
+    /// \param key Identifies what the points are, for example a hash of how they were calculated
+    ///
+    /// Call 'update' first, so that the support is up to date
+    void write(const boost::filesystem::path &filename, std::uint64_t key);
+
+    /// \brief Read points and support written by 'write'
+    ///
+    /// The next 'update' builds the hull from the support points and any points inserted since
+    ///
+    /// Updates the last write time of 'filename', so that it is kept by remove_stale_hull_files
+    ///
+    /// \returns false, and leaves this unchanged, if 'filename' does not exist, is not a hull file,
+    ///          or was written with a different key, format version, or dimension
+    bool read(const boost::filesystem::path &filename, std::uint64_t key);
+
+  private:
+
+    /// \brief Build m_geo from the points with labels 'labels'
+    bool _build(const std::vector<std::string> &labels);
+
+    Eigen::VectorXd m_bottom;
+    double m_tol;
+
+    /// all points, by label
+    std::map<std::string, Eigen::VectorXd> m_point;
+
+    /// labels of the vertices of the full hull of all points
+    std::set<std::string> m_support;
+
+    /// labels of points inserted or changed since the last update
+    std::vector<std::string> m_pending;
+
+    /// a support point was erased or changed, so the hull must be rebuilt from all points
+    bool m_full_rebuild = true;
+
+    bool m_modified = false;
+
+    /// the hull, and the label of each of the points it was built from
+    ///   (BP::Geo can not be copied or reused safely, so a new one is made for each build)
+    std::unique_ptr<BP::Geo> m_geo;
+    std::vector<std::string> m_geo_label;
+    bool m_geo_valid = false;
+
+    Index m_num_full_builds = 0;
+    Index m_num_partial_builds = 0;
+
+  };
+
+  /// \brief Remove all but the 'max_files' most recently used hull files (extension '.hull') in 'dir'
+  ///
+  /// Hull files are ordered by last write time, which IncrementalHull::write and
+  /// IncrementalHull::read update. The file 'keep' is never removed.
+  void remove_stale_hull_files(const boost::filesystem::path &dir, Index max_files, const boost::filesystem::path &keep);
+
+}
+
+#endif
@@ -285,6 +285,54 @@ namespace CASM {
   // Finds optimal assignments, based on cost_matrix, and returns total optimal cost
   double hungarian_method(const Eigen::MatrixXd &cost_matrix, std::vector<Index> &optimal_assignments, const double _tol);
 
+  // *******************************************************************************************
+
+  /// \brief Square cost matrix in compressed sparse row format, for sparse_assignment
+  ///
+  /// Entries of row i are in [row_begin[i], row_begin[i+1]). Assignments that have no
+  /// entry are not allowed.
+  struct SparseCostMatrix {
+
+    std::vector<Index> row_begin;
+    std::vector<Index> col;
+    std::vector<double> cost;
+
+    Index size() const {
+      return row_begin.empty() ? 0 : row_begin.size() - 1;
+    }
+
+    void clear() {
+      row_begin.assign(1, 0);
+      col.clear();
+      cost.clear();
+    }
+  };
+
+  /// \brief Finds the optimal assignment of rows to columns of a sparse cost matrix
+  ///
+  /// \param cost_matrix Square matrix of assignment costs
+  /// \param optimal_assignment Set so that row i is assigned to column optimal_assignment[i]. If it
+  ///        has the size of 'cost_matrix' on input, it is used as a warm start.
+  /// \param row_potential, col_potential Dual variables u, v, such that
+  ///        cost(i, j) - u[i] - v[j] >= 0 for every entry, and == 0 for assigned entries. If
+  ///        'col_potential' has the size of 'cost_matrix' on input, it is used as a warm start.
+  /// \param tot_cost Set to the total optimal cost
+  ///
+  /// \returns false if no assignment uses only entries of 'cost_matrix'
+  ///
+  /// Rows are assigned one at a time along shortest augmenting paths (Dijkstra with potentials),
+  /// so the cost is O(N*E*log(N)) for N rows and E entries, rather than the O(N^3) of
+  /// hungarian_method. The optimal assignment and potentials from a similar cost matrix, for
+  /// example the same sites with a small translation, are a good warm start.
+  ///
+  /// If 'cost_matrix' only has some entries of a dense matrix, the result is also optimal for the
+  /// dense matrix if the omitted costs are all >= max(u) + max(v).
+  bool sparse_assignment(const SparseCostMatrix &cost_matrix,
+                         std::vector<Index> &optimal_assignment,
+                         Eigen::VectorXd &row_potential,
+                         Eigen::VectorXd &col_potential,
+                         double &tot_cost);
+
   namespace HungarianMethod_impl {
     // *******************************************************************************************
     /* Hungarian Algorithm Routines
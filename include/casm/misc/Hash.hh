@@ -0,0 +1,34 @@
+#ifndef CASM_Hash_HH
+#define CASM_Hash_HH
+
+#include <cstdint>
+#include <string>
+#include <boost/filesystem.hpp>
+
+namespace CASM {
+
+  /// \brief 64-bit FNV-1a hash of 'size' bytes starting at 'data'
+  ///
+  /// - Unlike std::hash or boost::hash, the result does not depend on the platform or
+  ///   library version, so it may be stored in files
+  /// - Pass the result of a previous call as 'hash' to hash several ranges together
+  inline std::uint64_t fnv1a_hash(const void *data, std::size_t size, std::uint64_t hash = 14695981039346656037ULL) {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for(std::size_t i = 0; i < size; ++i) {
+      hash ^= bytes[i];
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
+  /// \brief 64-bit FNV-1a hash of the characters of 'str'
+  inline std::uint64_t fnv1a_hash(const std::string &str, std::uint64_t hash = 14695981039346656037ULL) {
+    return fnv1a_hash(str.data(), str.size(), hash);
+  }
+
+  /// \brief 64-bit FNV-1a hash of the contents of a file
+  std::uint64_t fnv1a_hash_file(const boost::filesystem::path &filename);
+
+}
+
+#endif
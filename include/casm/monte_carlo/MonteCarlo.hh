@@ -0,0 +1,258 @@
+#ifndef CASM_MonteCarlo_HH
+#define CASM_MonteCarlo_HH
+
+#include <string>
+#include <vector>
+
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+#include "casm/clex/ConfigDoF.hh"
+#include "casm/clex/Clexulator.hh"
+#include "casm/clex/SuperNeighborList.hh"
+#include "casm/clex/ECIContainer.hh"
+
+namespace CASM {
+
+  class Supercell;
+
+  /// \brief Thermodynamic conditions at one point of a Monte Carlo path
+  struct MonteConditions {
+
+    /// Temperature, in K
+    double temperature;
+
+    /// Parametric chemical potential, conjugate to the parametric composition. Only used by
+    /// SemiGrandCanonical.
+    Eigen::VectorXd param_chem_pot;
+
+  };
+
+  jsonParser &to_json(const MonteConditions &cond, jsonParser &json);
+
+  /// \brief Metropolis Monte Carlo on the occupation of a Supercell
+  ///
+  /// The formation energy of the supercell is the cluster expansion, volume*(eci*corr). Proposed
+  /// moves are scored with Clexulator::calc_restricted_delta_point_corr, for only the basis
+  /// functions that have ECI, so a move costs one neighborhood rather than calculating all
+  /// correlations of the supercell.
+  ///
+  /// Derived classes choose the move and the potential it is accepted with. Energies are per
+  /// supercell, and compositions are number per supercell, unless the name says otherwise.
+  ///
+  /// The Supercell must have its neighbor lists, and the Clexulator and ECIContainer must be
+  /// for the same basis set.
+  ///
+  /// If an EnergyClexulator generated with the same ECI is set, it is used instead to calculate
+  /// energies and changes in energy directly, without calculating correlations.
+  ///
+  class MonteCarlo {
+
+  public:
+
+    MonteCarlo(const Supercell &_scel,
+               const ConfigDoF &_configdof,
+               const Clexulator &_clexulator,
+               const ECIContainer &_eci,
+               MTRand::uint32 _seed);
+
+    virtual ~MonteCarlo() {}
+
+    const Supercell &supercell() const {
+      return m_scel;
+    }
+
+    const ConfigDoF &configdof() const {
+      return m_configdof;
+    }
+
+    /// \brief Number of sites in the supercell, the number of steps in a pass
+    Index num_sites() const {
+      return m_configdof.size();
+    }
+
+    /// \brief Components, as ordered by CompositionConverter::components
+    const std::vector<std::string> &components() const {
+      return m_components;
+    }
+
+    const MonteConditions &conditions() const {
+      return m_cond;
+    }
+
+    /// \brief Set the temperature and, for derived classes that use them, other conditions
+    virtual void set_conditions(const MonteConditions &_cond);
+
+    /// \brief Formation energy of the supercell
+    double energy() const {
+      return m_energy;
+    }
+
+    /// \brief Number of each component in the supercell
+    const Eigen::VectorXd &num_each_component() const {
+      return m_num_each_component;
+    }
+
+    /// \brief The potential that moves are accepted with
+    virtual double potential_energy() const = 0;
+
+    /// \brief Propose one move, and accept or reject it
+    ///
+    /// \returns true if the move was accepted
+    virtual bool step() = 0;
+
+    /// \brief Perform num_sites() steps
+    void pass();
+
+    /// \brief Number of moves proposed since the last reset_counts()
+    unsigned long proposed() const {
+      return m_proposed;
+    }
+
+    /// \brief Number of moves accepted since the last reset_counts()
+    unsigned long accepted() const {
+      return m_accepted;
+    }
+
+    void reset_counts() {
+      m_proposed = 0;
+      m_accepted = 0;
+    }
+
+    /// \brief Use 'energy_clexulator', generated with the same basis set and ECI, to calculate energies
+    ///
+    /// Recalculates energy()
+    void set_energy_clexulator(const EnergyClexulator &_energy_clexulator);
+
+    /// \brief Recalculate energy() from the correlations of the supercell
+    ///
+    /// Removes round-off accumulated by summing changes in energy
+    ///
+    /// \returns the change in energy()
+    double recalculate_energy();
+
+  protected:
+
+    /// \brief Change in energy() if the occupant of site 'l' is changed to 'occ_f'
+    double _delta_energy(Index l, int occ_f);
+
+    /// \brief Change the occupant of site 'l' to 'occ_f', and update the energy by 'delta_energy'
+    void _set_occ(Index l, int occ_f, double delta_energy);
+
+    /// \brief Metropolis criterion: accept if the change in potential is negative, else with
+    ///        probability exp(-delta_potential/(KB*T))
+    bool _accept(double delta_potential);
+
+    /// \brief Component index of occupant 'occ' of site 'l'
+    int _component(Index l, int occ) const {
+      return m_to_component[_b(l)][occ];
+    }
+
+    /// \brief Occupant index of component 'comp' on site 'l', or -1 if not allowed
+    int _occ(Index l, int comp) const {
+      return m_to_occ[_b(l)][comp];
+    }
+
+    /// \brief Number of allowed occupants of site 'l'
+    int _num_occ(Index l) const {
+      return m_to_component[_b(l)].size();
+    }
+
+    Index _b(Index l) const {
+      return l / m_volume;
+    }
+
+    Index _random_site() {
+      return m_twister.randInt(num_sites() - 1);
+    }
+
+    MTRand m_twister;
+
+    ConfigDoF m_configdof;
+
+    unsigned long m_proposed;
+    unsigned long m_accepted;
+
+  private:
+
+    const Supercell &m_scel;
+    Index m_volume;
+
+    Clexulator m_clexulator;
+    EnergyClexulator m_energy_clexulator;
+    ECIContainer m_eci;
+
+    /// change in correlations, indexed as correlations, only entries with ECI are set
+    std::vector<double> m_dcorr;
+
+    /// holds the neighbor list of a unit cell, if the Supercell does not store them
+    std::vector<SuperNeighborList::value_type> m_nlist_buffer;
+
+    MonteConditions m_cond;
+    double m_beta;
+
+    double m_energy;
+
+    std::vector<std::string> m_components;
+    Eigen::VectorXd m_num_each_component;
+
+    /// [basis site][occupant index] -> component index
+    Array< Array<int> > m_to_component;
+
+    /// [basis site][component index] -> occupant index, or -1 if not allowed
+    std::vector< std::vector<int> > m_to_occ;
+
+  };
+
+  /// \brief Canonical Monte Carlo: moves swap the occupants of two sites
+  ///
+  /// Composition is fixed by the initial occupation. Moves are accepted with the change in
+  /// energy(). A proposed swap of two sites with the same component, or of a component onto a
+  /// site that does not allow it, is rejected.
+  ///
+  class Canonical : public MonteCarlo {
+
+  public:
+
+    using MonteCarlo::MonteCarlo;
+
+    double potential_energy() const override {
+      return energy();
+    }
+
+    bool step() override;
+
+  };
+
+  /// \brief Semi-grand canonical Monte Carlo: moves change the occupant of one site
+  ///
+  /// Moves are accepted with the change in energy() - mu*num_each_component(), where mu is the
+  /// chemical potential of each component, converted from MonteConditions::param_chem_pot with
+  /// the composition axes.
+  ///
+  class SemiGrandCanonical : public MonteCarlo {
+
+  public:
+
+    SemiGrandCanonical(const Supercell &_scel,
+                       const ConfigDoF &_configdof,
+                       const Clexulator &_clexulator,
+                       const ECIContainer &_eci,
+                       MTRand::uint32 _seed);
+
+    void set_conditions(const MonteConditions &_cond) override;
+
+    double potential_energy() const override {
+      return energy() - m_mu.dot(num_each_component());
+    }
+
+    bool step() override;
+
+  private:
+
+    /// chemical potential of each component
+    Eigen::VectorXd m_mu;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef CASM_MonteDriver_HH
+#define CASM_MonteDriver_HH
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "casm/monte_carlo/MonteCarlo.hh"
+
+namespace CASM {
+
+  class PrimClex;
+  class jsonStreamWriter;
+
+  /// \brief Settings for running Monte Carlo along a path of conditions
+  ///
+  /// Read from JSON:
+  /// \code
+  /// {
+  ///   "ensemble" : "canonical" or "semi_grand_canonical",
+  ///   "supercell" : "SCEL..." or [[8, 0, 0], [0, 8, 0], [0, 0, 8]],  // name, or transformation matrix of the prim
+  ///   "initial_config" : "SCEL.../0",       // optional, a configuration of "supercell"
+  ///   "param_composition" : {"a" : 0.25},   // optional, canonical only, randomly set the initial composition
+  ///   "conditions" : {
+  ///     "initial" : {"temperature" : 1000.0, "param_chem_pot" : {"a" : 0.0}},
+  ///     "final" : {"temperature" : 100.0, "param_chem_pot" : {"a" : 0.0}},      // optional
+  ///     "increment" : {"temperature" : -50.0, "param_chem_pot" : {"a" : 0.0}}   // optional
+  ///   },
+  ///   "passes_per_sample" : 1,      // optional, default 1
+  ///   "check_period" : 100,         // optional, samples between checks for convergence, default 100
+  ///   "min_samples" : 100,          // optional, equilibrated samples required, default 100
+  ///   "max_samples" : 10000,        // optional, default 10000
+  ///   "precision" : 0.001,          // optional, standard error of the potential energy per unit cell, default 0.001
+  ///   "seed" : 0,                   // optional, default 0
+  ///   "write_samples" : false       // optional, default false
+  /// }
+  /// \endcode
+  ///
+  /// "param_chem_pot" is only used, and is required, for "semi_grand_canonical". The number of
+  /// conditions is the number of increments from "initial" to "final", which must be the same
+  /// for every quantity that changes.
+  ///
+  struct MonteSettings {
+
+    MonteSettings(const jsonParser &json, const PrimClex &primclex);
+
+    bool is_canonical;
+
+    /// Supercell name, or empty if given by 'transf_mat'
+    std::string supercell;
+    Eigen::Matrix3i transf_mat;
+
+    /// Configuration name, or empty
+    std::string initial_config;
+
+    /// Parametric composition for the initial occupation, or empty
+    Eigen::VectorXd param_composition;
+
+    std::vector<MonteConditions> path;
+
+    Index passes_per_sample;
+    Index check_period;
+    Index min_samples;
+    Index max_samples;
+    double precision;
+    MTRand::uint32 seed;
+    bool write_samples;
+
+  };
+
+  /// \brief Randomly set the occupation of 'configdof' to the parametric composition 'param_comp'
+  ///
+  /// The number of each component is rounded to the nearest integer. Throws if the composition
+  /// can not be set on the supercell.
+  void set_random_occupation(ConfigDoF &configdof,
+                             const Supercell &scel,
+                             const Eigen::VectorXd &param_comp,
+                             MTRand &twister);
+
+  /// \brief Runs MonteCarlo along a path of conditions
+  ///
+  /// At each condition, the state continues from the previous condition. Samples of the
+  /// observables are taken every MonteSettings::passes_per_sample passes. Every
+  /// MonteSettings::check_period samples, equilibration is detected from the potential energy,
+  /// and the condition is complete when there are at least MonteSettings::min_samples
+  /// equilibrated samples and the standard error of the potential energy per unit cell is less
+  /// than MonteSettings::precision, or when there are MonteSettings::max_samples samples.
+  ///
+  /// Results for each condition are written as they complete, as an element of an array:
+  /// \code
+  /// {
+  ///   "conditions" : {...},
+  ///   "converged" : true,
+  ///   "passes" : ...,
+  ///   "num_samples" : ...,
+  ///   "num_equilibration_samples" : ...,
+  ///   "acceptance" : ...,
+  ///   "heat_capacity" : ...,   // per unit cell, in eV/K
+  ///   "<observable>" : {"mean" : ..., "std_err" : ...},
+  ///   ...
+  /// }
+  /// \endcode
+  /// Observables are per unit cell: "potential_energy", "formation_energy", "comp_n(<component>)",
+  /// and "comp(<axis>)".
+  ///
+  class MonteDriver {
+
+  public:
+
+    MonteDriver(MonteCarlo &_mc, const MonteSettings &_set, std::ostream &_sout = std::cout);
+
+    /// \brief Names of the observables, in the order they are sampled
+    const std::vector<std::string> &observable_names() const {
+      return m_name;
+    }
+
+    /// \brief Run every condition of the path
+    ///
+    /// \param results Results for each condition are written as elements of an array
+    /// \param samples If not nullptr, samples for each condition are written as elements of an array
+    void run(jsonStreamWriter &results, jsonStreamWriter *samples = nullptr);
+
+    /// \brief Run one condition, and return its results
+    jsonParser run(const MonteConditions &cond, jsonStreamWriter *samples = nullptr);
+
+  private:
+
+    void _sample(std::vector<double> &sample) const;
+
+    MonteCarlo &m_mc;
+    const MonteSettings &m_set;
+    std::ostream &m_sout;
+
+    std::vector<std::string> m_name;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef CASM_MonteStatistics_HH
+#define CASM_MonteStatistics_HH
+
+#include <vector>
+
+#include "casm/CASM_global_definitions.hh"
+
+namespace CASM {
+
+  /// \brief Statistics of the equilibrated samples of an observable
+  struct MonteStats {
+
+    /// Number of samples
+    Index count;
+
+    double mean;
+
+    /// Variance of the samples
+    double var;
+
+    /// Estimated standard error of the mean, accounting for correlation between samples
+    double std_err;
+
+  };
+
+  /// \brief Index of the first equilibrated sample of an observable
+  ///
+  /// Samples are equilibrated from the first sample that is on the other side of, or equal to,
+  /// the mean of the samples after it than the first sample is. Before that, the observable is
+  /// still drifting from its initial value.
+  ///
+  /// Returns 0 if there are fewer than 2 samples, and samples.size() if they never cross.
+  Index equilibration_index(const std::vector<double> &samples);
+
+  /// \brief Statistics of samples [begin, samples.size())
+  ///
+  /// The standard error is estimated from batch means: the samples are divided into about
+  /// sqrt(count) batches, long enough that the means of the batches are nearly independent. It
+  /// is infinite if there are fewer than 4 samples.
+  MonteStats statistics(const std::vector<double> &samples, Index begin = 0);
+
+}
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef ParallelFor_HH
+#define ParallelFor_HH
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CASM {
+
+  /// \brief Number of worker threads to use when 'num_threads' are requested
+  ///
+  /// - 'num_threads' == 0 requests all available hardware threads
+  /// - Always returns at least 1
+  inline long resolve_num_threads(long num_threads) {
+    if(num_threads <= 0) {
+      num_threads = std::thread::hardware_concurrency();
+    }
+    return std::max(num_threads, 1L);
+  }
+
+  /// \brief Evaluate 'f(thread_index, begin, end)' for chunks [begin, end) of the range [0, N)
+  ///
+  /// \param N Size of the index range
+  /// \param chunk_size Number of indices handed to a worker at a time
+  /// \param num_threads Number of worker threads, see resolve_num_threads
+  /// \param f Function with signature 'void f(long thread_index, long begin, long end)'
+  ///
+  /// - Chunks are handed out dynamically, so work is balanced even if the cost per index varies
+  /// - 'thread_index' is in [0, num_threads), so 'f' can use per-thread data, such as a cloned Clexulator,
+  ///   without locking
+  /// - Which thread evaluates which chunk is not deterministic, so 'f' should write results for
+  ///   index i to a location determined by i, not by order of evaluation
+  /// - If only one thread is used, 'f' is evaluated on the calling thread
+  /// - If 'f' throws, remaining chunks are skipped and the first exception is rethrown after
+  ///   all workers have finished
+  ///
+  /// Call using:
+  /// \code
+  /// std::vector<Clexulator> clexulator(num_threads, my_clexulator);
+  /// parallel_for_chunks(N, 64, num_threads, [&](long thread, long begin, long end) {
+  ///   for(long i = begin; i < end; ++i) {
+  ///     result[i] = calculate(i, clexulator[thread]);
+  ///   }
+  /// });
+  /// \endcode
+  ///
+  template<typename Function>
+  void parallel_for_chunks(long N, long chunk_size, long num_threads, Function f) {
+
+    chunk_size = std::max(chunk_size, 1L);
+    long N_chunk = (N + chunk_size - 1) / chunk_size;
+    num_threads = std::min(resolve_num_threads(num_threads), std::max(N_chunk, 1L));
+
+    if(num_threads == 1) {
+      for(long begin = 0; begin < N; begin += chunk_size) {
+        f(0, begin, std::min(begin + chunk_size, N));
+      }
+      return;
+    }
+
+    std::atomic<long> next_chunk(0);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto worker = [&](long thread_index) {
+      try {
+        long chunk;
+        while((chunk = next_chunk++) < N_chunk) {
+          long begin = chunk * chunk_size;
+          f(thread_index, begin, std::min(begin + chunk_size, N));
+        }
+      }
+      catch(...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if(!error) {
+          error = std::current_exception();
+        }
+        // stop handing out work
+        next_chunk = N_chunk;
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for(long i = 1; i < num_threads; ++i) {
+      threads.push_back(std::thread(worker, i));
+    }
+    worker(0);
+    for(auto &t : threads) {
+      t.join();
+    }
+
+    if(error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+}
+
+#endif
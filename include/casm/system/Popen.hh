@@ -40,7 +40,38 @@ namespace CASM {
         m_stdout += path;
       }
 
-      m_pclose_handler(pclose(fp));
+      m_exit_status = pclose(fp);
+      m_pclose_handler(m_exit_status);
+    }
+
+    /// \brief Execute popen for a given command, writing stdout to 'sout' as it is read
+    ///
+    /// - Uses provided error handlers
+    /// - Does not store stdout, so gets() returns an empty string
+    void popen(std::string _command, std::ostream &sout) {
+
+      m_command = _command;
+
+      FILE *fp;
+      char path[PATH_MAX];
+
+      fp = ::popen(m_command.c_str(), "r");
+      m_popen_handler(fp);
+
+      m_stdout = "";
+      while(fgets(path, PATH_MAX, fp) != NULL) {
+        sout << path << std::flush;
+      }
+
+      m_exit_status = pclose(fp);
+      m_pclose_handler(m_exit_status);
+    }
+
+    /// \brief Returns the exit status of the last command, as returned by pclose
+    ///
+    /// - Use WIFEXITED and WEXITSTATUS from <sys/wait.h> to interpret
+    int status() const {
+      return m_exit_status;
     }
 
     /// \brief Returns the stdout resulting from the last popen call
@@ -72,6 +103,7 @@ namespace CASM {
 
     std::string m_command;
     std::string m_stdout;
+    int m_exit_status = 0;
     std::function<void(FILE *)> m_popen_handler;
     std::function<void(int)> m_pclose_handler;
   };
@@ -30,6 +30,16 @@ namespace CASM {
       }
     }
 
+    /// \brief Compilation options, used for compiling the '.o' file
+    std::string compile_options() const {
+      return m_compile_options;
+    }
+
+    /// \brief Shared library options, used for linking the '.so' file
+    std::string so_options() const {
+      return m_so_options;
+    }
+
     /// \brief Compile a shared library
     ///
     /// \param _filename_base Base name for the source code file. For example, "hello" results in writing "hello.cc",
@@ -0,0 +1,388 @@
+#ifndef TaskScheduler_HH
+#define TaskScheduler_HH
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "casm/system/ParallelFor.hh"
+
+namespace CASM {
+
+  class TaskGroup;
+
+  /// \brief Counters collected by a TaskScheduler, summed over its workers
+  struct TaskSchedulerStats {
+
+    /// \brief Number of worker threads
+    long num_threads;
+
+    /// \brief Number of tasks executed
+    long tasks;
+
+    /// \brief Number of tasks taken from another worker's queue
+    long steals;
+
+    /// \brief Total time workers spent with no task to run, in seconds
+    double idle_seconds;
+
+  };
+
+  /// \brief Work-stealing pool of worker threads that run tasks submitted through TaskGroups
+  ///
+  /// - Each worker has its own task queue. Tasks submitted from a worker go to the back of its
+  ///   queue and it runs them last-in first-out, so nested work stays on the thread that created
+  ///   it. Workers that run out of work steal the oldest tasks from the front of other workers'
+  ///   queues.
+  /// - Tasks submitted from other threads go to a shared queue, which workers take from when their
+  ///   own queue is empty
+  /// - A worker waiting on a TaskGroup runs other tasks until the group is finished, so tasks may
+  ///   create and wait on nested TaskGroups without blocking workers or starting more threads
+  /// - The destructor finishes all queued tasks before joining the workers
+  ///
+  /// Call using:
+  /// \code
+  /// TaskScheduler scheduler(num_threads);
+  /// TaskGroup group(scheduler);
+  /// for(long i = 0; i < N; ++i) {
+  ///   group.run([&, i]() {
+  ///     // may itself use a TaskGroup on 'scheduler'
+  ///     result[i] = calculate(i);
+  ///   });
+  /// }
+  /// group.wait();
+  /// \endcode
+  ///
+  class TaskScheduler {
+
+  public:
+
+    /// \brief Construct with 'num_threads' workers, see resolve_num_threads
+    explicit TaskScheduler(long num_threads = 0) :
+      m_pending(0),
+      m_stop(false) {
+      long N = resolve_num_threads(num_threads);
+      for(long i = 0; i < N; ++i) {
+        m_worker.push_back(std::unique_ptr<Worker>(new Worker()));
+      }
+      for(long i = 0; i < N; ++i) {
+        m_thread.push_back(std::thread(&TaskScheduler::_worker_loop, this, i));
+      }
+    }
+
+    TaskScheduler(const TaskScheduler &) = delete;
+    TaskScheduler &operator=(const TaskScheduler &) = delete;
+
+    /// \brief Finishes all queued tasks, then joins the workers
+    ~TaskScheduler() {
+      {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        m_stop = true;
+      }
+      m_sleep_cond.notify_all();
+      for(auto &t : m_thread) {
+        t.join();
+      }
+    }
+
+    /// \brief Number of worker threads
+    long size() const {
+      return m_worker.size();
+    }
+
+    /// \brief Task, steal, and idle time counters, summed over workers
+    TaskSchedulerStats stats() const {
+      TaskSchedulerStats result {size(), 0, 0, 0.0};
+      for(const auto &w : m_worker) {
+        result.tasks += w->tasks;
+        result.steals += w->steals;
+        result.idle_seconds += 1.0e-9 * w->idle_ns;
+      }
+      return result;
+    }
+
+    /// \brief Reset the counters returned by 'stats'
+    void reset_stats() {
+      for(auto &w : m_worker) {
+        w->tasks = 0;
+        w->steals = 0;
+        w->idle_ns = 0;
+      }
+    }
+
+  private:
+
+    friend class TaskGroup;
+
+    struct Task {
+      std::function<void()> f;
+      TaskGroup *group;
+    };
+
+    struct Worker {
+      Worker() : tasks(0), steals(0), idle_ns(0) {}
+
+      std::mutex mutex;
+      std::deque<Task> queue;
+
+      std::atomic<long> tasks;
+      std::atomic<long> steals;
+      std::atomic<long long> idle_ns;
+    };
+
+    struct ThisThread {
+      const TaskScheduler *scheduler;
+      long index;
+    };
+
+    static ThisThread &_this_thread() {
+      static thread_local ThisThread this_thread {nullptr, -1};
+      return this_thread;
+    }
+
+    /// \brief Index of the calling thread in this scheduler's workers, or -1 if it is not one of them
+    long _worker_index() const {
+      const ThisThread &t = _this_thread();
+      return (t.scheduler == this) ? t.index : -1;
+    }
+
+    static long long _elapsed_ns(std::chrono::steady_clock::time_point begin) {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    /// \brief Queue a task, on the calling worker's queue or on the shared queue
+    void _submit(Task task) {
+      long index = _worker_index();
+      Worker &w = (index < 0) ? m_shared : *m_worker[index];
+      {
+        std::lock_guard<std::mutex> lock(w.mutex);
+        w.queue.push_back(std::move(task));
+      }
+      {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        ++m_pending;
+      }
+      m_sleep_cond.notify_one();
+    }
+
+    /// \brief Take a task for worker 'index': its own newest task, else the oldest shared task,
+    ///        else the oldest task of another worker
+    bool _take(long index, Task &task) {
+      if(index >= 0 && _pop_back(*m_worker[index], task)) {
+        return true;
+      }
+      if(_pop_front(m_shared, task)) {
+        return true;
+      }
+      long N = size();
+      for(long i = 1; i <= N; ++i) {
+        long victim = (index + i) % N;
+        if(victim != index && _pop_front(*m_worker[victim], task)) {
+          if(index >= 0) {
+            ++m_worker[index]->steals;
+          }
+          return true;
+        }
+      }
+      return false;
+    }
+
+    bool _pop_back(Worker &w, Task &task) {
+      std::lock_guard<std::mutex> lock(w.mutex);
+      if(w.queue.empty()) {
+        return false;
+      }
+      task = std::move(w.queue.back());
+      w.queue.pop_back();
+      --m_pending;
+      return true;
+    }
+
+    bool _pop_front(Worker &w, Task &task) {
+      std::lock_guard<std::mutex> lock(w.mutex);
+      if(w.queue.empty()) {
+        return false;
+      }
+      task = std::move(w.queue.front());
+      w.queue.pop_front();
+      --m_pending;
+      return true;
+    }
+
+    /// \brief Run one queued task on worker 'index', returns false if there was none
+    bool _run_one(long index);
+
+    void _worker_loop(long index) {
+      _this_thread() = ThisThread {this, index};
+
+      Worker &w = *m_worker[index];
+      while(true) {
+        if(_run_one(index)) {
+          continue;
+        }
+        auto begin = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        m_sleep_cond.wait(lock, [&]() {
+          return m_stop || m_pending > 0;
+        });
+        bool stop = m_stop && m_pending == 0;
+        lock.unlock();
+        w.idle_ns += _elapsed_ns(begin);
+        if(stop) {
+          return;
+        }
+      }
+    }
+
+    std::vector<std::unique_ptr<Worker> > m_worker;
+    std::vector<std::thread> m_thread;
+
+    /// tasks submitted from threads that are not workers
+    Worker m_shared;
+
+    /// number of queued tasks, incremented while holding m_sleep_mutex so sleeping workers
+    /// do not miss new tasks
+    std::atomic<long> m_pending;
+
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_sleep_cond;
+    bool m_stop;
+
+  };
+
+  /// \brief A set of tasks run on a TaskScheduler that can be waited on together
+  ///
+  /// - 'run' may be called from any thread, including from tasks in this or other groups
+  /// - If a task throws, the first exception is rethrown by 'wait'. Other tasks still run.
+  /// - The destructor waits for unfinished tasks, ignoring exceptions
+  ///
+  class TaskGroup {
+
+  public:
+
+    explicit TaskGroup(TaskScheduler &scheduler) :
+      m_scheduler(scheduler),
+      m_unfinished(0) {}
+
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    ~TaskGroup() {
+      try {
+        wait();
+      }
+      catch(...) {}
+    }
+
+    /// \brief Queue 'f()' to run on the scheduler
+    template<typename Function>
+    void run(Function f) {
+      ++m_unfinished;
+      m_scheduler._submit(TaskScheduler::Task {std::function<void()>(std::move(f)), this});
+    }
+
+    /// \brief True if every task queued so far has finished
+    bool is_finished() const {
+      return m_unfinished == 0;
+    }
+
+    /// \brief Block until every task queued so far has finished
+    ///
+    /// - On a worker of the scheduler, other queued tasks are run while waiting
+    /// - Rethrows the first exception thrown by a task, once
+    void wait() {
+      long index = m_scheduler._worker_index();
+      if(index >= 0) {
+        TaskScheduler::Worker &w = *m_scheduler.m_worker[index];
+        while(m_unfinished > 0) {
+          if(!m_scheduler._run_one(index)) {
+            auto begin = std::chrono::steady_clock::now();
+            std::this_thread::yield();
+            w.idle_ns += TaskScheduler::_elapsed_ns(begin);
+          }
+        }
+      }
+      else {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_finished_cond.wait(lock, [&]() {
+          return m_unfinished == 0;
+        });
+      }
+
+      std::exception_ptr error;
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::swap(error, m_error);
+      }
+      if(error) {
+        std::rethrow_exception(error);
+      }
+    }
+
+  private:
+
+    friend class TaskScheduler;
+
+    void _finish_task(std::exception_ptr error) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if(error && !m_error) {
+        m_error = error;
+      }
+      if(--m_unfinished == 0) {
+        m_finished_cond.notify_all();
+      }
+    }
+
+    TaskScheduler &m_scheduler;
+    std::atomic<long> m_unfinished;
+
+    std::mutex m_mutex;
+    std::condition_variable m_finished_cond;
+    std::exception_ptr m_error;
+
+  };
+
+  inline bool TaskScheduler::_run_one(long index) {
+    Task task;
+    if(!_take(index, task)) {
+      return false;
+    }
+    std::exception_ptr error;
+    try {
+      task.f();
+    }
+    catch(...) {
+      error = std::current_exception();
+    }
+    ++m_worker[index]->tasks;
+    task.group->_finish_task(error);
+    return true;
+  }
+
+  /// \brief Evaluate 'f(begin, end)' for chunks [begin, end) of the range [0, N) on 'scheduler'
+  ///
+  /// Like parallel_for_chunks, but runs on the workers of an existing TaskScheduler, so it may be
+  /// nested inside other tasks without starting more threads
+  template<typename Function>
+  void parallel_for_chunks(TaskScheduler &scheduler, long N, long chunk_size, Function f) {
+    chunk_size = std::max(chunk_size, 1L);
+    TaskGroup group(scheduler);
+    for(long begin = 0; begin < N; begin += chunk_size) {
+      long end = std::min(begin + chunk_size, N);
+      group.run([&f, begin, end]() {
+        f(begin, end);
+      });
+    }
+    group.wait();
+  }
+
+}
+
+#endif
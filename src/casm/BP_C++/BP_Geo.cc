@@ -10,6 +10,8 @@
 
 #include "casm/BP_C++/BP_Geo.hh"
 
+#include <limits>
+
 namespace BP {
   //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
   //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -2079,6 +2081,64 @@ namespace BP {
 
   }
 
+  // distances from many points (each col of i1 is a point) to hull, as CH_dist_to_hull(const Eigen::VectorXd &)
+  //   dist(i) is the distance for point i, and facet(i) is the index (into CH_filter_facets) of the facet it was measured to
+  //
+  //   the facet normals are collected in one dense matrix, so that the distances of a block of points to all facets
+  //   are found with one matrix product, instead of one dot product per point and facet
+  //   if there are no facets, dist is NaN and facet is -1
+  void Geo::CH_dist_to_hull(const Eigen::MatrixXd &i1, Eigen::VectorXd &dist, Eigen::VectorXi &facet) const {
+
+    int i, j, block_begin, block_size;
+    int n_facets = CH_filter_facets.size();
+    int n_points = i1.cols();
+    const int max_block_size = 1024;
+    double min_d;
+
+    dist.resize(n_points);
+    facet.resize(n_points);
+    if(n_facets == 0) {
+      dist.setConstant(std::numeric_limits<double>::quiet_NaN());
+      facet.setConstant(-1);
+      return;
+    }
+
+    // the distance of point x to facet j is offset(j) - planes.row(j)*x, where
+    //   planes.row(j) is the outward normal of facet j, in scaled coordinates and divided by the cosine of its angle with 'bottom'
+    Eigen::MatrixXd planes(n_facets, dim);
+    Eigen::VectorXd offset(n_facets), length(n_facets);
+    double denom;
+    for(j = 0; j < n_facets; j++) {
+      denom = use_bottom ? bottom.dot(CH_filter_facets[j].out_norm) : 1.0;
+      planes.row(j) = CH_filter_facets[j].out_norm.cwiseQuotient(scale).transpose() / denom;
+      offset(j) = CH_filter_facets[j].pos.dot(CH_filter_facets[j].out_norm) / denom;
+      length(j) = use_bottom ? bottom.cwiseProduct(scale).norm() : CH_filter_facets[j].out_norm.cwiseProduct(scale).norm();
+    }
+
+    Eigen::MatrixXd d;
+    for(block_begin = 0; block_begin < n_points; block_begin += max_block_size) {
+      block_size = std::min(max_block_size, n_points - block_begin);
+
+      d.noalias() = planes * i1.middleCols(block_begin, block_size);
+
+      for(i = 0; i < block_size; i++) {
+
+        // keep the first facet of those within Geo_tol of the minimum distance, like CH_dist_to_hull(const Eigen::VectorXd &)
+        min_d = offset(0) - d(0, i);
+        facet(block_begin + i) = 0;
+        for(j = 1; j < n_facets; j++) {
+          if(offset(j) - d(j, i) < min_d - Geo_tol) {
+            min_d = offset(j) - d(j, i);
+            facet(block_begin + i) = j;
+          }
+        }
+
+        dist(block_begin + i) = min_d * length(facet(block_begin + i));
+      }
+    }
+
+  }
+
   //Eigen::VectorXd CH_vec_to_hull( const Eigen::VectorXd &i1)
 
   int Geo::CH_facets_size() {
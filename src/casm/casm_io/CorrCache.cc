@@ -0,0 +1,217 @@
+#include "casm/casm_io/CorrCache.hh"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace CASM {
+
+  namespace {
+    const char corr_cache_magic[8] = {'C', 'A', 'S', 'M', 'C', 'O', 'R', 'R'};
+  }
+
+  //*******************************************************************************************
+
+  CorrCache::~CorrCache() {
+    try {
+      close();
+    }
+    catch(...) {
+      _unmap();
+    }
+  }
+
+  //*******************************************************************************************
+
+  void CorrCache::open(const boost::filesystem::path &filename, std::uint64_t basis_hash, std::size_t corr_size) {
+    close();
+    m_index.clear();
+    m_N_rows = 0;
+
+    m_filename = filename;
+    m_read_only = false;
+    m_basis_hash = basis_hash;
+    m_corr_size = corr_size;
+
+    Header header;
+    if(!boost::filesystem::exists(m_filename) ||
+       !_read_header(header) ||
+       header.version != format_version ||
+       header.corr_size != m_corr_size ||
+       header.basis_hash != m_basis_hash) {
+      if(!m_filename.parent_path().empty()) {
+        boost::filesystem::create_directories(m_filename.parent_path());
+      }
+      _write_header();
+    }
+    else {
+      // drop a partially written final row, so appended rows stay aligned
+      std::size_t file_size = boost::filesystem::file_size(m_filename);
+      std::size_t N_rows = (file_size - sizeof(Header)) / _row_size();
+      if(file_size != sizeof(Header) + N_rows * _row_size()) {
+        boost::filesystem::resize_file(m_filename, sizeof(Header) + N_rows * _row_size());
+      }
+    }
+
+    _map();
+    m_is_open = true;
+  }
+
+  //*******************************************************************************************
+
+  void CorrCache::open_read_only(const boost::filesystem::path &filename) {
+    close();
+    m_index.clear();
+    m_N_rows = 0;
+
+    m_filename = filename;
+    m_read_only = true;
+
+    Header header;
+    if(!boost::filesystem::exists(m_filename) || !_read_header(header)) {
+      throw std::runtime_error(std::string("Error in CorrCache::open_read_only: ") + filename.string() + " is not a correlations cache file");
+    }
+    if(header.version != format_version) {
+      throw std::runtime_error(std::string("Error in CorrCache::open_read_only: ") + filename.string() + " has unsupported format version " + std::to_string(header.version));
+    }
+    m_basis_hash = header.basis_hash;
+    m_corr_size = header.corr_size;
+
+    _map();
+    m_is_open = true;
+  }
+
+  //*******************************************************************************************
+
+  void CorrCache::close() {
+    if(!m_is_open) {
+      return;
+    }
+    flush();
+    _unmap();
+    m_index.clear();
+    m_N_rows = 0;
+    m_is_open = false;
+  }
+
+  //*******************************************************************************************
+
+  const double *CorrCache::find(const std::string &configname) const {
+    auto it = m_index.find(fnv1a_hash(configname));
+    if(it == m_index.end()) {
+      return nullptr;
+    }
+    return _row(it->second.row);
+  }
+
+  //*******************************************************************************************
+
+  const double *CorrCache::find(const std::string &configname, std::uint64_t dof_hash) const {
+    auto it = m_index.find(fnv1a_hash(configname));
+    if(it == m_index.end() || it->second.dof_hash != dof_hash) {
+      return nullptr;
+    }
+    return _row(it->second.row);
+  }
+
+  //*******************************************************************************************
+
+  void CorrCache::append(const std::string &configname, std::uint64_t dof_hash, const double *corr) {
+    if(!m_is_open || m_read_only) {
+      throw std::runtime_error(std::string("Error in CorrCache::append: ") + m_filename.string() + " is not open for writing");
+    }
+    std::uint64_t key[2] = {fnv1a_hash(configname), dof_hash};
+    const char *key_begin = reinterpret_cast<const char *>(key);
+    const char *corr_begin = reinterpret_cast<const char *>(corr);
+    m_pending.insert(m_pending.end(), key_begin, key_begin + sizeof(key));
+    m_pending.insert(m_pending.end(), corr_begin, corr_begin + m_corr_size * sizeof(double));
+  }
+
+  //*******************************************************************************************
+
+  void CorrCache::flush() {
+    if(m_pending.empty()) {
+      return;
+    }
+
+    std::ofstream file(m_filename.string().c_str(), std::ios::binary | std::ios::app);
+    file.write(m_pending.data(), m_pending.size());
+    file.close();
+    if(file.fail()) {
+      throw std::runtime_error(std::string("Error in CorrCache::flush: could not write to ") + m_filename.string());
+    }
+    m_pending.clear();
+
+    _map();
+  }
+
+  //*******************************************************************************************
+
+  bool CorrCache::_read_header(Header &header) const {
+    std::ifstream file(m_filename.string().c_str(), std::ios::binary);
+    file.read(reinterpret_cast<char *>(&header), sizeof(Header));
+    return file.gcount() == sizeof(Header) &&
+           std::memcmp(header.magic, corr_cache_magic, sizeof(corr_cache_magic)) == 0 &&
+           header.header_size == sizeof(Header);
+  }
+
+  //*******************************************************************************************
+
+  void CorrCache::_write_header() const {
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    std::memcpy(header.magic, corr_cache_magic, sizeof(corr_cache_magic));
+    header.version = format_version;
+    header.header_size = sizeof(Header);
+    header.corr_size = m_corr_size;
+    header.basis_hash = m_basis_hash;
+
+    std::ofstream file(m_filename.string().c_str(), std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+    file.close();
+    if(file.fail()) {
+      throw std::runtime_error(std::string("Error in CorrCache: could not write ") + m_filename.string());
+    }
+  }
+
+  //*******************************************************************************************
+
+  void CorrCache::_map() {
+    _unmap();
+
+    std::size_t file_size = boost::filesystem::file_size(m_filename);
+    int fd = ::open(m_filename.string().c_str(), O_RDONLY);
+    if(fd < 0) {
+      throw std::runtime_error(std::string("Error in CorrCache: could not open ") + m_filename.string());
+    }
+    void *data = ::mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(data == MAP_FAILED) {
+      throw std::runtime_error(std::string("Error in CorrCache: could not map ") + m_filename.string());
+    }
+    m_data = static_cast<const char *>(data);
+    m_mapped_size = file_size;
+
+    // index rows appended since the last mapping
+    std::size_t N_rows = (file_size - sizeof(Header)) / _row_size();
+    for(std::size_t row = m_N_rows; row < N_rows; ++row) {
+      const std::uint64_t *key = reinterpret_cast<const std::uint64_t *>(m_data + sizeof(Header) + row * _row_size());
+      m_index[key[0]] = IndexEntry {row, key[1]};
+    }
+    m_N_rows = N_rows;
+  }
+
+  //*******************************************************************************************
+
+  void CorrCache::_unmap() {
+    if(m_data != nullptr) {
+      ::munmap(const_cast<char *>(m_data), m_mapped_size);
+      m_data = nullptr;
+      m_mapped_size = 0;
+    }
+  }
+
+}
@@ -0,0 +1,552 @@
+#include "casm/casm_io/jsonStream.hh"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace CASM {
+
+  namespace {
+
+    const char *event_name(jsonStreamReader::Event event) {
+      switch(event) {
+      case jsonStreamReader::BEGIN_OBJECT:
+        return "'{'";
+      case jsonStreamReader::END_OBJECT:
+        return "'}'";
+      case jsonStreamReader::BEGIN_ARRAY:
+        return "'['";
+      case jsonStreamReader::END_ARRAY:
+        return "']'";
+      case jsonStreamReader::KEY:
+        return "an object member";
+      case jsonStreamReader::VALUE:
+        return "a value";
+      case jsonStreamReader::END_OF_STREAM:
+        return "the end of the JSON";
+      }
+      return "";
+    }
+
+    int hex_to_num(int c) {
+      if(c >= '0' && c <= '9') return c - '0';
+      if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+      if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+      return 0;
+    }
+
+  }
+
+  //*******************************************************************************************
+
+  jsonStreamReader::jsonStreamReader(std::istream &stream) :
+    m_buf(stream.rdbuf()),
+    m_line(1),
+    m_after_key(false),
+    m_done(false),
+    m_event(END_OF_STREAM) {}
+
+  //*******************************************************************************************
+
+  jsonStreamReader::Event jsonStreamReader::next() {
+
+    if(m_level.empty()) {
+      if(m_done) {
+        _skip_ws();
+        return m_event = END_OF_STREAM;
+      }
+      return m_event = _read_value();
+    }
+
+    _skip_ws();
+    Level &top = m_level.back();
+
+    if(top.is_object) {
+      if(m_after_key) {
+        m_after_key = false;
+        return m_event = _read_value();
+      }
+      if(_peek() == '}') {
+        _get();
+        _close_level();
+        return m_event = END_OBJECT;
+      }
+      if(!top.first) {
+        _expect_char(',');
+        _skip_ws();
+      }
+      if(_peek() != '"') {
+        _error("expected an object member name");
+      }
+      _read_string(m_key);
+      _skip_ws();
+      _expect_char(':');
+      top.first = false;
+      m_after_key = true;
+      return m_event = KEY;
+    }
+
+    if(_peek() == ']') {
+      _get();
+      _close_level();
+      return m_event = END_ARRAY;
+    }
+    if(!top.first) {
+      _expect_char(',');
+    }
+    top.first = false;
+    return m_event = _read_value();
+  }
+
+  //*******************************************************************************************
+
+  void jsonStreamReader::expect(Event expected) {
+    Event found = next();
+    if(found != expected) {
+      _error(std::string("expected ") + event_name(expected) + ", found " + event_name(found));
+    }
+  }
+
+  //*******************************************************************************************
+
+  void jsonStreamReader::read(jsonParser &json) {
+    _read(next(), json);
+  }
+
+  //*******************************************************************************************
+
+  void jsonStreamReader::skip() {
+    Event first = next();
+    if(first != BEGIN_OBJECT && first != BEGIN_ARRAY) {
+      return;
+    }
+    std::size_t level = m_level.size();
+    while(m_level.size() >= level) {
+      next();
+    }
+  }
+
+  //*******************************************************************************************
+
+  int jsonStreamReader::_peek() {
+    return m_buf->sgetc();
+  }
+
+  //*******************************************************************************************
+
+  int jsonStreamReader::_get() {
+    int c = m_buf->sbumpc();
+    if(c == '\n') {
+      ++m_line;
+    }
+    return c;
+  }
+
+  //*******************************************************************************************
+
+  /// Skips whitespace and comments, as jsonParser::read does
+  void jsonStreamReader::_skip_ws() {
+    while(true) {
+      int c = _peek();
+      if(c == ' ' || c == '\n' || c == '\t' || c == '\r') {
+        _get();
+      }
+      else if(c == '/') {
+        _get();
+        c = _get();
+        if(c == '/') {
+          while((c = _get()) != '\n' && c != EOF) {}
+        }
+        else if(c == '*') {
+          int prev = 0;
+          while((c = _get()) != EOF && !(prev == '*' && c == '/')) {
+            prev = c;
+          }
+        }
+        else {
+          _error("unexpected '/'");
+        }
+      }
+      else {
+        return;
+      }
+    }
+  }
+
+  //*******************************************************************************************
+
+  void jsonStreamReader::_expect_char(char c) {
+    if(_peek() != c) {
+      _error(std::string("expected '") + c + "'");
+    }
+    _get();
+  }
+
+  //*******************************************************************************************
+
+  void jsonStreamReader::_error(const std::string &what) const {
+    throw std::runtime_error(std::string("Error reading JSON: ") + what + " at line " + std::to_string(m_line));
+  }
+
+  //*******************************************************************************************
+
+  jsonStreamReader::Event jsonStreamReader::_read_value() {
+    _skip_ws();
+    int c = _peek();
+    switch(c) {
+    case '{':
+      _get();
+      m_level.push_back(Level {true, true});
+      return BEGIN_OBJECT;
+    case '[':
+      _get();
+      m_level.push_back(Level {false, true});
+      return BEGIN_ARRAY;
+    case '"': {
+      std::string str;
+      _read_string(str);
+      to_json(str, m_value);
+      break;
+    }
+    case 't':
+      _read_literal("true");
+      to_json(true, m_value);
+      break;
+    case 'f':
+      _read_literal("false");
+      to_json(false, m_value);
+      break;
+    case 'n':
+      _read_literal("null");
+      m_value.put_null();
+      break;
+    case EOF:
+      _error("unexpected end of input");
+    default:
+      if(c == '-' || (c >= '0' && c <= '9')) {
+        _read_number();
+        break;
+      }
+      _error(std::string("unexpected character '") + char(c) + "'");
+    }
+    if(m_level.empty()) {
+      m_done = true;
+    }
+    return VALUE;
+  }
+
+  //*******************************************************************************************
+
+  /// Escapes are substituted as jsonParser::read does, including '\\uXXXX', which is read as a
+  /// single char, as jsonParser::print writes non-printable chars
+  void jsonStreamReader::_read_string(std::string &str) {
+    str.clear();
+    _get();
+    while(true) {
+      int c = _get();
+      if(c == '"') {
+        return;
+      }
+      if(c == EOF) {
+        _error("unterminated string");
+      }
+      if(c != '\\') {
+        str += char(c);
+        continue;
+      }
+      c = _get();
+      switch(c) {
+      case 't':
+        str += '\t';
+        break;
+      case 'b':
+        str += '\b';
+        break;
+      case 'f':
+        str += '\f';
+        break;
+      case 'n':
+        str += '\n';
+        break;
+      case 'r':
+        str += '\r';
+        break;
+      case '\\':
+        str += '\\';
+        break;
+      case '/':
+        str += '/';
+        break;
+      case '"':
+        str += '"';
+        break;
+      case 'x': {
+        int c1 = _get(), c2 = _get();
+        str += char((hex_to_num(c1) << 4) + hex_to_num(c2));
+        break;
+      }
+      case 'u': {
+        int value = 0;
+        for(int i = 0; i < 4; i++) {
+          value = (value << 4) + hex_to_num(_get());
+        }
+        str += char(value);
+        break;
+      }
+      default:
+        _error("invalid escape in string");
+      }
+    }
+  }
+
+  //*******************************************************************************************
+
+  /// Numbers with '.', 'e', or 'E' are real, others are int, or uint64 if too large for int64,
+  /// as for jsonParser::read
+  void jsonStreamReader::_read_number() {
+    m_number.clear();
+    bool is_real = false;
+    while(true) {
+      int c = _peek();
+      if((c >= '0' && c <= '9') || c == '-' || c == '+') {
+        m_number += char(_get());
+      }
+      else if(c == '.' || c == 'e' || c == 'E') {
+        is_real = true;
+        m_number += char(_get());
+      }
+      else {
+        break;
+      }
+    }
+
+    const char *begin = m_number.c_str();
+    char *end;
+    errno = 0;
+    if(is_real) {
+      double d = std::strtod(begin, &end);
+      if(end != begin + m_number.size()) {
+        _error("invalid number '" + m_number + "'");
+      }
+      *((json_spirit::mValue *) &m_value) = json_spirit::mValue(d);
+      return;
+    }
+
+    long long i = std::strtoll(begin, &end, 10);
+    if(end != begin + m_number.size()) {
+      _error("invalid number '" + m_number + "'");
+    }
+    if(errno == ERANGE && m_number[0] != '-') {
+      errno = 0;
+      unsigned long long u = std::strtoull(begin, &end, 10);
+      if(errno == ERANGE) {
+        _error("number out of range '" + m_number + "'");
+      }
+      *((json_spirit::mValue *) &m_value) = json_spirit::mValue(boost::uint64_t(u));
+      return;
+    }
+    if(errno == ERANGE) {
+      _error("number out of range '" + m_number + "'");
+    }
+    *((json_spirit::mValue *) &m_value) = json_spirit::mValue(boost::int64_t(i));
+  }
+
+  //*******************************************************************************************
+
+  void jsonStreamReader::_read_literal(const char *literal) {
+    for(const char *c = literal; *c; ++c) {
+      if(_get() != *c) {
+        _error(std::string("expected '") + literal + "'");
+      }
+    }
+  }
+
+  //*******************************************************************************************
+
+  void jsonStreamReader::_close_level() {
+    m_level.pop_back();
+    if(m_level.empty()) {
+      m_done = true;
+    }
+  }
+
+  //*******************************************************************************************
+
+  void jsonStreamReader::_read(Event first, json_spirit::mValue &json) {
+    switch(first) {
+    case VALUE:
+      json = m_value;
+      return;
+    case BEGIN_OBJECT: {
+      json = json_spirit::mObject();
+      json_spirit::mObject &obj = json.get_obj();
+      while(next() == KEY) {
+        json_spirit::mValue &member = obj[m_key];
+        _read(next(), member);
+      }
+      return;
+    }
+    case BEGIN_ARRAY: {
+      json = json_spirit::mArray();
+      json_spirit::mArray &arr = json.get_array();
+      Event event;
+      while((event = next()) != END_ARRAY) {
+        arr.push_back(json_spirit::mValue());
+        _read(event, arr.back());
+      }
+      return;
+    }
+    default:
+      _error(std::string("expected a value, found ") + event_name(first));
+    }
+  }
+
+  //*******************************************************************************************
+
+  jsonStreamWriter::jsonStreamWriter(std::ostream &stream, unsigned int indent, unsigned int prec) :
+    m_stream(stream),
+    m_indent(indent),
+    m_prec(prec),
+    m_after_key(false),
+    m_done(false) {}
+
+  //*******************************************************************************************
+
+  jsonStreamWriter &jsonStreamWriter::begin_object() {
+    _before_value("begin_object");
+    m_stream << '{';
+    m_level.push_back(Level {true, true});
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  jsonStreamWriter &jsonStreamWriter::end_object() {
+    if(m_level.empty() || !m_level.back().is_object || m_after_key) {
+      _error("end_object");
+    }
+    m_level.pop_back();
+    _new_line(m_level.size());
+    m_stream << '}';
+    _after_value();
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  jsonStreamWriter &jsonStreamWriter::begin_array() {
+    _before_value("begin_array");
+    m_stream << '[';
+    m_level.push_back(Level {false, true});
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  /// An empty array is printed as "[ ]", as by jsonParser::print
+  jsonStreamWriter &jsonStreamWriter::end_array() {
+    if(m_level.empty() || m_level.back().is_object) {
+      _error("end_array");
+    }
+    bool empty = m_level.back().first;
+    m_level.pop_back();
+    if(empty) {
+      m_stream << " ]";
+    }
+    else {
+      _new_line(m_level.size());
+      m_stream << ']';
+    }
+    _after_value();
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  jsonStreamWriter &jsonStreamWriter::key(const std::string &name) {
+    if(m_level.empty() || !m_level.back().is_object || m_after_key) {
+      _error("key '" + name + "'");
+    }
+    Level &top = m_level.back();
+    if(!top.first) {
+      m_stream << ',';
+    }
+    top.first = false;
+    _new_line(m_level.size());
+    m_stream << '"' << json_spirit::add_esc_chars(name, false, false) << "\" : ";
+    m_after_key = true;
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  /// The value is printed by jsonParser::print, then indented to the current level
+  jsonStreamWriter &jsonStreamWriter::value(const jsonParser &json) {
+    _before_value("value");
+
+    m_ss.str("");
+    m_ss.clear();
+    json.print(m_ss, m_indent, m_prec);
+    const std::string &str = m_ss.str();
+
+    std::size_t begin = 0, end;
+    while((end = str.find('\n', begin)) != std::string::npos) {
+      m_stream.write(str.data() + begin, end - begin);
+      _new_line(m_level.size());
+      begin = end + 1;
+    }
+    m_stream.write(str.data() + begin, str.size() - begin);
+
+    _after_value();
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  void jsonStreamWriter::_before_value(const std::string &what) {
+    if(m_level.empty()) {
+      if(m_done) {
+        _error(what + " after the end of the top-level value");
+      }
+      return;
+    }
+    Level &top = m_level.back();
+    if(top.is_object) {
+      if(!m_after_key) {
+        _error(what + " in an object without a key");
+      }
+      m_after_key = false;
+      return;
+    }
+    if(!top.first) {
+      m_stream << ',';
+    }
+    top.first = false;
+    _new_line(m_level.size());
+  }
+
+  //*******************************************************************************************
+
+  void jsonStreamWriter::_after_value() {
+    if(m_level.empty()) {
+      m_done = true;
+    }
+  }
+
+  //*******************************************************************************************
+
+  void jsonStreamWriter::_new_line(std::size_t level) {
+    m_stream << '\n';
+    for(std::size_t i = 0; i < level * m_indent; ++i) {
+      m_stream << ' ';
+    }
+  }
+
+  //*******************************************************************************************
+
+  void jsonStreamWriter::_error(const std::string &what) const {
+    throw std::runtime_error("Error in jsonStreamWriter: unexpected " + what);
+  }
+
+}
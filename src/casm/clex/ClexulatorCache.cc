@@ -0,0 +1,325 @@
+#include "casm/clex/ClexulatorCache.hh"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "casm/misc/Hash.hh"
+#include "casm/system/ParallelFor.hh"
+#include "casm/system/Popen.hh"
+
+namespace CASM {
+
+  namespace Clexulator_impl {
+
+    namespace fs = boost::filesystem;
+
+    namespace {
+
+      std::string _read_file(const fs::path &filename) {
+        std::ifstream file(filename.string().c_str(), std::ios::binary);
+        if(!file) {
+          throw std::runtime_error(std::string("Error reading Clexulator source: could not open ") + filename.string());
+        }
+        std::stringstream ss;
+        ss << file.rdbuf();
+        return ss.str();
+      }
+
+      void _write_file(const fs::path &filename, const std::string &text) {
+        std::ofstream file(filename.string().c_str(), std::ios::binary);
+        file << text;
+        file.close();
+        if(!file) {
+          throw std::runtime_error(std::string("Error building Clexulator: could not write ") + filename.string());
+        }
+      }
+
+      /// \brief Run 'command', throwing std::runtime_error with its output if it fails
+      void _run(const std::string &command) {
+        Popen p;
+        p.popen(command + " 2>&1");
+        if(!WIFEXITED(p.status()) || WEXITSTATUS(p.status()) != 0) {
+          throw std::runtime_error(
+            std::string("Error building Clexulator, command failed:\n  ") + command + "\n" + p.gets());
+        }
+      }
+
+      std::string _quote(const fs::path &path) {
+        return "\"" + path.string() + "\"";
+      }
+
+      std::string _unquote(const std::string &str) {
+        if(str.size() >= 2 && (str[0] == '"' || str[0] == '\'') && str.back() == str[0]) {
+          return str.substr(1, str.size() - 2);
+        }
+        return str;
+      }
+
+      /// \brief Directories of the '-I' options in 'compile_options'
+      std::vector<fs::path> _include_dirs(const std::string &compile_options) {
+        std::vector<fs::path> result;
+        std::istringstream in(compile_options);
+        std::string token;
+        bool is_dir = false;
+        while(in >> token) {
+          if(is_dir) {
+            result.push_back(_unquote(token));
+            is_dir = false;
+          }
+          else if(token == "-I") {
+            is_dir = true;
+          }
+          else if(token.compare(0, 2, "-I") == 0) {
+            result.push_back(_unquote(token.substr(2)));
+          }
+        }
+        return result;
+      }
+
+      /// \brief Names of the headers in '#include "casm/..."' lines of 'text'
+      std::vector<std::string> _casm_includes(const std::string &text) {
+        std::vector<std::string> result;
+        std::istringstream in(text);
+        std::string line;
+        while(std::getline(in, line)) {
+          std::size_t pos = line.find_first_not_of(" \t");
+          if(pos == std::string::npos || line[pos] != '#') {
+            continue;
+          }
+          pos = line.find_first_not_of(" \t", pos + 1);
+          if(pos == std::string::npos || line.compare(pos, 7, "include") != 0) {
+            continue;
+          }
+          pos = line.find_first_not_of(" \t", pos + 7);
+          if(pos == std::string::npos || line[pos] != '"') {
+            continue;
+          }
+          std::size_t end = line.find('"', pos + 1);
+          if(end != std::string::npos && line.compare(pos + 1, 5, "casm/") == 0) {
+            result.push_back(line.substr(pos + 1, end - pos - 1));
+          }
+        }
+        return result;
+      }
+
+      /// \brief Hash of the CASM headers included by 'source', directly or through other CASM
+      ///        headers, as found in the '-I' directories of 'compile_options'
+      ///
+      /// Headers that are not found are left to the compiler to find, or not.
+      std::uint64_t _headers_hash(const std::string &source, const std::string &compile_options) {
+        std::vector<fs::path> include_dirs = _include_dirs(compile_options);
+
+        // sorted by name, so that the hash does not depend on the order of includes
+        std::map<std::string, std::string> headers;
+        std::vector<std::string> todo = _casm_includes(source);
+        while(!todo.empty()) {
+          std::string name = todo.back();
+          todo.pop_back();
+          if(headers.count(name)) {
+            continue;
+          }
+          std::string &text = headers[name];
+          for(const fs::path &dir : include_dirs) {
+            if(fs::is_regular_file(dir / name)) {
+              text = _read_file(dir / name);
+              std::vector<std::string> included = _casm_includes(text);
+              todo.insert(todo.end(), included.begin(), included.end());
+              break;
+            }
+          }
+        }
+
+        std::uint64_t hash = fnv1a_hash(std::string());
+        for(const auto &header : headers) {
+          hash = fnv1a_hash(header.first.c_str(), header.first.size() + 1, hash);
+          hash = fnv1a_hash(header.second.c_str(), header.second.size() + 1, hash);
+        }
+        return hash;
+      }
+
+      /// \brief Contents of the "options" file, stored with a library to check for hash collisions
+      std::string _options_text(const std::string &compile_options,
+                                const std::string &so_options,
+                                std::uint64_t headers_hash) {
+        std::stringstream ss;
+        ss << compile_options << "\n" << so_options << "\nabi_version " << abi_version()
+           << "\nheaders " << std::hex << headers_hash << "\n";
+        return ss.str();
+      }
+
+      /// \brief Build into 'build_dir', which must not exist
+      void _build(std::string name,
+                  const fs::path &build_dir,
+                  const fs::path &source_path,
+                  const std::string &source,
+                  const std::string &compile_options,
+                  const std::string &so_options,
+                  std::uint64_t headers_hash,
+                  long num_threads) {
+
+        fs::create_directories(build_dir);
+        _write_file(build_dir / (name + ".cc"), source);
+        _write_file(build_dir / "options", _options_text(compile_options, so_options, headers_hash));
+
+        std::vector<std::string> tu = split_translation_units(source, source_path);
+        std::vector<fs::path> tu_src, tu_obj;
+        for(std::size_t i = 0; i < tu.size(); i++) {
+          tu_src.push_back(build_dir / (name + "_" + std::to_string(i) + ".cc"));
+          tu_obj.push_back(build_dir / (name + "_" + std::to_string(i) + ".o"));
+          _write_file(tu_src[i], tu[i]);
+        }
+
+        // compile the largest translation units first, to finish as early as possible
+        std::vector<long> order(tu.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](long a, long b) {
+          return tu[a].size() > tu[b].size();
+        });
+
+        parallel_for_chunks(tu.size(), 1, num_threads, [&](long thread, long begin, long end) {
+          for(long i = begin; i < end; ++i) {
+            _run(compile_options + " -o " + _quote(tu_obj[order[i]]) + " -c " + _quote(tu_src[order[i]]));
+          }
+        });
+
+        std::string objects;
+        for(std::size_t i = 0; i < tu_obj.size(); i++) {
+          objects += " " + _quote(tu_obj[i]);
+        }
+        _run(so_options + " -o " + _quote(build_dir / (name + ".so")) + objects);
+
+        for(std::size_t i = 0; i < tu.size(); i++) {
+          fs::remove(tu_src[i]);
+          fs::remove(tu_obj[i]);
+        }
+      }
+
+    }
+
+    //*******************************************************************************************
+
+    std::vector<std::string> split_translation_units(const std::string &source, const fs::path &source_path) {
+
+      std::string prefix = translation_unit_prefix();
+      std::string line_file = "\"" + source_path.string() + "\"";
+
+      std::string prelude = "#line 1 " + line_file + "\n";
+      std::vector<std::string> result;
+      bool in_prelude = true;
+
+      std::istringstream in(source);
+      std::string line;
+      long line_number = 0;
+      while(std::getline(in, line)) {
+        line_number++;
+        if(line.compare(0, prefix.size(), prefix) == 0) {
+          in_prelude = false;
+          result.push_back(prelude + "#line " + std::to_string(line_number) + " " + line_file + "\n");
+        }
+        if(in_prelude) {
+          prelude += line + "\n";
+        }
+        else {
+          result.back() += line + "\n";
+        }
+      }
+
+      if(in_prelude) {
+        result.push_back(source);
+      }
+      return result;
+    }
+
+    //*******************************************************************************************
+
+    fs::path clexulator_cache_dir() {
+      const char *dir = std::getenv("CASM_CLEXULATOR_CACHE");
+      if(dir && *dir) {
+        return fs::path(dir);
+      }
+      dir = std::getenv("XDG_CACHE_HOME");
+      if(dir && *dir) {
+        return fs::path(dir) / "casm" / "clexulator";
+      }
+      dir = std::getenv("HOME");
+      if(dir && *dir) {
+        return fs::path(dir) / ".cache" / "casm" / "clexulator";
+      }
+      return fs::path();
+    }
+
+    //*******************************************************************************************
+
+    fs::path build_clexulator(std::string name,
+                              const fs::path &dirpath,
+                              std::string compile_options,
+                              std::string so_options,
+                              long num_threads) {
+
+      fs::path source_path = fs::absolute(dirpath / (name + ".cc"));
+      std::string source = _read_file(source_path);
+
+      std::uint64_t hash = fnv1a_hash(source);
+      hash = fnv1a_hash(compile_options.c_str(), compile_options.size() + 1, hash);
+      hash = fnv1a_hash(so_options.c_str(), so_options.size() + 1, hash);
+      hash = fnv1a_hash(std::to_string(abi_version()), hash);
+
+      // the included CASM headers may change without a change in abi_version, e.g. in inline code
+      std::uint64_t headers_hash = _headers_hash(source, compile_options);
+      hash = fnv1a_hash(&headers_hash, sizeof(headers_hash), hash);
+      std::stringstream ss;
+      ss << name << "_" << std::hex << hash;
+
+      fs::path cache_dir = clexulator_cache_dir();
+      if(cache_dir.empty()) {
+        cache_dir = dirpath;
+      }
+
+      // in the unlikely event of a hash collision, the next free suffix is used
+      for(int i = 0; ; i++) {
+        fs::path lib_dir = cache_dir / (ss.str() + (i ? "_" + std::to_string(i) : std::string()));
+
+        if(!fs::exists(lib_dir)) {
+          fs::path tmp_dir = cache_dir / (lib_dir.filename().string() + ".tmp" + std::to_string(getpid()));
+          fs::remove_all(tmp_dir);
+          try {
+            _build(name, tmp_dir, source_path, source, compile_options, so_options, headers_hash, num_threads);
+          }
+          catch(...) {
+            fs::remove_all(tmp_dir);
+            throw;
+          }
+
+          // if another process finished the same library first, use that one
+          boost::system::error_code ec;
+          fs::rename(tmp_dir, lib_dir, ec);
+          if(ec) {
+            fs::remove_all(tmp_dir);
+            if(!fs::exists(lib_dir / (name + ".so"))) {
+              throw std::runtime_error(
+                std::string("Error building Clexulator: could not create ") + lib_dir.string() + ": " + ec.message());
+            }
+          }
+          return lib_dir / name;
+        }
+
+        if(fs::exists(lib_dir / (name + ".so")) &&
+           fs::exists(lib_dir / (name + ".cc")) &&
+           fs::exists(lib_dir / "options") &&
+           _read_file(lib_dir / (name + ".cc")) == source &&
+           _read_file(lib_dir / "options") == _options_text(compile_options, so_options, headers_hash)) {
+          return lib_dir / name;
+        }
+      }
+    }
+
+  }
+
+}
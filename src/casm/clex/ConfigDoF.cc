@@ -1,5 +1,9 @@
 #include "casm/CASM_global_definitions.hh"
 #include "casm/clex/ConfigDoF.hh"
+
+#include <cmath>
+#include <boost/functional/hash.hpp>
+#include "casm/misc/Hash.hh"
 #include "casm/symmetry/PermuteIterator.hh"
 #include "casm/clex/Correlation.hh"
 #include "casm/clex/Clexulator.hh"
@@ -11,7 +15,8 @@ namespace CASM {
   ConfigDoF::ConfigDoF(Index _N) :
     m_N(_N),
     m_deformation(Eigen::Matrix3d::Identity()),
-    m_is_strained(false) {
+    m_is_strained(false),
+    m_tol(TOL) {
   }
 
   //*******************************************************************************
@@ -20,7 +25,8 @@ namespace CASM {
     m_N(_occ.size()),
     m_occupation(_occ),
     m_deformation(Eigen::Matrix3d::Identity()),
-    m_is_strained(false) {
+    m_is_strained(false),
+    m_tol(TOL) {
   }
 
   //*******************************************************************************
@@ -30,7 +36,8 @@ namespace CASM {
     m_occupation(_occ),
     m_displacement(_disp),
     m_deformation(_deformation),
-    m_is_strained(false) {
+    m_is_strained(false),
+    m_tol(TOL) {
     if(size() != occupation().size() || size() != displacement().cols()) {
       std::cerr << "CRITICAL ERROR: Attempting to initialize ConfigDoF with data structures of incompatible size: \n"
                 << "                occupation().size() = " << occupation().size() << " and displacement().size() = " << displacement().size() << "\n"
@@ -72,6 +79,39 @@ namespace CASM {
 
   //*******************************************************************************
 
+  std::size_t ConfigDoF::hash(long bucket_shift) const {
+    std::size_t seed = boost::hash_range(occupation().begin(), occupation().end());
+
+    // ConfigDoF that compare equal have each displacement and deformation component equal
+    //   within m_tol, so their fingerprints differ by less than (3*size() + 9)*m_tol. Using buckets
+    //   twice that wide ensures equal ConfigDoF are never more than one bucket apart.
+    double fingerprint = (deformation() - Eigen::Matrix3d::Identity()).sum();
+    if(has_displacement()) {
+      fingerprint += displacement().sum();
+    }
+    double width = 2.0 * (3 * size() + 9) * m_tol;
+    long bucket = std::floor(fingerprint / width) + bucket_shift;
+
+    boost::hash_combine(seed, bucket);
+    return seed;
+  }
+
+  //*******************************************************************************
+
+  std::uint64_t ConfigDoF::fingerprint() const {
+    std::uint64_t result = fnv1a_hash(&m_N, sizeof(m_N));
+    for(Index i = 0; i < occupation().size(); i++) {
+      int occ_i = occupation()[i];
+      result = fnv1a_hash(&occ_i, sizeof(occ_i), result);
+    }
+    if(has_displacement()) {
+      result = fnv1a_hash(displacement().data(), displacement().size() * sizeof(double), result);
+    }
+    return fnv1a_hash(deformation().data(), deformation().size() * sizeof(double), result);
+  }
+
+  //*******************************************************************************
+
   void ConfigDoF::clear() {
     m_N = 0;
     _occupation().clear();
@@ -715,10 +755,13 @@ namespace CASM {
     std::vector<double> tcorr(clexulator.corr_size(), 0.0);
     //std::vector<double> corr(clexulator.corr_size(), 0.0);
 
+    //Holds the neighbor list, if the Supercell does not store them
+    std::vector<SuperNeighborList::value_type> nlist_buffer(scel.nlist().nlist_size());
+
     for(int v = 0; v < scel_vol; v++) {
 
       //Point the Clexulator to the right neighborhood
-      clexulator.set_nlist(scel.get_nlist(v).begin());
+      clexulator.set_nlist(scel.nlist().sites(v, nlist_buffer.data()));
 
       //Fill up contributions
       clexulator.calc_global_corr_contribution(&tcorr[0]);
@@ -738,6 +781,93 @@ namespace CASM {
     return correlations;
   }
 
+  /// \brief Returns the cluster expansion per unit cell, eci*correlations, using an 'energy_clexulator'
+  ///        generated with the ECI. Supercell needs a correctly populated neighbor list.
+  double clex_energy(const ConfigDoF &configdof, const Supercell &scel, EnergyClexulator &energy_clexulator) {
+
+    int scel_vol = scel.volume();
+
+    energy_clexulator.set_config_occ(configdof.occupation().begin());
+
+    //Holds the neighbor list, if the Supercell does not store them
+    std::vector<SuperNeighborList::value_type> nlist_buffer(scel.nlist().nlist_size());
+
+    double energy = 0.0;
+    for(int v = 0; v < scel_vol; v++) {
+      energy_clexulator.set_nlist(scel.nlist().sites(v, nlist_buffer.data()));
+      energy += energy_clexulator.calc_energy();
+    }
+
+    return energy / (double) scel_vol;
+  }
+
+  namespace {
+    /// Number of ConfigDoF evaluated together for each neighborhood in the batched correlations()
+    const Index corr_batch_size = 64;
+  }
+
+  /// \brief Fills rows [row_begin, row_begin + configdof_list.size()) of 'corr_mat' with correlations
+  ///        for a batch of ConfigDoF that all belong to 'scel'
+  ///
+  /// - 'corr_mat' must already have at least row_begin + configdof_list.size() rows and
+  ///   clexulator.corr_size() columns
+  /// - Supercell needs a correctly populated neighbor list
+  /// - ConfigDoF are evaluated in blocks: for each unit cell the neighbor list is set once and then
+  ///   used for every ConfigDoF in the block, so it stays in cache, and a single scratch array
+  ///   holds the contribution from each neighborhood
+  /// - Results are identical to calling correlations(const ConfigDoF&, const Supercell&, Clexulator&)
+  ///   on each ConfigDoF
+  void correlations(const std::vector<const ConfigDoF *> &configdof_list,
+                    const Supercell &scel,
+                    Clexulator &clexulator,
+                    CorrMatrix &corr_mat,
+                    Index row_begin) {
+
+    //Size of the supercell will be used for normalizing correlations to a per primitive cell value
+    int scel_vol = scel.volume();
+    Index corr_size = clexulator.corr_size();
+    Index N_config = configdof_list.size();
+
+    assert(corr_mat.cols() == corr_size && corr_mat.rows() >= row_begin + N_config);
+
+    corr_mat.block(row_begin, 0, N_config, corr_size).setZero();
+
+    //Holds contribution to global correlations from a particular neighborhood, shared by all ConfigDoF
+    std::vector<double> tcorr(corr_size, 0.0);
+
+    //Holds the neighbor list, if the Supercell does not store them
+    std::vector<SuperNeighborList::value_type> nlist_buffer(scel.nlist().nlist_size());
+
+    for(Index block_begin = 0; block_begin < N_config; block_begin += corr_batch_size) {
+      Index block_end = std::min(block_begin + corr_batch_size, N_config);
+
+      for(int v = 0; v < scel_vol; v++) {
+
+        //Point the Clexulator to the right neighborhood, once for the whole block
+        clexulator.set_nlist(scel.nlist().sites(v, nlist_buffer.data()));
+
+        for(Index c = block_begin; c < block_end; c++) {
+
+          //Inform Clexulator of the bitstring
+          clexulator.set_config_occ(configdof_list[c]->occupation().begin());
+
+          //Fill up contributions
+          clexulator.calc_global_corr_contribution(tcorr.data());
+
+          //Add contributions to total correlations
+          double *corr_row = &corr_mat(row_begin + c, 0);
+          for(Index i = 0; i < corr_size; i++) {
+            corr_row[i] += tcorr[i];
+          }
+        }
+      }
+    }
+
+    // normalize by supercell volume
+    corr_mat.block(row_begin, 0, N_config, corr_size) /= (double) scel_vol;
+
+  }
+
 
 
   //ConfigDoF &apply(const Permutation &perm, ConfigDoF &dof) {
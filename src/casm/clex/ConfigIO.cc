@@ -83,6 +83,64 @@ namespace CASM {
     }
 
 
+    //****************************************************************************************
+
+    void CorrBatch::prefetch(const std::vector<const Configuration *> &_configs, Clexulator &clexulator) {
+      m_row.clear();
+
+      if(m_cache == nullptr) {
+        correlations(_configs, clexulator, m_corr, m_num_threads);
+        for(Index i = 0; i < _configs.size(); i++) {
+          m_row[_configs[i]] = &m_corr(i, 0);
+        }
+        return;
+      }
+
+      // evaluate only Configurations that are not in the cache, or whose DoF changed
+      std::vector<std::string> name(_configs.size());
+      std::vector<std::uint64_t> fingerprint(_configs.size());
+      std::vector<Index> missing;
+      std::vector<const Configuration *> missing_configs;
+      for(Index i = 0; i < _configs.size(); i++) {
+        name[i] = _configs[i]->name();
+        fingerprint[i] = _configs[i]->configdof().fingerprint();
+        if(m_cache->find(name[i], fingerprint[i]) == nullptr) {
+          missing.push_back(i);
+          missing_configs.push_back(_configs[i]);
+        }
+      }
+
+      if(missing.size()) {
+        correlations(missing_configs, clexulator, m_corr, m_num_threads);
+        for(Index j = 0; j < missing.size(); j++) {
+          m_cache->append(name[missing[j]], fingerprint[missing[j]], &m_corr(j, 0));
+        }
+        m_cache->flush();
+      }
+
+      // flush remaps the cache, so look up rows only after it
+      for(Index i = 0; i < _configs.size(); i++) {
+        m_row[_configs[i]] = m_cache->find(name[i], fingerprint[i]);
+      }
+    }
+
+    //****************************************************************************************
+
+    void CorrBatch::prefetch_cached(const std::vector<const Configuration *> &_configs) {
+      m_row.clear();
+
+      if(m_cache == nullptr) {
+        return;
+      }
+
+      for(Index i = 0; i < _configs.size(); i++) {
+        const double *corr = m_cache->find(_configs[i]->name(), _configs[i]->configdof().fingerprint());
+        if(corr != nullptr) {
+          m_row[_configs[i]] = corr;
+        }
+      }
+    }
+
     //****************************************************************************************
 
     std::string CorrConfigFormatter::long_header(const Configuration &_tmplt) const {
@@ -112,20 +170,38 @@ namespace CASM {
 
     //****************************************************************************************
 
+    void CorrConfigFormatter::prefetch(const std::vector<const Configuration *> &_configs) const {
+      m_batch.prefetch(_configs, m_clexulator);
+    }
+
+    //****************************************************************************************
+
+    const double *CorrConfigFormatter::_corr(const Configuration &_config) const {
+      const double *corr = m_batch.find(_config);
+      if(corr == nullptr) {
+        m_tcorr = correlations(_config, m_clexulator);
+        corr = m_tcorr.begin();
+      }
+      return corr;
+    }
+
+    //****************************************************************************************
+
     void CorrConfigFormatter::inject(const Configuration &_config, DataStream &_stream, Index) const {
 
-      Correlation corr = correlations(_config, m_clexulator);
+      const double *corr = _corr(_config);
+      Index corr_size = m_clexulator.corr_size();
 
       //Cases
       if(_index_rules().size() == 0) {
-        for(Index nc = 0; nc < corr.size(); nc++) {
+        for(Index nc = 0; nc < corr_size; nc++) {
           _stream << corr[nc];
         }
       }
       else if(_index_rules()[0].size() == 1) {
         IndexContainer::const_iterator it(_index_rules().cbegin()), it_end(_index_rules().cend());
         for(; it != it_end; ++it) {
-          if((*it)[0] < corr.size())
+          if((*it)[0] < corr_size)
             _stream <<  corr[(*it)[0]];
           else
             _stream <<  double(NAN) << DataStream::failbit;
@@ -138,21 +214,22 @@ namespace CASM {
 
     void CorrConfigFormatter::print(const Configuration &_config, std::ostream &_stream, Index) const {
 
-      Correlation corr = correlations(_config, m_clexulator);
+      const double *corr = _corr(_config);
+      Index corr_size = m_clexulator.corr_size();
 
       _stream.flags(std::ios::showpoint | std::ios::fixed | std::ios::right);
       _stream.precision(8);
 
       //Cases
       if(_index_rules().size() == 0) {
-        for(Index nc = 0; nc < corr.size(); nc++) {
+        for(Index nc = 0; nc < corr_size; nc++) {
           _stream << ' ' << std::setw(16) << corr[nc];
         }
       }
       else if(_index_rules()[0].size() == 1) {
         IndexContainer::const_iterator it(_index_rules().cbegin()), it_end(_index_rules().cend());
         for(; it != it_end; ++it) {
-          if((*it)[0] < corr.size())
+          if((*it)[0] < corr_size)
             _stream <<  ' ' << std::setw(16) << corr[(*it)[0]];
           else
             _stream <<  std::setw(17) << "unknown";
@@ -164,7 +241,11 @@ namespace CASM {
     //****************************************************************************************
 
     jsonParser &CorrConfigFormatter::to_json(const Configuration &_config, jsonParser &json)const {
-      json = correlations(_config, m_clexulator);
+      const double *corr = _corr(_config);
+      json.put_array();
+      for(Index nc = 0; nc < m_clexulator.corr_size(); nc++) {
+        json.push_back(corr[nc]);
+      }
       return json;
     }
 
@@ -172,7 +253,9 @@ namespace CASM {
     void CorrConfigFormatter::init(const Configuration &_tmplt) const {
       if(!m_clexulator.initialized()) {
         m_clexulator = _tmplt.get_primclex().global_clexulator();
+        m_batch.set_cache(_tmplt.get_primclex().global_corr_cache());
       }
+      m_batch.set_num_threads(_tmplt.get_primclex().num_threads());
     };
 
     //****************************************************************************************
@@ -188,9 +271,25 @@ namespace CASM {
     void ClexConfigFormatter::init(const Configuration &_tmplt) const {
       if(!m_clexulator.initialized()) {
         m_clexulator = _tmplt.get_primclex().global_clexulator();
+        m_batch.set_cache(_tmplt.get_primclex().global_corr_cache());
       }
 
       m_eci = _tmplt.get_primclex().global_eci(m_clex_name);
+      m_num_threads = _tmplt.get_primclex().num_threads();
+      m_batch.set_num_threads(m_num_threads);
+
+      // evaluate with ECI folded in when there are no correlations to reuse, unless nothing
+      // is to be compiled
+      m_energy_clexulator = EnergyClexulator();
+      if(_tmplt.get_primclex().settings().clexulator_type() != "table") {
+        try {
+          m_energy_clexulator = _tmplt.get_primclex().global_energy_clexulator(m_clex_name);
+        }
+        catch(std::exception &e) {
+          std::cerr << "Warning: could not use energy clexulator for " << m_clex_name << ": " << e.what() << std::endl;
+          m_energy_clexulator = EnergyClexulator();
+        }
+      }
     };
 
     //****************************************************************************************
@@ -201,8 +300,49 @@ namespace CASM {
 
     //****************************************************************************************
 
+    void ClexConfigFormatter::prefetch(const std::vector<const Configuration *> &_configs) const {
+      m_energy.clear();
+      if(!m_energy_clexulator.initialized()) {
+        m_batch.prefetch(_configs, m_clexulator);
+        return;
+      }
+
+      // reuse cached correlations, and evaluate the others with the energy clexulator
+      m_batch.prefetch_cached(_configs);
+      std::vector<const Configuration *> uncached;
+      for(const Configuration *config : _configs) {
+        if(m_batch.find(*config) == nullptr) {
+          uncached.push_back(config);
+        }
+      }
+      std::vector<double> energy;
+      clex_energy(uncached, m_energy_clexulator, energy, m_num_threads);
+      for(Index i = 0; i < uncached.size(); i++) {
+        m_energy[uncached[i]] = energy[i];
+      }
+    }
+
+    //****************************************************************************************
+
+    double ClexConfigFormatter::_clex(const Configuration &_config) const {
+      const double *corr = m_batch.find(_config);
+      if(corr != nullptr) {
+        return m_eci * corr;
+      }
+      auto it = m_energy.find(&_config);
+      if(it != m_energy.end()) {
+        return it->second;
+      }
+      if(m_energy_clexulator.initialized()) {
+        return clex_energy(_config.configdof(), _config.get_supercell(), m_energy_clexulator);
+      }
+      return m_eci * correlations(_config, m_clexulator);
+    }
+
+    //****************************************************************************************
+
     void ClexConfigFormatter::inject(const Configuration &_config, DataStream &_stream, Index) const {
-      _stream << m_eci *correlations(_config, m_clexulator);
+      _stream << _clex(_config);
     }
 
     //****************************************************************************************
@@ -211,14 +351,14 @@ namespace CASM {
       _stream.flags(std::ios::showpoint | std::ios::fixed | std::ios::right);
       _stream.precision(8);
 
-      _stream << m_eci *correlations(_config, m_clexulator);
+      _stream << _clex(_config);
 
     }
 
     //****************************************************************************************
 
     jsonParser &ClexConfigFormatter::to_json(const Configuration &_config, jsonParser &json)const {
-      json = m_eci * correlations(_config, m_clexulator);
+      json = _clex(_config);
       return json;
     }
 
@@ -1,4 +1,6 @@
 #include <functional>
+#include <iomanip>
+#include "casm/misc/Hash.hh"
 #include "casm/casm_io/EigenDataStream.hh"
 #include "casm/clex/ConfigIterator.hh"
 #include "casm/clex/ConfigIO.hh"
@@ -11,6 +13,12 @@
 namespace CASM {
 
   namespace ConfigIO_impl {
+
+    namespace {
+      /// Number of hull files kept in the cache, the most recently used
+      const Index max_hull_files = 8;
+    }
+
     void BaseHullConfigFormatter::init(const Configuration &_tmplt) const {
       // initialize hull_props to look something like:
       //      {"comp", "formation_energy", "configname"}
@@ -70,20 +78,43 @@ namespace CASM {
       Eigen::MatrixXd reduced_mat(m_projection * mat_wrapper.matrix().transpose());
       //std::cout << "Size after: " << reduced_mat.rows() << ", " << reduced_mat.cols() << "\n";
       //std::cout << "reduced_mat is \n" << reduced_mat.transpose() << "\n\n and projection is \n" << m_projection << "\n\n";
-      m_hull.set_verbosity(0);
 
-      //(using check_for_repeats=false doesn't seem to be an improvement)
-      m_hull.reset_points(reduced_mat, true);
+      // define which direction is down
+      Eigen::VectorXd down = Eigen::VectorXd::Zero(rank + 1);
+      down(rank) = -1;
 
-      if(!m_hull.calc_CH()) { //calculates hull
+      // start from the hull stored by a previous query, if any, and update it only for
+      // configurations that were added, removed, or whose data changed
+      m_hull = IncrementalHull(down);
+      fs::path hull_file;
+      std::uint64_t key = _hull_key();
+      const PrimClex &primclex = _tmplt.get_primclex();
+      if(!primclex.get_path().empty()) {
+        std::stringstream ss;
+        ss << std::hex << std::setw(16) << std::setfill('0') << key;
+        hull_file = primclex.dir().hull_cache(ss.str());
+        m_hull.read(hull_file, key);
+      }
+
+      m_hull.assign(mat_wrapper.labels(), reduced_mat);
+
+      if(!m_hull.update()) { //calculates hull
         throw std::runtime_error("Failure to construct convex hull from selection " + m_selection
                                  + " for formatted output!\n");
       }
 
-      // define which direction is down
-      Eigen::VectorXd down = Eigen::VectorXd::Zero(rank + 1);
-      down(rank) = -1;
-      m_hull.CH_bottom(down);
+      if(!hull_file.empty() && m_hull.modified()) {
+        try {
+          bool is_new = !fs::exists(hull_file);
+          m_hull.write(hull_file, key);
+          if(is_new) {
+            remove_stale_hull_files(hull_file.parent_path(), max_hull_files, hull_file);
+          }
+        }
+        catch(std::exception &e) {
+          std::cerr << "Warning: could not store convex hull " << hull_file << ": " << e.what() << std::endl;
+        }
+      }
 
 
       /*
@@ -93,13 +124,28 @@ namespace CASM {
 
 
       // record names of on-hull configs
-      auto hull_inds = m_hull.CH_verts_indices();
-      for(Index i = 0; i < hull_inds.size(); i++) {
-        m_on_hull[mat_wrapper.labels()[hull_inds[i]]] = true;
+      m_on_hull.clear();
+      for(const auto &label : m_hull.vertices()) {
+        m_on_hull[label] = true;
       }
 
     }
 
+    //****************************************************************************************
+
+    std::uint64_t BaseHullConfigFormatter::_hull_key() const {
+      std::stringstream ss;
+      ss << "selection: " << m_selection << "\n"
+         << "dependent: " << m_dependent_prop << "\n"
+         << "independent:";
+      for(const auto &prop : m_independent_props) {
+        ss << " " << prop;
+      }
+      ss << "\n";
+      std::uint64_t hash = fnv1a_hash(ss.str());
+      return fnv1a_hash(m_projection.data(), m_projection.size() * sizeof(double), hash);
+    }
+
     //****************************************************************************************
     bool BaseHullConfigFormatter::parse_args(const std::string &args) {
       if(m_independent_props.size() || m_selection.size())
@@ -155,13 +201,54 @@ namespace CASM {
 
     //****************************************************************************************
 
-    void HullDistConfigFormatter::inject(const Configuration &_config, DataStream &_stream, Index) const {
+    void HullDistConfigFormatter::prefetch(const std::vector<const Configuration *> &_configs) const {
+      m_dist.clear();
+      _format().prefetch(_configs);
+
+      // projected data of each configuration, as columns, skipping configurations that are missing any of it
+      std::vector<const Configuration *> found;
+      Eigen::MatrixXd pts(_projection().rows(), _configs.size());
+      for(Index i = 0; i < _configs.size(); i++) {
+        MatrixXdDataStream mat_wrapper;
+        mat_wrapper << _format()(*_configs[i]);
+        if(mat_wrapper.fail()) {
+          m_dist[_configs[i]] = NAN;
+          continue;
+        }
+        pts.col(found.size()) = _projection() * mat_wrapper.matrix().transpose();
+        found.push_back(_configs[i]);
+      }
+
+      Eigen::VectorXd dist;
+      Eigen::VectorXi facet;
+      _hull().CH_dist_to_hull(Eigen::MatrixXd(pts.leftCols(found.size())), dist, facet);
+      for(Index i = 0; i < found.size(); i++) {
+        m_dist[found[i]] = dist(i);
+      }
+    }
+
+    //****************************************************************************************
+
+    double HullDistConfigFormatter::_dist(const Configuration &_config) const {
+      auto it = m_dist.find(&_config);
+      if(it != m_dist.end())
+        return it->second;
+
       MatrixXdDataStream mat_wrapper;
       mat_wrapper << _format()(_config);
       if(mat_wrapper.fail())
+        return NAN;
+      return _hull().CH_dist_to_hull(Eigen::VectorXd(_projection() * mat_wrapper.matrix().transpose()));
+    }
+
+    //****************************************************************************************
+
+    void HullDistConfigFormatter::inject(const Configuration &_config, DataStream &_stream, Index) const {
+      double dist = _dist(_config);
+      if(std::isnan(dist))
         _stream << DataStream::failbit << double(NAN);
       else
-        _stream << _hull().CH_dist_to_hull(Eigen::VectorXd(_projection()*mat_wrapper.matrix().transpose()));
+        _stream << dist;
     }
 
     //****************************************************************************************
@@ -170,28 +257,22 @@ namespace CASM {
       _stream.flags(std::ios::showpoint | std::ios::fixed | std::ios::right);
       _stream.precision(8);
 
-      MatrixXdDataStream mat_wrapper;
-      mat_wrapper << _format()(_config);
-      //std::cout << "mat_wrapper.matrix() is " << mat_wrapper.matrix() << "\n";
-      //std::cout << "rotated, is " << (_projection()*mat_wrapper.matrix().transpose()).transpose() << "\n";
-      //std::cout << "projection is \n" << _projection() << "\n";
-      if(mat_wrapper.fail())
+      double dist = _dist(_config);
+      if(std::isnan(dist))
         _stream << "unknown";
       else
-        _stream << _hull().CH_dist_to_hull(Eigen::VectorXd(_projection()*mat_wrapper.matrix().transpose()));
+        _stream << dist;
     }
 
     //****************************************************************************************
 
     jsonParser &HullDistConfigFormatter::to_json(const Configuration &_config, jsonParser &json)const {
-      MatrixXdDataStream mat_wrapper;
-      mat_wrapper << _format()(_config);
-      if(mat_wrapper.fail())
+      double dist = _dist(_config);
+      if(std::isnan(dist))
         json = "unknown";
       else
-        json = _hull().CH_dist_to_hull(Eigen::VectorXd(_projection() * mat_wrapper.matrix().transpose()));
+        json = dist;
       return json;
     }
   }
 }
-
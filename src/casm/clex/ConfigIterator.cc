@@ -33,7 +33,9 @@ namespace CASM {
   /// Specialize for Configuration, const Configuration, Transition, const Transition
   template<>
   int ConfigIterator<Configuration, PrimClex>::config_list_size() const {
-    return m_primclex->get_supercell(m_scel_index).get_config_list().size();
+    // const access, so that passing over a Supercell does not mark its config_list dirty
+    const PrimClex &primclex = *m_primclex;
+    return primclex.get_supercell(m_scel_index).get_config_list().size();
   }
 
   template<>
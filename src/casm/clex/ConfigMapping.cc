@@ -4,6 +4,12 @@
 #include "casm/crystallography/Lattice.hh"
 #include "casm/crystallography/LatticeMap.hh"
 #include "casm/crystallography/SupercellEnumerator.hh"
+#include "casm/system/ParallelFor.hh"
+
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <queue>
 
 namespace CASM {
   //*******************************************************************************************
@@ -79,44 +85,95 @@ namespace CASM {
   }
   //*******************************************************************************************
 
-  bool import_structure_occupation(const BasicStructure<Site> &_struc,
+  StructureMapping map_structure_occupation(const BasicStructure<Site> &_struc,
+                                            PrimClex &pclex,
+                                            bool robust_flag,
+                                            bool rotate_flag,
+                                            double _tol,
+                                            double lattice_weight,
+                                            double vol_tol,
+                                            Index k_best) {
+
+    auto begin = std::chrono::steady_clock::now();
+    StructureMapping result;
+    jsonParser &relaxation_properties = result.relaxation_properties;
+    ConfigDoF &tconfigdof = result.configdof;
+
+    relaxation_properties.put_obj();
+
+    try {
+      if(!struc_to_configdof(_struc, pclex, tconfigdof, result.mapped_lat, result.alternatives, robust_flag, rotate_flag, _tol, lattice_weight, vol_tol, k_best)) {
+        result.error = "Structure is incompatible with PRIM.";
+      }
+      else {
+        relaxation_properties["basis_deformation"] = ConfigMapping::basis_cost(tconfigdof);
+        relaxation_properties["lattice_deformation"] = ConfigMapping::strain_cost(_struc.lattice(), tconfigdof);
+        relaxation_properties["volume_relaxation"] = tconfigdof.deformation().determinant();
+        Eigen::Matrix3d E = StrainConverter::green_lagrange(tconfigdof.deformation());
+        std::vector<double> Evec(6);
+        Evec[0] = (E(0, 0));
+        Evec[1] = (E(1, 1));
+        Evec[2] = (E(2, 2));
+        Evec[3] = (sqrt(2.0) * E(1, 2));
+        Evec[4] = (sqrt(2.0) * E(0, 2));
+        Evec[5] = (sqrt(2.0) * E(0, 1));
+        relaxation_properties["relaxation_strain"] = Evec;
+        result.success = true;
+      }
+    }
+    catch(const std::exception &ex) {
+      result.error = ex.what();
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return result;
+  }
+
+  //*******************************************************************************************
+
+  std::vector<StructureMapping> map_structures_occupation(const std::vector<BasicStructure<Site> > &strucs,
+                                                          PrimClex &pclex,
+                                                          bool robust_flag,
+                                                          bool rotate_flag,
+                                                          double _tol,
+                                                          double lattice_weight,
+                                                          double vol_tol,
+                                                          Index num_threads,
+                                                          Index k_best) {
+
+    // generate the lazily constructed symmetry and voronoi data that mapping uses, so that
+    // workers only read 'pclex'
+    pclex.get_prim().point_group();
+    pclex.get_prim().lattice().generate_voronoi_table();
+
+    std::vector<StructureMapping> result(strucs.size());
+    parallel_for_chunks(strucs.size(), 1, num_threads, [&](long thread, long begin, long end) {
+      for(long i = begin; i < end; ++i) {
+        result[i] = map_structure_occupation(strucs[i], pclex, robust_flag, rotate_flag, _tol, lattice_weight, vol_tol, k_best);
+      }
+    });
+    return result;
+  }
+
+  //*******************************************************************************************
+
+  bool insert_structure_occupation(const StructureMapping &mapping,
                                    const Configuration *hint_ptr,
                                    PrimClex &pclex,
                                    std::string &imported_name,
-                                   jsonParser &relaxation_properties,
-                                   bool robust_flag,
-                                   bool rotate_flag,
                                    bool strict_flag,
-                                   double _tol,
-                                   double lattice_weight,
-                                   double vol_tol) {
+                                   double _tol) {
+
+    if(!mapping.success)
+      throw std::runtime_error(mapping.error);
 
     //Indices for Configuration index and permutation operation index
-    ConfigDoF tconfigdof;
-    Lattice mapped_lat;
+    const Lattice &mapped_lat = mapping.mapped_lat;
     bool new_config_flag;
 
-    relaxation_properties.put_obj();
-
-    if(!struc_to_configdof(_struc, pclex, tconfigdof, mapped_lat, robust_flag, rotate_flag, _tol, lattice_weight, vol_tol))
-      throw std::runtime_error("Structure is incompatible with PRIM.");
-
-    relaxation_properties["basis_deformation"] = ConfigMapping::basis_cost(tconfigdof);
-    relaxation_properties["lattice_deformation"] = ConfigMapping::strain_cost(_struc.lattice(), tconfigdof);
-    relaxation_properties["volume_relaxation"] = tconfigdof.deformation().determinant();
-    Eigen::Matrix3d E = StrainConverter::green_lagrange(tconfigdof.deformation());
-    std::vector<double> Evec(6);
-    Evec[0] = (E(0, 0));
-    Evec[1] = (E(1, 1));
-    Evec[2] = (E(2, 2));
-    Evec[3] = (sqrt(2.0) * E(1, 2));
-    Evec[4] = (sqrt(2.0) * E(0, 2));
-    Evec[5] = (sqrt(2.0) * E(0, 1));
-    relaxation_properties["relaxation_strain"] = Evec;
-
     ConfigDoF relaxed_occ;
 
-    relaxed_occ.set_occupation(tconfigdof.occupation());
+    relaxed_occ.set_occupation(mapping.configdof.occupation());
     if(hint_ptr != nullptr) {
       ConfigDoF canon_relaxed_occ, canon_ideal_occ;
       Supercell const &scel(hint_ptr->get_supercell());
@@ -143,24 +200,82 @@ namespace CASM {
 
     Index import_scel_index = pclex.add_supercell(mapped_lat), import_config_index;
 
-    Configuration import_config(pclex.get_supercell(import_scel_index), jsonParser(), relaxed_occ);
+    Supercell &import_scel = pclex.get_supercell(import_scel_index);
+    Configuration import_config(import_scel, jsonParser(), relaxed_occ);
 
     if(strict_flag) {
-      permute_it = pclex.get_supercell(import_scel_index).permute_begin();
-      new_config_flag = pclex.get_supercell(import_scel_index).add_canon_config(import_config, import_config_index);
-      imported_name = pclex.get_supercell(import_scel_index).get_config(import_config_index).name();
+      permute_it = import_scel.permute_begin();
+      new_config_flag = import_scel.add_canon_config(import_config, import_config_index);
     }
     else {
-      permute_it = pclex.get_supercell(import_scel_index).permute_begin();
-      new_config_flag = pclex.get_supercell(import_scel_index).add_config(import_config, import_config_index, permute_it);
-      imported_name = pclex.get_supercell(import_scel_index).get_config(import_config_index).name();
+      permute_it = import_scel.permute_begin();
+      new_config_flag = import_scel.add_config(import_config, import_config_index, permute_it);
     }
+    // const access, which leaves the configuration indexed
+    imported_name = static_cast<const Supercell &>(import_scel).get_config(import_config_index).name();
 
     return new_config_flag;
   }
 
   //*******************************************************************************************
 
+  void print_mappings(const BasicStructure<Site> &_struc,
+                      const StructureMapping &mapping,
+                      PrimClex &pclex,
+                      double lattice_weight,
+                      std::ostream &sout,
+                      std::string indent) {
+
+    if(!mapping.success)
+      return;
+
+    // as in deformed_struc_to_configdofs
+    double lw = max(min(lattice_weight, 1.0), 1e-9);
+
+    std::vector<std::pair<const ConfigDoF *, const Lattice *> > mapped(1, std::make_pair(&mapping.configdof, &mapping.mapped_lat));
+    for(const auto &alt : mapping.alternatives)
+      mapped.push_back(std::make_pair(&alt.configdof, &alt.mapped_lat));
+
+    sout << indent << std::setw(6) << "rank" << std::setw(14) << "cost" << std::setw(22) << "lattice_deformation"
+         << std::setw(20) << "basis_deformation" << "   supercell   occupation\n";
+    for(Index i = 0; i < mapped.size(); i++) {
+      const ConfigDoF &dof = *mapped[i].first;
+      double strain_cost = ConfigMapping::strain_cost(_struc.lattice(), dof);
+      double basis_cost = ConfigMapping::basis_cost(dof);
+      sout << indent << std::setw(6) << i + 1
+           << std::setw(14) << std::setprecision(6) << lw *strain_cost + (1.0 - lw) * basis_cost
+           << std::setw(22) << strain_cost << std::setw(20) << basis_cost
+           << "   " << Supercell(&pclex, *mapped[i].second).get_name() << "   ";
+      for(Index l = 0; l < dof.size(); l++)
+        sout << dof.occ(l);
+      sout << "\n";
+    }
+  }
+
+  //*******************************************************************************************
+
+  bool import_structure_occupation(const BasicStructure<Site> &_struc,
+                                   const Configuration *hint_ptr,
+                                   PrimClex &pclex,
+                                   std::string &imported_name,
+                                   jsonParser &relaxation_properties,
+                                   bool robust_flag,
+                                   bool rotate_flag,
+                                   bool strict_flag,
+                                   double _tol,
+                                   double lattice_weight,
+                                   double vol_tol) {
+
+    StructureMapping mapping = map_structure_occupation(_struc, pclex, robust_flag, rotate_flag, _tol, lattice_weight, vol_tol);
+    if(!mapping.success)
+      throw std::runtime_error(mapping.error);
+
+    relaxation_properties = mapping.relaxation_properties;
+    return insert_structure_occupation(mapping, hint_ptr, pclex, imported_name, strict_flag, _tol);
+  }
+
+  //*******************************************************************************************
+
   bool import_structure(const fs::path &pos_path,
                         PrimClex &pclex,
                         std::string &imported_name,
@@ -284,7 +399,25 @@ namespace CASM {
                           double _tol,
                           double lattice_weight,
                           double vol_tol) {
+    std::vector<ConfigDoFMapping> alternatives;
+    return struc_to_configdof(struc, pclex, mapped_configdof, mapped_lat, alternatives, robust_flag, rotate_flag, _tol, lattice_weight, vol_tol, 1);
+  }
+
+  //*******************************************************************************************
 
+  bool struc_to_configdof(const BasicStructure<Site> &struc,
+                          PrimClex &pclex,
+                          ConfigDoF &mapped_configdof,
+                          Lattice &mapped_lat,
+                          std::vector<ConfigDoFMapping> &alternatives,
+                          bool robust_flag,
+                          bool rotate_flag,
+                          double _tol,
+                          double lattice_weight,
+                          double vol_tol,
+                          Index k_best) {
+
+    alternatives.clear();
     bool valid_mapping(false);
     // If structure's lattice is a supercell of the primitive lattice, then import as ideal_structure
     if(!robust_flag && struc.lattice().is_supercell_of(pclex.get_prim().lattice(), _tol)) {
@@ -294,8 +427,15 @@ namespace CASM {
     }
 
     // If structure's lattice is not a supercell of the primitive lattice, then import as deformed_structure
-    if(!valid_mapping) // if not a supercell or robust_flag=true, treat as deformed
-      valid_mapping = deformed_struc_to_configdof(struc,  pclex, mapped_configdof, mapped_lat, rotate_flag, _tol, lattice_weight, vol_tol);
+    if(!valid_mapping) { // if not a supercell or robust_flag=true, treat as deformed
+      std::vector<ConfigDoFMapping> mappings = deformed_struc_to_configdofs(struc, pclex, rotate_flag, _tol, lattice_weight, vol_tol, k_best);
+      valid_mapping = !mappings.empty();
+      if(valid_mapping) {
+        mapped_configdof = mappings[0].configdof;
+        mapped_lat = mappings[0].mapped_lat;
+        alternatives.assign(mappings.begin() + 1, mappings.end());
+      }
+    }
 
     return valid_mapping;
   }
@@ -362,6 +502,80 @@ namespace CASM {
                                    double _tol,
                                    double lattice_weight,
                                    double vol_tol) {
+    std::vector<ConfigDoFMapping> mappings = deformed_struc_to_configdofs(struc, pclex, rotate_flag, _tol, lattice_weight, vol_tol, 1);
+    if(mappings.empty()) {
+      //std::cerr << "WARNING: In Supercell::import_deformed_structure(), no successful mapping was found for Structure " << src << "\n"
+      //        << "         This Structure may be incompatible with the ideal crystal specified by the PRIM file. \n";
+      return false;
+    }
+    mapped_configdof = mappings[0].configdof;
+    mapped_lat = mappings[0].mapped_lat;
+    return true;
+  }
+
+  //*******************************************************************************************
+
+  namespace {
+
+    /// \brief Node of the best-first search in deformed_struc_to_configdofs
+    ///
+    /// - A supercell node holds the lowest weighted strain cost of any lattice mapping onto its
+    ///   supercell, and is expanded into lattice mapping nodes when it reaches the top of the queue
+    /// - A lattice mapping node holds the weighted strain cost of mapping the structure's lattice
+    ///   onto the supercell by deformation F
+    ///
+    /// Basis costs are non-negative, so 'strain_cost' is a lower bound on the total cost of every
+    /// mapping below a node.
+    struct MappingNode {
+      double strain_cost;
+      /// order created, so that ties are broken the same way every time
+      Index order;
+      Index scel;
+      bool is_scel;
+      Eigen::Matrix3d F;
+      Eigen::Matrix3d N;
+
+      /// std::priority_queue puts the greatest element on top, so order by decreasing cost
+      bool operator<(const MappingNode &B) const {
+        if(strain_cost != B.strain_cost)
+          return strain_cost > B.strain_cost;
+        return order > B.order;
+      }
+    };
+  }
+
+  //*******************************************************************************************
+  /*
+   * Find the 'k_best' lowest cost mappings of a deformed structure onto supercells of the prim,
+   * with total_cost = w*lattice_cost + (1-w)*basis_cost as in deformed_struc_to_configdof
+   *
+   * Candidate lattice mappings are searched best-first, in order of increasing strain cost. The
+   * strain cost is a lower bound on the total cost, so the search stops as soon as the next
+   * candidate's strain cost is no better than the k-th best total cost found, and the basis
+   * assignment is only solved for candidates that may still improve on it:
+   *   1) For each supercell in the volume range, find the lowest strain cost of any lattice mapping
+   *   2) Take the supercell or lattice mapping with the lowest strain cost:
+   *      - a supercell is expanded into its lattice mappings with strain cost below the bound
+   *      - a lattice mapping is scored by solving the basis assignment
+   *   3) Repeat 2) until the lowest strain cost left is not below the k-th best total cost
+   *
+   * Lattice mappings related by a point group operation of the supercell are equivalent, so only
+   * the first is scored. If the basis assignment fails, the structure's composition is
+   * incompatible with supercells of that volume, and the remaining candidates with that volume
+   * are skipped.
+   *
+   * Returns mappings in order of increasing total cost. Mappings onto the same supercell with
+   * the same occupation and total cost are only included once. Returns an empty vector if no
+   * mapping is possible.
+   */
+  //*******************************************************************************************
+  std::vector<ConfigDoFMapping> deformed_struc_to_configdofs(const BasicStructure<Site> &struc,
+                                                             PrimClex &pclex,
+                                                             bool rotate_flag,
+                                                             double _tol,
+                                                             double lattice_weight,
+                                                             double vol_tol,
+                                                             Index k_best) {
     //squeeze lattice_weight into [0,1] if necessary
     double lw = max(min(lattice_weight, 1.0), 1e-9);
     double bw = 1.0 - lw;
@@ -369,10 +583,8 @@ namespace CASM {
     _tol = max(_tol, 1e-12);
     // make vol_tol >= _tol
     vol_tol = max(_tol, vol_tol);
+    k_best = max(k_best, Index(1));
 
-    //Add new Supercell if it doesn't exist already. Use primitive point group to check for equivalence and
-    //store transformation matrix
-    Eigen::MatrixXd deformation;
     double num_atoms = double(struc.basis.size());
     // min_vol assumes dilute vacancies -- best case scenario
     int min_vol(ceil((num_atoms / double(pclex.get_prim().basis.size())) - _tol));
@@ -390,148 +602,143 @@ namespace CASM {
       min_vol = new_min_vol;
     }
 
-    //std::cout << "max_va_fraction: " << max_va_fraction << "   Volume range: " << min_vol << " to " << max_vol << "\n";
-    Eigen::MatrixXd ttrans_mat, tF, best_trans;
-    double strain_cost(1e10), basis_cost(1e10), best_cost(1e20), tot_cost, best_strain_cost, best_basis_cost;
-    ConfigDoF tdof;
-    BasicStructure<Site> tstruc(struc);
-    Lattice tlat;
-    //std::cout << "First pass: ";
+    const SymGroup &point_group = pclex.get_prim().point_group();
+    const Eigen::Matrix3d relaxed_lat_mat(struc.lattice().lat_column_mat());
+    const double relaxed_atomic_vol = struc.lattice().vol() / num_atoms;
+
+    // 1) lower bound on the strain cost for each supercell
+    std::vector<Lattice> scel_lat;
+    std::vector<Index> scel_vol;
+    std::priority_queue<MappingNode> queue;
+    Index order(0);
     for(Index i_vol = min_vol; i_vol <= max_vol; i_vol++) {
-      //std::cout << "v=" << i_vol << "   ";
-      tlat = find_nearest_super_lattice(pclex.get_prim().lattice(), struc.lattice(), pclex.get_prim().point_group(), tF, ttrans_mat, i_vol, i_vol, _tol);
-      strain_cost = lw * LatticeMap::calc_strain_cost(tF, struc.lattice().vol() / num_atoms);
+      SupercellEnumerator<Lattice> enumerator(pclex.get_prim().lattice(), point_group, i_vol, i_vol + 1);
+      for(auto it = enumerator.begin(); it != enumerator.end(); ++it) {
+        Lattice tlat = niggli(*it, point_group, _tol);
 
-      if(best_cost < strain_cost)
-        continue;
-      //std::cout << "best_cost " << best_cost << "   strain_cost " << strain_cost << "\n";
-      tstruc = struc;
+        // simplest mapping onto the supercell, which does not change the crystal setting
+        Eigen::Matrix3d F = relaxed_lat_mat * Eigen::Matrix3d(tlat.inv_lat_column_mat());
+        double min_cost = LatticeMap::calc_strain_cost(F, relaxed_atomic_vol);
 
-      tstruc.set_lattice(Lattice(tF * Eigen::MatrixXd(tlat.lat_column_mat())), CART);
+        LatticeMap strainmap(tlat, struc.lattice(), round(num_atoms), _tol, 1);
+        min_cost = min(min_cost, strainmap.best_strain_mapping().strain_cost());
 
-      if(rotate_flag) {
-        tF = StrainConverter::right_stretch_tensor(tF);
-        tstruc.set_lattice(Lattice(tF * Eigen::MatrixXd(tlat.lat_column_mat())), FRAC);
+        queue.push(MappingNode {lw * min_cost, order++, Index(scel_lat.size()), true, F, Eigen::Matrix3d::Identity()});
+        scel_lat.push_back(tlat);
+        scel_vol.push_back(i_vol);
       }
+    }
 
-      Supercell scel(&pclex, tlat);
+    std::vector<std::unique_ptr<Supercell> > scel(scel_lat.size());
+    std::vector<bool> incompatible_vol(max_vol + 1, false);
 
-      if(!struc_to_configdof(scel, tstruc, tdof, true, _tol))
+    // point group operations that map each supercell lattice onto itself, and the lattice
+    // mappings scored for each supercell
+    std::vector<std::vector<Eigen::Matrix3d> > scel_ops(scel_lat.size());
+    std::vector<std::vector<Eigen::Matrix3d> > scored(scel_lat.size());
+
+    std::vector<ConfigDoFMapping> result;
+    std::vector<Index> result_scel;
+
+    // mappings must cost less than this to be among the k best found so far
+    auto bound = [&]() {
+      return (result.size() < k_best) ? 1e20 : result.back().cost - _tol;
+    };
+
+    ConfigDoF tdof;
+    BasicStructure<Site> tstruc(struc);
+    while(!queue.empty() && queue.top().strain_cost < bound()) {
+      MappingNode node = queue.top();
+      queue.pop();
+      if(incompatible_vol[scel_vol[node.scel]])
         continue;
-      basis_cost = bw * ConfigMapping::basis_cost(tdof);
-      tot_cost = strain_cost + basis_cost;
-      //std::cout << "\n**Starting strain_cost = " << strain_cost << ";   and basis_cost = " << basis_cost << "  TOTAL: " << strain_cost + basis_cost << "\n";
-      if(tot_cost < best_cost) {
-        best_cost = tot_cost - _tol;
-        best_strain_cost = strain_cost;
-        best_basis_cost = basis_cost;
-        best_trans = Eigen::MatrixXd(tlat.inv_lat_column_mat()) * tF.inverse() * Eigen::MatrixXd(struc.lattice().lat_column_mat());
-        //std::cout << "tF is:\n" << tF << "\n and N is:\n" << best_trans << "\n";
-        mapped_configdof = tdof;
 
-        mapped_lat = tlat;
-      }
-    }
-    //std::cout << "\n\n";
+      const Lattice &tlat = scel_lat[node.scel];
 
-    //std::cout << "Second pass:\n";
-    for(Index i_vol = min_vol; i_vol <= max_vol; i_vol++) {
-      //std::cout << "  vol = " << i_vol << "\n";
-      SupercellEnumerator<Lattice> enumerator(pclex.get_prim().lattice(), pclex.get_prim().point_group(), i_vol, i_vol + 1);
-      bool break_early(false);
-      for(auto it = enumerator.begin(); it != enumerator.end() && !break_early; ++it) {
-        tlat = niggli(*it, pclex.get_prim().point_group(), _tol);
-        Supercell scel(&pclex, tlat);
-
-        //Determine best mapping for this supercell
-
-        //Initialize with simplest mapping onto supercell 'i', so that we don't change the crystal setting unnecessarily
-        tF = struc.lattice().lat_column_mat() * tlat.inv_lat_column_mat();
-
-        strain_cost = lw * LatticeMap::calc_strain_cost(tF, struc.lattice().vol() / num_atoms);
-
-        // If simplest mapping seems viable, check it further
-        if(strain_cost < best_cost) {
-          tstruc = struc;
-          tstruc.set_lattice(Lattice(tF * Eigen::MatrixXd(tlat.lat_column_mat())), CART);
-          if(rotate_flag) {
-            tF = StrainConverter::right_stretch_tensor(tF);
-            tstruc.set_lattice(Lattice(tF * Eigen::MatrixXd(tlat.lat_column_mat())), FRAC);
-          }
+      // 2a) expand a supercell into its lattice mappings
+      if(node.is_scel) {
+        SymGroup scel_point_group;
+        tlat.find_invariant_subgroup(point_group, scel_point_group, _tol);
+        for(Index i = 0; i < scel_point_group.size(); i++)
+          scel_ops[node.scel].push_back(Eigen::Matrix3d(scel_point_group[i].get_matrix(CART)));
 
-          if(!struc_to_configdof(scel, tstruc, tdof, true, _tol))
-            break;
-          basis_cost = bw * ConfigMapping::basis_cost(tdof);
-          //std::cout << "\n**Starting strain_cost = " << strain_cost << ";   and basis_cost = " << basis_cost << "  TOTAL: " << strain_cost + basis_cost << "\n";
-          tot_cost = strain_cost + basis_cost;
-          //std::cout << "    scel.name = " << scel.get_name()  << "  simple map: strain_cost " << strain_cost << "   best_cost " << best_cost << "    tot_cost " << tot_cost << "\n";
-          if(tot_cost < best_cost) {
-            best_cost = tot_cost - _tol;
-            best_strain_cost = strain_cost;
-            best_basis_cost = basis_cost;
-            best_trans = Matrix3<double>::identity();
-            //std::cout << "tF is:\n" << tF << "\n and N is:\n" << best_trans << "\n";
-            mapped_configdof = tdof;
-
-            mapped_lat = tlat;
-          }
-        } // Done checking simplest mapping
+        // LatticeMap reports a cost of 1e20 when it runs out of mappings
+        double max_cost = min(bound() / lw, 1e10);
+
+        double simple_cost = LatticeMap::calc_strain_cost(node.F, relaxed_atomic_vol);
+        if(simple_cost < max_cost)
+          queue.push(MappingNode {lw * simple_cost, order++, node.scel, false, node.F, Eigen::Matrix3d::Identity()});
 
-        // If the simplest mapping is best, we have avoided a lot of extra work, but we still need to check for
-        // non-trivial mappings that are better than both the simplest mapping and the best found mapping
         LatticeMap strainmap(tlat, struc.lattice(), round(num_atoms), _tol, 1);
-        strain_cost = lw * strainmap.strain_cost();
-        if(best_cost < strain_cost)
-          strain_cost = lw * strainmap.next_mapping_better_than(best_cost).strain_cost();
-
-        while(strain_cost < best_cost) {  // only enter loop if there's a chance of improving on current best
-          tstruc = struc;
-          // We modify the deformed structure so that its lattice is a deformed version of the nearest ideal lattice
-          // Don't need matrixN if we use set_lattice(CART), because matrixF depends on matrixN implicitly
-          tstruc.set_lattice(Lattice(strainmap.matrixF() * Eigen::MatrixXd(tlat.lat_column_mat())), CART);
-          if(rotate_flag) {
-            tF = StrainConverter::right_stretch_tensor(strainmap.matrixF());
-            tstruc.set_lattice(Lattice(tF * Eigen::MatrixXd(tlat.lat_column_mat())), FRAC);
-          }
+        double cost = strainmap.strain_cost();
+        if(!(cost < max_cost))
+          cost = strainmap.next_mapping_better_than(max_cost).strain_cost();
+        while(cost < max_cost) {
+          queue.push(MappingNode {lw * cost, order++, node.scel, false, strainmap.matrixF(), strainmap.matrixN()});
+          cost = strainmap.next_mapping_better_than(max_cost).strain_cost();
+        }
+        continue;
+      }
 
-          if(!struc_to_configdof(scel, tstruc, tdof, true, _tol)) {
-            break_early = true;
-            break;
-            //no longer unexpected
-            //throw std::runtime_error("Unexpected error in deformed_struc_to_config_dof(). This should never happen!\n");
-          }
-          //std::cout << "New strain_cost = " << strain_cost << ";   and basis_cost = " << basis_cost << "  TOTAL: " << strain_cost + basis_cost << "\n";
-          //std::cout << "  Compare -> best_cost = " << best_cost << "\n";
-          basis_cost = bw * ConfigMapping::basis_cost(tdof);
-          tot_cost = strain_cost + basis_cost;
-          //std::cout << "      complex map: best_cost " << best_cost << "    strain_cost " << strain_cost << "    tot_cost " << tot_cost << "\n";
-          if(tot_cost < best_cost) {
-            //std::cout << "Old best_trans, with cost " << best_cost << ":\n" << best_trans << "\n";
-            best_cost = tot_cost - _tol;
-            best_strain_cost = strain_cost;
-            best_basis_cost = basis_cost;
-            best_trans = strainmap.matrixN();
-            //std::cout << "New best_trans, with cost " << best_cost << ":\n" << best_trans << "\n";
-            mapped_configdof = tdof;
-
-            mapped_lat = tlat;
-          }
-          // This finds first decomposition:
-          //            struc.lattice() =  deformation*(supercell_list[import_scel_index].get_real_super_lattice())*equiv_mat
-          //   that has cost function less than best_cost
-          strain_cost = lw * strainmap.next_mapping_better_than(best_cost).strain_cost();
+      // 2b) score a lattice mapping by solving the basis assignment
+
+      // Lattice mappings F and F*R, where R is an operation of the prim point group that maps the
+      // supercell lattice onto itself, are equivalent by symmetry and have the same basis cost
+      bool equivalent = false;
+      for(const auto &scored_F : scored[node.scel]) {
+        for(Index i = 0; i < scel_ops[node.scel].size() && !equivalent; i++) {
+          equivalent = (scored_F * scel_ops[node.scel][i] - node.F).cwiseAbs().maxCoeff() < _tol;
         }
+        if(equivalent)
+          break;
+      }
+      if(equivalent)
+        continue;
+      scored[node.scel].push_back(node.F);
+
+      // We modify the deformed structure so that its lattice is a deformed version of the nearest ideal lattice
+      tstruc = struc;
+      tstruc.set_lattice(Lattice(node.F * Eigen::Matrix3d(tlat.lat_column_mat())), CART);
+      if(rotate_flag) {
+        Eigen::Matrix3d tF = StrainConverter::right_stretch_tensor(node.F);
+        tstruc.set_lattice(Lattice(tF * Eigen::Matrix3d(tlat.lat_column_mat())), FRAC);
+      }
+
+      if(!scel[node.scel])
+        scel[node.scel].reset(new Supercell(&pclex, tlat));
+
+      if(!struc_to_configdof(*scel[node.scel], tstruc, tdof, true, _tol)) {
+        incompatible_vol[scel_vol[node.scel]] = true;
+        continue;
+      }
+
+      double basis_cost = bw * ConfigMapping::basis_cost(tdof);
+      double tot_cost = node.strain_cost + basis_cost;
+      if(!(tot_cost < bound()))
+        continue;
+
+      // skip mappings that duplicate one already found, such as symmetrically equivalent ones
+      bool duplicate = false;
+      for(Index i = 0; i < result.size() && !duplicate; i++) {
+        duplicate = result_scel[i] == node.scel &&
+                    almost_equal(result[i].cost, tot_cost, _tol) &&
+                    result[i].configdof.occupation() == tdof.occupation();
+      }
+      if(duplicate)
+        continue;
+
+      Index pos = result.size();
+      while(pos > 0 && tot_cost < result[pos - 1].cost)
+        pos--;
+      result.insert(result.begin() + pos, ConfigDoFMapping {tdof, tlat, Eigen::Matrix3d(node.N), node.strain_cost, basis_cost, tot_cost});
+      result_scel.insert(result_scel.begin() + pos, node.scel);
+      if(result.size() > k_best) {
+        result.pop_back();
+        result_scel.pop_back();
       }
     }
-    //std::cout << "best_cost = " << best_cost << "    best_strain_cost = " << best_strain_cost << "    best_basis_cost = " << best_basis_cost << "\n";
-    if(best_cost > 1e9) {
-      //std::cerr << "WARNING: In Supercell::import_deformed_structure(), no successful mapping was found for Structure " << src << "\n"
-      //        << "         This Structure may be incompatible with the ideal crystal specified by the PRIM file. \n";
-      return false;
-    }
-    //std::cout << "FINAL COST IS: " << best_cost << "\nFINAL TRANS MAT IS:\n" << best_trans << "\n\n";
-    return true;
 
+    return result;
   }
 
   //****************************************************************************************************************
@@ -628,6 +835,142 @@ namespace CASM {
     return true;
   }
 
+  //****************************************************************************************************************
+  /*
+   * Sparse version of calc_cost_matrix, for large supercells
+   *
+   * Only pairs of a supercell site and a relaxed atom that are within 'max_dist' of each other are included, with
+   * the same cost as in calc_cost_matrix. They are found by sorting the relaxed atoms into a periodic grid of bins
+   * at least 'max_dist' wide, so only the atoms in a site's bin and the neighboring bins are checked. All entries
+   * for vacancies are included.
+   *
+   * 'complete' is set to true if no allowed pairs were left out, so that the result is equivalent to
+   * calc_cost_matrix.
+   *
+   * Returns false if lattices are incompatible, like calc_cost_matrix
+   */
+  //****************************************************************************************************************
+
+  bool calc_sparse_cost_matrix(const Supercell &scel,
+                               const BasicStructure<Site> &rstruc,
+                               const Coordinate &trans,
+                               double max_dist,
+                               SparseCostMatrix &cost_matrix,
+                               bool &complete) {
+
+    const Structure &prim = scel.get_prim();
+    const Lattice &lat = scel.get_real_super_lattice();
+    Index N = scel.num_sites();
+    Index N_atoms = rstruc.basis.size();
+
+    // allowed(b, s): species s of the relaxed structure is allowed on prim basis site b
+    std::vector<std::string> species;
+    std::vector<Index> atom_species(N_atoms);
+    for(Index j = 0; j < N_atoms; j++) {
+      Index s = std::find(species.begin(), species.end(), rstruc.basis[j].occ_name()) - species.begin();
+      if(s == species.size())
+        species.push_back(rstruc.basis[j].occ_name());
+      atom_species[j] = s;
+    }
+    Eigen::MatrixXi allowed(prim.basis.size(), species.size());
+    std::vector<bool> va_allowed(prim.basis.size());
+    for(Index b = 0; b < prim.basis.size(); b++) {
+      for(Index s = 0; s < species.size(); s++)
+        allowed(b, s) = prim.basis[b].contains(species[s]);
+      va_allowed[b] = prim.basis[b].contains("Va");
+    }
+
+    // Bail if an atom is not allowed on any site, or a vacancy is required but not allowed, like calc_cost_matrix
+    Eigen::VectorXi atom_count = Eigen::VectorXi::Zero(species.size());
+    for(Index j = 0; j < N_atoms; j++)
+      atom_count[atom_species[j]]++;
+    for(Index s = 0; s < species.size(); s++) {
+      if(allowed.col(s).maxCoeff() == 0)
+        return false;
+    }
+    if(N_atoms < N && std::find(va_allowed.begin(), va_allowed.end(), true) == va_allowed.end())
+      return false;
+
+    // Grid bins are at least max_dist wide, measured perpendicular to the faces of the supercell, so that
+    // atoms within max_dist of a site are in its bin or a neighboring bin
+    Eigen::Matrix3d L(lat.lat_column_mat());
+    double vol = std::abs(L.determinant());
+    int n_bins[3];
+    for(int k = 0; k < 3; k++) {
+      double height = vol / L.col((k + 1) % 3).cross(L.col((k + 2) % 3)).norm();
+      n_bins[k] = std::max(1, int(std::min(std::floor(height / max_dist), double(N))));
+    }
+    auto bin_index = [&](const Coordinate & coord, int bin[3]) {
+      for(int k = 0; k < 3; k++) {
+        double f = coord(FRAC)[k] - std::floor(coord(FRAC)[k]);
+        bin[k] = std::min(int(f * n_bins[k]), n_bins[k] - 1);
+      }
+    };
+
+    std::vector<Coordinate> relaxed_coord;
+    relaxed_coord.reserve(N_atoms);
+    std::vector<std::vector<Index> > bin_atoms(n_bins[0] * n_bins[1] * n_bins[2]);
+    int bin[3];
+    for(Index j = 0; j < N_atoms; j++) {
+      relaxed_coord.push_back(Coordinate(rstruc.basis[j](FRAC), lat, FRAC));
+      relaxed_coord.back()(CART) += trans(CART);
+      bin_index(relaxed_coord.back(), bin);
+      bin_atoms[(bin[0] * n_bins[1] + bin[1]) * n_bins[2] + bin[2]].push_back(j);
+    }
+
+    // neighboring bin indices along each axis, without repeats when there are fewer than 3 bins
+    auto neighbors = [&](int k, int b) {
+      std::vector<int> result;
+      for(int d = -1; d <= 1; d++) {
+        int nb = ((b + d) % n_bins[k] + n_bins[k]) % n_bins[k];
+        if(std::find(result.begin(), result.end(), nb) == result.end())
+          result.push_back(nb);
+      }
+      return result;
+    };
+
+    cost_matrix.clear();
+    Index N_allowed = 0, N_included = 0;
+    double max_dist2 = max_dist * max_dist;
+    for(Index i = 0; i < N; i++) {
+      Index b = scel.get_b(i);
+      Coordinate site_coord = scel.coord(i);
+      for(Index s = 0; s < species.size(); s++) {
+        if(allowed(b, s))
+          N_allowed += atom_count[s];
+      }
+
+      bin_index(site_coord, bin);
+      for(int b0 : neighbors(0, bin[0])) {
+        for(int b1 : neighbors(1, bin[1])) {
+          for(int b2 : neighbors(2, bin[2])) {
+            for(Index j : bin_atoms[(b0 * n_bins[1] + b1) * n_bins[2] + b2]) {
+              if(!allowed(b, atom_species[j]))
+                continue;
+              double dist = site_coord.min_dist(relaxed_coord[j]);
+              if(dist * dist <= max_dist2) {
+                cost_matrix.col.push_back(j);
+                cost_matrix.cost.push_back(dist * dist);
+                N_included++;
+              }
+            }
+          }
+        }
+      }
+
+      if(va_allowed[b]) {
+        for(Index j = N_atoms; j < N; j++) {
+          cost_matrix.col.push_back(j);
+          cost_matrix.cost.push_back(0.0);
+        }
+      }
+      cost_matrix.row_begin.push_back(cost_matrix.col.size());
+    }
+
+    complete = (N_included == N_allowed);
+    return true;
+  }
+
   //***************************************************************************************************
   // New mapping routine. Return an ideal configuration corresponding to a relaxed structure.
   // Options:
@@ -657,8 +1000,14 @@ namespace CASM {
 
     //Initialize everything
 
-    Eigen::MatrixXd cost_matrix(scel.num_sites(), scel.num_sites());
+    Eigen::MatrixXd cost_matrix;
+    SparseCostMatrix sparse_cost_matrix;
+    Eigen::VectorXd row_potential, col_potential;
+    std::vector<Index> sparse_assignments;
     std::vector<Index> optimal_assignments(scel.num_sites()), best_assignments(scel.num_sites());
+
+    // initial neighborhood for the sparse cost matrix: the mean distance between sites
+    double neighbor_dist = std::pow(std::abs(scel.get_real_super_lattice().vol()) / double(scel.num_sites()), 1.0 / 3.0);
     //BasicStructure<Site> best_ideal_struc(rstruc);
     Coordinate ttrans(Vector3<double>(0, 0, 0), rstruc.lattice(), FRAC), best_trans(Vector3<double>(0, 0, 0), rstruc.lattice(), FRAC);
     Array<int> assignment_bitstring(scel.num_sites());
@@ -698,16 +1047,40 @@ namespace CASM {
       ttrans.set_lattice(rstruc.lattice(), CART);
       trans_dist = ttrans(CART).length();
       //shift_struc -= ttrans;
-      if(!calc_cost_matrix(scel, rstruc, ttrans, cost_matrix)) {
-        //std::cerr << "In Supercell::struc_to_config. Cannot construct cost matrix." << std::endl;
-        //std::cerr << "This message is probably OK, if you are using translate_flag == true." << std::endl;
-        //continue;
-        return false;
+
+      // Solve the assignment problem using only pairs of sites and atoms that are near each other, widening the
+      // neighborhood until the potentials prove that the result is optimal for the full cost matrix. The solution
+      // for the previous translation is used as a warm start.
+      bool solved = false;
+      for(double max_dist = neighbor_dist; !solved; max_dist *= 2.0) {
+        bool complete;
+        if(!calc_sparse_cost_matrix(scel, rstruc, ttrans, max_dist, sparse_cost_matrix, complete)) {
+          return false;
+        }
+        if(sparse_assignment(sparse_cost_matrix, sparse_assignments, row_potential, col_potential, mean)) {
+          solved = complete || row_potential.maxCoeff() + col_potential.maxCoeff() <= max_dist * max_dist;
+        }
+        if(complete) {
+          break;
+        }
       }
 
-      //std::cout << "cost_matrix is\n" << cost_matrix <<  "\n\n";
-      // The mapping routine is called here
-      mean = hungarian_method(cost_matrix, optimal_assignments, _tol);
+      if(solved) {
+        optimal_assignments = sparse_assignments;
+      }
+      // If there is no assignment using only allowed pairs, use the dense cost matrix, as before
+      else {
+        if(!calc_cost_matrix(scel, rstruc, ttrans, cost_matrix)) {
+          //std::cerr << "In Supercell::struc_to_config. Cannot construct cost matrix." << std::endl;
+          //std::cerr << "This message is probably OK, if you are using translate_flag == true." << std::endl;
+          //continue;
+          return false;
+        }
+
+        //std::cout << "cost_matrix is\n" << cost_matrix <<  "\n\n";
+        // The mapping routine is called here
+        mean = hungarian_method(cost_matrix, optimal_assignments, _tol);
+      }
       //std::cout << "mean is " << mean << " and stddev is " << stddev << "\n";
       // add small penalty (~_tol) for larger translation distances, so that shortest equivalent translation is used
       mean += _tol * trans_dist / 10.0;
@@ -6,6 +6,7 @@
 #include "casm/clex/Supercell.hh"
 #include "casm/clex/Clexulator.hh"
 #include "casm/crystallography/jsonStruc.hh"
+#include "casm/system/ParallelFor.hh"
 
 
 namespace CASM {
@@ -292,10 +293,13 @@ namespace CASM {
     std::vector<double> tcorr(clexulator.corr_size(), 0.0);
     std::vector<double> corr(clexulator.corr_size(), 0.0);
 
+    //Holds the neighbor list, if the Supercell does not store them
+    std::vector<SuperNeighborList::value_type> nlist_buffer(scel.nlist().nlist_size());
+
     for(int v = 0; v < scel_vol; v++) {
 
       //Point the Clexulator to the right neighborhood
-      clexulator.set_nlist(scel.get_nlist(v).begin());
+      clexulator.set_nlist(scel.nlist().sites(v, nlist_buffer.data()));
 
       //Fill up contributions
       clexulator.calc_global_corr_contribution(&tcorr[0]);
@@ -861,6 +865,8 @@ namespace CASM {
     }
     else {
 
+      // 'source' is always an array, possibly empty or missing in the file
+      m_source.put_array();
       json.get_if(m_source, "source");
       json.get_else(m_selected, "selected", false);
       from_json(m_configdof, json["dof"]);
@@ -1193,35 +1199,7 @@ namespace CASM {
   /// Read in the 'most local' reference states: either configuration, supercell, or root reference
   ///   All reference states should be at the same level, so we look for the "properties.ref.0.json" file
   fs::path Configuration::get_reference_state_dir() const {
-
-    const DirectoryStructure &dir = get_primclex().dir();
-    const ProjectSettings &set = get_primclex().settings();
-
-    fs::path ref_dir;
-    //fs::path set_path = fs::path("settings") / fs::path(get_primclex().get_curr_calctype()) / fs::path(get_primclex().get_curr_ref());
-    //fs::path ref_file("properties.ref_state.0.json");
-
-    // get_path() / set_path / ref_file
-    if(fs::exists(dir.ref_state(set.calctype(), set.ref(), 0))) {
-      // read in config ref
-      //ref_dir = get_path() / set_path;
-      ref_dir = dir.ref_dir(set.calctype(), set.ref());
-    }
-    // get_supercell().get_path() / set_path / ref_file
-    else if(fs::exists(dir.supercell_ref_state(get_supercell().get_name(), set.calctype(), set.ref(), 0))) {
-      // read in supercell ref
-      //ref_dir = get_supercell().get_path() / set_path;
-      ref_dir = dir.supercell_ref_dir(get_supercell().get_name(), set.calctype(), set.ref());
-    }
-    //get_primclex().get_path() / set_path / ref_file
-    else if(fs::exists(dir.configuration_ref_state(name(), set.calctype(), set.ref(), 0))) {
-      // read in root ref
-      //ref_dir = get_primclex().get_path() / set_path;
-      ref_dir = dir.configuration_ref_dir(name(), set.calctype(), set.ref());
-    }
-
-    return ref_dir;
-
+    return reference_state_dir(get_primclex(), name());
   }
 
   //*********************************************************************************
@@ -1371,6 +1349,32 @@ namespace CASM {
     return generated["sublat_struct_fact"].get<Eigen::MatrixXcd>();
   }
 
+  fs::path reference_state_dir(const PrimClex &primclex, const std::string &configname) {
+
+    const DirectoryStructure &dir = primclex.dir();
+    const ProjectSettings &set = primclex.settings();
+    std::string scelname = configname.substr(0, configname.find('/'));
+
+    fs::path ref_dir;
+
+    // project reference states
+    if(fs::exists(dir.ref_state(set.calctype(), set.ref(), 0))) {
+      ref_dir = dir.ref_dir(set.calctype(), set.ref());
+    }
+    // supercell reference states
+    else if(fs::exists(dir.supercell_ref_state(scelname, set.calctype(), set.ref(), 0))) {
+      ref_dir = dir.supercell_ref_dir(scelname, set.calctype(), set.ref());
+    }
+    // configuration reference states
+    else if(fs::exists(dir.configuration_ref_state(configname, set.calctype(), set.ref(), 0))) {
+      ref_dir = dir.configuration_ref_dir(configname, set.calctype(), set.ref());
+    }
+
+    return ref_dir;
+  }
+
+  //*********************************************************************************
+
   /// \brief Returns correlations using 'clexulator'.
   ///
   /// This still assumes that the PrimClex and Supercell are set up for this, so make sure you've called:
@@ -1402,10 +1406,13 @@ namespace CASM {
     std::vector<double> tcorr(clexulator.corr_size(), 0.0);
     //std::vector<double> corr(clexulator.corr_size(), 0.0);
 
+    //Holds the neighbor list, if the Supercell does not store them
+    std::vector<SuperNeighborList::value_type> nlist_buffer(scel.nlist().nlist_size());
+
     for(int v = 0; v < scel_vol; v++) {
 
       //Point the Clexulator to the right neighborhood
-      clexulator.set_nlist(scel.get_nlist(v).begin());
+      clexulator.set_nlist(scel.nlist().sites(v, nlist_buffer.data()));
 
       //Fill up contributions
       clexulator.calc_global_corr_contribution(&tcorr[0]);
@@ -1426,6 +1433,111 @@ namespace CASM {
     */
   }
 
+  namespace {
+
+    /// Number of Configurations handed to a worker thread at a time by the batched correlations()
+    const Index corr_chunk_size = 64;
+
+    /// Fill rows [begin, end) of 'corr_mat', evaluating consecutive Configurations that share a Supercell together
+    void _correlations(const std::vector<const Configuration *> &config_list,
+                       Index begin,
+                       Index end,
+                       Clexulator &clexulator,
+                       CorrMatrix &corr_mat) {
+
+      std::vector<const ConfigDoF *> configdof_list;
+      Index row_begin = begin;
+      while(row_begin < end) {
+        const Supercell &scel = config_list[row_begin]->get_supercell();
+
+        configdof_list.clear();
+        Index row_end = row_begin;
+        while(row_end < end && &config_list[row_end]->get_supercell() == &scel) {
+          configdof_list.push_back(&config_list[row_end]->configdof());
+          row_end++;
+        }
+
+        correlations(configdof_list, scel, clexulator, corr_mat, row_begin);
+        row_begin = row_end;
+      }
+    }
+  }
+
+  /// \brief Fills 'corr_mat' with correlations using 'clexulator', one row per Configuration in 'config_list'
+  ///
+  /// - Consecutive Configurations in 'config_list' that share a Supercell are evaluated as a batch
+  ///   (see correlations(const std::vector<const ConfigDoF*>&, const Supercell&, Clexulator&, CorrMatrix&, Index)),
+  ///   so ordering Configurations by Supercell is most efficient
+  /// - Rows are in the same order as 'config_list'
+  /// - With 'num_threads' != 1, chunks of 'config_list' are evaluated concurrently, each worker thread
+  ///   using its own copy of 'clexulator' (0 uses all available cores, see resolve_num_threads).
+  ///   Results do not depend on the number of threads.
+  /// - Same setup requirements as correlations(const Configuration&, Clexulator&)
+  ///
+  CorrMatrix &correlations(const std::vector<const Configuration *> &config_list,
+                           Clexulator &clexulator,
+                           CorrMatrix &corr_mat,
+                           Index num_threads) {
+
+    corr_mat.resize(config_list.size(), clexulator.corr_size());
+
+    Index N_chunk = (config_list.size() + corr_chunk_size - 1) / corr_chunk_size;
+    num_threads = std::min(resolve_num_threads(num_threads), std::max(N_chunk, Index(1)));
+
+    if(num_threads == 1) {
+      _correlations(config_list, 0, config_list.size(), clexulator, corr_mat);
+      return corr_mat;
+    }
+
+    // Clexulators hold evaluation state, so each worker needs its own copy
+    std::vector<Clexulator> clexulator_copies(num_threads, clexulator);
+
+    parallel_for_chunks(config_list.size(), corr_chunk_size, num_threads,
+    [&](Index thread, Index begin, Index end) {
+      _correlations(config_list, begin, end, clexulator_copies[thread], corr_mat);
+    });
+
+    return corr_mat;
+  }
+
+  /// \brief Fills 'energy' with the cluster expansion per unit cell using 'energy_clexulator', one
+  ///        value per Configuration in 'config_list'
+  ///
+  /// - With 'num_threads' != 1, chunks of 'config_list' are evaluated concurrently, each worker thread
+  ///   using its own copy of 'energy_clexulator' (0 uses all available cores, see resolve_num_threads).
+  ///   Results do not depend on the number of threads.
+  /// - Same setup requirements as clex_energy(const ConfigDoF&, const Supercell&, EnergyClexulator&)
+  ///
+  std::vector<double> &clex_energy(const std::vector<const Configuration *> &config_list,
+                                   EnergyClexulator &energy_clexulator,
+                                   std::vector<double> &energy,
+                                   Index num_threads) {
+
+    energy.resize(config_list.size());
+
+    Index N_chunk = (config_list.size() + corr_chunk_size - 1) / corr_chunk_size;
+    num_threads = std::min(resolve_num_threads(num_threads), std::max(N_chunk, Index(1)));
+
+    if(num_threads == 1) {
+      for(Index i = 0; i < config_list.size(); i++) {
+        energy[i] = clex_energy(config_list[i]->configdof(), config_list[i]->get_supercell(), energy_clexulator);
+      }
+      return energy;
+    }
+
+    // EnergyClexulators hold evaluation state, so each worker needs its own copy
+    std::vector<EnergyClexulator> clexulator_copies(num_threads, energy_clexulator);
+
+    parallel_for_chunks(config_list.size(), corr_chunk_size, num_threads,
+    [&](Index thread, Index begin, Index end) {
+      for(Index i = begin; i < end; i++) {
+        energy[i] = clex_energy(config_list[i]->configdof(), config_list[i]->get_supercell(), clexulator_copies[thread]);
+      }
+    });
+
+    return energy;
+  }
+
 }
 
 
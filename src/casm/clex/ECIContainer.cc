@@ -18,6 +18,15 @@ namespace CASM {
     return result;
   }
 
+  double operator*(const ECIContainer &_eci, double const *_corr_begin) {
+    double result(0);
+    auto ind_it(_eci.eci_index_list().cbegin()), ind_end(_eci.eci_index_list().cend());
+    auto eci_it(_eci.eci_list().cbegin());
+    for(; ind_it != ind_end; ++ind_it, ++eci_it)
+      result += (*eci_it) * _corr_begin[*ind_it];
+    return result;
+  }
+
   namespace ECIContainer_impl {
     /**
      * Read from specified path and fill up ECI values and indices.
@@ -1,12 +1,19 @@
 #include "casm/clex/PrimClex.hh"
 
+#include <iomanip>
+#include <numeric>
+
 #include <boost/algorithm/string.hpp>
 
 #include "casm/clex/ConfigIterator.hh"
 #include "casm/clex/ECIContainer.hh"
+#include "casm/clex/TableClexulator.hh"
+#include "casm/misc/Hash.hh"
 #include "casm/clusterography/jsonClust.hh"
 #include "casm/system/RuntimeLibrary.hh"
+#include "casm/system/ParallelFor.hh"
 #include "casm/casm_io/SafeOfstream.hh"
+#include "casm/casm_io/jsonStream.hh"
 
 
 namespace CASM {
@@ -83,7 +90,9 @@ namespace CASM {
     }
 
     // read config_list
-    if(fs::is_regular_file(get_config_list_path())) {
+    //   configurations are stored in a file per supercell, and read on first access. Projects
+    //   that still have a single config_list.json are read here, and converted by write_config_list()
+    if(fs::is_regular_file(get_config_list_path()) && !fs::exists(m_dir.config_list_dir())) {
 
       any_print = true;
       sout << "  Read " << get_config_list_path() << std::endl;
@@ -117,13 +126,13 @@ namespace CASM {
   //*******************************************************************************************
   /// Return supercell directory path
   fs::path PrimClex::get_path(const Index &scel_index) const {
-    return root / "training_data" / supercell_list[scel_index].get_name();
+    return root / "training_data" / get_supercell(scel_index).get_name();
   }
 
   //*******************************************************************************************
   /// Return configuration directory path
   fs::path PrimClex::get_path(const Index &scel_index, const Index &config_index) const {
-    return get_path(scel_index) / supercell_list[scel_index].get_config(config_index).get_id();
+    return get_path(scel_index) / get_supercell(scel_index).get_config(config_index).get_id();
   }
 
   //*******************************************************************************************
@@ -230,18 +239,21 @@ namespace CASM {
   //*******************************************************************************************
   /// const Access entire supercell_list
   const boost::container::stable_vector<Supercell> &PrimClex::get_supercell_list() const {
+    _construct_supercells();
     return supercell_list;
   };
 
   //*******************************************************************************************
   /// const Access supercell by index
   const Supercell &PrimClex::get_supercell(Index i) const {
+    _construct_supercells(i + 1);
     return supercell_list[i];
   };
 
   //*******************************************************************************************
   /// Access supercell by index
   Supercell &PrimClex::get_supercell(Index i) {
+    _construct_supercells(i + 1);
     return supercell_list[i];
   };
 
@@ -254,7 +266,7 @@ namespace CASM {
       std::cout << "  supercell '" << scellname << "' not found." << std::endl;
       exit(1);
     }
-    return supercell_list[index];
+    return get_supercell(index);
   };
 
   //*******************************************************************************************
@@ -266,7 +278,7 @@ namespace CASM {
       std::cout << "  supercell '" << scellname << "' not found." << std::endl;
       exit(1);
     }
-    return supercell_list[index];
+    return get_supercell(index);
   };
 
   //*******************************************************************************************
@@ -327,6 +339,7 @@ namespace CASM {
 
   /// Configuration iterator: begin
   PrimClex::config_iterator PrimClex::config_begin() {
+    _construct_supercells();
     if(supercell_list.size() == 0 || supercell_list[0].get_config_list().size() > 0)
       return config_iterator(this, 0, 0);
     return ++config_iterator(this, 0, 0);
@@ -335,12 +348,14 @@ namespace CASM {
   //*******************************************************************************************
   /// Configuration iterator: end
   PrimClex::config_iterator PrimClex::config_end() {
+    _construct_supercells();
     return config_iterator(this, supercell_list.size(), 0);
   }
 
   //*******************************************************************************************
   /// const Configuration iterator: begin
   PrimClex::config_const_iterator PrimClex::config_cbegin() const {
+    _construct_supercells();
     if(supercell_list.size() == 0 || supercell_list[0].get_config_list().size() > 0)
       return config_const_iterator(this, 0, 0);
     return ++config_const_iterator(this, 0, 0);
@@ -349,6 +364,7 @@ namespace CASM {
   //*******************************************************************************************
   /// const Configuration iterator: end
   PrimClex::config_const_iterator PrimClex::config_cend() const {
+    _construct_supercells();
     return config_const_iterator(this, supercell_list.size(), 0);
   }
 
@@ -356,6 +372,7 @@ namespace CASM {
   //*******************************************************************************************
   /// Configuration iterator: begin
   PrimClex::config_iterator PrimClex::selected_config_begin() {
+    _construct_supercells();
     //std::cout << "BEGINNING SELECTED CONFIG ITERATOR\n"
     //          << "supercell_list.size() is " << supercell_list.size() << "\n";
 
@@ -367,12 +384,14 @@ namespace CASM {
   //*******************************************************************************************
   /// Configuration iterator: end
   PrimClex::config_iterator PrimClex::selected_config_end() {
+    _construct_supercells();
     return config_iterator(this, supercell_list.size(), 0, true);
   }
 
   //*******************************************************************************************
   /// const Configuration iterator: begin
   PrimClex::config_const_iterator PrimClex::selected_config_cbegin() const {
+    _construct_supercells();
     if(supercell_list.size() == 0 || (supercell_list[0].get_config_list().size() > 0 && supercell_list[0].get_config(0).selected()))
       return config_const_iterator(this, 0, 0, true);
     return ++config_const_iterator(this, 0, 0, true);
@@ -381,6 +400,7 @@ namespace CASM {
   //*******************************************************************************************
   /// const Configuration iterator: end
   PrimClex::config_const_iterator PrimClex::selected_config_cend() const {
+    _construct_supercells();
     return config_const_iterator(this, supercell_list.size(), 0, true);
   }
 
@@ -404,38 +424,86 @@ namespace CASM {
   // **** IO ****
   //*******************************************************************************************
   /**
-   * Re-write config_list.json, updating all the data
+   * Write the config_list file of each supercell whose configurations have been modified, see
+   * Supercell::config_list_dirty. Other supercells are unchanged on disk, and are not rewritten.
+   *
+   * If the project has a single config_list.json, it is first split into a file per supercell,
+   * and then moved to config_list.json.bak.
    */
 
   void PrimClex::write_config_list() {
 
-    if(supercell_list.size() == 0) {
+    // supercells that have not been constructed have not been read or modified
+    if(m_scel_transf_mat.size() == 0) {
       fs::remove(get_config_list_path());
+      fs::remove_all(m_dir.config_list_dir());
       return;
     }
 
-    jsonParser json;
+    if(fs::is_regular_file(get_config_list_path()) && !fs::exists(m_dir.config_list_dir())) {
+      _split_config_list();
+    }
+
+    fs::create_directories(m_dir.config_list_dir());
+
+    for(Index s = 0; s < supercell_list.size(); s++) {
+      if(supercell_list[s].config_list_dirty()) {
+        supercell_list[s].write_config_list();
+      }
+    }
+
+    write_config_list_summary();
 
     if(fs::exists(get_config_list_path())) {
-      json.read(get_config_list_path());
+      fs::path backup = get_config_list_path();
+      backup += ".bak";
+      fs::rename(get_config_list_path(), backup);
     }
-    else {
-      json.put_obj();
+
+    return;
+  }
+
+
+  //*******************************************************************************************
+
+  /// Only the counts of Supercell whose config list has been read are updated, the others
+  ///   are kept as they are
+  void PrimClex::write_config_list_summary() const {
+    // a project with a single config_list.json is not split until write_config_list
+    if(root.empty() || !fs::exists(m_dir.config_list_dir())) {
+      return;
     }
 
+    jsonParser summary = config_list_summary();
+    bool updated = false;
     for(Index s = 0; s < supercell_list.size(); s++) {
-      supercell_list[s].write_config_list(json);
+      if(supercell_list[s].config_list_loaded()) {
+        supercell_list[s].write_config_list_summary(summary["supercells"][supercell_list[s].get_name()]);
+        updated = true;
+      }
+    }
+    if(!updated && fs::exists(m_dir.config_list_summary())) {
+      return;
     }
+    SafeOfstream summary_file;
+    summary_file.open(m_dir.config_list_summary());
+    summary.print(summary_file.ofstream());
+    summary_file.close();
+    m_config_list_summary = summary;
+  }
 
-    SafeOfstream file;
-    file.open(get_config_list_path());
-    json.print(file.ofstream());
-    file.close();
+  //*******************************************************************************************
 
-    return;
+  const jsonParser &PrimClex::config_list_summary() const {
+    if(!m_config_list_summary_read) {
+      m_config_list_summary_read = true;
+      if(!root.empty() && fs::is_regular_file(m_dir.config_list_summary())) {
+        m_config_list_summary = jsonParser(m_dir.config_list_summary());
+      }
+    }
+    return m_config_list_summary;
   }
 
-
   // **** Operators ****
 
 
@@ -659,6 +727,7 @@ namespace CASM {
     //print_clexulator(clex_stream, "MyClexulator", global_orbitree);
     //clex_stream.close();
 
+    generate_supercell_nlists();
     return;
   };
 
@@ -743,9 +812,10 @@ namespace CASM {
    *  ARN 100213
    */
   //*******************************************************************************************
-  void PrimClex::generate_supercells(int volStart, int volEnd, bool verbose) {
+  void PrimClex::generate_supercells(int volStart, int volEnd, bool verbose, long num_threads) {
+    _construct_supercells();
     Array < Lattice > supercell_lattices;
-    prim.lattice().generate_supercells(supercell_lattices, prim.factor_group(), volEnd, volStart);    //point_group?
+    prim.lattice().generate_supercells(supercell_lattices, prim.factor_group(), volEnd, volStart, num_threads);    //point_group?
     for(Index i = 0; i < supercell_lattices.size(); i++) {
       Index list_size = supercell_list.size();
       Index index = add_canonical_supercell(supercell_lattices[i]);
@@ -761,9 +831,13 @@ namespace CASM {
 
   }
   //*******************************************************************************************
+  /// Supercell generate their neighbor lists on first use, see Supercell::nlist(), so this only
+  ///   regenerates those already generated, after prim_nlist has changed
   void PrimClex::generate_supercell_nlists() {
     for(Index i = 0; i < supercell_list.size(); i++) {
-      supercell_list[i].generate_neighbor_list();
+      if(supercell_list[i].nlist_generated()) {
+        supercell_list[i].generate_neighbor_list();
+      }
     }
   }
 
@@ -794,14 +868,17 @@ namespace CASM {
     // Does this check for equivalent supercells with different transformation matrices? Seems like it should
     // Insert second loop that goes over a symmetry operation list and applies it to the transformation matrix
     Supercell scel(this, superlat);
-    scel.set_id(supercell_list.size());
-    for(Index i = 0; i < supercell_list.size(); i++) {
-      if(supercell_list[i].get_transf_mat() == scel.get_transf_mat())
-        return i;
+    auto it = m_scel_index.find(scel.get_name());
+    if(it != m_scel_index.end() && m_scel_transf_mat[it->second] == scel.get_transf_mat()) {
+      return it->second;
     }
 
     // if not already existing, add it
+    _construct_supercells();
+    scel.set_id(supercell_list.size());
     supercell_list.push_back(scel);
+    m_scel_transf_mat.push_back(scel.get_transf_mat());
+    m_scel_index.insert(std::make_pair(scel.get_name(), supercell_list.size() - 1));
     return supercell_list.size() - 1;
   }
   //*******************************************************************************************
@@ -833,13 +910,58 @@ namespace CASM {
    */
   //*******************************************************************************************
   void PrimClex::enumerate_all_configurations() {
-    for(Index i = 0; i < supercell_list.size(); i++) {
-      supercell_list[i].enumerate_all_occupation_configurations();
+    _construct_supercells();
+    std::vector<Index> scel_indices(supercell_list.size());
+    std::iota(scel_indices.begin(), scel_indices.end(), 0);
+    enumerate_occupation_configurations(scel_indices);
+  }
+
+  //*******************************************************************************************
+  /**  ENUMERATE_OCCUPATION_CONFIGURATIONS
+   *   Each supercell is enumerated into its own buffer by a worker thread, largest supercells
+   *   first. Buffers are then added to the supercells in the order given by 'scel_indices'.
+   */
+  //*******************************************************************************************
+  void PrimClex::enumerate_occupation_configurations(const std::vector<Index> &scel_indices, bool orderly) {
+    _construct_supercells();
+
+    if(resolve_num_threads(num_threads()) == 1) {
+      for(Index i = 0; i < scel_indices.size(); i++) {
+        supercell_list[scel_indices[i]].enumerate_all_occupation_configurations(orderly);
+      }
+      return;
+    }
+
+    // Symmetry representations and translation permutations are generated on first use, and
+    //   may be shared between supercells, so generate them before starting threads
+    for(Index i = 0; i < scel_indices.size(); i++) {
+      supercell_list[scel_indices[i]].permute_begin();
+    }
+
+    // Cost grows rapidly with volume, so schedule the largest supercells first
+    std::vector<Index> order(scel_indices.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](Index a, Index b) {
+      return supercell_list[scel_indices[a]].volume() > supercell_list[scel_indices[b]].volume();
+    });
+
+    std::vector<std::vector<Configuration> > buffer(scel_indices.size());
+    parallel_for_chunks(order.size(), 1, num_threads(), [&](long thread, long begin, long end) {
+      for(long i = begin; i < end; ++i) {
+        Index k = order[i];
+        supercell_list[scel_indices[k]].enumerate_all_occupation_configurations(buffer[k], orderly);
+      }
+    });
+
+    for(Index k = 0; k < scel_indices.size(); k++) {
+      supercell_list[scel_indices[k]].add_enumerated_configurations(buffer[k]);
+      std::vector<Configuration>().swap(buffer[k]);
     }
   }
 
   //*******************************************************************************************
   void PrimClex::print_supercells() const {
+    _construct_supercells();
 
 
     // also write supercells/supercell_path directories with LAT files
@@ -876,6 +998,7 @@ namespace CASM {
 
   //*******************************************************************************************
   void PrimClex::print_supercells(std::ostream &stream) const {
+    _construct_supercells();
     for(Index i = 0; i < supercell_list.size(); i++) {
       stream << "Supercell Name: '" << supercell_list[i].get_name() << "' Number: " << i << " Volume: " << supercell_list[i].get_transf_mat().determinant() << "\n";
       stream << "Supercell Transformation Matrix: \n";
@@ -902,6 +1025,9 @@ namespace CASM {
 
     Matrix3<double> mat;
 
+    // Supercells are not constructed until first accessed. The transformation matrix is
+    //   calculated as in the Supercell constructor, so names and duplicates match.
+
     std::string s;
     while(!stream.eof()) {
       std::getline(stream, s);
@@ -911,11 +1037,38 @@ namespace CASM {
 
         //Lattice lat(prim.lattice.coord_trans(CASM::FRAC)*mat);
         Lattice lat(prim.lattice().coord_trans(FRAC)*mat);
-        add_canonical_supercell(lat);
+        Matrix3<int> transf_mat = calc_transf_mat(lat);
+
+        std::string name = generate_scel_name(transf_mat);
+        auto it = m_scel_index.find(name);
+        if(it != m_scel_index.end() && m_scel_transf_mat[it->second] == transf_mat) {
+          continue;
+        }
+        if(it == m_scel_index.end()) {
+          m_scel_index.insert(std::make_pair(name, m_scel_transf_mat.size()));
+        }
+        m_scel_transf_mat.push_back(transf_mat);
       }
     }
   }
 
+  //*******************************************************************************************
+  void PrimClex::_construct_supercells() const {
+    _construct_supercells(m_scel_transf_mat.size());
+  }
+
+  //*******************************************************************************************
+  void PrimClex::_construct_supercells(Index end) const {
+    end = std::min(end, Index(m_scel_transf_mat.size()));
+    PrimClex *self = const_cast<PrimClex *>(this);
+    while(supercell_list.size() < end) {
+      Supercell scel(self, m_scel_transf_mat[supercell_list.size()]);
+      scel.set_id(supercell_list.size());
+      supercell_list.push_back(scel);
+    }
+  }
+
+
   //*******************************************************************************************
   /**
    * Use the global_orbitree of *this to populate the global correlations in the
@@ -1002,15 +1155,71 @@ namespace CASM {
    */
   //*******************************************************************************************
   void PrimClex::read_config_list() {
+    _construct_supercells();
 
-    jsonParser json(get_config_list_path());
-
-    if(!json.contains("supercells")) {
-      return;
+    // read one configuration at a time, the file may be large
+    fs::ifstream file(get_config_list_path());
+    jsonStreamReader reader(file);
+    try {
+      reader.expect(jsonStreamReader::BEGIN_OBJECT);
+      while(reader.next() == jsonStreamReader::KEY) {
+        if(reader.key() != "supercells") {
+          reader.skip();
+          continue;
+        }
+        reader.expect(jsonStreamReader::BEGIN_OBJECT);
+        while(reader.next() == jsonStreamReader::KEY) {
+          Index index;
+          if(contains_supercell(reader.key(), index)) {
+            supercell_list[index].read_config_list(reader);
+          }
+          else {
+            reader.skip();
+          }
+        }
+      }
+    }
+    catch(std::runtime_error &e) {
+      throw std::runtime_error(std::string(e.what()) + "\n  while reading " + get_config_list_path().string());
     }
+  }
 
-    for(Index i = 0; i < supercell_list.size(); i++) {
-      supercell_list[i].read_config_list(json);
+  //*******************************************************************************************
+
+  void PrimClex::_split_config_list() const {
+    fs::create_directories(m_dir.config_list_dir());
+
+    // copy one configuration at a time, the file may be large
+    fs::ifstream file(get_config_list_path());
+    jsonStreamReader reader(file);
+    try {
+      reader.expect(jsonStreamReader::BEGIN_OBJECT);
+      while(reader.next() == jsonStreamReader::KEY) {
+        if(reader.key() != "supercells") {
+          reader.skip();
+          continue;
+        }
+        reader.expect(jsonStreamReader::BEGIN_OBJECT);
+        while(reader.next() == jsonStreamReader::KEY) {
+          std::string scelname = reader.key();
+          SafeOfstream scel_file;
+          scel_file.open(m_dir.config_list(scelname));
+          jsonStreamWriter writer(scel_file.ofstream());
+          writer.begin_object().key("supercells").begin_object().key(scelname).begin_object();
+          reader.expect(jsonStreamReader::BEGIN_OBJECT);
+          while(reader.next() == jsonStreamReader::KEY) {
+            writer.key(reader.key());
+            jsonParser json_config;
+            reader.read(json_config);
+            writer.value(json_config);
+          }
+          writer.end_object().end_object().end_object();
+          scel_file.close();
+        }
+      }
+    }
+    catch(std::runtime_error &e) {
+      throw std::runtime_error(std::string(e.what()) + "\n  while splitting " + get_config_list_path().string());
     }
   }
 
@@ -1022,6 +1231,7 @@ namespace CASM {
   //*******************************************************************************************
 
   int PrimClex::amount_selected() const {
+    _construct_supercells();
     int amount_selected = 0;
     for(Index s = 0; s < supercell_list.size(); s++) {
       amount_selected += supercell_list[s].amount_selected();
@@ -1031,13 +1241,12 @@ namespace CASM {
 
   //*******************************************************************************************
   bool PrimClex::contains_supercell(std::string scellname, Index &index) const {
-    for(Index i = 0; i < supercell_list.size(); i++) {
-      if(supercell_list[i].get_name() == scellname) {
-        index = i;
-        return true;
-      }
+    auto it = m_scel_index.find(scellname);
+    if(it != m_scel_index.end()) {
+      index = it->second;
+      return true;
     }
-    index = supercell_list.size();
+    index = m_scel_transf_mat.size();
     return false;
 
   };
@@ -1230,6 +1439,7 @@ namespace CASM {
   /// Return the configuration closest in param_composition to the target_param_comp
   ///   Tie break returns configuration in smallest supercell (first found at that size)
   const Configuration &PrimClex::closest_calculated_config(const Eigen::VectorXd &target_param_comp) const {
+    _construct_supercells();
 
     //std::cout << "begin closest_calculated_config()" << std::endl;
 
@@ -1299,6 +1509,7 @@ namespace CASM {
 
   //*******************************************************************************************
   void PrimClex::populate_structure_factor() {
+    _construct_supercells();
     for(Index i = 0; i < supercell_list.size(); i++)
       populate_structure_factor(i);
     return;
@@ -1306,12 +1517,14 @@ namespace CASM {
 
   //*******************************************************************************************
   void PrimClex::populate_structure_factor(const Index &scell_index) {
+    _construct_supercells();
     supercell_list[scell_index].populate_structure_factor();
     return;
   }
 
   //*******************************************************************************************
   void PrimClex::populate_structure_factor(const Index &scell_index, const Index &config_index) {
+    _construct_supercells();
     supercell_list[scell_index].populate_structure_factor(config_index);
     return;
   }
@@ -1323,14 +1536,67 @@ namespace CASM {
         throw std::runtime_error(
           std::string("Error loading clexulator ") + settings().bset() + ". No basis functions exist.");
       }
-      m_global_clexulator = Clexulator(settings().global_clexulator(),
-                                       dir().clexulator_dir(settings().bset()),
-                                       settings().compile_options(),
-                                       settings().so_options());
+      if(settings().clexulator_type() == "table") {
+        Structure prim(get_prim());
+        SiteOrbitree tree(prim.lattice());
+        Array<UnitCellCoord> nlist;
+        _read_global_basis_functions(prim, tree, nlist);
+        m_global_clexulator = Clexulator(settings().global_clexulator(),
+                                         std::unique_ptr<Clexulator_impl::Base>(new TableClexulator(prim, tree, nlist)));
+      }
+      else {
+        m_global_clexulator = Clexulator(settings().global_clexulator(),
+                                         dir().clexulator_dir(settings().bset()),
+                                         settings().compile_options(),
+                                         settings().so_options());
+      }
     }
     return m_global_clexulator;
   }
 
+  //*******************************************************************************************
+  /// The orbits are read from clust.json, rather than generated again, so they are the same as
+  /// the orbits of the generated Clexulator source, and the site basis functions are those of
+  /// bspecs.json.
+  void PrimClex::_read_global_basis_functions(Structure &prim, SiteOrbitree &tree, Array<UnitCellCoord> &nlist) const {
+    jsonParser bspecs_json(dir().bspecs(settings().bset()));
+    prim.fill_occupant_bases(bspecs_json["basis_functions"]["site_basis_functions"].get<std::string>()[0]);
+
+    tree.min_num_components = 2;
+    tree.min_length = 0.0001;
+    from_json(jsonHelper(tree, prim), jsonParser(dir().clust(settings().bset())));
+    tree.collect_basis_info(prim);
+    tree.generate_clust_bases();
+
+    expand_nlist(prim, tree, nlist);
+  }
+
+  //*******************************************************************************************
+  /// \brief Binary cache of correlations calculated with global_clexulator(), or nullptr if not available
+  ///
+  /// - The cache is stored in the hidden .casm directory, one file per basis set, and is keyed by
+  ///   a hash of the Clexulator source, so editing or regenerating basis functions starts a new cache
+  /// - Returns nullptr if this PrimClex has no project directory, or if the cache can not be
+  ///   opened, in which case correlations should just be calculated
+  CorrCache *PrimClex::global_corr_cache() const {
+    if(get_path().empty()) {
+      return nullptr;
+    }
+    fs::path filename = dir().corr_cache(settings().bset());
+    if(!m_global_corr_cache || m_global_corr_cache_path != filename) {
+      m_global_corr_cache_path = filename;
+      m_global_corr_cache = std::make_shared<CorrCache>();
+      try {
+        std::uint64_t basis_hash = fnv1a_hash_file(dir().clexulator_src(settings().name(), settings().bset()));
+        m_global_corr_cache->open(filename, basis_hash, global_clexulator().corr_size());
+      }
+      catch(std::exception &e) {
+        std::cerr << "Warning: could not open correlations cache " << filename << ": " << e.what() << std::endl;
+      }
+    }
+    return m_global_corr_cache->is_open() ? m_global_corr_cache.get() : nullptr;
+  }
+
   //*******************************************************************************************
   ECIContainer PrimClex::global_eci(std::string clex_name)const {
     return ECIContainer(dir().eci_out(clex_name,
@@ -1340,6 +1606,78 @@ namespace CASM {
                                       settings().eci()));
   }
 
+  //*******************************************************************************************
+  /// \brief Clexulator with the ECI of 'clex_name' folded in, regenerated if the ECI or basis set change
+  ///
+  /// - The source is written next to eci.out, and its first line records a hash of eci.out and
+  ///   of the global Clexulator source. If either has changed, the basis functions are
+  ///   regenerated from clust.json, the source is re-written, and it is re-compiled.
+  /// - Throws if there are no basis functions or no ECI, or if clust.json no longer gives
+  ///   the basis set of the global Clexulator.
+  EnergyClexulator PrimClex::global_energy_clexulator(std::string clex_name) const {
+
+    const ProjectSettings &set = settings();
+    fs::path clex_src = dir().clexulator_src(set.name(), set.bset());
+    fs::path eci_path = dir().eci_out(clex_name, set.calctype(), set.ref(), set.bset(), set.eci());
+    fs::path src = dir().energy_clexulator_src(set.name(), clex_name, set.calctype(), set.ref(), set.bset(), set.eci());
+
+    if(!fs::exists(clex_src)) {
+      throw std::runtime_error(
+        std::string("Error loading energy clexulator ") + set.bset() + ". No basis functions exist.");
+    }
+    if(!fs::exists(eci_path)) {
+      throw std::runtime_error(
+        std::string("Error loading energy clexulator: ") + eci_path.string() + " does not exist.");
+    }
+    if(set.clexulator_type() == "table") {
+      throw std::runtime_error(
+        "Error loading energy clexulator: Energy clexulators must be compiled, but the clexulator type is 'table'.");
+    }
+
+    std::uint64_t eci_hash = fnv1a_hash_file(eci_path);
+    std::uint64_t basis_hash = fnv1a_hash_file(clex_src);
+    std::stringstream ss;
+    ss << "// key: " << std::hex << fnv1a_hash(&basis_hash, sizeof(basis_hash), eci_hash);
+    std::string key = ss.str();
+
+    std::string curr_key;
+    if(fs::exists(src)) {
+      fs::ifstream in(src);
+      std::getline(in, curr_key);
+    }
+
+    if(curr_key != key) {
+
+      Structure prim(get_prim());
+      SiteOrbitree tree(prim.lattice());
+      Array<UnitCellCoord> nlist;
+      _read_global_basis_functions(prim, tree, nlist);
+
+      Clexulator clexulator = global_clexulator();
+      if(tree.basis_set_size() != clexulator.corr_size() || nlist.size() != clexulator.nlist_size()) {
+        throw std::runtime_error(
+          std::string("Error generating energy clexulator: ") + dir().clust(set.bset()).string() +
+          " does not match the basis functions. Please re-run 'casm bset -u'.");
+      }
+
+      SafeOfstream file;
+      file.open(src);
+      file.ofstream() << key << "\n";
+      print_energy_clexulator(prim, tree, nlist, ECIContainer(eci_path), set.energy_clexulator(), file.ofstream());
+      file.close();
+      m_global_energy_clexulator = EnergyClexulator();
+    }
+
+    if(!m_global_energy_clexulator.initialized() || m_global_energy_clexulator_src != src) {
+      m_global_energy_clexulator_src = src;
+      m_global_energy_clexulator = EnergyClexulator(set.energy_clexulator(),
+                                                    src.parent_path(),
+                                                    set.compile_options(),
+                                                    set.so_options());
+    }
+    return m_global_energy_clexulator;
+  }
+
   //*******************************************************************************************
   /// \brief Make orbitree. For now specifically global.
   ///
@@ -1464,6 +1802,65 @@ namespace CASM {
     }
   }
 
+  namespace {
+
+    /// \brief Add the degrees of freedom of 'prim' to 'dof_manager', for printing a clexulator
+    void _init_clexulator_dofs(DoFManager &dof_manager,
+                               const Structure &prim,
+                               SiteOrbitree &tree,
+                               const Array<UnitCellCoord> &nlist) {
+
+      for(Index b = 0; b < prim.basis.size(); b++) {
+        if(prim.basis[b].site_occupant().size() > 1) {
+          dof_manager.add_dof(prim.basis[b].site_occupant().type_name());
+          break;
+        }
+      }
+      for(Index b = 0; b < prim.basis.size(); b++) {
+        for(Index i = 0; i < prim.basis[i].displacement().size(); i++)
+          dof_manager.add_dof(prim.basis[b].displacement()[i].type_name());
+      }
+
+      dof_manager.resize_neighborhood(nlist.size());
+
+      // We can add more as needed
+      dof_manager.register_dofs(tree);
+    }
+
+    /// \brief Formulae for the change in the 'N_func' flower functions about basis site 'nb' due to changing its occupant
+    Array<std::string> _delta_flower_formulae(SiteOrbit &orbit,
+                                              const Array<FunctionVisitor *> &labelers,
+                                              const Structure &prim,
+                                              Index nb,
+                                              Index N_func) {
+
+      // Very configuration-centric -> Find a way to move this block to OccupationDoFEnvironment:
+      Array<std::string> formulae(N_func, std::string()), tformulae;
+      // loop over site basis functions
+      for(Index nsbf = 0; nsbf < prim.basis[nb].occupant_basis().size(); nsbf++) {
+        std::string delta_prefix = "(m_occ_func_" + std::to_string(nb) + "_" + std::to_string(nsbf) + "[occ_f] - m_occ_func_" + std::to_string(nb) + "_" + std::to_string(nsbf) + "[occ_i])";
+
+        tformulae = orbit.delta_occfunc_flower_function_cpp_strings(labelers, nb, nsbf);
+        for(Index nf = 0; nf < tformulae.size(); nf++) {
+          if(!tformulae[nf].size())
+            continue;
+
+          if(formulae[nf].size())
+            formulae[nf] += " + ";
+
+          formulae[nf] += delta_prefix;
+
+          if(tformulae[nf] == "1" || tformulae[nf] == "(1)")
+            continue;
+
+          formulae[nf] += "*";
+          formulae[nf] += tformulae[nf];
+        }
+      }
+      return formulae;
+    }
+  }
+
   //*******************************************************************************************
   /// \brief Print clexulator
   void print_clexulator(const Structure &prim,
@@ -1473,26 +1870,19 @@ namespace CASM {
                         std::ostream &stream) {
 
     DoFManager dof_manager;
-
-    for(Index b = 0; b < prim.basis.size(); b++) {
-      if(prim.basis[b].site_occupant().size() > 1) {
-        dof_manager.add_dof(prim.basis[b].site_occupant().type_name());
-        break;
-      }
-    }
-    for(Index b = 0; b < prim.basis.size(); b++) {
-      for(Index i = 0; i < prim.basis[i].displacement().size(); i++)
-        dof_manager.add_dof(prim.basis[b].displacement()[i].type_name());
-    }
-
-    dof_manager.resize_neighborhood(nlist.size());
-
-    // We can add more as needed
-    dof_manager.register_dofs(tree);
+    _init_clexulator_dofs(dof_manager, prim, tree, nlist);
 
     Index N_corr(tree.basis_set_size());
     std::stringstream private_def_stream, public_def_stream, interface_imp_stream, bfunc_imp_stream;
 
+    // basis function implementations of the empty cluster, printed with the interface, and of
+    // the other orbit branches, printed as (label, implementation) translation units, with large
+    // branches split into several so that no one translation unit takes much longer to compile
+    std::string empty_imp_str;
+    std::vector<std::pair<std::string, std::string> > branch_tu;
+    const Index max_tu_size = 100000;
+    Index tu_begin_orbit = 0;
+
     std::string uclass_name;
     for(Index i = 0; i < class_name.size(); i++)
       uclass_name.push_back(std::toupper(class_name[i]));
@@ -1595,7 +1985,7 @@ namespace CASM {
     Array<Array<std::string> > dflower_method_names(prim.basis.size(), Array<std::string>(N_corr));
 
     // temporary storage for formula
-    Array<std::string> formulae, tformulae;
+    Array<std::string> formulae;
 
     bool make_newline(false);
 
@@ -1659,30 +2049,7 @@ namespace CASM {
           }
           make_newline = false;
 
-          // Very configuration-centric -> Find a way to move this block to OccupationDoFEnvironment:
-          formulae.resize(formulae.size(), std::string());
-          // loop over site basis functions
-          for(Index nsbf = 0; nsbf < prim.basis[nb].occupant_basis().size(); nsbf++) {
-            std::string delta_prefix = "(m_occ_func_" + std::to_string(nb) + "_" + std::to_string(nsbf) + "[occ_f] - m_occ_func_" + std::to_string(nb) + "_" + std::to_string(nsbf) + "[occ_i])";
-
-            tformulae = tree[np][no].delta_occfunc_flower_function_cpp_strings(labelers, nb, nsbf);
-            for(Index nf = 0; nf < tformulae.size(); nf++) {
-              if(!tformulae[nf].size())
-                continue;
-
-              if(formulae[nf].size())
-                formulae[nf] += " + ";
-
-              formulae[nf] += delta_prefix;
-
-              if(tformulae[nf] == "1" || tformulae[nf] == "(1)")
-                continue;
-
-              formulae[nf] += "*";
-              formulae[nf] += tformulae[nf];
-              //formulae[nf] += ")";
-            }
-          }
+          formulae = _delta_flower_formulae(tree[np][no], labelers, prim, nb, formulae.size());
           for(Index nf = 0; nf < formulae.size(); nf++) {
             if(!formulae[nf].size())
               continue;
@@ -1706,7 +2073,21 @@ namespace CASM {
         // \End Configuration specific part
 
         lf += tlf;
+
+        if(np > 0 && (no + 1 == tree[np].size() || bfunc_imp_stream.tellp() >= max_tu_size)) {
+          std::string label = "orbit branch " + std::to_string(np);
+          if(tu_begin_orbit != 0 || no + 1 != tree[np].size())
+            label += ", orbits " + std::to_string(tu_begin_orbit) + " to " + std::to_string(no);
+          branch_tu.push_back(std::make_pair(label, bfunc_imp_stream.str()));
+          bfunc_imp_stream.str("");
+          tu_begin_orbit = no + 1;
+        }
       }
+      if(np == 0) {
+        empty_imp_str = bfunc_imp_stream.str();
+        bfunc_imp_stream.str("");
+      }
+      tu_begin_orbit = 0;
     }//Finished writing method definitions and implementations for basis functions
 
     //clean up:
@@ -1841,12 +2222,19 @@ namespace CASM {
 
            indent << "};\n\n" << // close class definition
 
+           "}\n\n\n" <<      // close namespace
+
+           // the class definition is included in each translation unit, see Clexulator_impl::split_translation_units
+           Clexulator_impl::translation_unit_prefix() << "interface\n\n" <<
+
+           "namespace CASM {\n\n" <<
+
            indent <<
 
            "//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n\n" <<
 
            interface_imp_stream.str() <<
-           bfunc_imp_stream.str() <<
+           empty_imp_str <<
            "}\n\n\n" <<      // close namespace
 
            "extern \"C\" {\n" <<
@@ -1856,6 +2244,221 @@ namespace CASM {
            indent << "}\n\n" <<
            "}\n" <<
 
+           "\n";
+
+    // basis functions of clusters with one or more sites, compiled concurrently
+    for(Index i = 0; i < branch_tu.size(); i++) {
+      stream <<
+             "\n" <<
+             Clexulator_impl::translation_unit_prefix() << branch_tu[i].first << "\n\n" <<
+             "namespace CASM {\n\n" <<
+             branch_tu[i].second <<
+             "}\n\n";
+    }
+    // EOF
+
+    return;
+  }
+
+
+  //*******************************************************************************************
+  /// \brief Print clexulator with ECI folded into energy kernels
+  ///
+  /// Prints a Clexulator_impl::EnergyBase for the basis functions of 'tree' and the ECI 'eci'.
+  /// Unlike print_clexulator, there is no method per basis function and no tables of method
+  /// pointers: calc_energy and the per-basis-site delta energy methods are single functions of
+  /// 'eci*formula' terms, with the ECI as literal constants, and basis functions with zero ECI
+  /// are not printed at all.
+  void print_energy_clexulator(const Structure &prim,
+                               SiteOrbitree &tree,
+                               const Array<UnitCellCoord> &nlist,
+                               const ECIContainer &eci,
+                               std::string class_name,
+                               std::ostream &stream) {
+
+    DoFManager dof_manager;
+    _init_clexulator_dofs(dof_manager, prim, tree, nlist);
+
+    Index N_corr(tree.basis_set_size());
+
+    // ECI as literal constants, or empty if zero
+    Array<std::string> eci_str(N_corr);
+    for(Index i = 0; i < eci.eci_index_list().size(); i++) {
+      if(eci.eci_index_list()[i] >= N_corr) {
+        throw std::runtime_error(
+          std::string("Error in print_energy_clexulator: ECI for basis function ") +
+          std::to_string(eci.eci_index_list()[i]) + ", but there are only " + std::to_string(N_corr) + ".");
+      }
+      if(eci.eci_list()[i] != 0.0) {
+        std::stringstream ss;
+        ss << std::setprecision(17) << eci.eci_list()[i];
+        eci_str[eci.eci_index_list()[i]] = ss.str();
+      }
+    }
+
+    std::stringstream private_def_stream, public_def_stream, interface_imp_stream;
+    std::stringstream energy_stream;
+    Array<std::string> delta_str(prim.basis.size());
+
+    std::string indent(2, ' ');
+
+    //linear function index
+    Index lf = 0;
+
+    Array<FunctionVisitor *> labelers(dof_manager.get_function_label_visitors());
+    Array<std::string> formulae;
+
+    //loop over orbits
+    for(Index np = 0; np < tree.size(); np++) {
+      for(Index no = 0; no < tree[np].size(); no++) {
+
+        formulae = tree[np][no].orbit_function_cpp_strings(labelers);
+        Index tlf = formulae.size();
+
+        for(Index nf = 0; nf < formulae.size(); nf++) {
+          if(!formulae[nf].size() || !eci_str[lf + nf].size())
+            continue;
+          energy_stream <<
+                        indent << "  // bfunc " << lf + nf << ", orbit " << np << ", " << no << "\n" <<
+                        indent << "  result += " << eci_str[lf + nf] << "*(" << formulae[nf] << ");\n";
+        }
+
+        // loop over flowers (i.e., basis sites of prim)
+        for(Index nb = 0; nb < prim.basis.size(); nb++) {
+          formulae = _delta_flower_formulae(tree[np][no], labelers, prim, nb, tlf);
+          for(Index nf = 0; nf < formulae.size(); nf++) {
+            if(!formulae[nf].size() || !eci_str[lf + nf].size())
+              continue;
+            delta_str[nb] +=
+              indent + "  // bfunc " + std::to_string(lf + nf) + ", orbit " + std::to_string(np) + ", " + std::to_string(no) + "\n" +
+              indent + "  result += " + eci_str[lf + nf] + "*(" + formulae[nf] + ");\n";
+          }
+        }
+
+        lf += tlf;
+      }
+    }
+
+    //clean up:
+    for(Index nl = 0; nl < labelers.size(); nl++)
+      delete labelers[nl];
+    labelers.clear();
+
+    private_def_stream <<
+                       indent << "  /// \\brief Clone the EnergyBase\n" <<
+                       indent << "  virtual " << class_name << "* _clone() const override {\n" <<
+                       indent << "    return new " << class_name << "(*this);\n" <<
+                       indent << "  }\n\n";
+
+    dof_manager.print_clexulator_member_definitions(private_def_stream, prim, indent + "  ");
+
+    dof_manager.print_clexulator_private_method_definitions(private_def_stream, prim, indent + "  ");
+
+    for(Index nb = 0; nb < prim.basis.size(); nb++) {
+      private_def_stream <<
+                         indent << "  double delta_energy_at_" << nb << "(int occ_i, int occ_f) const;\n";
+    }
+
+    public_def_stream <<
+                      indent << "  " << class_name << "();\n\n" <<
+                      indent << "  ~" << class_name << "();\n\n" <<
+
+                      indent << "  /// \\brief Calculate contribution to the cluster expansion from one unit cell\n" <<
+                      indent << "  double calc_energy() const override;\n\n" <<
+
+                      indent << "  /// \\brief Calculate the change in the cluster expansion due to changing an occupant\n" <<
+                      indent << "  double calc_delta_energy(int b_index, int occ_i, int occ_f) const override;\n\n";
+
+    dof_manager.print_clexulator_public_method_definitions(public_def_stream, prim, indent + "  ");
+
+    // Write constructor and destructor
+    interface_imp_stream <<
+                         indent << class_name << "::" << class_name << "() :\n" <<
+                         indent << "  Clexulator_impl::EnergyBase(" << nlist.size() << ") {\n";
+
+    dof_manager.print_to_clexulator_constructor(interface_imp_stream, prim, indent + "  ");
+
+    interface_imp_stream <<
+                         indent << "}\n\n" <<
+
+                         indent << class_name << "::~" << class_name << "(){\n" <<
+                         indent << "  //nothing here for now\n" <<
+                         indent << "}\n\n";
+
+    // Write evaluation methods
+    interface_imp_stream <<
+                         indent << "/// \\brief Calculate contribution to the cluster expansion from one unit cell\n" <<
+                         indent << "double " << class_name << "::calc_energy() const {\n" <<
+                         indent << "  double result = 0.0;\n" <<
+                         energy_stream.str() <<
+                         indent << "  return result;\n" <<
+                         indent << "}\n\n";
+
+    for(Index nb = 0; nb < prim.basis.size(); nb++) {
+      interface_imp_stream <<
+                           indent << "double " << class_name << "::delta_energy_at_" << nb << "(int occ_i, int occ_f) const {\n" <<
+                           indent << "  double result = 0.0;\n" <<
+                           delta_str[nb] <<
+                           indent << "  return result;\n" <<
+                           indent << "}\n\n";
+    }
+
+    interface_imp_stream <<
+                         indent << "/// \\brief Calculate the change in the cluster expansion due to changing an occupant\n" <<
+                         indent << "double " << class_name << "::calc_delta_energy(int b_index, int occ_i, int occ_f) const {\n" <<
+                         indent << "  switch(b_index) {\n";
+    for(Index nb = 0; nb < prim.basis.size(); nb++) {
+      interface_imp_stream <<
+                           indent << "  case " << nb << ":\n" <<
+                           indent << "    return delta_energy_at_" << nb << "(occ_i, occ_f);\n";
+    }
+    interface_imp_stream <<
+                         indent << "  default:\n" <<
+                         indent << "    return 0.0;\n" <<
+                         indent << "  }\n" <<
+                         indent << "}\n\n";
+
+
+    // PUT EVERYTHING TOGETHER
+    stream <<
+           "#include <cstddef>\n" <<
+           "#include \"casm/clex/Clexulator.hh\"\n" <<
+           "\n\n\n" <<
+           "/****** ENERGY CLEXULATOR CLASS FOR PRIM ******" << std::endl;
+
+    prim.print(stream);
+
+    stream <<
+           "**/\n\n\n" <<
+
+           "/// \\brief Returns a Clexulator_impl::EnergyBase* owning a " << class_name << "\n" <<
+           "extern \"C\" CASM::Clexulator_impl::EnergyBase* make_" + class_name << "();\n\n" <<
+
+           "namespace CASM {\n\n" <<
+
+           indent << "class " << class_name << " : public Clexulator_impl::EnergyBase {\n\n" <<
+
+           indent << "public:\n\n" <<
+           public_def_stream.str() << "\n" <<
+
+           indent << "private:\n\n" <<
+           private_def_stream.str() << "\n" <<
+
+           indent << "};\n\n" <<
+
+           indent <<
+           "//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n\n" <<
+
+           interface_imp_stream.str() <<
+           "}\n\n\n" <<      // close namespace
+
+           "extern \"C\" {\n" <<
+           indent << "/// \\brief Returns a Clexulator_impl::EnergyBase* owning a " << class_name << "\n" <<
+           indent << "CASM::Clexulator_impl::EnergyBase* make_" + class_name << "() {\n" <<
+           indent << "  return new CASM::" + class_name + "();\n" <<
+           indent << "}\n\n" <<
+           "}\n" <<
+
            "\n";
     // EOF
 
@@ -0,0 +1,121 @@
+#include "casm/clex/SuperNeighborList.hh"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#include "casm/container/Array.hh"
+#include "casm/crystallography/PrimGrid.hh"
+#include "casm/crystallography/UnitCellCoord.hh"
+#include "casm/clex/Clexulator.hh"
+
+namespace CASM {
+
+  static_assert(std::is_same<SuperNeighborList::value_type, Clexulator_impl::Base::nlist_index_type>::value,
+                "SuperNeighborList::value_type must be the Clexulator neighbor list index type");
+
+  SuperNeighborList::SuperNeighborList(const PrimGrid &prim_grid,
+                                       const Array<UnitCellCoord> &prim_nlist,
+                                       Index max_table_bytes) :
+    m_volume(prim_grid.size()),
+    m_nlist_size(prim_nlist.size()),
+    m_delta(4 * prim_nlist.size()) {
+
+    // the neighbor list includes every sublattice, so the largest index is that of the last site
+    Index basis_size = 0;
+    for(Index n = 0; n < m_nlist_size; n++) {
+      basis_size = std::max(basis_size, Index(prim_nlist[n][0] + 1));
+    }
+    if(m_volume * basis_size > Index(std::numeric_limits<value_type>::max())) {
+      throw std::runtime_error("Error constructing SuperNeighborList: too many sites in the supercell");
+    }
+
+    for(int i = 0; i < 3; i++) {
+      m_S[i] = prim_grid.S(i);
+    }
+
+    // translation (i,j,k) in canonical coordinates is (m,n,p) = invU * (i,j,k), see PrimGrid
+    const Matrix3<int> &invU = prim_grid.invU();
+    for(Index n = 0; n < m_nlist_size; n++) {
+      const UnitCellCoord &delta = prim_nlist[n];
+      m_delta[4 * n] = delta[0] * m_volume;
+      for(int i = 0; i < 3; i++) {
+        long d = 0;
+        for(int j = 0; j < 3; j++) {
+          d += invU(i, j) * delta[j + 1];
+        }
+        m_delta[4 * n + i + 1] = ((d % m_S[i]) + m_S[i]) % m_S[i];
+      }
+    }
+
+    if(m_volume * m_nlist_size * sizeof(value_type) <= max_table_bytes) {
+      std::vector<value_type> table(m_volume * m_nlist_size);
+      for(Index v = 0; v < m_volume; v++) {
+        _calc(v, table.data() + v * m_nlist_size);
+      }
+      m_table.swap(table);
+    }
+  }
+
+  //*******************************************************************************************
+
+  SuperNeighborList::value_type SuperNeighborList::site(Index unitcell_index, Index nlist_index) const {
+    if(tabulated()) {
+      return m_table[unitcell_index * m_nlist_size + nlist_index];
+    }
+
+    long mnp[3] = {long(unitcell_index % m_S[0]), long((unitcell_index / m_S[0]) % m_S[1]), long(unitcell_index / (m_S[0] * m_S[1]))};
+    const long *d = m_delta.data() + 4 * nlist_index;
+    long l = d[0];
+    long stride = 1;
+    for(int i = 0; i < 3; i++) {
+      long x = mnp[i] + d[i + 1];
+      l += (x < m_S[i] ? x : x - m_S[i]) * stride;
+      stride *= m_S[i];
+    }
+    return l;
+  }
+
+  //*******************************************************************************************
+
+  bool SuperNeighborList::overlaps(Index basis_size) const {
+    if(!m_nlist_size) {
+      return false;
+    }
+    std::vector<value_type> buffer(m_nlist_size);
+    const value_type *nlist = sites(0, buffer.data());
+    for(Index j = 0; j < basis_size; j++) {
+      for(Index n = j + 1; n < m_nlist_size; n++) {
+        if(nlist[n] == nlist[j]) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  //*******************************************************************************************
+
+  void SuperNeighborList::_calc(Index unitcell_index, value_type *nlist) const {
+
+    // l = m + n * S[0] + p * S[0] * S[1]
+    long m = unitcell_index % m_S[0];
+    long n = (unitcell_index / m_S[0]) % m_S[1];
+    long p = unitcell_index / (m_S[0] * m_S[1]);
+    long stride_n = m_S[0];
+    long stride_p = m_S[0] * m_S[1];
+
+    const long *d = m_delta.data();
+    for(Index i = 0; i < m_nlist_size; i++, d += 4) {
+      long x = m + d[1];
+      long y = n + d[2];
+      long z = p + d[3];
+      nlist[i] = d[0] +
+                 (x < m_S[0] ? x : x - m_S[0]) +
+                 (y < m_S[1] ? y : y - m_S[1]) * stride_n +
+                 (z < m_S[2] ? z : z - m_S[2]) * stride_p;
+    }
+  }
+
+}
@@ -12,40 +12,49 @@
 #include "casm/clex/ConfigEnumAllOccupations.hh"
 #include "casm/clex/ConfigEnumInterpolation.hh"
 #include "casm/clex/Clexulator.hh"
+#include "casm/casm_io/SafeOfstream.hh"
+#include "casm/casm_io/jsonStream.hh"
 
 namespace CASM {
 
+  namespace {
 
-  /*****************************************************************/
-  // GENERATE_NEIGHBOR_LIST_REGULAR
-  // This generates the neighbor list for any non-diagonal supercell
-  // of the PRIM. It first generates the mapping between bijk and
-  // l(i.e. given bijk, we will know what its linear index is).
-  // It then assigns the jth neighbor to the linear index in linear_
-  // index[b][i+delta_i][j+delta_j][k+delta_k]
-  //
-  // ARN 082513
-  /*****************************************************************/
-
-  void Supercell::generate_neighbor_list() {
-
-    nlists.resize(num_sites());
-
-    //Use the bijk->l map to populate the linear index
-    for(Index i = 0; i < num_sites(); i++) {
+    /// Convert a config_list member name to a configuration id, returns false if it is not one
+    bool _config_id(const std::string &name, Index &configid) {
+      if(name.empty() || name.size() > 18 || name.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+      }
+      configid = std::stol(name);
+      return std::to_string(configid) == name;
+    }
 
-      nlists[i].resize(get_primclex().get_nlist_size());
+  }
 
-      for(Index j = 0; j < nlists[i].size(); j++) {
 
-        const UnitCellCoord &delta = get_primclex().get_nlist_uccoord(j);
+  /*****************************************************************/
 
-        nlists[i][j] = find(uccoord(i) + delta);
+  /// The neighbor list of site 'l' is that of unit cell 'l % volume()', because the neighbor list
+  /// UnitCellCoord include the sublattice of the neighbor, so one neighbor list per unit cell is
+  /// generated. See SuperNeighborList.
+  void Supercell::generate_neighbor_list(Index max_table_bytes) {
+    std::lock_guard<std::mutex> lock(m_nlist.mutex);
+    _generate_neighbor_list(max_table_bytes);
+  }
 
-      }
+  void Supercell::_generate_neighbor_list_once() const {
+    std::lock_guard<std::mutex> lock(m_nlist.mutex);
+    if(!m_nlist.generated.load(std::memory_order_relaxed)) {
+      _generate_neighbor_list(SuperNeighborList::default_max_table_bytes);
     }
+  }
 
-    return;
+  void Supercell::_generate_neighbor_list(Index max_table_bytes) const {
+    Array<UnitCellCoord> prim_nlist;
+    for(Index j = 0; j < get_primclex().get_nlist_size(); j++) {
+      prim_nlist.push_back(get_primclex().get_nlist_uccoord(j));
+    }
+    m_nlist.value = SuperNeighborList(m_prim_grid, prim_nlist, max_table_bytes);
+    m_nlist.generated.store(true, std::memory_order_release);
   }
 
   /**
@@ -63,20 +72,7 @@ namespace CASM {
    */
 
   bool Supercell::neighbor_image_overlaps() const {
-    //loop over one of each basis type in the supercell
-    //for(Index i = 0; i < num_sites(); i = i + volume()) {
-    for(Index i = 0; i < num_sites(); i++) {
-      //loop over the first N sites in the list of site i and check for repeated values
-      for(Index j = 0; j < basis_size(); j++) {
-        //if the neighbor appears more than once, then you have periodicity issues
-        if(nlists[i].reverse_find(nlists[i][j]) != j) {
-          return true;
-        }
-      }
-
-    }
-
-    return false;
+    return nlist().overlaps(basis_size());
   }
 
   /*****************************************************************/
@@ -168,6 +164,7 @@ namespace CASM {
   }
 
   Supercell::config_iterator Supercell::config_end() {
+    _load_config_list();
     return ++config_iterator(primclex, m_id, config_list.size() - 1);
   }
 
@@ -177,6 +174,7 @@ namespace CASM {
   }
 
   Supercell::config_const_iterator Supercell::config_cend() const {
+    _load_config_list();
     return ++config_const_iterator(primclex, m_id, config_list.size() - 1);
   }
 
@@ -268,6 +266,8 @@ namespace CASM {
   //*******************************************************************************
 
   void Supercell::add_enumerated_configurations(ConfigEnumIterator<Configuration> it_begin, ConfigEnumIterator<Configuration> it_end) {
+    _load_config_list();
+    m_config_list_dirty = true;
 
     // Remember existing configs, to avoid duplicates
     //   Enumerated configurations are added after existing configurations
@@ -281,15 +281,11 @@ namespace CASM {
       // Adds the configuration to the list, if not among previously existing configurations
 
       bool add = true;
-      if(N_existing_enumerated != N_existing) {
-        for(Index i = 0; i < N_existing; i++) {
-          if(config_list[i].configdof() == it_begin->configdof()) {
-            config_list[i].push_back_source(it_begin.source());
-            add = false;
-            N_existing_enumerated++;
-            break;
-          }
-        }
+      Index i;
+      if(N_existing_enumerated != N_existing && _find_config(it_begin->configdof(), i) && i < N_existing) {
+        config_list[i].push_back_source(it_begin.source());
+        add = false;
+        N_existing_enumerated++;
       }
       if(add) {
         config_list.push_back(*it_begin);
@@ -303,19 +299,57 @@ namespace CASM {
 
   //*******************************************************************************
 
-  void Supercell::enumerate_all_occupation_configurations() {
+  void Supercell::add_enumerated_configurations(const std::vector<Configuration> &buffer) {
+    _load_config_list();
+    m_config_list_dirty = true;
+
+    // Same as add_enumerated_configurations(ConfigEnumIterator, ConfigEnumIterator)
+    Index N_existing = config_list.size();
+    Index N_existing_enumerated = 0;
+    for(const Configuration &config : buffer) {
+      Index i;
+      if(N_existing_enumerated != N_existing && _find_config(config.configdof(), i) && i < N_existing) {
+        config_list[i].push_back_source(config.source());
+        N_existing_enumerated++;
+      }
+      else {
+        config_list.push_back(config);
+        config_list.back().set_id(config_list.size() - 1);
+      }
+    }
+  }
+
+  //*******************************************************************************
+
+  void Supercell::enumerate_all_occupation_configurations(bool orderly) {
     Configuration init_config(*this), final_config(*this);
 
     init_config.set_occupation(Array<int>(num_sites(), 0));
     final_config.set_occupation(max_allowed_occupation());
 
-    ConfigEnumAllOccupations<Configuration> enumerator(init_config, final_config, permute_begin(), permute_end());
+    ConfigEnumAllOccupations<Configuration> enumerator(init_config, final_config, permute_begin(), permute_end(), orderly);
     add_enumerated_configurations(enumerator);
 
   }
 
   //*******************************************************************************
 
+  void Supercell::enumerate_all_occupation_configurations(std::vector<Configuration> &buffer, bool orderly) {
+    Configuration init_config(*this), final_config(*this);
+
+    init_config.set_occupation(Array<int>(num_sites(), 0));
+    final_config.set_occupation(max_allowed_occupation());
+
+    ConfigEnumAllOccupations<Configuration> enumerator(init_config, final_config, permute_begin(), permute_end(), orderly);
+    for(auto it = enumerator.begin(); it != enumerator.end(); ++it) {
+      buffer.push_back(*it);
+      buffer.back().set_source(it.source());
+    }
+
+  }
+
+  //*******************************************************************************
+
   void Supercell::enumerate_interpolated_configurations(Supercell::config_const_iterator initial, Supercell::config_const_iterator final,
                                                         long Nstep, long begin_delta, long end_delta) {
 
@@ -658,15 +692,53 @@ namespace CASM {
    */
   //*******************************************************************************
   bool Supercell::contains_config(const Configuration &config, Index &index) const {
-    for(Index i = 0; i < config_list.size(); i++)
-      if(config.configdof() == config_list[i].configdof()) {
-        index = i;
-        return true;
-      }
+    return _find_config(config.configdof(), index);
+  };
+
+  //*******************************************************************************
+
+  void Supercell::_update_config_index() const {
+    // entries are indexed again after non-const access, so start over before the stale ones pile up
+    if(m_config_index_size > config_list.size() || m_config_index.size() > 2 * config_list.size()) {
+      _reset_config_index();
+    }
+    for(; m_config_index_size < config_list.size(); m_config_index_size++) {
+      m_config_index.insert(std::make_pair(config_list[m_config_index_size].configdof().hash(), m_config_index_size));
+    }
+  }
+
+  //*******************************************************************************
+
+  void Supercell::_reset_config_index() const {
+    m_config_index.clear();
+    m_config_index_size = 0;
+  }
+
+  //*******************************************************************************
+  /**
+   *   Looks up '_configdof' in the hash index of config_list, checking the adjacent
+   *     displacement/deformation buckets (see ConfigDoF::hash). Candidates are
+   *     compared using ConfigDoF::operator==.
+   *
+   *   If found, 'index' contains the smallest matching index into config_list, else
+   *     'index' = config_list.size().
+   */
+  //*******************************************************************************
+  bool Supercell::_find_config(const ConfigDoF &_configdof, Index &index) const {
+    _load_config_list();
+    _update_config_index();
 
     index = config_list.size();
-    return false;
-  };
+    for(long shift = -1; shift <= 1; shift++) {
+      auto range = m_config_index.equal_range(_configdof.hash(shift));
+      for(auto it = range.first; it != range.second; ++it) {
+        if(it->second < index && _configdof == config_list[it->second].configdof()) {
+          index = it->second;
+        }
+      }
+    }
+    return index != config_list.size();
+  }
 
   //*******************************************************************************
   /**
@@ -703,6 +775,8 @@ namespace CASM {
    */
   //*******************************************************************************
   bool Supercell::add_canon_config(const Configuration &canon_config, Index &index) {
+    _load_config_list();
+    m_config_list_dirty = true;
 
     // Add 'canon_config' to 'config_list' if it doesn't already exist
     //   store it's index into 'config_list' in 'config_list_index'
@@ -724,6 +798,8 @@ namespace CASM {
 
   void Supercell::read_config_list(const jsonParser &json) {
 
+    m_config_list_loaded = true;
+
     // Provide an error check
     if(config_list.size() != 0) {
       std::cerr << "Error in Supercell::read_configuration." << std::endl;
@@ -756,6 +832,49 @@ namespace CASM {
   }
 
 
+  //*******************************************************************************
+
+  void Supercell::read_config_list(jsonStreamReader &reader) {
+
+    m_config_list_loaded = true;
+
+    // Provide an error check
+    if(config_list.size() != 0) {
+      std::cerr << "Error in Supercell::read_configuration." << std::endl;
+      std::cerr << "  config_list.size() != 0, only use this once" << std::endl;
+      exit(1);
+    }
+
+    reader.expect(jsonStreamReader::BEGIN_OBJECT);
+
+    // Configurations should be numbered sequentially, and are read until one is not found. They are
+    //   usually stored in order, but if not, configurations are held in 'later' until their turn.
+    std::map<Index, Configuration> later;
+    while(reader.next() == jsonStreamReader::KEY) {
+      std::string configname = reader.key();
+      Index configid;
+      if(!_config_id(configname, configid) || configid < config_list.size()) {
+        reader.skip();
+        continue;
+      }
+
+      // Configuration reads from json["supercells"][get_name()][configid]
+      jsonParser json;
+      reader.read(json["supercells"][get_name()][configname]);
+      if(configid != config_list.size()) {
+        later.insert(std::make_pair(configid, Configuration(json, *this, configid)));
+        continue;
+      }
+
+      config_list.push_back(Configuration(json, *this, configid));
+      auto it = later.begin();
+      while(it != later.end() && it->first == config_list.size()) {
+        config_list.push_back(it->second);
+        it = later.erase(it);
+      }
+    }
+  }
+
   //*******************************************************************************
 
   //Copy constructor is needed for proper initialization of m_prim_grid
@@ -767,8 +886,10 @@ namespace CASM {
     recip_grid(recip_prim_lattice, (*primclex).get_prim().lattice().get_reciprocal()),
     m_perm_symrep_ID(-1),
     name(RHS.name),
-    nlists(RHS.nlists),
+    m_nlist(RHS.m_nlist),
     config_list(RHS.config_list),
+    m_config_list_loaded(RHS.m_config_list_loaded),
+    m_config_list_dirty(RHS.m_config_list_dirty),
     transf_mat(RHS.transf_mat),
     scaling(RHS.scaling),
     m_id(RHS.m_id) {
@@ -916,17 +1037,228 @@ namespace CASM {
    */
 
   jsonParser &Supercell::write_config_list(jsonParser &json) {
+    _load_config_list();
     for(Index c = 0; c < config_list.size(); c++) {
       config_list[c].write(json);
     }
     return json;
   }
+  //*******************************************************************************
+
+  fs::path Supercell::get_config_list_path() const {
+    return primclex->dir().config_list(get_name());
+  }
+
+  //*******************************************************************************
+
+  void Supercell::write_config_list() {
+    _load_config_list();
+
+    fs::path path = get_config_list_path();
+    if(!fs::exists(path) && config_list.size() == 0) {
+      return;
+    }
+
+    fs::create_directories(path.parent_path());
+    SafeOfstream file;
+    file.open(path);
+    jsonStreamWriter writer(file.ofstream());
+
+    // write each configuration, merged with its data in the existing file
+    std::vector<bool> written(config_list.size(), false);
+    auto write_configs = [&](jsonStreamReader * reader) {
+      writer.key(get_name()).begin_object();
+      if(reader) {
+        reader->expect(jsonStreamReader::BEGIN_OBJECT);
+        while(reader->next() == jsonStreamReader::KEY) {
+          std::string configname = reader->key();
+          jsonParser json;
+          jsonParser &json_config = json["supercells"][get_name()][configname];
+          reader->read(json_config);
+          Index configid;
+          if(_config_id(configname, configid) && configid < config_list.size() && !written[configid]) {
+            config_list[configid].write(json);
+            written[configid] = true;
+          }
+          writer.key(configname).value(json_config);
+        }
+      }
+      for(Index c = 0; c < config_list.size(); c++) {
+        if(!written[c]) {
+          jsonParser json;
+          config_list[c].write(json);
+          writer.key(config_list[c].get_id()).value(json["supercells"][get_name()][config_list[c].get_id()]);
+        }
+      }
+      writer.end_object();
+    };
+
+    try {
+      writer.begin_object();
+      bool found_supercells = false;
+      if(fs::exists(path)) {
+        fs::ifstream existing(path);
+        jsonStreamReader reader(existing);
+        reader.expect(jsonStreamReader::BEGIN_OBJECT);
+        while(reader.next() == jsonStreamReader::KEY) {
+          if(reader.key() != "supercells") {
+            writer.key(reader.key());
+            jsonParser json;
+            reader.read(json);
+            writer.value(json);
+            continue;
+          }
+
+          found_supercells = true;
+          bool found_scel = false;
+          writer.key("supercells").begin_object();
+          reader.expect(jsonStreamReader::BEGIN_OBJECT);
+          while(reader.next() == jsonStreamReader::KEY) {
+            if(reader.key() == get_name()) {
+              found_scel = true;
+              write_configs(&reader);
+              continue;
+            }
+            writer.key(reader.key());
+            jsonParser json;
+            reader.read(json);
+            writer.value(json);
+          }
+          if(!found_scel) {
+            write_configs(nullptr);
+          }
+          writer.end_object();
+        }
+      }
+      if(!found_supercells) {
+        writer.key("supercells").begin_object();
+        write_configs(nullptr);
+        writer.end_object();
+      }
+      writer.end_object();
+    }
+    catch(std::runtime_error &e) {
+      // do not leave the temporary file, which would prevent the next write
+      file.ofstream().close();
+      fs::remove(path.string() + ".tmp");
+      throw std::runtime_error(std::string(e.what()) + "\n  while writing " + path.string());
+    }
+
+    file.close();
+    m_config_list_dirty = false;
+  }
+
+  //*******************************************************************************
+
+  void Supercell::count_configs(Index &generated, Index &selected, Index &calculated) const {
+    generated = 0;
+    selected = 0;
+    calculated = 0;
+
+    if(!m_config_list_loaded && !primclex->get_path().empty()) {
+      fs::path path = get_config_list_path();
+      if(!fs::exists(path)) {
+        return;
+      }
+
+      // the summary is used only if the file has not been changed since the summary was written
+      const jsonParser &summary = primclex->config_list_summary();
+      std::string calc_string = "calctype." + primclex->settings().calctype();
+      std::string ref_string = "ref." + primclex->settings().ref();
+      if(summary.contains("supercells") && summary["supercells"].contains(get_name())) {
+        const jsonParser &json = summary["supercells"][get_name()];
+        if(json.contains("last_write_time") &&
+           json["last_write_time"].get<long>() == long(fs::last_write_time(path)) &&
+           json.contains("calculated") &&
+           json["calculated"].contains(calc_string) &&
+           json["calculated"][calc_string].contains(ref_string)) {
+          from_json(generated, json["configs"]);
+          from_json(selected, json["selected"]);
+          from_json(calculated, json["calculated"][calc_string][ref_string]);
+          return;
+        }
+      }
+    }
+
+    _load_config_list();
+    generated = config_list.size();
+    for(Index i = 0; i < config_list.size(); i++) {
+      if(config_list[i].selected()) {
+        selected++;
+      }
+      if(config_list[i].calc_properties().contains("relaxed_energy")) {
+        calculated++;
+      }
+    }
+  }
+
+  //*******************************************************************************
+
+  void Supercell::write_config_list_summary(jsonParser &json) const {
+    // config_list is read first, so that the counts are those in memory
+    _load_config_list();
+    Index generated, selected, calculated;
+    count_configs(generated, selected, calculated);
+
+    if(!json.is_obj()) {
+      json = jsonParser::object();
+    }
+    json["configs"] = generated;
+    json["selected"] = selected;
+    json["calculated"]["calctype." + primclex->settings().calctype()]["ref." + primclex->settings().ref()] = calculated;
+
+    fs::path path = get_config_list_path();
+    json["last_write_time"] = fs::exists(path) ? long(fs::last_write_time(path)) : -1L;
+  }
+
+  //*******************************************************************************
+
+  void Supercell::_load_config_list() const {
+    if(m_config_list_loaded) {
+      return;
+    }
+    m_config_list_loaded = true;
+
+    if(primclex->get_path().empty() || !fs::is_regular_file(get_config_list_path())) {
+      return;
+    }
+    fs::ifstream file(get_config_list_path());
+    jsonStreamReader reader(file);
+    try {
+      reader.expect(jsonStreamReader::BEGIN_OBJECT);
+      while(reader.next() == jsonStreamReader::KEY) {
+        if(reader.key() != "supercells") {
+          reader.skip();
+          continue;
+        }
+        reader.expect(jsonStreamReader::BEGIN_OBJECT);
+        while(reader.next() == jsonStreamReader::KEY) {
+          if(reader.key() == get_name()) {
+            const_cast<Supercell *>(this)->read_config_list(reader);
+          }
+          else {
+            reader.skip();
+          }
+        }
+      }
+    }
+    catch(std::exception &e) {
+      // do not leave a partial config_list marked as loaded, which would be written over the file
+      const_cast<Supercell *>(this)->config_list.clear();
+      _reset_config_index();
+      m_config_list_loaded = false;
+      throw std::runtime_error(std::string(e.what()) + "\n  while reading " + get_config_list_path().string());
+    }
+  }
+
 
 
   //*******************************************************************************
 
   //This function stores the displacements from a relaxed structure  to a unrelaxed super cell and stores them in the corresponding configuration of the super cell
   void Supercell::findConfigDisplacements(Structure tstruc, Index config_num) {
+    _load_config_list();
+    m_config_list_dirty = true;
 
     double min_disp, tdisp;
     UnitCellCoord tUCC;
@@ -967,6 +1299,7 @@ namespace CASM {
       displacement.col(i) = static_cast<Eigen::VectorXd>(disp_coord(CART));
     }
     config_list[config_num].set_displacement(displacement);
+    _reset_config_index();
   }
 
   //*******************************************************************************
@@ -1425,6 +1758,12 @@ namespace CASM {
   //***********************************************************
 
   void Supercell::generate_name() {
+    name = generate_scel_name(transf_mat);
+  }
+
+  //***********************************************************
+
+  std::string generate_scel_name(const Matrix3<int> &transf_mat) {
     //calc_hnf();
     /*
     Matrix3<int> tmat = transf_mat.transpose();
@@ -1438,10 +1777,11 @@ namespace CASM {
     */
 
     Eigen::Matrix3i H = hermite_normal_form(Eigen::Matrix3i(transf_mat)).first;
-    name = "SCEL";
+    std::string name = "SCEL";
     std::stringstream tname;
     tname << H(0, 0)*H(1, 1)*H(2, 2) << "_" << H(0, 0) << "_" << H(1, 1) << "_" << H(2, 2) << "_" << H(1, 2) << "_" << H(0, 2) << "_" << H(0, 1);
     name.append(tname.str());
+    return name;
   }
 
   //***********************************************************
@@ -1456,6 +1796,7 @@ namespace CASM {
    */
 
   Index Supercell::amount_selected() const {
+    _load_config_list();
     Index amount_selected = 0;
     for(Index c = 0; c < config_list.size(); c++) {
       if(config_list[c].selected()) {
@@ -1638,6 +1979,7 @@ namespace CASM {
    */
 
   Structure Supercell::superstructure(Index config_index) const {
+    _load_config_list();
     if(config_index >= config_list.size()) {
       std::cerr << "ERROR in Supercell::superstructure" << std::endl;
       std::cerr << "Requested superstructure of configuration with index " << config_index << " but there are only " << config_list.size() << " configurations" << std::endl;
@@ -1800,6 +2142,7 @@ namespace CASM {
   }
 
   void Supercell::populate_structure_factor() {
+    _load_config_list();
     if(m_fourier_matrix.rows() == 0 || m_fourier_matrix.cols() == 0 || m_phase_factor.rows() == 0 || m_phase_factor.cols() == 0) {
       generate_fourier_matrix();
     }
@@ -1810,6 +2153,8 @@ namespace CASM {
   }
 
   void Supercell::populate_structure_factor(const Index &config_index) {
+    _load_config_list();
+    m_config_list_dirty = true;
     if(m_fourier_matrix.rows() == 0 || m_fourier_matrix.cols() == 0 || m_phase_factor.rows() == 0 || m_phase_factor.cols() == 0) {
       generate_fourier_matrix();
     }
@@ -0,0 +1,353 @@
+#include "casm/clex/TableClexulator.hh"
+
+#include <cmath>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+
+#include "casm/basis_set/OccupantFunction.hh"
+#include "casm/basis_set/PolynomialFunction.hh"
+#include "casm/clusterography/Orbitree.hh"
+#include "casm/misc/CASM_math.hh"
+
+namespace CASM {
+
+  namespace {
+
+    /// \brief Value of 'val' as printed to generated Clexulator source, with 10 significant digits
+    double _as_printed(double val) {
+      std::stringstream ss;
+      ss.precision(10);
+      ss << val;
+      return std::stod(ss.str());
+    }
+
+    /// \brief Appends basis functions to a TableClexulator::Table
+    ///
+    /// For each function: begin_function, then for each group: begin_group, add_cluster for
+    /// each cluster, end_group. Call finish once, after the last function.
+    class TableBuilder {
+
+    public:
+
+      TableBuilder(TableClexulator::Table &_table, const std::vector<std::vector<std::uint32_t> > &_occ_func_begin) :
+        m_table(_table), m_occ_func_begin(_occ_func_begin) {}
+
+      void begin_function() {
+        m_table.func_group.push_back(m_table.group_delta.size());
+      }
+
+      void begin_group(int delta, double divisor) {
+        m_table.group_delta.push_back(delta);
+        m_table.group_divisor.push_back(divisor);
+        m_table.group_cluster.push_back(m_table.cluster_term.size());
+      }
+
+      /// \brief Add the monomials of 'func', in the order make_formula prints them
+      ///
+      /// Functions that print as "0" are skipped.
+      void add_cluster(const Function *func) {
+        if(!func)
+          return;
+
+        const PolynomialFunction *poly = dynamic_cast<const PolynomialFunction *>(func);
+        if(!poly) {
+          throw std::runtime_error(
+            std::string("Error in TableClexulator: Basis function of type ") + func->type_name() +
+            " is not supported, only polynomials of occupation functions.");
+        }
+
+        Array<Array<Index> > unique_product;
+        Array<double> prefactor;
+        PTLeaf<double> const *current(poly->poly_coeffs().begin());
+        while(current) {
+          if(!almost_zero(current->val())) {
+            unique_product.push_back(current->key());
+            prefactor.push_back(current->val());
+          }
+          current = current->next();
+        }
+        if(!unique_product.size())
+          return;
+
+        Array<Index> iperm;
+        unique_product.sort(iperm);
+        prefactor.permute(iperm);
+
+        m_table.cluster_term.push_back(m_table.term_coeff.size());
+        for(Index np = 0; np < unique_product.size(); np++) {
+          double coeff = _as_printed(prefactor[np]);
+          if(almost_zero(prefactor[np] + 1))
+            coeff = -1.0;
+          else if(almost_zero(prefactor[np] - 1))
+            coeff = 1.0;
+
+          m_table.term_coeff.push_back(coeff);
+          m_table.term_factor.push_back(m_table.factor.size());
+          for(Index na = 0; na < unique_product[np].size(); na++) {
+            if(!unique_product[np][na])
+              continue;
+            m_table.factor.push_back(_var(poly->argument(na), unique_product[np][na]));
+          }
+        }
+      }
+
+      /// \brief Remove the current group if no clusters were added
+      void end_group() {
+        if(m_table.group_cluster.back() == m_table.cluster_term.size()) {
+          m_table.group_delta.pop_back();
+          m_table.group_divisor.pop_back();
+          m_table.group_cluster.pop_back();
+        }
+      }
+
+      /// \brief Add the end of each range
+      void finish() {
+        m_table.func_group.push_back(m_table.group_delta.size());
+        m_table.group_cluster.push_back(m_table.cluster_term.size());
+        m_table.cluster_term.push_back(m_table.term_coeff.size());
+        m_table.term_factor.push_back(m_table.factor.size());
+      }
+
+    private:
+
+      /// \brief Gathered variable index for occupation function 'arg' to the power 'pow', added if necessary
+      std::uint32_t _var(const Function *arg, int pow) {
+        const OccupantFunction *occ = dynamic_cast<const OccupantFunction *>(arg);
+        if(!occ) {
+          throw std::runtime_error(
+            std::string("Error in TableClexulator: Basis function argument of type ") + arg->type_name() +
+            " is not supported, only occupation functions.");
+        }
+
+        std::tuple<std::uint32_t, std::uint32_t, int> key(occ->dof().ID(), m_occ_func_begin[occ->basis_ind()][occ->occ_func_ind()], pow);
+        auto it = m_var.find(key);
+        if(it != m_var.end())
+          return it->second;
+
+        m_table.var_nlist.push_back(std::get<0>(key));
+        m_table.var_occ_func.push_back(std::get<1>(key));
+        m_table.var_pow.push_back(pow);
+        return m_var[key] = m_table.var_nlist.size() - 1;
+      }
+
+      TableClexulator::Table &m_table;
+      const std::vector<std::vector<std::uint32_t> > &m_occ_func_begin;
+
+      /// (neighbor list index, occupation function begin, power) -> gathered variable index
+      std::map<std::tuple<std::uint32_t, std::uint32_t, int>, std::uint32_t> m_var;
+
+    };
+
+  }
+
+  //*******************************************************************************************
+  /// Functions are collected in the same order, and with the same neighbor list indices, as
+  /// print_clexulator: the orbit functions of each orbit before its flower functions, which
+  /// change the neighbor list indices of the orbit's clusters.
+  TableClexulator::TableClexulator(const Structure &prim, SiteOrbitree &tree, const Array<UnitCellCoord> &nlist) :
+    Clexulator_impl::Base(nlist.size(), tree.basis_set_size()) {
+
+    std::shared_ptr<Data> data = std::make_shared<Data>();
+    Index N_basis = prim.basis.size();
+
+    // occupation function values, as printed by OccupationDoFEnvironment::print_to_clexulator_constructor
+    data->occ_func_begin.resize(N_basis);
+    for(Index b = 0; b < N_basis; b++) {
+      for(Index f = 0; f < prim.basis[b].occupant_basis().size(); f++) {
+        data->occ_func_begin[b].push_back(data->occ_func.size());
+        for(Index s = 0; s < prim.basis[b].site_occupant().size(); s++) {
+          double val = prim.basis[b].occupant_basis()[f]->eval(Array<Index>(1, prim.basis[b].site_occupant().ID()), Array<Index>(1, s));
+          data->occ_func.push_back(_as_printed(val));
+        }
+      }
+    }
+
+    data->flower.resize(N_basis);
+    data->delta.resize(N_basis);
+
+    TableBuilder orbit_builder(data->orbit, data->occ_func_begin);
+    std::vector<TableBuilder> flower_builder, delta_builder;
+    for(Index b = 0; b < N_basis; b++) {
+      flower_builder.emplace_back(data->flower[b], data->occ_func_begin);
+      delta_builder.emplace_back(data->delta[b], data->occ_func_begin);
+    }
+
+    for(Index np = 0; np < tree.size(); np++) {
+      for(Index no = 0; no < tree[np].size(); no++) {
+        SiteOrbit &orbit = tree[np][no];
+        Index N_func = orbit.prototype.clust_basis.size();
+
+        for(Index nf = 0; nf < N_func; nf++) {
+          orbit_builder.begin_function();
+          orbit_builder.begin_group(-1, orbit.size());
+          for(Index ne = 0; ne < orbit.size(); ne++)
+            orbit_builder.add_cluster(orbit[ne].clust_basis[nf]);
+          orbit_builder.end_group();
+        }
+
+        for(Index b = 0; b < N_basis; b++) {
+
+          // copies of the cluster basis functions, and of their quotients by each site basis
+          // function of b, translated to each neighbor list that includes b
+          Index N_site_func = prim.basis[b].occupant_basis().size();
+          std::vector<BasisSet> flower;
+          std::vector<std::vector<BasisSet> > quotient(N_site_func);
+          for(Index ne = 0; ne < orbit.size(); ne++) {
+            for(Index nt = 0; nt < orbit[ne].trans_nlists().size(); nt++) {
+              Index ib = orbit[ne].trans_nlist(nt).find(b);
+              if(ib == orbit[ne].size())
+                continue;
+              orbit[ne].set_nlist_inds(orbit[ne].trans_nlist(nt));
+              flower.push_back(orbit[ne].clust_basis);
+              for(Index f = 0; f < N_site_func; f++)
+                quotient[f].push_back(orbit[ne].clust_basis.poly_quotient_set(orbit[ne][ib].occupant_basis()[f]));
+            }
+          }
+
+          for(Index nf = 0; nf < N_func; nf++) {
+            flower_builder[b].begin_function();
+            flower_builder[b].begin_group(-1, orbit.size());
+            for(Index i = 0; i < flower.size(); i++)
+              flower_builder[b].add_cluster(flower[i][nf]);
+            flower_builder[b].end_group();
+
+            delta_builder[b].begin_function();
+            for(Index f = 0; f < N_site_func; f++) {
+              delta_builder[b].begin_group(f, orbit.size());
+              for(Index i = 0; i < quotient[f].size(); i++)
+                delta_builder[b].add_cluster(quotient[f][i][nf]);
+              delta_builder[b].end_group();
+            }
+          }
+        }
+      }
+    }
+
+    orbit_builder.finish();
+    Index N_var = data->orbit.var_nlist.size();
+    Index N_delta = 0;
+    for(Index b = 0; b < N_basis; b++) {
+      flower_builder[b].finish();
+      delta_builder[b].finish();
+      N_var = std::max(N_var, Index(data->flower[b].var_nlist.size()));
+      N_var = std::max(N_var, Index(data->delta[b].var_nlist.size()));
+      N_delta = std::max(N_delta, Index(data->occ_func_begin[b].size()));
+    }
+
+    if(data->orbit.func_group.size() != corr_size() + 1) {
+      throw std::runtime_error(
+        std::string("Error in TableClexulator: Found ") + std::to_string(data->orbit.func_group.size() - 1) +
+        " basis functions, expected " + std::to_string(corr_size()) + ".");
+    }
+
+    m_data = data;
+    m_var.resize(N_var);
+    m_delta.resize(N_delta);
+  }
+
+  //*******************************************************************************************
+
+  void TableClexulator::calc_global_corr_contribution(double *corr_begin) const {
+    _gather(m_data->orbit);
+    for(size_type i = 0; i < corr_size(); i++) {
+      *(corr_begin + i) = _eval(m_data->orbit, i);
+    }
+  }
+
+  void TableClexulator::calc_restricted_global_corr_contribution(double *corr_begin, size_type const *ind_list_begin, size_type const *ind_list_end) const {
+    _gather(m_data->orbit);
+    for(; ind_list_begin < ind_list_end; ind_list_begin++) {
+      *(corr_begin + *ind_list_begin) = _eval(m_data->orbit, *ind_list_begin);
+    }
+  }
+
+  void TableClexulator::calc_point_corr(int b_index, double *corr_begin) const {
+    const Table &table = m_data->flower[b_index];
+    _gather(table);
+    for(size_type i = 0; i < corr_size(); i++) {
+      *(corr_begin + i) = _eval(table, i);
+    }
+  }
+
+  void TableClexulator::calc_restricted_point_corr(int b_index, double *corr_begin, size_type const *ind_list_begin, size_type const *ind_list_end) const {
+    const Table &table = m_data->flower[b_index];
+    _gather(table);
+    for(; ind_list_begin < ind_list_end; ind_list_begin++) {
+      *(corr_begin + *ind_list_begin) = _eval(table, *ind_list_begin);
+    }
+  }
+
+  void TableClexulator::calc_delta_point_corr(int b_index, int occ_i, int occ_f, double *corr_begin) const {
+    const Table &table = m_data->delta[b_index];
+    _set_delta(b_index, occ_i, occ_f);
+    _gather(table);
+    for(size_type i = 0; i < corr_size(); i++) {
+      *(corr_begin + i) = _eval(table, i);
+    }
+  }
+
+  void TableClexulator::calc_restricted_delta_point_corr(int b_index,
+                                                         int occ_i,
+                                                         int occ_f,
+                                                         double *corr_begin,
+                                                         size_type const *ind_list_begin,
+                                                         size_type const *ind_list_end) const {
+    const Table &table = m_data->delta[b_index];
+    _set_delta(b_index, occ_i, occ_f);
+    _gather(table);
+    for(; ind_list_begin < ind_list_end; ind_list_begin++) {
+      *(corr_begin + *ind_list_begin) = _eval(table, *ind_list_begin);
+    }
+  }
+
+  //*******************************************************************************************
+
+  void TableClexulator::_gather(const Table &table) const {
+    const double *occ_func = m_data->occ_func.data();
+    const std::uint32_t *var_occ_func = table.var_occ_func.data();
+    const std::uint32_t *var_nlist = table.var_nlist.data();
+    double *var = m_var.data();
+    for(size_type v = 0; v < table.var_nlist.size(); v++) {
+      var[v] = occ_func[var_occ_func[v] + m_occ_ptr[m_nlist_ptr[var_nlist[v]]]];
+    }
+    for(size_type v = 0; v < table.var_pow.size(); v++) {
+      if(table.var_pow[v] != 1)
+        var[v] = std::pow(var[v], table.var_pow[v]);
+    }
+  }
+
+  /// Sums are evaluated left to right, and products of factors are taken in order, as in the
+  /// generated source, so that the result does not depend on compiler optimizations.
+  double TableClexulator::_eval(const Table &table, size_type func) const {
+    const double *var = m_var.data();
+    double value = 0.0;
+    for(std::uint32_t g = table.func_group[func]; g < table.func_group[func + 1]; g++) {
+      double group_sum = 0.0;
+      for(std::uint32_t c = table.group_cluster[g]; c < table.group_cluster[g + 1]; c++) {
+        double cluster_sum = 0.0;
+        for(std::uint32_t t = table.cluster_term[c]; t < table.cluster_term[c + 1]; t++) {
+          double term = table.term_coeff[t];
+          for(std::uint32_t k = table.term_factor[t]; k < table.term_factor[t + 1]; k++) {
+            term *= var[table.factor[k]];
+          }
+          cluster_sum += term;
+        }
+        group_sum += cluster_sum;
+      }
+      if(table.group_delta[g] >= 0)
+        group_sum = m_delta[table.group_delta[g]] * group_sum;
+      value += group_sum / table.group_divisor[g];
+    }
+    return value;
+  }
+
+  void TableClexulator::_set_delta(int b_index, int occ_i, int occ_f) const {
+    const std::vector<std::uint32_t> &begin = m_data->occ_func_begin[b_index];
+    for(size_type f = 0; f < begin.size(); f++) {
+      m_delta[f] = m_data->occ_func[begin[f] + occ_f] - m_data->occ_func[begin[f] + occ_i];
+    }
+  }
+
+}
@@ -512,15 +512,24 @@ namespace CASM {
   /// The supercell that is inserted in the 'supercell' container is the niggli cell, rotated to a
   /// standard orientation (see standard_orientation function).
   ///
+  /// With 'num_threads' > 1 (0 uses all available cores) the supercell matrices are checked and the
+  /// niggli cells are found in parallel. The supercells are in the same order for any 'num_threads'.
+  ///
   void Lattice::generate_supercells(Array<Lattice> &supercell,
                                     const SymGroup &effective_pg,
                                     int max_prim_vol,
-                                    int min_prim_vol) const {
+                                    int min_prim_vol,
+                                    long num_threads) const {
     SupercellEnumerator<Lattice> enumerator(*this, effective_pg, min_prim_vol, max_prim_vol + 1);
+    std::vector<Eigen::Matrix3i> T = enumerate_supercell_matrices(enumerator, num_threads);
+
     supercell.clear();
-    for(auto it = enumerator.begin(); it != enumerator.end(); ++it) {
-      supercell.push_back(niggli(*it, effective_pg, TOL));
-    }
+    supercell.resize(T.size());
+    parallel_for_chunks(T.size(), 16, num_threads, [&](long thread, long begin, long end) {
+      for(long i = begin; i < end; ++i) {
+        supercell[i] = niggli(CASM::make_supercell(*this, T[i]), effective_pg, TOL);
+      }
+    });
     return;
   }
 
@@ -1,5 +1,6 @@
 #include "casm/crystallography/SupercellEnumerator.hh"
 
+#include <stdexcept>
 #include <boost/math/special_functions/round.hpp>
 #include "casm/external/Eigen/Dense"
 
@@ -7,6 +8,187 @@
 
 namespace CASM {
 
+  namespace {
+
+    /// \brief g = x*a + y*b, where g is a greatest common divisor of a and b (possibly negative)
+    void _extended_gcd(long a, long b, long &g, long &x, long &y) {
+      long old_r = a, r = b, old_x = 1, x_ = 0, old_y = 0, y_ = 1;
+      while(r != 0) {
+        long q = old_r / r, tmp;
+        tmp = r;
+        r = old_r - q * r;
+        old_r = tmp;
+        tmp = x_;
+        x_ = old_x - q * x_;
+        old_x = tmp;
+        tmp = y_;
+        y_ = old_y - q * y_;
+        old_y = tmp;
+      }
+      g = old_r;
+      x = old_x;
+      y = old_y;
+    }
+
+    /// \brief a/b rounded down, for b > 0
+    long _floor_div(long a, long b) {
+      long q = a / b;
+      return (a % b != 0 && a < 0) ? q - 1 : q;
+    }
+
+    /// \brief The H of hermite_normal_form(M), for a 3x3 matrix without the dynamic allocation
+    ///        and the repeated subtraction of the general version
+    ///
+    /// The hermite normal form of a full rank matrix is unique, so any sequence of unimodular column
+    /// operations that reaches it gives the same H. Here each off-diagonal entry is eliminated with
+    /// a single extended gcd step.
+    Eigen::Matrix3i _hermite_normal_form_3(const Eigen::Matrix3i &M) {
+      long H[3][3];
+      for(int i = 0; i < 3; i++) {
+        for(int j = 0; j < 3; j++) {
+          H[i][j] = M(i, j);
+        }
+      }
+
+      // bottom row up: zeros to the left of H(i,i). Rows below i are already zero in columns <= i.
+      for(int i = 2; i >= 0; i--) {
+        for(int c = i - 1; c >= 0; c--) {
+          if(H[i][c] == 0)
+            continue;
+          long g, x, y;
+          _extended_gcd(H[i][i], H[i][c], g, x, y);
+          long p = H[i][i] / g, q = H[i][c] / g;
+          for(int r = 0; r <= i; r++) {
+            long hi = H[r][i], hc = H[r][c];
+            H[r][i] = x * hi + y * hc;
+            H[r][c] = p * hc - q * hi;
+          }
+        }
+        if(H[i][i] == 0) {
+          throw std::runtime_error("Error in hermite_normal_form: M must be full rank.");
+        }
+        if(H[i][i] < 0) {
+          for(int r = 0; r <= i; r++) {
+            H[r][i] *= -1;
+          }
+        }
+      }
+
+      // 0 <= H(r,c) < H(r,r) for c > r, same order as hermite_normal_form
+      for(int c = 1; c < 3; c++) {
+        for(int r = c - 1; r >= 0; r--) {
+          long k = _floor_div(H[r][c], H[r][r]);
+          for(int rr = 0; rr <= r; rr++) {
+            H[rr][c] -= k * H[rr][r];
+          }
+        }
+      }
+
+      Eigen::Matrix3i result;
+      for(int i = 0; i < 3; i++) {
+        for(int j = 0; j < 3; j++) {
+          result(i, j) = H[i][j];
+        }
+      }
+      return result;
+    }
+
+    /// \brief Compare supercell matrices in hermite normal form by H00, H11, H22, H12, H02, H01,
+    ///        returns -1, 0, or 1 if A is less than, equal to, or greater than B
+    int _compare_hnf(const Eigen::Matrix3i &A, const Eigen::Matrix3i &B) {
+      static const int row[6] = {0, 1, 2, 1, 0, 0};
+      static const int col[6] = {0, 1, 2, 2, 2, 1};
+      for(int i = 0; i < 6; i++) {
+        if(A(row[i], col[i]) > B(row[i], col[i]))
+          return 1;
+        if(A(row[i], col[i]) < B(row[i], col[i]))
+          return -1;
+      }
+      return 0;
+    }
+
+  }
+
+  /// \brief Point group operations as integer transformations of supercell matrices
+  ///
+  /// For S = U*T, where S and U are the superlattice and unit lattice column vector matrices, the
+  /// equivalent superlattice op*S = U*T' has T' = U.inverse()*op*U*T. Returns U.inverse()*op*U,
+  /// rounded to integer, for each op in 'point_grp'.
+  ///
+  std::vector<Eigen::Matrix3i> integer_point_group(const Lattice &unit, const SymGroup &point_grp) {
+    Eigen::Matrix3d U = unit.lat_column_mat();
+    Eigen::Matrix3d U_inv = U.inverse();
+    std::vector<Eigen::Matrix3i> result;
+    result.reserve(point_grp.size());
+    for(int i = 0; i < point_grp.size(); i++) {
+      Eigen::Matrix3d op = point_grp[i].get_matrix(CART);
+      result.push_back(iround(U_inv * op * U));
+    }
+    return result;
+  }
+
+  /// \brief Check if a supercell matrix in hermite normal form is canonical
+  ///
+  /// \param T A supercell matrix in hermite normal form
+  /// \param int_point_grp Point group as from integer_point_group
+  ///
+  /// T is canonical if for all ops, the hermite normal form of op*T is not lexicographically
+  /// greater than T, as described for canonical_hnf
+  ///
+  bool is_canonical_hnf(const Eigen::Matrix3i &T, const std::vector<Eigen::Matrix3i> &int_point_grp) {
+    for(const auto &op : int_point_grp) {
+      Eigen::Matrix3i transformed = op * T;
+      if(transformed == T)
+        continue;
+      if(_compare_hnf(_hermite_normal_form_3(transformed), T) > 0)
+        return false;
+    }
+    return true;
+  }
+
+  /// \brief Diagonals of supercell matrices in hermite normal form, in the order SupercellIterator visits them
+  ///
+  /// Volume ascending, then H00 ascending, then H11 ascending, with H22 = volume/(H00*H11)
+  ///
+  std::vector<Eigen::Vector3i> hnf_diagonals(int begin_volume, int end_volume) {
+    std::vector<Eigen::Vector3i> result;
+    for(int vol = std::max(begin_volume, 1); vol < end_volume; vol++) {
+      for(int a = 1; a <= vol; a++) {
+        if(vol % a != 0)
+          continue;
+        for(int b = 1; b <= vol / a; b++) {
+          if((vol / a) % b != 0)
+            continue;
+          result.push_back(Eigen::Vector3i(a, b, vol / (a * b)));
+        }
+      }
+    }
+    return result;
+  }
+
+  /// \brief Append the canonical supercell matrices with diagonal 'diag' to 'result'
+  ///
+  /// Off-diagonal entries are visited in the order SupercellIterator visits them: H12 fastest,
+  /// then H02, then H01
+  ///
+  void canonical_hnf_block(const Eigen::Vector3i &diag,
+                           const std::vector<Eigen::Matrix3i> &int_point_grp,
+                           std::vector<Eigen::Matrix3i> &result) {
+    Eigen::Matrix3i T = Eigen::Matrix3i::Zero();
+    T(0, 0) = diag(0);
+    T(1, 1) = diag(1);
+    T(2, 2) = diag(2);
+    for(T(0, 1) = 0; T(0, 1) < diag(0); T(0, 1)++) {
+      for(T(0, 2) = 0; T(0, 2) < diag(0); T(0, 2)++) {
+        for(T(1, 2) = 0; T(1, 2) < diag(1); T(1, 2)++) {
+          if(is_canonical_hnf(T, int_point_grp)) {
+            result.push_back(T);
+          }
+        }
+      }
+    }
+  }
+
   template<>
   SupercellEnumerator<Lattice>::SupercellEnumerator(Lattice unit,
                                                     double tol,
@@ -18,6 +200,7 @@ namespace CASM {
     m_end_volume(end_volume) {
 
     m_lat.generate_point_group(m_point_group, tol);
+    m_int_point_group = integer_point_group(m_lat, m_point_group);
 
   }
 
@@ -30,7 +213,8 @@ namespace CASM {
     m_lat(unit),
     m_point_group(point_grp),
     m_begin_volume(begin_volume),
-    m_end_volume(end_volume) {}
+    m_end_volume(end_volume),
+    m_int_point_group(integer_point_group(m_lat, m_point_group)) {}
 
   /// \brief Return canonical hermite normal form of the supercell matrix, and op used to find it
   ///
@@ -61,9 +245,9 @@ namespace CASM {
   ///
   std::pair<Eigen::MatrixXi, Eigen::MatrixXd> canonical_hnf(const Eigen::MatrixXi &T, const BasicStructure<Site> &unitcell) {
 
-    Eigen::Matrix3d lat = unitcell.lattice().lat_column_mat();
     Structure unitstruc(unitcell);
     SymGroup pg = unitstruc.point_group();
+    std::vector<Eigen::Matrix3i> int_pg = integer_point_group(unitcell.lattice(), pg);
 
     Eigen::Matrix3i H, H_init, H_canon;
 
@@ -76,9 +260,7 @@ namespace CASM {
 
     for(int i = 0; i < pg.size(); i++) {
 
-      Eigen::Matrix3i transformed = iround(lat.inverse() * (Eigen::Matrix3d(pg[i].get_matrix(CART)) * lat)) * H_init;
-
-      H = hermite_normal_form(transformed).first;
+      H = _hermite_normal_form_3(int_pg[i] * H_init);
 
       // canonical only if H_canon is '>=' H, for all H, so if H '>' m_current, make H the H_canon
       if(H(0, 0) > H_canon(0, 0)) {
@@ -0,0 +1,357 @@
+#include "casm/hull/IncrementalHull.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <stdexcept>
+
+namespace CASM {
+
+  namespace {
+    const char incremental_hull_magic[8] = {'C', 'A', 'S', 'M', 'H', 'U', 'L', 'L'};
+  }
+
+  //*******************************************************************************************
+
+  IncrementalHull::IncrementalHull(const Eigen::VectorXd &_bottom, double _tol) :
+    m_bottom(_bottom),
+    m_tol(_tol),
+    m_geo(new BP::Geo()) {}
+
+  //*******************************************************************************************
+
+  IncrementalHull::IncrementalHull(const IncrementalHull &RHS) :
+    m_geo(new BP::Geo()) {
+    *this = RHS;
+  }
+
+  //*******************************************************************************************
+
+  IncrementalHull &IncrementalHull::operator=(const IncrementalHull &RHS) {
+    if(this == &RHS) {
+      return *this;
+    }
+    m_bottom = RHS.m_bottom;
+    m_tol = RHS.m_tol;
+    m_point = RHS.m_point;
+    m_support = RHS.m_support;
+    m_pending = RHS.m_pending;
+    m_full_rebuild = RHS.m_full_rebuild;
+    m_modified = RHS.m_modified;
+    m_num_full_builds = RHS.m_num_full_builds;
+    m_num_partial_builds = RHS.m_num_partial_builds;
+
+    m_geo.reset(new BP::Geo());
+    m_geo_label.clear();
+    m_geo_valid = false;
+    if(RHS.m_geo_valid) {
+      _build(RHS.m_geo_label);
+    }
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  void IncrementalHull::insert(const std::string &label, const Eigen::VectorXd &pos) {
+    if(pos.size() != dim()) {
+      throw std::runtime_error("Error in IncrementalHull::insert: point " + label + " has dimension " +
+                               std::to_string(pos.size()) + ", expected " + std::to_string(dim()));
+    }
+    auto it = m_point.find(label);
+    if(it != m_point.end()) {
+      if(it->second == pos) {
+        return;
+      }
+      if(m_support.count(label)) {
+        m_full_rebuild = true;
+      }
+      it->second = pos;
+    }
+    else {
+      m_point[label] = pos;
+    }
+    m_pending.push_back(label);
+    m_modified = true;
+  }
+
+  //*******************************************************************************************
+
+  void IncrementalHull::erase(const std::string &label) {
+    if(!m_point.erase(label)) {
+      return;
+    }
+    if(m_support.erase(label)) {
+      m_full_rebuild = true;
+    }
+    m_modified = true;
+  }
+
+  //*******************************************************************************************
+
+  void IncrementalHull::assign(const std::vector<std::string> &labels, const Eigen::MatrixXd &pos) {
+    std::set<std::string> keep(labels.begin(), labels.end());
+    std::vector<std::string> erased;
+    for(const auto &point : m_point) {
+      if(!keep.count(point.first)) {
+        erased.push_back(point.first);
+      }
+    }
+    for(const auto &label : erased) {
+      erase(label);
+    }
+    for(Index i = 0; i < labels.size(); i++) {
+      insert(labels[i], pos.col(i));
+    }
+  }
+
+  //*******************************************************************************************
+
+  bool IncrementalHull::update() {
+
+    if(m_full_rebuild || !m_geo_valid) {
+
+      // after 'read' the support is known, and the hull only needs to be built from it
+      std::vector<std::string> labels;
+      if(!m_full_rebuild && m_support.size()) {
+        labels.assign(m_support.begin(), m_support.end());
+        for(const auto &label : m_pending) {
+          if(m_point.count(label) && !m_support.count(label)) {
+            labels.push_back(label);
+          }
+        }
+        ++m_num_partial_builds;
+      }
+      else {
+        for(const auto &point : m_point) {
+          labels.push_back(point.first);
+        }
+        ++m_num_full_builds;
+      }
+      m_pending.clear();
+      if(!_build(labels)) {
+        return false;
+      }
+      m_full_rebuild = false;
+      return true;
+    }
+
+    if(m_pending.empty()) {
+      return true;
+    }
+
+    // new or moved points that are strictly inside the current hull do not change it
+    std::vector<std::string> outside;
+    {
+      std::vector<std::string> candidate;
+      std::set<std::string> unique;
+      for(const auto &label : m_pending) {
+        if(m_point.count(label) && !m_support.count(label) && unique.insert(label).second) {
+          candidate.push_back(label);
+        }
+      }
+      m_pending.clear();
+
+      Eigen::MatrixXd pos(dim(), candidate.size());
+      for(Index i = 0; i < candidate.size(); i++) {
+        pos.col(i) = m_point[candidate[i]];
+      }
+      Eigen::VectorXd dist;
+      Eigen::VectorXi facet;
+      m_geo->CH_wholehull();
+      m_geo->CH_dist_to_hull(pos, dist, facet);
+      m_geo->CH_bottom(m_bottom);
+
+      for(Index i = 0; i < candidate.size(); i++) {
+        if(!(dist(i) > m_tol)) {
+          outside.push_back(candidate[i]);
+        }
+      }
+    }
+
+    if(outside.empty()) {
+      return true;
+    }
+
+    std::vector<std::string> labels(m_support.begin(), m_support.end());
+    labels.insert(labels.end(), outside.begin(), outside.end());
+    ++m_num_partial_builds;
+    return _build(labels);
+  }
+
+  //*******************************************************************************************
+
+  std::vector<std::string> IncrementalHull::vertices() const {
+    std::vector<std::string> result;
+    if(!m_geo_valid) {
+      return result;
+    }
+    BP::BP_Vec<int> index = m_geo->CH_verts_indices();
+    for(Index i = 0; i < index.size(); i++) {
+      result.push_back(m_geo_label[index[i]]);
+    }
+    return result;
+  }
+
+  //*******************************************************************************************
+
+  bool IncrementalHull::_build(const std::vector<std::string> &labels) {
+
+    m_geo.reset(new BP::Geo());
+    m_geo->set_verbosity(0);
+    m_geo_label = labels;
+    m_geo_valid = false;
+
+    if(labels.empty()) {
+      return false;
+    }
+
+    Eigen::MatrixXd pos(dim(), labels.size());
+    for(Index i = 0; i < labels.size(); i++) {
+      pos.col(i) = m_point.find(labels[i])->second;
+    }
+    m_geo->reset_points(pos, true);
+    if(!m_geo->calc_CH()) {
+      return false;
+    }
+
+    // before filtering, the hull vertices are the vertices of the full hull
+    m_support.clear();
+    BP::BP_Vec<int> index = m_geo->CH_verts_indices();
+    for(Index i = 0; i < index.size(); i++) {
+      m_support.insert(labels[index[i]]);
+    }
+
+    m_geo->CH_bottom(m_bottom);
+    m_geo_valid = true;
+    return true;
+  }
+
+  //*******************************************************************************************
+
+  void IncrementalHull::write(const boost::filesystem::path &filename, std::uint64_t key) {
+
+    if(!filename.parent_path().empty()) {
+      boost::filesystem::create_directories(filename.parent_path());
+    }
+
+    // write to a temporary file and rename, so an interrupted write does not leave a partial file
+    boost::filesystem::path tmp = filename.string() + ".tmp";
+    std::ofstream file(tmp.string().c_str(), std::ios::binary | std::ios::trunc);
+
+    std::uint32_t version = format_version, point_dim = dim();
+    std::uint64_t N = m_point.size();
+    file.write(incremental_hull_magic, sizeof(incremental_hull_magic));
+    file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+    file.write(reinterpret_cast<const char *>(&point_dim), sizeof(point_dim));
+    file.write(reinterpret_cast<const char *>(&key), sizeof(key));
+    file.write(reinterpret_cast<const char *>(&N), sizeof(N));
+    file.write(reinterpret_cast<const char *>(m_bottom.data()), dim() * sizeof(double));
+
+    for(const auto &point : m_point) {
+      std::uint32_t label_size = point.first.size();
+      char is_support = m_support.count(point.first) ? 1 : 0;
+      file.write(reinterpret_cast<const char *>(&label_size), sizeof(label_size));
+      file.write(point.first.data(), label_size);
+      file.write(&is_support, 1);
+      file.write(reinterpret_cast<const char *>(point.second.data()), dim() * sizeof(double));
+    }
+
+    file.close();
+    if(file.fail()) {
+      throw std::runtime_error(std::string("Error in IncrementalHull::write: could not write ") + tmp.string());
+    }
+    boost::filesystem::rename(tmp, filename);
+    m_modified = false;
+  }
+
+  //*******************************************************************************************
+
+  bool IncrementalHull::read(const boost::filesystem::path &filename, std::uint64_t key) {
+
+    std::ifstream file(filename.string().c_str(), std::ios::binary);
+    if(!file) {
+      return false;
+    }
+
+    char magic[8];
+    std::uint32_t version, point_dim;
+    std::uint64_t file_key, N;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char *>(&version), sizeof(version));
+    file.read(reinterpret_cast<char *>(&point_dim), sizeof(point_dim));
+    file.read(reinterpret_cast<char *>(&file_key), sizeof(file_key));
+    file.read(reinterpret_cast<char *>(&N), sizeof(N));
+    if(!file ||
+       std::memcmp(magic, incremental_hull_magic, sizeof(magic)) != 0 ||
+       version != format_version ||
+       point_dim != dim() ||
+       file_key != key) {
+      return false;
+    }
+
+    Eigen::VectorXd bottom(dim());
+    file.read(reinterpret_cast<char *>(bottom.data()), dim() * sizeof(double));
+    if(!file || bottom != m_bottom) {
+      return false;
+    }
+
+    std::map<std::string, Eigen::VectorXd> point;
+    std::set<std::string> support;
+    for(std::uint64_t i = 0; i < N; i++) {
+      std::uint32_t label_size;
+      file.read(reinterpret_cast<char *>(&label_size), sizeof(label_size));
+      if(!file || label_size > (1 << 16)) {
+        return false;
+      }
+      std::string label(label_size, '\0');
+      char is_support;
+      Eigen::VectorXd pos(dim());
+      file.read(&label[0], label_size);
+      file.read(&is_support, 1);
+      file.read(reinterpret_cast<char *>(pos.data()), dim() * sizeof(double));
+      if(!file) {
+        return false;
+      }
+      if(is_support) {
+        support.insert(label);
+      }
+      point[label] = pos;
+    }
+
+    m_point.swap(point);
+    m_support.swap(support);
+    m_pending.clear();
+    m_full_rebuild = m_support.empty();
+    m_modified = false;
+    m_geo.reset(new BP::Geo());
+    m_geo_label.clear();
+    m_geo_valid = false;
+
+    // mark as used, for remove_stale_hull_files
+    boost::system::error_code ec;
+    boost::filesystem::last_write_time(filename, std::time(nullptr), ec);
+    return true;
+  }
+
+  //*******************************************************************************************
+
+  void remove_stale_hull_files(const boost::filesystem::path &dir, Index max_files, const boost::filesystem::path &keep) {
+    std::vector<std::pair<std::time_t, boost::filesystem::path> > files;
+    boost::filesystem::directory_iterator it(dir), end;
+    for(; it != end; ++it) {
+      if(boost::filesystem::is_regular_file(it->path()) && it->path().extension() == ".hull") {
+        files.push_back(std::make_pair(boost::filesystem::last_write_time(it->path()), it->path()));
+      }
+    }
+    std::sort(files.begin(), files.end());
+    Index N = files.size();
+    for(Index i = 0; i < files.size() && N > max_files; i++) {
+      if(files[i].second != keep) {
+        boost::filesystem::remove(files[i].second);
+        N--;
+      }
+    }
+  }
+
+}
@@ -1,5 +1,9 @@
 #include "casm/misc/CASM_math.hh"
 
+#include <functional>
+#include <limits>
+#include <queue>
+
 namespace CASM {
   //*******************************************************************************************
 
@@ -409,6 +413,143 @@ namespace CASM {
     return tot_cost;
   }
 
+  //*******************************************************************************************
+
+  bool sparse_assignment(const SparseCostMatrix &cost_matrix,
+                         std::vector<Index> &optimal_assignment,
+                         Eigen::VectorXd &row_potential,
+                         Eigen::VectorXd &col_potential,
+                         double &tot_cost) {
+    const Index N = cost_matrix.size();
+    const double inf = std::numeric_limits<double>::infinity();
+    const Index none = -1;
+    const std::vector<Index> &row_begin = cost_matrix.row_begin;
+    const std::vector<Index> &col = cost_matrix.col;
+    const std::vector<double> &cost = cost_matrix.cost;
+
+    Eigen::VectorXd &u = row_potential;
+    Eigen::VectorXd &v = col_potential;
+    if(v.size() != N)
+      v = Eigen::VectorXd::Zero(N);
+
+    // Any column potentials are feasible with u[i] = min_j(cost(i, j) - v[j])
+    u.resize(N);
+    for(Index i = 0; i < N; i++) {
+      u[i] = inf;
+      for(Index e = row_begin[i]; e < row_begin[i + 1]; e++)
+        u[i] = std::min(u[i], cost[e] - v[col[e]]);
+      if(u[i] == inf)
+        return false;
+    }
+
+    // Warm start: keep the previous assignment of a row if that entry is still tight
+    std::vector<Index> col_of_row(N, none), row_of_col(N, none);
+    bool warm = (optimal_assignment.size() == N);
+    for(Index i = 0; i < N; i++) {
+      for(Index e = row_begin[i]; e < row_begin[i + 1]; e++) {
+        Index j = col[e];
+        if(row_of_col[j] != none || (warm && j != optimal_assignment[i]))
+          continue;
+        if(cost[e] - u[i] - v[j] <= 0.0) {
+          col_of_row[i] = j;
+          row_of_col[j] = i;
+          break;
+        }
+      }
+    }
+
+    // Assign the remaining rows along shortest augmenting paths, using reduced costs
+    //   cost(i, j) - u[i] - v[j] >= 0 as edge lengths
+    std::vector<double> dist(N, inf);
+    std::vector<Index> pred(N, none);
+    std::vector<bool> done(N, false);
+    std::vector<Index> visited_cols, finished_cols;
+    typedef std::pair<double, Index> Item;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item> > heap;
+
+    for(Index s = 0; s < N; s++) {
+      if(col_of_row[s] != none)
+        continue;
+
+      visited_cols.clear();
+      finished_cols.clear();
+      heap = std::priority_queue<Item, std::vector<Item>, std::greater<Item> >();
+
+      auto relax = [&](Index i, double d_i) {
+        for(Index e = row_begin[i]; e < row_begin[i + 1]; e++) {
+          Index j = col[e];
+          if(done[j])
+            continue;
+          double d = d_i + std::max(cost[e] - u[i] - v[j], 0.0);
+          if(d < dist[j]) {
+            if(dist[j] == inf)
+              visited_cols.push_back(j);
+            dist[j] = d;
+            pred[j] = i;
+            heap.push(Item(d, j));
+          }
+        }
+      };
+
+      relax(s, 0.0);
+      Index sink = none;
+      while(!heap.empty()) {
+        Item top = heap.top();
+        heap.pop();
+        Index j = top.second;
+        if(done[j] || top.first > dist[j])
+          continue;
+        done[j] = true;
+        finished_cols.push_back(j);
+        if(row_of_col[j] == none) {
+          sink = j;
+          break;
+        }
+        relax(row_of_col[j], dist[j]);
+      }
+
+      if(sink == none)
+        return false;
+
+      // Update potentials so that the augmenting path is tight and all reduced costs stay >= 0
+      double delta = dist[sink];
+      u[s] += delta;
+      for(Index j : finished_cols) {
+        if(j == sink)
+          continue;
+        u[row_of_col[j]] += delta - dist[j];
+        v[j] -= delta - dist[j];
+      }
+
+      // Augment
+      for(Index j = sink; j != none;) {
+        Index i = pred[j];
+        Index next = col_of_row[i];
+        col_of_row[i] = j;
+        row_of_col[j] = i;
+        j = (i == s) ? none : next;
+      }
+
+      for(Index j : visited_cols) {
+        dist[j] = inf;
+        pred[j] = none;
+        done[j] = false;
+      }
+    }
+
+    optimal_assignment = col_of_row;
+    tot_cost = 0.0;
+    for(Index i = 0; i < N; i++) {
+      for(Index e = row_begin[i]; e < row_begin[i + 1]; e++) {
+        if(col[e] == col_of_row[i]) {
+          tot_cost += cost[e];
+          break;
+        }
+      }
+    }
+    return true;
+  }
+
   namespace HungarianMethod_impl {
     //*******************************************************************************************
     /**
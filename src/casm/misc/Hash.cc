@@ -0,0 +1,23 @@
+#include "casm/misc/Hash.hh"
+
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace CASM {
+
+  std::uint64_t fnv1a_hash_file(const boost::filesystem::path &filename) {
+    std::ifstream file(filename.string().c_str(), std::ios::binary);
+    if(!file) {
+      throw std::runtime_error(std::string("Error in fnv1a_hash_file: could not open ") + filename.string());
+    }
+    std::uint64_t hash = 14695981039346656037ULL;
+    std::vector<char> buf(1 << 16);
+    while(file) {
+      file.read(buf.data(), buf.size());
+      hash = fnv1a_hash(buf.data(), file.gcount(), hash);
+    }
+    return hash;
+  }
+
+}
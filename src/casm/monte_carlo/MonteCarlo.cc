@@ -0,0 +1,255 @@
+#include "casm/monte_carlo/MonteCarlo.hh"
+
+#include <cmath>
+#include "casm/clex/PrimClex.hh"
+#include "casm/clex/Supercell.hh"
+
+namespace CASM {
+
+  jsonParser &to_json(const MonteConditions &cond, jsonParser &json) {
+    json.put_obj();
+    json["temperature"] = cond.temperature;
+    if(cond.param_chem_pot.size()) {
+      json["param_chem_pot"].put_obj();
+      for(Index i = 0; i < cond.param_chem_pot.size(); i++) {
+        json["param_chem_pot"][std::string(1, (char)((int)'a' + i))] = cond.param_chem_pot(i);
+      }
+    }
+    return json;
+  }
+
+  //*******************************************************************************************
+  /// \param _scel Supercell, with neighbor lists
+  /// \param _configdof Initial occupation
+  /// \param _clexulator Clexulator for the basis set the ECI were fit with
+  /// \param _eci ECI
+  /// \param _seed Seed for the random number generator
+  MonteCarlo::MonteCarlo(const Supercell &_scel,
+                         const ConfigDoF &_configdof,
+                         const Clexulator &_clexulator,
+                         const ECIContainer &_eci,
+                         MTRand::uint32 _seed) :
+    m_twister(_seed),
+    m_configdof(_configdof),
+    m_proposed(0),
+    m_accepted(0),
+    m_scel(_scel),
+    m_volume(_scel.volume()),
+    m_clexulator(_clexulator),
+    m_eci(_eci),
+    m_dcorr(_clexulator.corr_size(), 0.0),
+    m_nlist_buffer(_scel.nlist().nlist_size()),
+    m_beta(0.0),
+    m_energy(0.0) {
+
+    if(!m_configdof.has_occupation() || m_configdof.size() != m_scel.num_sites()) {
+      throw std::runtime_error("Error constructing MonteCarlo: occupation does not match supercell " + m_scel.get_name());
+    }
+
+    for(auto it = m_eci.eci_index_list().cbegin(); it != m_eci.eci_index_list().cend(); ++it) {
+      if(*it >= m_clexulator.corr_size()) {
+        throw std::runtime_error("Error constructing MonteCarlo: ECI index out of range of the basis set");
+      }
+    }
+
+    if(!m_scel.get_primclex().has_composition_axes()) {
+      throw std::runtime_error("Error constructing MonteCarlo: no composition axes selected");
+    }
+
+    m_components = m_scel.get_primclex().composition_axes().components();
+    Array<std::string> components;
+    for(auto it = m_components.cbegin(); it != m_components.cend(); ++it) {
+      components.push_back(*it);
+    }
+    m_to_component = get_index_converter(m_scel.get_prim(), components);
+
+    m_to_occ.resize(m_to_component.size(), std::vector<int>(m_components.size(), -1));
+    for(Index b = 0; b < m_to_component.size(); b++) {
+      for(Index occ = 0; occ < m_to_component[b].size(); occ++) {
+        m_to_occ[b][m_to_component[b][occ]] = occ;
+      }
+    }
+
+    m_num_each_component = Eigen::VectorXd::Zero(m_components.size());
+    for(Index l = 0; l < num_sites(); l++) {
+      m_num_each_component(_component(l, m_configdof.occ(l))) += 1.0;
+    }
+
+    recalculate_energy();
+  }
+
+  //*******************************************************************************************
+  void MonteCarlo::set_conditions(const MonteConditions &_cond) {
+    if(!(_cond.temperature > 0.0)) {
+      throw std::runtime_error("Error in MonteCarlo::set_conditions: temperature must be positive");
+    }
+    m_cond = _cond;
+    m_beta = 1.0 / (KB * m_cond.temperature);
+  }
+
+  //*******************************************************************************************
+  void MonteCarlo::pass() {
+    for(Index i = 0; i < num_sites(); i++) {
+      step();
+    }
+  }
+
+  //*******************************************************************************************
+  void MonteCarlo::set_energy_clexulator(const EnergyClexulator &_energy_clexulator) {
+    if(_energy_clexulator.nlist_size() != m_clexulator.nlist_size()) {
+      throw std::runtime_error("Error in MonteCarlo::set_energy_clexulator: neighbor list size does not match the basis set");
+    }
+    m_energy_clexulator = _energy_clexulator;
+    recalculate_energy();
+  }
+
+  //*******************************************************************************************
+  double MonteCarlo::recalculate_energy() {
+    double energy;
+    if(m_energy_clexulator.initialized()) {
+      energy = clex_energy(m_configdof, m_scel, m_energy_clexulator) * m_volume;
+    }
+    else {
+      energy = m_eci * correlations(m_configdof, m_scel, m_clexulator) * m_volume;
+    }
+    double diff = energy - m_energy;
+    m_energy = energy;
+    return diff;
+  }
+
+  //*******************************************************************************************
+  /// The change in correlations summed over the supercell is the change in point correlations
+  /// of site 'l', calculated from the neighborhood of the unit cell that contains 'l'.
+  double MonteCarlo::_delta_energy(Index l, int occ_f) {
+
+    if(m_energy_clexulator.initialized()) {
+      m_energy_clexulator.set_config_occ(m_configdof.occupation().begin());
+      m_energy_clexulator.set_nlist(m_scel.nlist().sites(l % m_volume, m_nlist_buffer.data()));
+      return m_energy_clexulator.calc_delta_energy(_b(l), m_configdof.occ(l), occ_f);
+    }
+
+    const Array<ECIContainer::size_type> &index = m_eci.eci_index_list();
+    const ECIContainer::ScalarECI &eci = m_eci.eci_list();
+
+    m_clexulator.set_config_occ(m_configdof.occupation().begin());
+    m_clexulator.set_nlist(m_scel.nlist().sites(l % m_volume, m_nlist_buffer.data()));
+    m_clexulator.calc_restricted_delta_point_corr(_b(l),
+                                                  m_configdof.occ(l),
+                                                  occ_f,
+                                                  m_dcorr.data(),
+                                                  index.begin(),
+                                                  index.end());
+
+    double delta_energy = 0.0;
+    for(Index i = 0; i < index.size(); i++) {
+      delta_energy += eci[i] * m_dcorr[index[i]];
+    }
+    return delta_energy;
+  }
+
+  //*******************************************************************************************
+  void MonteCarlo::_set_occ(Index l, int occ_f, double delta_energy) {
+    m_num_each_component(_component(l, m_configdof.occ(l))) -= 1.0;
+    m_num_each_component(_component(l, occ_f)) += 1.0;
+    m_configdof.occ(l) = occ_f;
+    m_energy += delta_energy;
+  }
+
+  //*******************************************************************************************
+  bool MonteCarlo::_accept(double delta_potential) {
+    if(delta_potential <= 0.0) {
+      return true;
+    }
+    return m_twister.randExc() < std::exp(-m_beta * delta_potential);
+  }
+
+  //*******************************************************************************************
+  /// The energy of a swap is the change from the first occupant change plus the change from the
+  /// second occupant change evaluated with the first already made, which is correct when the two
+  /// sites are neighbors.
+  bool Canonical::step() {
+    ++m_proposed;
+
+    Index l1 = _random_site();
+    Index l2 = _random_site();
+
+    int comp1 = _component(l1, m_configdof.occ(l1));
+    int comp2 = _component(l2, m_configdof.occ(l2));
+    if(comp1 == comp2) {
+      return false;
+    }
+
+    int occ1_i = m_configdof.occ(l1);
+    int occ1_f = _occ(l1, comp2);
+    int occ2_f = _occ(l2, comp1);
+    if(occ1_f < 0 || occ2_f < 0) {
+      return false;
+    }
+
+    double delta_energy = _delta_energy(l1, occ1_f);
+    m_configdof.occ(l1) = occ1_f;
+    delta_energy += _delta_energy(l2, occ2_f);
+    m_configdof.occ(l1) = occ1_i;
+
+    if(!_accept(delta_energy)) {
+      return false;
+    }
+
+    _set_occ(l1, occ1_f, 0.0);
+    _set_occ(l2, occ2_f, delta_energy);
+    ++m_accepted;
+    return true;
+  }
+
+  //*******************************************************************************************
+  SemiGrandCanonical::SemiGrandCanonical(const Supercell &_scel,
+                                         const ConfigDoF &_configdof,
+                                         const Clexulator &_clexulator,
+                                         const ECIContainer &_eci,
+                                         MTRand::uint32 _seed) :
+    MonteCarlo(_scel, _configdof, _clexulator, _eci, _seed),
+    m_mu(Eigen::VectorXd::Zero(components().size())) {}
+
+  //*******************************************************************************************
+  void SemiGrandCanonical::set_conditions(const MonteConditions &_cond) {
+    const CompositionConverter &axes = supercell().get_primclex().composition_axes();
+    if(_cond.param_chem_pot.size() != axes.independent_compositions()) {
+      throw std::runtime_error(
+        std::string("Error in SemiGrandCanonical::set_conditions: expected ") +
+        std::to_string(axes.independent_compositions()) + " parametric chemical potentials, received " +
+        std::to_string(_cond.param_chem_pot.size()));
+    }
+    MonteCarlo::set_conditions(_cond);
+    m_mu = axes.atomic_mu(_cond.param_chem_pot);
+  }
+
+  //*******************************************************************************************
+  bool SemiGrandCanonical::step() {
+    ++m_proposed;
+
+    Index l = _random_site();
+    int num_occ = _num_occ(l);
+    if(num_occ < 2) {
+      return false;
+    }
+
+    // choose one of the other allowed occupants
+    int occ_i = m_configdof.occ(l);
+    int occ_f = m_twister.randInt(num_occ - 2);
+    if(occ_f >= occ_i) {
+      ++occ_f;
+    }
+
+    double delta_energy = _delta_energy(l, occ_f);
+    double delta_potential = delta_energy - (m_mu(_component(l, occ_f)) - m_mu(_component(l, occ_i)));
+
+    if(!_accept(delta_potential)) {
+      return false;
+    }
+
+    _set_occ(l, occ_f, delta_energy);
+    ++m_accepted;
+    return true;
+  }
+
+}
@@ -0,0 +1,389 @@
+#include "casm/monte_carlo/MonteDriver.hh"
+
+#include <algorithm>
+#include <cmath>
+#include "casm/casm_io/jsonStream.hh"
+#include "casm/clex/PrimClex.hh"
+#include "casm/clex/Supercell.hh"
+#include "casm/monte_carlo/MonteStatistics.hh"
+
+namespace CASM {
+
+  namespace {
+
+    std::string _axis_name(Index i) {
+      return std::string(1, (char)((int)'a' + i));
+    }
+
+    /// Read a vector keyed by composition axis name, {"a" : ..., "b" : ...}
+    Eigen::VectorXd _read_axis_vector(const jsonParser &json, Index size, const std::string &what) {
+      Eigen::VectorXd vec(size);
+      for(Index i = 0; i < size; i++) {
+        if(!json.contains(_axis_name(i))) {
+          throw std::runtime_error("Error reading Monte Carlo settings: '" + what + "' is missing axis '" + _axis_name(i) + "'");
+        }
+        vec(i) = json[_axis_name(i)].get<double>();
+      }
+      return vec;
+    }
+
+    /// Read conditions, with quantities not in 'json' taken from 'defaults'. The chemical
+    /// potential is only read if 'defaults' has one.
+    MonteConditions _read_conditions(const jsonParser &json, const MonteConditions &defaults, Index num_axes) {
+      MonteConditions cond = defaults;
+      if(json.contains("temperature")) {
+        cond.temperature = json["temperature"].get<double>();
+      }
+      if(defaults.param_chem_pot.size() && json.contains("param_chem_pot")) {
+        cond.param_chem_pot = _read_axis_vector(json["param_chem_pot"], num_axes, "param_chem_pot");
+      }
+      return cond;
+    }
+
+    Eigen::VectorXd _as_vector(const MonteConditions &cond) {
+      Eigen::VectorXd vec(1 + cond.param_chem_pot.size());
+      vec(0) = cond.temperature;
+      vec.tail(cond.param_chem_pot.size()) = cond.param_chem_pot;
+      return vec;
+    }
+
+    /// Conditions from 'initial' to 'final', by 'incr'
+    std::vector<MonteConditions> _make_path(const MonteConditions &initial,
+                                            const MonteConditions &final,
+                                            const MonteConditions &incr) {
+      Eigen::VectorXd begin = _as_vector(initial);
+      Eigen::VectorXd diff = _as_vector(final) - begin;
+      Eigen::VectorXd step = _as_vector(incr);
+
+      double N = -1.0;
+      for(Index i = 0; i < diff.size(); i++) {
+        if(almost_zero(step(i))) {
+          if(!almost_zero(diff(i))) {
+            throw std::runtime_error("Error reading Monte Carlo settings: a quantity that changes from 'initial' to 'final' has no 'increment'");
+          }
+          continue;
+        }
+        double n = diff(i) / step(i);
+        if(n < -TOL || std::abs(n - std::round(n)) > 1e-6) {
+          throw std::runtime_error("Error reading Monte Carlo settings: 'final' is not a whole number of 'increment' from 'initial'");
+        }
+        if(N >= 0.0 && std::round(n) != N) {
+          throw std::runtime_error("Error reading Monte Carlo settings: quantities need different numbers of 'increment' from 'initial' to 'final'");
+        }
+        N = std::round(n);
+      }
+
+      std::vector<MonteConditions> path;
+      for(Index i = 0; i <= std::max(N, 0.0); i++) {
+        MonteConditions cond = initial;
+        cond.temperature += i * incr.temperature;
+        if(cond.param_chem_pot.size()) {
+          cond.param_chem_pot += i * incr.param_chem_pot;
+        }
+        path.push_back(cond);
+      }
+      return path;
+    }
+
+  }
+
+  //*******************************************************************************************
+  MonteSettings::MonteSettings(const jsonParser &json, const PrimClex &primclex) :
+    transf_mat(Eigen::Matrix3i::Zero()) {
+
+    if(!primclex.has_composition_axes()) {
+      throw std::runtime_error("Error reading Monte Carlo settings: no composition axes selected");
+    }
+    Index num_axes = primclex.composition_axes().independent_compositions();
+
+    if(!json.contains("ensemble")) {
+      throw std::runtime_error("Error reading Monte Carlo settings: 'ensemble' is required");
+    }
+    std::string ensemble = json["ensemble"].get<std::string>();
+    if(ensemble == "canonical") {
+      is_canonical = true;
+    }
+    else if(ensemble == "semi_grand_canonical") {
+      is_canonical = false;
+    }
+    else {
+      throw std::runtime_error("Error reading Monte Carlo settings: unknown 'ensemble' '" + ensemble + "'");
+    }
+
+    if(!json.contains("supercell")) {
+      throw std::runtime_error("Error reading Monte Carlo settings: 'supercell' is required");
+    }
+    if(json["supercell"].is_string()) {
+      supercell = json["supercell"].get<std::string>();
+    }
+    else {
+      from_json(transf_mat, json["supercell"]);
+    }
+
+    if(json.contains("initial_config")) {
+      initial_config = json["initial_config"].get<std::string>();
+    }
+
+    if(json.contains("param_composition")) {
+      if(!is_canonical) {
+        throw std::runtime_error("Error reading Monte Carlo settings: 'param_composition' is only used for the canonical ensemble");
+      }
+      param_composition = _read_axis_vector(json["param_composition"], num_axes, "param_composition");
+    }
+
+    // conditions
+    if(!json.contains("conditions") || !json["conditions"].contains("initial")) {
+      throw std::runtime_error("Error reading Monte Carlo settings: 'conditions/initial' is required");
+    }
+    const jsonParser &cjson = json["conditions"];
+    if(!cjson["initial"].contains("temperature")) {
+      throw std::runtime_error("Error reading Monte Carlo settings: 'conditions/initial/temperature' is required");
+    }
+    if(!is_canonical && !cjson["initial"].contains("param_chem_pot")) {
+      throw std::runtime_error("Error reading Monte Carlo settings: 'conditions/initial/param_chem_pot' is required for the semi-grand canonical ensemble");
+    }
+
+    MonteConditions zero;
+    zero.temperature = 0.0;
+    if(!is_canonical) {
+      zero.param_chem_pot = Eigen::VectorXd::Zero(num_axes);
+    }
+
+    MonteConditions initial = _read_conditions(cjson["initial"], zero, num_axes);
+    if(cjson.contains("final")) {
+      if(!cjson.contains("increment")) {
+        throw std::runtime_error("Error reading Monte Carlo settings: 'conditions/final' requires 'conditions/increment'");
+      }
+      MonteConditions final = _read_conditions(cjson["final"], initial, num_axes);
+      MonteConditions incr = _read_conditions(cjson["increment"], zero, num_axes);
+      path = _make_path(initial, final, incr);
+    }
+    else {
+      path.push_back(initial);
+    }
+    for(auto it = path.cbegin(); it != path.cend(); ++it) {
+      if(!(it->temperature > 0.0)) {
+        throw std::runtime_error("Error reading Monte Carlo settings: temperatures must be positive");
+      }
+    }
+
+    // sampling
+    passes_per_sample = json.contains("passes_per_sample") ? json["passes_per_sample"].get<int>() : 1;
+    check_period = json.contains("check_period") ? json["check_period"].get<int>() : 100;
+    min_samples = json.contains("min_samples") ? json["min_samples"].get<int>() : 100;
+    max_samples = json.contains("max_samples") ? json["max_samples"].get<int>() : 10000;
+    precision = json.contains("precision") ? json["precision"].get<double>() : 0.001;
+    seed = json.contains("seed") ? json["seed"].get<unsigned int>() : 0;
+    write_samples = json.contains("write_samples") ? json["write_samples"].get<bool>() : false;
+
+    if(passes_per_sample < 1 || check_period < 1 || max_samples < 1) {
+      throw std::runtime_error("Error reading Monte Carlo settings: 'passes_per_sample', 'check_period', and 'max_samples' must be positive");
+    }
+  }
+
+  //*******************************************************************************************
+  /// Sites that allow the fewest components are set first, so that components that are only
+  /// allowed on some sublattices are placed there.
+  void set_random_occupation(ConfigDoF &configdof,
+                             const Supercell &scel,
+                             const Eigen::VectorXd &param_comp,
+                             MTRand &twister) {
+
+    const CompositionConverter &axes = scel.get_primclex().composition_axes();
+    Eigen::VectorXd n = axes.mol_composition(param_comp) * scel.volume();
+
+    std::vector<std::string> v_components = axes.components();
+    Array<std::string> components;
+    for(auto it = v_components.cbegin(); it != v_components.cend(); ++it) {
+      components.push_back(*it);
+    }
+    Array< Array<int> > convert = get_index_converter(scel.get_prim(), components);
+
+    std::vector<long> remaining(n.size());
+    long total = 0;
+    for(Index i = 0; i < n.size(); i++) {
+      remaining[i] = std::lround(n(i));
+      if(remaining[i] < 0) {
+        throw std::runtime_error("Error setting occupation: composition is outside the composition space");
+      }
+      total += remaining[i];
+    }
+    if(total != (long) scel.num_sites()) {
+      throw std::runtime_error("Error setting occupation: number of each component does not match the number of sites in supercell " + scel.get_name());
+    }
+
+    // shuffle sites, then order by number of allowed components
+    std::vector<Index> site(scel.num_sites());
+    for(Index l = 0; l < site.size(); l++) {
+      site[l] = l;
+    }
+    for(Index i = site.size(); i > 1; i--) {
+      std::swap(site[i - 1], site[twister.randInt(i - 1)]);
+    }
+    std::stable_sort(site.begin(), site.end(), [&](Index l1, Index l2) {
+      return convert[scel.get_b(l1)].size() < convert[scel.get_b(l2)].size();
+    });
+
+    configdof.set_occupation(Array<int>(scel.num_sites(), 0));
+    for(auto it = site.cbegin(); it != site.cend(); ++it) {
+      const Array<int> &allowed = convert[scel.get_b(*it)];
+      int best = -1;
+      for(Index occ = 0; occ < allowed.size(); occ++) {
+        if(remaining[allowed[occ]] > 0 && (best < 0 || remaining[allowed[occ]] > remaining[allowed[best]])) {
+          best = occ;
+        }
+      }
+      if(best < 0) {
+        throw std::runtime_error("Error setting occupation: composition can not be set on supercell " + scel.get_name());
+      }
+      configdof.occ(*it) = best;
+      --remaining[allowed[best]];
+    }
+  }
+
+  //*******************************************************************************************
+  MonteDriver::MonteDriver(MonteCarlo &_mc, const MonteSettings &_set, std::ostream &_sout) :
+    m_mc(_mc),
+    m_set(_set),
+    m_sout(_sout) {
+
+    m_name.push_back("potential_energy");
+    m_name.push_back("formation_energy");
+    for(auto it = m_mc.components().cbegin(); it != m_mc.components().cend(); ++it) {
+      m_name.push_back("comp_n(" + *it + ")");
+    }
+    Index num_axes = m_mc.supercell().get_primclex().composition_axes().independent_compositions();
+    for(Index i = 0; i < num_axes; i++) {
+      m_name.push_back("comp(" + _axis_name(i) + ")");
+    }
+  }
+
+  //*******************************************************************************************
+  void MonteDriver::run(jsonStreamWriter &results, jsonStreamWriter *samples) {
+    results.begin_array();
+    if(samples) {
+      samples->begin_array();
+    }
+    for(auto it = m_set.path.cbegin(); it != m_set.path.cend(); ++it) {
+      results.value(run(*it, samples));
+      results.flush();
+    }
+    results.end_array();
+    if(samples) {
+      samples->end_array();
+    }
+  }
+
+  //*******************************************************************************************
+  /// Samples are written as an object with the conditions, the observable names, and an array
+  /// with one row per sample:
+  /// \code
+  /// {
+  ///   "conditions" : {...},
+  ///   "observables" : ["potential_energy", ...],
+  ///   "samples" : [
+  ///     [ ... ],
+  ///     ...
+  ///   ]
+  /// }
+  /// \endcode
+  jsonParser MonteDriver::run(const MonteConditions &cond, jsonStreamWriter *samples) {
+
+    m_mc.set_conditions(cond);
+    m_mc.recalculate_energy();
+    m_mc.reset_counts();
+
+    if(samples) {
+      samples->begin_object();
+      samples->key("conditions").value(cond);
+      samples->key("observables").value(m_name);
+      samples->key("samples").begin_array();
+    }
+
+    std::vector< std::vector<double> > obs(m_name.size());
+    std::vector<double> sample(m_name.size());
+    Index passes = 0;
+    Index equil = 0;
+    bool converged = false;
+
+    while(true) {
+      for(Index i = 0; i < m_set.passes_per_sample; i++) {
+        m_mc.pass();
+      }
+      passes += m_set.passes_per_sample;
+
+      _sample(sample);
+      for(Index i = 0; i < sample.size(); i++) {
+        obs[i].push_back(sample[i]);
+      }
+      if(samples) {
+        samples->value(sample);
+      }
+
+      Index N = obs[0].size();
+      if(N % m_set.check_period == 0 || N >= m_set.max_samples) {
+        equil = equilibration_index(obs[0]);
+        MonteStats stats = statistics(obs[0], equil);
+        if(stats.count >= m_set.min_samples && stats.std_err <= m_set.precision) {
+          converged = true;
+          break;
+        }
+        if(N >= m_set.max_samples) {
+          break;
+        }
+      }
+    }
+
+    if(samples) {
+      samples->end_array();
+      samples->end_object();
+      samples->flush();
+    }
+
+    jsonParser json;
+    json["conditions"] = cond;
+    json["converged"] = converged;
+    json["passes"] = passes;
+    json["num_samples"] = obs[0].size();
+    json["num_equilibration_samples"] = equil;
+    json["acceptance"] = m_mc.proposed() ? ((double) m_mc.accepted()) / m_mc.proposed() : 0.0;
+
+    for(Index i = 0; i < m_name.size(); i++) {
+      MonteStats stats = statistics(obs[i], equil);
+      json[m_name[i]]["mean"] = stats.mean;
+      json[m_name[i]]["std_err"] = stats.std_err;
+      if(i == 0) {
+        json["heat_capacity"] = m_mc.supercell().volume() * stats.var / (KB * cond.temperature * cond.temperature);
+      }
+    }
+
+    m_sout << "  T: " << cond.temperature;
+    if(cond.param_chem_pot.size()) {
+      m_sout << "  param_chem_pot: " << cond.param_chem_pot.transpose();
+    }
+    m_sout << "  samples: " << obs[0].size()
+           << "  <potential_energy>: " << json["potential_energy"]["mean"].get<double>()
+           << (converged ? "" : "  (not converged)") << std::endl;
+
+    return json;
+  }
+
+  //*******************************************************************************************
+  /// Observables are per unit cell
+  void MonteDriver::_sample(std::vector<double> &sample) const {
+    double volume = m_mc.supercell().volume();
+    Eigen::VectorXd comp_n = m_mc.num_each_component() / volume;
+    Eigen::VectorXd comp = m_mc.supercell().get_primclex().composition_axes().param_composition(comp_n);
+
+    Index i = 0;
+    sample[i++] = m_mc.potential_energy() / volume;
+    sample[i++] = m_mc.energy() / volume;
+    for(Index j = 0; j < comp_n.size(); j++) {
+      sample[i++] = comp_n(j);
+    }
+    for(Index j = 0; j < comp.size(); j++) {
+      sample[i++] = comp(j);
+    }
+  }
+
+}
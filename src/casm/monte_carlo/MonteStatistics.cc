@@ -0,0 +1,82 @@
+#include "casm/monte_carlo/MonteStatistics.hh"
+
+#include <cmath>
+#include <limits>
+
+namespace CASM {
+
+  //*******************************************************************************************
+  Index equilibration_index(const std::vector<double> &samples) {
+    Index N = samples.size();
+    if(N < 2) {
+      return 0;
+    }
+
+    // suffix_sum[i] = sum of samples[i, N)
+    std::vector<double> suffix_sum(N + 1, 0.0);
+    for(Index i = N; i > 0; i--) {
+      suffix_sum[i - 1] = suffix_sum[i] + samples[i - 1];
+    }
+
+    bool above = samples[0] > suffix_sum[1] / (N - 1);
+    for(Index i = 1; i < N - 1; i++) {
+      double mean_after = suffix_sum[i + 1] / (N - i - 1);
+      if(above ? (samples[i] <= mean_after) : (samples[i] >= mean_after)) {
+        return i;
+      }
+    }
+    return N;
+  }
+
+  //*******************************************************************************************
+  MonteStats statistics(const std::vector<double> &samples, Index begin) {
+    MonteStats stats;
+    stats.count = begin < samples.size() ? samples.size() - begin : 0;
+    stats.mean = 0.0;
+    stats.var = 0.0;
+    stats.std_err = std::numeric_limits<double>::infinity();
+    if(stats.count == 0) {
+      return stats;
+    }
+
+    for(Index i = begin; i < samples.size(); i++) {
+      stats.mean += samples[i];
+    }
+    stats.mean /= stats.count;
+
+    for(Index i = begin; i < samples.size(); i++) {
+      stats.var += (samples[i] - stats.mean) * (samples[i] - stats.mean);
+    }
+    stats.var /= stats.count;
+
+    if(stats.count < 4) {
+      return stats;
+    }
+
+    // batch means, using the last num_batch*batch_size samples
+    Index num_batch = std::sqrt((double) stats.count);
+    Index batch_size = stats.count / num_batch;
+    Index batch_begin = samples.size() - num_batch * batch_size;
+
+    double mean = 0.0;
+    std::vector<double> batch_mean(num_batch, 0.0);
+    for(Index i = 0; i < num_batch; i++) {
+      for(Index j = 0; j < batch_size; j++) {
+        batch_mean[i] += samples[batch_begin + i * batch_size + j];
+      }
+      batch_mean[i] /= batch_size;
+      mean += batch_mean[i];
+    }
+    mean /= num_batch;
+
+    double batch_var = 0.0;
+    for(Index i = 0; i < num_batch; i++) {
+      batch_var += (batch_mean[i] - mean) * (batch_mean[i] - mean);
+    }
+    batch_var /= (num_batch - 1);
+
+    stats.std_err = std::sqrt(batch_var / num_batch);
+    return stats;
+  }
+
+}
@@ -0,0 +1,131 @@
+/// Benchmark of Supercell::add_config, which detects duplicates using the hash index of
+/// Supercell::config_list
+///
+/// Usage, from the repository root:
+///   add_config_benchmark [N1 N2 ...]
+///
+/// For each N (default: 10000 100000 1000000), N random occupations of a ternary FCC
+/// supercell of volume 20 are added to an empty Supercell through Supercell::add_config,
+/// and then added again, so that every one is found as a duplicate. Then the stored
+/// canonical configurations are looked up with Supercell::contains_config, which includes
+/// no canonicalization, and, for comparison, a sample of them with a linear scan of
+/// config_list, which is how duplicates were found before the hash index.
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "casm/clex/PrimClex.hh"
+
+using namespace CASM;
+
+namespace {
+
+  double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+}
+
+int main(int argc, char *argv[]) {
+  namespace fs = boost::filesystem;
+
+  std::vector<Index> sizes;
+  for(int i = 1; i < argc; i++) {
+    sizes.push_back(std::stoul(argv[i]));
+  }
+  if(sizes.empty()) {
+    sizes = {10000, 100000, 1000000};
+  }
+
+  Structure prim(fs::path("tests/unit/crystallography/PRIM1"));
+
+  std::cout << std::setw(10) << "N"
+            << std::setw(10) << "unique"
+            << std::setw(16) << "add_config(s)"
+            << std::setw(16) << "duplicates(s)"
+            << std::setw(16) << "lookup(us)"
+            << std::setw(16) << "linear(us)" << std::endl;
+
+  for(Index N : sizes) {
+
+    // a new PrimClex for each N, so that each starts with an empty Supercell
+    PrimClex primclex(prim);
+    Matrix3<double> T(0.0);
+    T(0, 0) = 2.0;
+    T(1, 1) = 2.0;
+    T(2, 2) = 5.0;
+    Supercell &scel = primclex.get_supercell(primclex.add_supercell(Lattice(prim.lattice().lat_column_mat() * T)));
+
+    std::mt19937 engine(N);
+    std::uniform_int_distribution<int> occupant(0, 2);
+    std::vector<Configuration> configs;
+    configs.reserve(N);
+    Array<int> occ(scel.num_sites());
+    for(Index i = 0; i < N; i++) {
+      for(Index l = 0; l < occ.size(); l++) {
+        occ[l] = occupant(engine);
+      }
+      configs.push_back(Configuration(scel, jsonParser(), ConfigDoF(occ)));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for(const Configuration &config : configs) {
+      scel.add_config(config);
+    }
+    double t_add = seconds_since(start);
+    Index unique = scel.get_config_list().size();
+
+    start = std::chrono::steady_clock::now();
+    for(const Configuration &config : configs) {
+      if(scel.add_config(config)) {
+        std::cerr << "Error: a duplicate configuration was added" << std::endl;
+        return 1;
+      }
+    }
+    double t_dup = seconds_since(start);
+    configs.clear();
+
+    const Supercell::ConfigList &config_list = scel.get_config_list();
+    start = std::chrono::steady_clock::now();
+    for(Index i = 0; i < config_list.size(); i++) {
+      Index index;
+      if(!scel.contains_config(config_list[i], index) || index != i) {
+        std::cerr << "Error: configuration " << i << " was not found" << std::endl;
+        return 1;
+      }
+    }
+    double t_lookup = seconds_since(start) / config_list.size();
+
+    // a linear scan finds configuration i after i comparisons, so sample evenly
+    Index samples = std::min<Index>(100, config_list.size());
+    start = std::chrono::steady_clock::now();
+    for(Index s = 0; s < samples; s++) {
+      Index i = (s * config_list.size()) / samples;
+      Index j = 0;
+      while(!(config_list[j].configdof() == config_list[i].configdof())) {
+        j++;
+      }
+      if(j != i) {
+        std::cerr << "Error: configuration " << i << " is repeated" << std::endl;
+        return 1;
+      }
+    }
+    double t_linear = seconds_since(start) / samples;
+
+    std::cout << std::setw(10) << N
+              << std::setw(10) << unique
+              << std::setw(16) << std::fixed << std::setprecision(3) << t_add
+              << std::setw(16) << t_dup
+              << std::setw(16) << 1e6 * t_lookup
+              << std::setw(16) << 1e6 * t_linear << std::endl;
+  }
+
+  return 0;
+}
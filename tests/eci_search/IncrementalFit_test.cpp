@@ -0,0 +1,128 @@
+#define BOOST_TEST_MODULE IncrementalFit
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+// eci_search is built as a single translation unit, see apps/eci_search/eci_search.cpp
+
+#include "jsonParser.cc"
+#include "BP_Vec.hh"
+
+namespace CASM {
+  template<typename T>
+  CASM::jsonParser &to_json(const BP::BP_Vec<T> &value, CASM::jsonParser &json) {
+    json.put_array();
+    for(int i = 0; i < value.size(); i++)
+      json.push_back(value[i]);
+    return json;
+  }
+
+  template<typename T>
+  void from_json(BP::BP_Vec<T> &value, const CASM::jsonParser &json) {
+    value.capacity(json.size());
+    for(int i = 0; i < json.size(); i++)
+      value.add(json[i].get<T>());
+  }
+}
+
+#include "BP_basic.cc"
+#include "BP_Dir.cc"
+#include "BP_Vec.cc"
+#include "BP_GVec.cc"
+#include "BP_Plot.cc"
+#include "BP_Geo.cc"
+#include "BP_Parse.cc"
+#include "BP_StopWatch.cc"
+#include "CorrCache.cc"
+#include "Correlation.cc"
+#include "ECISet.cc"
+#include "EnergySet.cc"
+#include "GeneticAlgorithm.cc"
+
+/// What is being tested:
+#include "IncrementalFit.cc"
+
+/// Dependencies
+#include "Functions.cc"
+#include "Minimize.cc"
+#include "Population.cc"
+
+/// What is being used to test it:
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+  /// Fit 'eci' with 'fitter', and check the eci, cv, and rms against a least squares fit of a copy
+  ///   from scratch, by ECISet::fit
+  void check_fit(IncrementalFit &fitter, ECISet &eci, const Correlation &corr, const EnergySet &nrg) {
+    bool singular, expected_singular;
+    fitter.fit(eci, singular);
+
+    ECISet expected(eci);
+    expected.fit(corr, nrg, expected_singular);
+
+    BOOST_REQUIRE_EQUAL(singular, expected_singular);
+    if(singular) {
+      return;
+    }
+
+    double scale = 0.0;
+    for(int i = 0; i < eci.size(); i++) {
+      scale = std::max(scale, std::abs(expected.get_value(i)));
+    }
+    for(int i = 0; i < eci.size(); i++) {
+      BOOST_CHECK_SMALL(eci.get_value(i) - expected.get_value(i), 1e-8 * scale);
+    }
+    BOOST_CHECK_CLOSE(eci.get_rms(), expected.get_rms(), 1e-6);
+
+    // if a structure is fit exactly whatever its energy (hat matrix diagonal 1), its held out
+    //   error is round-off divided by round-off, and the cv scores cannot be compared
+    Eigen::MatrixXd A(nrg.get_Nstruct_on(), expected.get_Nclust_on());
+    expected.set_correlation_matrix(A, corr, nrg);
+    Eigen::JacobiSVD<Eigen::MatrixXd> svd(A, Eigen::ComputeThinU);
+    if(1.0 - svd.matrixU().rowwise().squaredNorm().maxCoeff() > 1e-8) {
+      BOOST_CHECK_CLOSE(eci.get_cv(), expected.get_cv(), 1e-6);
+    }
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(IncrementalFitTest)
+
+BOOST_AUTO_TEST_CASE(CompareToFitTest) {
+
+  EnergySet nrg("tests/eci_search/energy");
+  Correlation corr("tests/eci_search/corr.in", nrg);
+  ECISet eci("tests/eci_search/eci.in");
+
+  IncrementalFit fitter(corr, nrg);
+  BOOST_REQUIRE(fitter.initialized());
+
+  // the clusters on in eci.in, from scratch
+  check_fit(fitter, eci, corr, nrg);
+
+  // single toggles, which add or remove one column of the factorization; there are more
+  //   than the number of updates after which the factorization is recomputed
+  for(int step = 0; step < 400; step++) {
+    int i = (7 * step + 3) % eci.size();
+    if(!eci.toggle_allowed(i)) {
+      continue;
+    }
+    eci.toggle_clust(i);
+    check_fit(fitter, eci, corr, nrg);
+
+    // several toggles at once, removing and adding columns in one update, and too many to update
+    if(step % 40 == 0) {
+      int Ntoggle = (step % 80 == 0) ? 3 : 12;
+      for(int j = 0; j < Ntoggle; j++) {
+        int k = (11 * step + 5 * j + 1) % eci.size();
+        if(eci.toggle_allowed(k)) {
+          eci.toggle_clust(k);
+        }
+      }
+      check_fit(fitter, eci, corr, nrg);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,63 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/casm_io/CorrCache.hh"
+
+/// Dependencies
+
+/// What is being used to test it:
+#include <vector>
+#include <boost/filesystem.hpp>
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(CorrCacheTest)
+
+BOOST_AUTO_TEST_CASE(AppendFindTest) {
+
+  boost::filesystem::path filename("casm_io/CorrCache_test_out/test.corr");
+  boost::filesystem::remove_all(filename.parent_path());
+
+  std::vector<double> corr_a = {1.0, 0.5, 0.25};
+  std::vector<double> corr_b = {1.0, -0.5, 0.125};
+
+  {
+    CorrCache cache(filename, 123, 3);
+    BOOST_CHECK_EQUAL(cache.size(), 0);
+    cache.append("SCEL1_1_1_1_0_0_0/0", 10, corr_a.data());
+
+    // rows are visible after flush
+    BOOST_CHECK(cache.find("SCEL1_1_1_1_0_0_0/0") == nullptr);
+    cache.flush();
+    BOOST_CHECK(cache.find("SCEL1_1_1_1_0_0_0/0", 10) != nullptr);
+    BOOST_CHECK(cache.find("SCEL1_1_1_1_0_0_0/0", 11) == nullptr);
+    BOOST_CHECK(cache.find("SCEL1_1_1_1_0_0_0/1") == nullptr);
+
+    // changed DoF: the last row for a configname is used
+    cache.append("SCEL1_1_1_1_0_0_0/0", 11, corr_b.data());
+  }
+
+  {
+    CorrCache cache;
+    cache.open_read_only(filename);
+    BOOST_CHECK_EQUAL(cache.basis_hash(), 123);
+    BOOST_CHECK_EQUAL(cache.corr_size(), 3);
+    BOOST_CHECK_EQUAL(cache.size(), 2);
+    BOOST_CHECK_EQUAL(cache.num_configs(), 1);
+    BOOST_CHECK(cache.find("SCEL1_1_1_1_0_0_0/0", 10) == nullptr);
+    const double *corr = cache.find("SCEL1_1_1_1_0_0_0/0", 11);
+    BOOST_REQUIRE(corr != nullptr);
+    BOOST_CHECK_EQUAL_COLLECTIONS(corr, corr + 3, corr_b.begin(), corr_b.end());
+  }
+
+  {
+    // a different basis set starts a new cache
+    CorrCache cache(filename, 124, 3);
+    BOOST_CHECK_EQUAL(cache.size(), 0);
+  }
+
+  boost::filesystem::remove_all(filename.parent_path());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
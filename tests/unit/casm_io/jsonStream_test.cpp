@@ -0,0 +1,159 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/casm_io/jsonStream.hh"
+
+/// Dependencies
+
+/// What is being used to test it:
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace CASM;
+
+namespace {
+
+  const std::string json_str =
+    "{\n"
+    "  // comments are skipped\n"
+    "  \"supercells\" : {\n"
+    "    \"SCEL1_1_1_1_0_0_0\" : {\n"
+    "      \"0\" : {\n"
+    "        \"dof\" : { \"occupation\" : [ 0 ] },\n"
+    "        \"selected\" : false,\n"
+    "        \"source\" : [ { \"enumerated_by\" : \"ConfigEnumAllOccupations\" } ]\n"
+    "      },\n"
+    "      \"1\" : {\n"
+    "        \"dof\" : { \"occupation\" : [ 1 ] },\n"
+    "        \"selected\" : true,\n"
+    "        \"data\" : [ -1, 2.5, 1e-3, 18446744073709551615, null, \"a\\\"b\\\\c\\n\" ],\n"
+    "        \"empty\" : [ [], {} ]\n"
+    "      }\n"
+    "    }\n"
+    "  },\n"
+    "  \"version\" : \"0.1.0\"\n"
+    "}\n";
+
+}
+
+BOOST_AUTO_TEST_SUITE(jsonStreamTest)
+
+BOOST_AUTO_TEST_CASE(ReaderTest) {
+
+  std::stringstream ss(json_str);
+  jsonParser expected(ss);
+
+  // read the whole document
+  {
+    std::stringstream ss(json_str);
+    jsonStreamReader reader(ss);
+    jsonParser json;
+    reader.read(json);
+    BOOST_CHECK(json == expected);
+    BOOST_CHECK_EQUAL(reader.next(), jsonStreamReader::END_OF_STREAM);
+  }
+
+  // read configurations one at a time
+  {
+    std::stringstream ss(json_str);
+    jsonStreamReader reader(ss);
+    reader.expect(jsonStreamReader::BEGIN_OBJECT);
+    reader.expect(jsonStreamReader::KEY);
+    BOOST_CHECK_EQUAL(reader.key(), "supercells");
+    reader.expect(jsonStreamReader::BEGIN_OBJECT);
+    reader.expect(jsonStreamReader::KEY);
+    BOOST_CHECK_EQUAL(reader.key(), "SCEL1_1_1_1_0_0_0");
+    reader.expect(jsonStreamReader::BEGIN_OBJECT);
+    BOOST_CHECK_EQUAL(reader.depth(), 3);
+
+    int count = 0;
+    while(reader.next() == jsonStreamReader::KEY) {
+      std::string configid = reader.key();
+      jsonParser json;
+      reader.read(json);
+      BOOST_CHECK(json == expected["supercells"]["SCEL1_1_1_1_0_0_0"][configid]);
+      ++count;
+    }
+    BOOST_CHECK_EQUAL(count, 2);
+    BOOST_CHECK_EQUAL(reader.event(), jsonStreamReader::END_OBJECT);
+
+    reader.expect(jsonStreamReader::END_OBJECT);
+    reader.expect(jsonStreamReader::KEY);
+    BOOST_CHECK_EQUAL(reader.key(), "version");
+    reader.expect(jsonStreamReader::VALUE);
+    BOOST_CHECK_EQUAL(reader.value().get<std::string>(), "0.1.0");
+    reader.expect(jsonStreamReader::END_OBJECT);
+    reader.expect(jsonStreamReader::END_OF_STREAM);
+  }
+
+  // skip values
+  {
+    std::stringstream ss(json_str);
+    jsonStreamReader reader(ss);
+    reader.expect(jsonStreamReader::BEGIN_OBJECT);
+    reader.expect(jsonStreamReader::KEY);
+    reader.skip();
+    reader.expect(jsonStreamReader::KEY);
+    BOOST_CHECK_EQUAL(reader.key(), "version");
+  }
+
+  // errors give the line number
+  {
+    std::stringstream ss("{\n  \"a\" : 1,\n  \"b\" : [ 1 2 ]\n}");
+    jsonStreamReader reader(ss);
+    jsonParser json;
+    BOOST_CHECK_THROW(reader.read(json), std::runtime_error);
+    BOOST_CHECK_EQUAL(reader.line(), 3);
+  }
+
+}
+
+BOOST_AUTO_TEST_CASE(WriterTest) {
+
+  std::stringstream ss(json_str);
+  jsonParser expected(ss);
+
+  // writing members one at a time gives the same output as jsonParser::print
+  std::stringstream expected_ss;
+  expected.print(expected_ss);
+
+  std::stringstream result_ss;
+  jsonStreamWriter writer(result_ss);
+  writer.begin_object();
+  writer.key("supercells").begin_object();
+  writer.key("SCEL1_1_1_1_0_0_0").begin_object();
+  writer.key("0").value(expected["supercells"]["SCEL1_1_1_1_0_0_0"]["0"]);
+  writer.key("1").value(expected["supercells"]["SCEL1_1_1_1_0_0_0"]["1"]);
+  writer.end_object();
+  writer.end_object();
+  writer.key("version").value("0.1.0");
+  writer.end_object();
+  BOOST_CHECK(writer.complete());
+  BOOST_CHECK_EQUAL(result_ss.str(), expected_ss.str());
+
+  // arrays
+  std::stringstream array_ss;
+  jsonStreamWriter array_writer(array_ss);
+  array_writer.begin_array();
+  array_writer.value(expected["supercells"]["SCEL1_1_1_1_0_0_0"]["0"]["dof"]);
+  array_writer.begin_array().end_array();
+  array_writer.end_array();
+
+  jsonParser array_json;
+  array_json.put_array();
+  array_json.push_back(expected["supercells"]["SCEL1_1_1_1_0_0_0"]["0"]["dof"]);
+  array_json.push_back(jsonParser::array());
+  std::stringstream array_expected_ss;
+  array_json.print(array_expected_ss);
+  BOOST_CHECK_EQUAL(array_ss.str(), array_expected_ss.str());
+
+  // values in an object need a key
+  std::stringstream error_ss;
+  jsonStreamWriter error_writer(error_ss);
+  error_writer.begin_object();
+  BOOST_CHECK_THROW(error_writer.value(1), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
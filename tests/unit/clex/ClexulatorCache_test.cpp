@@ -0,0 +1,130 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/ClexulatorCache.hh"
+
+/// Dependencies
+#include "casm/system/RuntimeLibrary.hh"
+
+/// What is being used to test it:
+#include <cstdlib>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+using namespace CASM;
+
+namespace {
+
+  std::string test_source() {
+    return std::string("extern \"C\" int part_a();\n") +
+           "extern \"C\" int part_b();\n" +
+           "\n" +
+           Clexulator_impl::translation_unit_prefix() + "a\n" +
+           "extern \"C\" int part_a() { return 1; }\n" +
+           "\n" +
+           Clexulator_impl::translation_unit_prefix() + "b\n" +
+           "extern \"C\" int part_b() { return part_a() + 1; }\n";
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(ClexulatorCacheTest)
+
+BOOST_AUTO_TEST_CASE(SplitTest) {
+
+  auto tu = Clexulator_impl::split_translation_units(test_source(), "test.cc");
+  BOOST_REQUIRE_EQUAL(tu.size(), 2);
+  for(const auto &src : tu) {
+    BOOST_CHECK(src.find("extern \"C\" int part_b();") != std::string::npos);
+  }
+  BOOST_CHECK(tu[0].find("#line 4 \"test.cc\"") != std::string::npos);
+  BOOST_CHECK(tu[0].find("return 1;") != std::string::npos);
+  BOOST_CHECK(tu[0].find("return part_a() + 1;") == std::string::npos);
+  BOOST_CHECK(tu[1].find("return part_a() + 1;") != std::string::npos);
+
+  // no translation units marked
+  tu = Clexulator_impl::split_translation_units("int f() { return 0; }\n", "test.cc");
+  BOOST_REQUIRE_EQUAL(tu.size(), 1);
+  BOOST_CHECK_EQUAL(tu[0], "int f() { return 0; }\n");
+}
+
+BOOST_AUTO_TEST_CASE(BuildTest) {
+  namespace fs = boost::filesystem;
+
+  fs::path testdir("tests/unit/clex/ClexulatorCache_test_out");
+  fs::remove_all(testdir);
+  fs::create_directories(testdir / "src");
+  fs::ofstream(testdir / "src" / "test_cache.cc") << test_source();
+
+  setenv("CASM_CLEXULATOR_CACHE", (testdir / "cache").string().c_str(), 1);
+
+  std::string compile_options = RuntimeLibrary::default_compile_options();
+  std::string so_options = RuntimeLibrary::default_so_options();
+
+  fs::path lib_base = Clexulator_impl::build_clexulator("test_cache", testdir / "src", compile_options, so_options);
+  BOOST_CHECK(lib_base.parent_path().parent_path() == testdir / "cache");
+  BOOST_REQUIRE(fs::exists(lib_base.string() + ".so"));
+
+  RuntimeLibrary lib;
+  lib.load(lib_base.string());
+  BOOST_CHECK_EQUAL(lib.get_function<int()>("part_b")(), 2);
+
+  // same source and options: found in the cache, not rebuilt
+  std::time_t t = fs::last_write_time(lib_base.string() + ".so");
+  BOOST_CHECK(Clexulator_impl::build_clexulator("test_cache", testdir / "src", compile_options, so_options) == lib_base);
+  BOOST_CHECK_EQUAL(fs::last_write_time(lib_base.string() + ".so"), t);
+
+  // different options: a different library
+  fs::path other_base = Clexulator_impl::build_clexulator("test_cache", testdir / "src", compile_options + " -O1", so_options);
+  BOOST_CHECK(other_base != lib_base);
+  BOOST_CHECK(fs::exists(other_base.string() + ".so"));
+
+  // a compiler error is reported
+  fs::ofstream(testdir / "src" / "test_cache.cc") << test_source() << "not C++\n";
+  BOOST_CHECK_THROW(Clexulator_impl::build_clexulator("test_cache", testdir / "src", compile_options, so_options), std::runtime_error);
+
+  unsetenv("CASM_CLEXULATOR_CACHE");
+  fs::remove_all(testdir);
+}
+
+BOOST_AUTO_TEST_CASE(HeaderTest) {
+  namespace fs = boost::filesystem;
+
+  fs::path testdir("tests/unit/clex/ClexulatorCache_test_out");
+  fs::remove_all(testdir);
+  fs::create_directories(testdir / "src");
+  fs::create_directories(testdir / "include" / "casm");
+  fs::ofstream(testdir / "src" / "test_header.cc")
+      << "#include \"casm/test_header.hh\"\n"
+      << "extern \"C\" int get_value() { return test_value; }\n";
+  fs::ofstream(testdir / "include" / "casm" / "test_header.hh") << "#include \"casm/test_value.hh\"\n";
+  fs::ofstream(testdir / "include" / "casm" / "test_value.hh") << "const int test_value = 1;\n";
+
+  setenv("CASM_CLEXULATOR_CACHE", (testdir / "cache").string().c_str(), 1);
+
+  std::string compile_options = RuntimeLibrary::default_compile_options() + " -I" + (testdir / "include").string();
+  std::string so_options = RuntimeLibrary::default_so_options();
+
+  fs::path lib_base = Clexulator_impl::build_clexulator("test_header", testdir / "src", compile_options, so_options);
+  RuntimeLibrary lib;
+  lib.load(lib_base.string());
+  BOOST_CHECK_EQUAL(lib.get_function<int()>("get_value")(), 1);
+
+  // a change in a header included by an included header: rebuilt
+  fs::ofstream(testdir / "include" / "casm" / "test_value.hh") << "const int test_value = 2;\n";
+  fs::path changed_base = Clexulator_impl::build_clexulator("test_header", testdir / "src", compile_options, so_options);
+  BOOST_CHECK(changed_base != lib_base);
+  RuntimeLibrary changed_lib;
+  changed_lib.load(changed_base.string());
+  BOOST_CHECK_EQUAL(changed_lib.get_function<int()>("get_value")(), 2);
+
+  // changed back: found in the cache
+  fs::ofstream(testdir / "include" / "casm" / "test_value.hh") << "const int test_value = 1;\n";
+  BOOST_CHECK(Clexulator_impl::build_clexulator("test_header", testdir / "src", compile_options, so_options) == lib_base);
+
+  unsetenv("CASM_CLEXULATOR_CACHE");
+  fs::remove_all(testdir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,6 +7,7 @@
 /// Dependencies
 
 /// What is being used to test it:
+#include <cstdlib>
 #include <boost/filesystem.hpp>
 
 using namespace CASM;
@@ -16,6 +17,9 @@ BOOST_AUTO_TEST_SUITE(ClexulatorTest)
 BOOST_AUTO_TEST_CASE(MakeClexulatorTest) {
   namespace fs = boost::filesystem;
 
+  // build in a cache in the test directory, removed by 'scons -c Clexulator'
+  setenv("CASM_CLEXULATOR_CACHE", "tests/unit/clex/Clexulator_cache", 1);
+
   Clexulator clexulator("test_Clexulator",
                         "tests/unit/clex",
                         RuntimeLibrary::default_compile_options() + " --std=c++11 -Iinclude",
@@ -23,6 +27,7 @@ BOOST_AUTO_TEST_CASE(MakeClexulatorTest) {
 
   BOOST_CHECK_EQUAL(clexulator.corr_size(), 75);
 
+  unsetenv("CASM_CLEXULATOR_CACHE");
 }
 
 BOOST_AUTO_TEST_SUITE_END()
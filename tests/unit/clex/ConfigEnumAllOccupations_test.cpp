@@ -0,0 +1,84 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/ConfigEnumAllOccupations.hh"
+
+/// Dependencies
+#include "casm/clex/PrimClex.hh"
+#include "casm/container/Counter.hh"
+
+/// What is being used to test it:
+#include <set>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+using namespace CASM;
+
+namespace {
+
+  typedef std::set<std::vector<int> > OccSet;
+
+  /// Canonical forms of every primitive occupation of 'scel', found by canonicalizing each one
+  OccSet brute_force(const Supercell &scel) {
+    OccSet result;
+    Configuration config(const_cast<Supercell &>(scel));
+    Array<int> max_occ = scel.max_allowed_occupation();
+    Counter<Array<int> > counter(Array<int>(scel.num_sites(), 0), max_occ, Array<int>(scel.num_sites(), 1));
+    do {
+      config.set_occupation(counter());
+      PermuteIterator it_canon;
+      Configuration canon = config.canonical_form(scel.permute_begin(), scel.permute_end(), it_canon);
+      if(canon.is_primitive(scel.permute_begin())) {
+        result.insert(std::vector<int>(canon.occupation().begin(), canon.occupation().end()));
+      }
+    }
+    while(++counter);
+    return result;
+  }
+
+  /// Occupations enumerated by ConfigEnumAllOccupations, checking that none is repeated
+  OccSet enumerated(const Supercell &scel, bool orderly) {
+    OccSet result;
+    Configuration init_config(const_cast<Supercell &>(scel)), final_config(const_cast<Supercell &>(scel));
+    init_config.set_occupation(Array<int>(scel.num_sites(), 0));
+    final_config.set_occupation(scel.max_allowed_occupation());
+
+    ConfigEnumAllOccupations<Configuration> enumerator(init_config, final_config, scel.permute_begin(), scel.permute_end(), orderly);
+    Index count = 0;
+    for(auto it = enumerator.begin(); it != enumerator.end(); ++it, ++count) {
+      BOOST_CHECK(it->is_canonical(scel.permute_begin(), scel.permute_end()));
+      result.insert(std::vector<int>(it->occupation().begin(), it->occupation().end()));
+    }
+    BOOST_CHECK_EQUAL(count, result.size());
+    return result;
+  }
+
+  void check_supercells(const fs::path &prim_path, int max_volume) {
+    Structure prim(prim_path);
+    PrimClex primclex(prim);
+    primclex.generate_supercells(1, max_volume, false);
+    BOOST_REQUIRE(primclex.get_supercell_list().size() > 0);
+
+    for(const Supercell &scel : primclex.get_supercell_list()) {
+      OccSet expected = brute_force(scel);
+      BOOST_CHECK(enumerated(scel, true) == expected);
+      BOOST_CHECK(enumerated(scel, false) == expected);
+    }
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(ConfigEnumAllOccupationsTest)
+
+BOOST_AUTO_TEST_CASE(OrderlyFCCTest) {
+  // ternary FCC, primitive cell, supercells of volume 1 to 6
+  check_supercells("tests/unit/crystallography/PRIM1", 6);
+}
+
+BOOST_AUTO_TEST_CASE(OrderlyConventionalFCCTest) {
+  // ternary FCC, conventional cubic cell with 4 basis sites, supercells of volume 1 and 2
+  check_supercells("tests/unit/crystallography/PRIM2", 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,181 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/PrimClex.hh"
+
+/// Dependencies
+#include "casm/app/ProjectBuilder.hh"
+#include "casm/app/AppIO.hh"
+
+/// What is being used to test it:
+#include <sstream>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+using namespace CASM;
+
+namespace {
+
+  std::string read_file(const fs::path &path) {
+    fs::ifstream file(path);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(ConfigListTest)
+
+/// A project with a single .casm/config_list.json is split into a config_list file per
+///   supercell, keeping all data, and afterwards only modified supercells are rewritten
+BOOST_AUTO_TEST_CASE(MigrateTest) {
+
+  fs::path root("tests/unit/clex/test_ConfigList");
+  fs::remove_all(root);
+  fs::create_directories(root);
+
+  // ternary FCC
+  Structure prim(fs::path("tests/unit/crystallography/PRIM1"));
+  write_prim(prim, root / "prim.json", FRAC);
+  ProjectBuilder(root, "ConfigList", "formation_energy").build();
+  DirectoryStructure dir(root);
+
+  // enumerate, and write supercells and configurations in the single file format
+  std::stringstream log;
+  PrimClex primclex(root, log);
+  primclex.generate_supercells(1, 3, false);
+  std::vector<Index> scel_indices(primclex.get_supercell_list().size());
+  for(Index i = 0; i < scel_indices.size(); i++) {
+    scel_indices[i] = i;
+  }
+  primclex.enumerate_occupation_configurations(scel_indices);
+  BOOST_REQUIRE(primclex.get_supercell_list().size() > 2);
+
+  fs::create_directories(root / "training_data");
+  fs::ofstream scelfile(root / "training_data" / "SCEL");
+  primclex.print_supercells(scelfile);
+  scelfile.close();
+
+  jsonParser legacy;
+  for(Index i = 0; i < primclex.get_supercell_list().size(); i++) {
+    primclex.get_supercell(i).write_config_list(legacy);
+  }
+  // data Configuration does not read must be kept too
+  for(auto scel_it = legacy["supercells"].begin(); scel_it != legacy["supercells"].end(); ++scel_it) {
+    for(auto config_it = scel_it->begin(); config_it != scel_it->end(); ++config_it) {
+      (*config_it)["extra"] = scel_it.name() + "/" + config_it.name();
+    }
+  }
+  legacy.write(dir.config_list());
+  BOOST_REQUIRE(!fs::exists(dir.config_list_dir()));
+
+  // migrate, modifying one supercell
+  {
+    PrimClex migrated(root, log);
+    Supercell &scel = migrated.get_supercell(1);
+    BOOST_CHECK(!scel.config_list_dirty());
+    scel.get_config(0).set_selected(true);
+    BOOST_CHECK(scel.config_list_dirty());
+    migrated.write_config_list();
+    BOOST_CHECK(!scel.config_list_dirty());
+  }
+  BOOST_CHECK(!fs::exists(dir.config_list()));
+  BOOST_CHECK(fs::is_regular_file(dir.config_list().string() + ".bak"));
+
+  for(auto scel_it = legacy["supercells"].begin(); scel_it != legacy["supercells"].end(); ++scel_it) {
+    fs::path path = dir.config_list(scel_it.name());
+    BOOST_REQUIRE(fs::is_regular_file(path));
+    jsonParser shard(path);
+    BOOST_REQUIRE_EQUAL(shard["supercells"][scel_it.name()].size(), scel_it->size());
+    for(auto config_it = scel_it->begin(); config_it != scel_it->end(); ++config_it) {
+      const jsonParser &json_config = shard["supercells"][scel_it.name()][config_it.name()];
+      BOOST_CHECK(json_config["extra"] == (*config_it)["extra"]);
+      BOOST_CHECK(json_config["source"] == (*config_it)["source"]);
+      BOOST_CHECK(json_config["dof"] == (*config_it)["dof"]);
+    }
+  }
+
+  // read back
+  {
+    PrimClex read(root, log);
+    BOOST_REQUIRE_EQUAL(read.get_supercell_list().size(), primclex.get_supercell_list().size());
+    for(Index i = 0; i < primclex.get_supercell_list().size(); i++) {
+      const Supercell &expected = primclex.get_supercell(i);
+      const Supercell &scel = static_cast<const PrimClex &>(read).get_supercell(i);
+      BOOST_CHECK_EQUAL(scel.get_name(), expected.get_name());
+      BOOST_REQUIRE_EQUAL(scel.get_config_list().size(), expected.get_config_list().size());
+      for(Index j = 0; j < expected.get_config_list().size(); j++) {
+        BOOST_CHECK(scel.get_config(j).occupation() == expected.get_config(j).occupation());
+        BOOST_CHECK(scel.get_config(j).source() == expected.get_config(j).source());
+        BOOST_CHECK_EQUAL(scel.get_config(j).selected(), i == 1 && j == 0);
+      }
+      BOOST_CHECK(!scel.config_list_dirty());
+    }
+  }
+
+  // supercells that are only read are not rewritten
+  {
+    PrimClex read(root, log);
+    const PrimClex &const_read = read;
+    const Supercell &untouched = const_read.get_supercell(0);
+    BOOST_CHECK(untouched.get_config_list().size() > 0);
+    BOOST_CHECK(untouched.config_list_loaded());
+    BOOST_CHECK(!untouched.config_list_dirty());
+
+    // a change to the file that would be lost if it were rewritten
+    std::string marked = read_file(dir.config_list(untouched.get_name())) + "\n\n";
+    fs::ofstream(dir.config_list(untouched.get_name())) << marked;
+
+    read.get_supercell(2).get_config(0).set_selected(true);
+    read.write_config_list();
+
+    BOOST_CHECK_EQUAL(read_file(dir.config_list(untouched.get_name())), marked);
+    jsonParser shard(dir.config_list(read.get_supercell(2).get_name()));
+    BOOST_CHECK(shard["supercells"][read.get_supercell(2).get_name()]["0"]["selected"].get<bool>());
+  }
+
+  // configurations are counted from the summary, without reading config lists, unless a
+  //   config list was changed after the summary was written
+  fs::path changed = dir.config_list(primclex.get_supercell(0).get_name());
+  fs::last_write_time(changed, fs::last_write_time(changed) - 10);
+  {
+    PrimClex read(root, log);
+    const PrimClex &const_read = read;
+    for(Index i = 0; i < primclex.get_supercell_list().size(); i++) {
+      const Supercell &scel = const_read.get_supercell(i);
+      Index generated, selected, calculated;
+      scel.count_configs(generated, selected, calculated);
+      BOOST_CHECK_EQUAL(scel.config_list_loaded(), i == 0);
+      BOOST_CHECK_EQUAL(generated, primclex.get_supercell(i).get_config_list().size());
+      BOOST_CHECK_EQUAL(selected, (i == 1 || i == 2) ? 1 : 0);
+      BOOST_CHECK_EQUAL(calculated, 0);
+    }
+  }
+
+  // a config list that fails to read part way is not kept in part, so that it is not written
+  //   over the file
+  fs::path broken = dir.config_list(primclex.get_supercell(2).get_name());
+  std::string contents = read_file(broken);
+  BOOST_REQUIRE(contents.find("\"1\"") != std::string::npos);
+  contents = contents.substr(0, contents.find("\"1\"") + 10);
+  fs::ofstream(broken) << contents;
+  {
+    PrimClex read(root, log);
+    Supercell &scel = read.get_supercell(2);
+    const Supercell &const_scel = scel;
+    BOOST_CHECK_THROW(const_scel.get_config_list(), std::runtime_error);
+    BOOST_CHECK(!scel.config_list_loaded());
+
+    Configuration config(primclex.get_supercell(2).get_config(0));
+    BOOST_CHECK_THROW(scel.add_config(config), std::runtime_error);
+    BOOST_CHECK(!scel.config_list_loaded());
+    read.write_config_list();
+  }
+  BOOST_CHECK_EQUAL(read_file(broken), contents);
+
+  fs::remove_all(root);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,221 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/ConfigMapping.hh"
+
+/// Dependencies
+#include "casm/clex/PrimClex.hh"
+#include "casm/crystallography/LatticeMap.hh"
+#include "casm/crystallography/SupercellEnumerator.hh"
+#include "casm/strain/StrainConverter.hh"
+
+/// What is being used to test it:
+#include <cmath>
+#include <boost/filesystem.hpp>
+
+using namespace CASM;
+
+namespace {
+
+  /// The search deformed_struc_to_configdof used before the best-first search, which checks the
+  ///   nearest supercell lattice of each volume, and then every supercell of each volume
+  ///
+  /// Returns the total cost of the best mapping, or 1e20 if there is none
+  double volume_loop_mapping(const BasicStructure<Site> &struc,
+                             PrimClex &pclex,
+                             bool rotate_flag,
+                             double _tol,
+                             double lattice_weight,
+                             double vol_tol,
+                             ConfigDoF &mapped_configdof,
+                             Lattice &mapped_lat) {
+    double lw = max(min(lattice_weight, 1.0), 1e-9);
+    double bw = 1.0 - lw;
+    _tol = max(_tol, 1e-12);
+    vol_tol = max(_tol, vol_tol);
+
+    double num_atoms = double(struc.basis.size());
+    int min_vol(ceil((num_atoms / double(pclex.get_prim().basis.size())) - _tol));
+    double max_va_fraction = min(0.75, double(pclex.get_prim().max_possible_vacancies()) / double(pclex.get_prim().basis.size()));
+    int max_vol = ceil(num_atoms / (double(pclex.get_prim().basis.size()) * (1.0 - max_va_fraction)) - _tol);
+    if(max_va_fraction > TOL) {
+      int Nvol = CASM::round(std::abs(struc.lattice().vol() / pclex.get_prim().lattice().vol()));
+      int new_min_vol = min(max_vol, max(CASM::round((1.0 - vol_tol) * double(Nvol)), min_vol));
+      int new_max_vol = max(min_vol, min(CASM::round((1.0 + vol_tol) * double(Nvol)), max_vol));
+      max_vol = new_max_vol;
+      min_vol = new_min_vol;
+    }
+
+    Eigen::MatrixXd ttrans_mat, tF;
+    double strain_cost, basis_cost, tot_cost, best_cost(1e20), result(1e20);
+    ConfigDoF tdof;
+    BasicStructure<Site> tstruc(struc);
+    Lattice tlat;
+
+    // map the structure's lattice, deformed by 'F', onto 'tlat', and keep it if it is the best so far
+    auto score = [&](const Eigen::MatrixXd & F, const Supercell & scel) {
+      tstruc = struc;
+      tstruc.set_lattice(Lattice(F * Eigen::MatrixXd(tlat.lat_column_mat())), CART);
+      if(rotate_flag) {
+        tstruc.set_lattice(Lattice(StrainConverter::right_stretch_tensor(F) * Eigen::MatrixXd(tlat.lat_column_mat())), FRAC);
+      }
+      if(!struc_to_configdof(scel, tstruc, tdof, true, _tol))
+        return false;
+      basis_cost = bw * ConfigMapping::basis_cost(tdof);
+      tot_cost = strain_cost + basis_cost;
+      if(tot_cost < best_cost) {
+        best_cost = tot_cost - _tol;
+        result = tot_cost;
+        mapped_configdof = tdof;
+        mapped_lat = tlat;
+      }
+      return true;
+    };
+
+    for(Index i_vol = min_vol; i_vol <= max_vol; i_vol++) {
+      tlat = find_nearest_super_lattice(pclex.get_prim().lattice(), struc.lattice(), pclex.get_prim().point_group(), tF, ttrans_mat, i_vol, i_vol, _tol);
+      strain_cost = lw * LatticeMap::calc_strain_cost(tF, struc.lattice().vol() / num_atoms);
+      if(best_cost < strain_cost)
+        continue;
+      score(tF, Supercell(&pclex, tlat));
+    }
+
+    for(Index i_vol = min_vol; i_vol <= max_vol; i_vol++) {
+      SupercellEnumerator<Lattice> enumerator(pclex.get_prim().lattice(), pclex.get_prim().point_group(), i_vol, i_vol + 1);
+      bool break_early(false);
+      for(auto it = enumerator.begin(); it != enumerator.end() && !break_early; ++it) {
+        tlat = niggli(*it, pclex.get_prim().point_group(), _tol);
+        Supercell scel(&pclex, tlat);
+
+        tF = struc.lattice().lat_column_mat() * tlat.inv_lat_column_mat();
+        strain_cost = lw * LatticeMap::calc_strain_cost(tF, struc.lattice().vol() / num_atoms);
+        if(strain_cost < best_cost && !score(tF, scel))
+          break;
+
+        LatticeMap strainmap(tlat, struc.lattice(), CASM::round(num_atoms), _tol, 1);
+        strain_cost = lw * strainmap.strain_cost();
+        if(best_cost < strain_cost)
+          strain_cost = lw * strainmap.next_mapping_better_than(best_cost).strain_cost();
+        while(strain_cost < best_cost) {
+          if(!score(strainmap.matrixF(), scel)) {
+            break_early = true;
+            break;
+          }
+          strain_cost = lw * strainmap.next_mapping_better_than(best_cost).strain_cost();
+        }
+      }
+    }
+    return result;
+  }
+
+  /// Configuration 'occ' of the supercell 'transf_mat' of 'primclex', strained by 'F' and with
+  ///   pseudo-random displacements of up to 'max_disp' in each direction
+  BasicStructure<Site> make_strained(PrimClex &primclex,
+                                     const Matrix3<int> &transf_mat,
+                                     const Array<int> &occ,
+                                     const Eigen::Matrix3d &F,
+                                     double max_disp) {
+    Supercell &scel = primclex.get_supercell(primclex.add_supercell(Lattice(primclex.get_prim().lattice().lat_column_mat() * transf_mat)));
+    Configuration config(scel, jsonParser(), ConfigDoF(occ));
+    BasicStructure<Site> struc(scel.superstructure(config));
+
+    struc.set_lattice(Lattice(F * Eigen::Matrix3d(struc.lattice().lat_column_mat())), FRAC);
+    for(Index i = 0; i < struc.basis.size(); i++) {
+      Vector3<double> disp;
+      for(int j = 0; j < 3; j++) {
+        disp[j] = max_disp * std::sin(1.0 + 3.0 * i + 7.0 * j);
+      }
+      struc.basis[i](CART) += disp;
+    }
+    return struc;
+  }
+
+  /// Check the best-first search against the volume loop, and its 'k_best' mappings
+  void check_mapping(const BasicStructure<Site> &struc, PrimClex &primclex, double lattice_weight) {
+    double tol = TOL;
+    double vol_tol = 0.25;
+
+    ConfigDoF expected_dof;
+    Lattice expected_lat;
+    double expected_cost = volume_loop_mapping(struc, primclex, true, tol, lattice_weight, vol_tol, expected_dof, expected_lat);
+    BOOST_REQUIRE(expected_cost < 1e10);
+
+    std::vector<ConfigDoFMapping> best = deformed_struc_to_configdofs(struc, primclex, true, tol, lattice_weight, vol_tol, 1);
+    BOOST_REQUIRE_EQUAL(best.size(), 1);
+    BOOST_CHECK_SMALL(best[0].cost - expected_cost, 1e-8);
+    BOOST_CHECK(best[0].mapped_lat.is_equivalent(expected_lat));
+
+    // equal cost mappings onto the same supercell may differ by symmetry
+    Supercell scel(&primclex, expected_lat);
+    BOOST_CHECK(best[0].configdof.canonical_form(scel.permute_begin(), scel.permute_end(), tol).occupation() ==
+                expected_dof.canonical_form(scel.permute_begin(), scel.permute_end(), tol).occupation());
+
+    // the k best, starting with the best
+    std::vector<ConfigDoFMapping> k_best = deformed_struc_to_configdofs(struc, primclex, true, tol, lattice_weight, vol_tol, 5);
+    BOOST_REQUIRE(k_best.size() > 1);
+    BOOST_CHECK(k_best.size() <= 5);
+    BOOST_CHECK_SMALL(k_best[0].cost - best[0].cost, 1e-8);
+    for(Index i = 0; i < k_best.size(); i++) {
+      BOOST_CHECK_SMALL(k_best[i].strain_cost + k_best[i].basis_cost - k_best[i].cost, 1e-12);
+      if(i > 0) {
+        BOOST_CHECK(k_best[i - 1].cost <= k_best[i].cost);
+      }
+    }
+
+    // as reported by map_structure_occupation
+    StructureMapping mapping = map_structure_occupation(struc, primclex, true, true, tol, lattice_weight, vol_tol, 3);
+    BOOST_REQUIRE(mapping.success);
+    BOOST_CHECK(mapping.configdof.occupation() == k_best[0].configdof.occupation());
+    BOOST_REQUIRE_EQUAL(mapping.alternatives.size(), 2);
+    for(Index i = 0; i < mapping.alternatives.size(); i++) {
+      BOOST_CHECK_SMALL(mapping.alternatives[i].cost - k_best[i + 1].cost, 1e-8);
+    }
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(ConfigMappingTest)
+
+BOOST_AUTO_TEST_CASE(DeformedMappingTest) {
+
+  // ternary FCC
+  Structure prim(fs::path("tests/unit/crystallography/PRIM1"));
+  PrimClex primclex(prim);
+
+  Eigen::Matrix3d F;
+  F << 1.02, 0.03, 0.0,
+  0.03, 0.97, 0.01,
+  0.0, 0.01, 1.04;
+
+  // a volume 4 supercell
+  Matrix3<int> T(0);
+  T(0, 0) = 2;
+  T(1, 1) = 2;
+  T(2, 2) = 1;
+  Array<int> occ;
+  occ.push_back(0);
+  occ.push_back(1);
+  occ.push_back(2);
+  occ.push_back(1);
+  BasicStructure<Site> struc4 = make_strained(primclex, T, occ, F, 0.05);
+  check_mapping(struc4, primclex, 0.5);
+  check_mapping(struc4, primclex, 0.2);
+
+  // a non-diagonal volume 6 supercell, more strongly strained
+  T(0, 1) = 1;
+  T(2, 2) = 1;
+  T(1, 2) = 1;
+  T(2, 1) = -1;
+  BOOST_REQUIRE_EQUAL(std::lround(std::abs(T.determinant())), 6);
+  occ.push_back(0);
+  occ.push_back(2);
+  Eigen::Matrix3d G;
+  G << 1.0, 0.08, 0.0,
+  0.0, 1.0, 0.0,
+  0.0, 0.0, 0.98;
+  BasicStructure<Site> struc6 = make_strained(primclex, T, occ, G * F, 0.08);
+  check_mapping(struc6, primclex, 0.5);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
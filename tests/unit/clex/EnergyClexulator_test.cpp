@@ -0,0 +1,137 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/Clexulator.hh"
+
+/// Dependencies
+#include "casm/clex/PrimClex.hh"
+#include "casm/clex/ECIContainer.hh"
+#include "casm/clex/TableClexulator.hh"
+
+/// What is being used to test it:
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+using namespace CASM;
+
+namespace {
+
+  /// Generate an energy clexulator for 'prim' with sparse ECI, and check calc_energy and
+  ///   calc_delta_energy against eci*correlations from a TableClexulator for the same basis set
+  void check_energy(const fs::path &prim_path, const jsonParser &bspecs_json, std::string name) {
+
+    fs::path testdir("tests/unit/clex/EnergyClexulator_test_out");
+    fs::create_directories(testdir);
+
+    // chebychev site basis functions
+    Structure prim(prim_path);
+    prim.fill_occupant_bases('c');
+
+    // print_energy_clexulator and TableClexulator both change neighbor list indices, so use separate trees
+    SiteOrbitree table_tree = make_orbitree(prim, bspecs_json);
+    table_tree.collect_basis_info(prim);
+    table_tree.generate_clust_bases();
+    Array<UnitCellCoord> nlist;
+    expand_nlist(prim, table_tree, nlist);
+    Clexulator table(name, std::unique_ptr<Clexulator_impl::Base>(new TableClexulator(prim, table_tree, nlist)));
+
+    // ECI for every third basis function, including one that is zero
+    fs::ofstream ecifile(testdir / (name + "_eci.out"));
+    for(int i = 0; i < 7; i++) {
+      ecifile << "# header\n";
+    }
+    for(Index i = 0; i < table.corr_size(); i += 3) {
+      double eci = (i == 3) ? 0.0 : 0.1 * std::cos(1.0 + i);
+      ecifile << std::setprecision(17) << eci << " " << eci << " " << i << "\n";
+    }
+    ecifile.close();
+    ECIContainer eci(testdir / (name + "_eci.out"));
+
+    SiteOrbitree energy_tree = make_orbitree(prim, bspecs_json);
+    energy_tree.collect_basis_info(prim);
+    energy_tree.generate_clust_bases();
+    Array<UnitCellCoord> energy_nlist;
+    expand_nlist(prim, energy_tree, energy_nlist);
+    BOOST_REQUIRE(energy_nlist == nlist);
+
+    fs::ofstream outfile(testdir / (name + ".cc"));
+    print_energy_clexulator(prim, energy_tree, energy_nlist, eci, name, outfile);
+    outfile.close();
+
+    EnergyClexulator energy(name,
+                            testdir,
+                            RuntimeLibrary::default_compile_options() + " --std=c++11 -Iinclude",
+                            RuntimeLibrary::default_so_options() + " -lboost_filesystem -lboost_system");
+    BOOST_REQUIRE_EQUAL(energy.nlist_size(), table.nlist_size());
+
+    // the neighborhood is the neighbor list itself, with pseudo-random occupants
+    std::vector<Clexulator::nlist_index_type> config_nlist(nlist.size());
+    std::vector<int> occ(nlist.size());
+    for(Index i = 0; i < nlist.size(); i++) {
+      config_nlist[i] = i;
+    }
+
+    std::vector<double> corr(table.corr_size());
+    for(int trial = 0; trial < 10; trial++) {
+      for(Index i = 0; i < nlist.size(); i++) {
+        occ[i] = (5 * trial + 3 * i + i * i) % prim.basis[nlist[i][0]].site_occupant().size();
+      }
+      table.set_config_occ(occ.data());
+      table.set_nlist(config_nlist.data());
+      energy.set_config_occ(occ.data());
+      energy.set_nlist(config_nlist.data());
+
+      table.calc_global_corr_contribution(corr.data());
+      BOOST_CHECK_SMALL(energy.calc_energy() - eci * corr.data(), 1e-12);
+
+      // the site of basis site 'b' in the origin unit cell is the neighbor list entry 'b'
+      for(int b = 0; b < prim.basis.size(); b++) {
+        int occ_b = occ[b];
+        for(int occ_i = 0; occ_i < prim.basis[b].site_occupant().size(); occ_i++) {
+          occ[b] = occ_i;
+          for(int occ_f = 0; occ_f < prim.basis[b].site_occupant().size(); occ_f++) {
+            table.calc_delta_point_corr(b, occ_i, occ_f, corr.data());
+            BOOST_CHECK_SMALL(energy.calc_delta_energy(b, occ_i, occ_f) - eci * corr.data(), 1e-12);
+          }
+        }
+        occ[b] = occ_b;
+      }
+    }
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(EnergyClexulatorTest)
+
+BOOST_AUTO_TEST_CASE(CompareToCorrelationsTest) {
+  namespace fs = boost::filesystem;
+
+  fs::path testdir("tests/unit/clex/EnergyClexulator_test_out");
+  fs::remove_all(testdir);
+
+  // build in a cache in the test directory
+  setenv("CASM_CLEXULATOR_CACHE", (testdir / "cache").string().c_str(), 1);
+
+  // ternary FCC
+  jsonParser fcc_bspecs;
+  fcc_bspecs["orbit_branch_specs"]["2"]["max_length"] = 4.01;
+  fcc_bspecs["orbit_branch_specs"]["3"]["max_length"] = 3.01;
+  fcc_bspecs["orbit_branch_specs"]["4"]["max_length"] = 3.01;
+  check_energy("tests/unit/crystallography/PRIM1", fcc_bspecs, "test_FCC_Energy_Clexulator");
+
+  // ternary FCC, conventional cubic cell with 4 basis sites
+  jsonParser conventional_bspecs;
+  conventional_bspecs["orbit_branch_specs"]["2"]["max_length"] = 4.01;
+  conventional_bspecs["orbit_branch_specs"]["3"]["max_length"] = 3.01;
+  check_energy("tests/unit/crystallography/PRIM2", conventional_bspecs, "test_Conventional_Energy_Clexulator");
+
+  unsetenv("CASM_CLEXULATOR_CACHE");
+  fs::remove_all(testdir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,70 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/PrimClex.hh"
+
+/// Dependencies
+#include "casm/clex/Configuration.hh"
+#include "casm/clex/Supercell.hh"
+
+/// What is being used to test it:
+#include <numeric>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+using namespace CASM;
+
+namespace {
+
+  /// Enumerate supercells of volume 1 to 'max_volume', then all of their configurations,
+  ///   using 'num_threads' threads for both
+  void enumerate(PrimClex &primclex, int max_volume, long num_threads, bool orderly) {
+    primclex.generate_supercells(1, max_volume, false, num_threads);
+    primclex.set_num_threads(num_threads);
+    std::vector<Index> scel_indices(primclex.get_supercell_list().size());
+    std::iota(scel_indices.begin(), scel_indices.end(), 0);
+    primclex.enumerate_occupation_configurations(scel_indices, orderly);
+  }
+
+  void check_same(const PrimClex &serial, const PrimClex &parallel) {
+    BOOST_REQUIRE_EQUAL(serial.get_supercell_list().size(), parallel.get_supercell_list().size());
+    for(Index i = 0; i < serial.get_supercell_list().size(); i++) {
+      const Supercell &scel = serial.get_supercell(i);
+      const Supercell &pscel = parallel.get_supercell(i);
+      BOOST_CHECK_EQUAL(scel.get_name(), pscel.get_name());
+      BOOST_REQUIRE_EQUAL(scel.get_config_list().size(), pscel.get_config_list().size());
+      for(Index j = 0; j < scel.get_config_list().size(); j++) {
+        const Configuration &config = scel.get_config(j);
+        const Configuration &pconfig = pscel.get_config(j);
+        BOOST_CHECK_EQUAL(config.name(), pconfig.name());
+        BOOST_CHECK(config.occupation() == pconfig.occupation());
+        BOOST_CHECK(config.source() == pconfig.source());
+      }
+    }
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(ParallelEnumerationTest)
+
+BOOST_AUTO_TEST_CASE(SameAsSerialTest) {
+  namespace fs = boost::filesystem;
+
+  // ternary FCC
+  Structure prim(fs::path("tests/unit/crystallography/PRIM1"));
+
+  for(bool orderly : {false, true}) {
+    PrimClex serial(prim);
+    enumerate(serial, 5, 1, orderly);
+    BOOST_REQUIRE(serial.get_supercell_list().size() > 1);
+
+    for(long num_threads : {2, 4}) {
+      PrimClex parallel(prim);
+      enumerate(parallel, 5, num_threads, orderly);
+      check_same(serial, parallel);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,135 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/ConfigMapping.hh"
+
+/// Dependencies
+#include "casm/clex/PrimClex.hh"
+
+/// What is being used to test it:
+#include <cmath>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+using namespace CASM;
+
+namespace {
+
+  /// Configuration 'occ' of the supercell 'transf_mat' of 'primclex', strained by 'F' and with
+  ///   pseudo-random displacements of up to 'max_disp' in each direction
+  BasicStructure<Site> make_strained(PrimClex &primclex,
+                                     const Matrix3<int> &transf_mat,
+                                     const std::vector<int> &occ,
+                                     const Eigen::Matrix3d &F,
+                                     double max_disp,
+                                     int seed) {
+    Supercell &scel = primclex.get_supercell(primclex.add_supercell(Lattice(primclex.get_prim().lattice().lat_column_mat() * transf_mat)));
+    Array<int> occ_array;
+    for(int o : occ) {
+      occ_array.push_back(o);
+    }
+    Configuration config(scel, jsonParser(), ConfigDoF(occ_array));
+    BasicStructure<Site> struc(scel.superstructure(config));
+
+    struc.set_lattice(Lattice(F * Eigen::Matrix3d(struc.lattice().lat_column_mat())), FRAC);
+    for(Index i = 0; i < struc.basis.size(); i++) {
+      Vector3<double> disp;
+      for(int j = 0; j < 3; j++) {
+        disp[j] = max_disp * std::sin(seed + 3.0 * i + 7.0 * j);
+      }
+      struc.basis[i](CART) += disp;
+    }
+    return struc;
+  }
+
+  /// Map 'strucs' with 'num_threads' threads, then add them to 'primclex' in order
+  std::vector<StructureMapping> map_and_insert(const std::vector<BasicStructure<Site> > &strucs,
+                                               PrimClex &primclex,
+                                               long num_threads,
+                                               std::vector<std::string> &names) {
+    std::vector<StructureMapping> mappings = map_structures_occupation(strucs, primclex, true, true, TOL, 0.5, 0.25, num_threads);
+    names.clear();
+    for(const auto &mapping : mappings) {
+      std::string name;
+      if(mapping.success) {
+        insert_structure_occupation(mapping, nullptr, primclex, name, false, TOL);
+      }
+      names.push_back(name);
+    }
+    return mappings;
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(ParallelMappingTest)
+
+BOOST_AUTO_TEST_CASE(SameAsSerialTest) {
+
+  // ternary FCC
+  Structure prim(fs::path("tests/unit/crystallography/PRIM1"));
+
+  // strained and displaced structures on several supercells, including some that map onto the
+  //   same configuration
+  std::vector<BasicStructure<Site> > strucs;
+  {
+    PrimClex primclex(prim);
+    Eigen::Matrix3d F;
+    F << 1.02, 0.03, 0.0,
+    0.03, 0.97, 0.01,
+    0.0, 0.01, 1.04;
+
+    Matrix3<int> T(0);
+    T(0, 0) = 2;
+    T(1, 1) = 2;
+    T(2, 2) = 1;
+    for(int seed = 0; seed < 3; seed++) {
+      strucs.push_back(make_strained(primclex, T, {0, 1, 2, 1}, F, 0.05, seed));
+      strucs.push_back(make_strained(primclex, T, {0, 0, 2, 1}, F, 0.05, seed));
+    }
+
+    T(0, 1) = 1;
+    T(1, 2) = 1;
+    T(2, 1) = -1;
+    strucs.push_back(make_strained(primclex, T, {0, 1, 2, 1, 0, 2}, F, 0.08, 1));
+    strucs.push_back(make_strained(primclex, T, {1, 1, 1, 1, 1, 2}, F, 0.03, 2));
+
+    T = Matrix3<int>(0);
+    T(0, 0) = 1;
+    T(1, 1) = 1;
+    T(2, 2) = 3;
+    strucs.push_back(make_strained(primclex, T, {2, 0, 1}, F, 0.04, 3));
+  }
+
+  PrimClex serial(prim);
+  std::vector<std::string> serial_names;
+  std::vector<StructureMapping> serial_mappings = map_and_insert(strucs, serial, 1, serial_names);
+
+  for(long num_threads : {2, 4}) {
+    PrimClex parallel(prim);
+    std::vector<std::string> parallel_names;
+    std::vector<StructureMapping> parallel_mappings = map_and_insert(strucs, parallel, num_threads, parallel_names);
+
+    BOOST_REQUIRE_EQUAL(parallel_mappings.size(), serial_mappings.size());
+    for(Index i = 0; i < serial_mappings.size(); i++) {
+      const StructureMapping &mapping = serial_mappings[i];
+      const StructureMapping &pmapping = parallel_mappings[i];
+      BOOST_CHECK_EQUAL(mapping.success, pmapping.success);
+      BOOST_CHECK_EQUAL(mapping.error, pmapping.error);
+      BOOST_CHECK_EQUAL(serial_names[i], parallel_names[i]);
+      BOOST_CHECK(mapping.relaxation_properties == pmapping.relaxation_properties);
+      BOOST_CHECK(mapping.configdof.occupation() == pmapping.configdof.occupation());
+      BOOST_CHECK(mapping.configdof.displacement() == pmapping.configdof.displacement());
+      BOOST_CHECK(mapping.configdof.deformation() == pmapping.configdof.deformation());
+      BOOST_CHECK(mapping.mapped_lat.lat_column_mat() == pmapping.mapped_lat.lat_column_mat());
+    }
+  }
+
+  // the structures are mapped, and some onto the same configuration
+  for(const auto &mapping : serial_mappings) {
+    BOOST_CHECK(mapping.success);
+  }
+  BOOST_CHECK_EQUAL(serial_names[0], serial_names[2]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,85 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/SuperNeighborList.hh"
+
+/// Dependencies
+#include "casm/container/Array.hh"
+#include "casm/crystallography/Lattice.hh"
+#include "casm/crystallography/PrimGrid.hh"
+#include "casm/crystallography/UnitCellCoord.hh"
+
+/// What is being used to test it:
+#include <vector>
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(SuperNeighborListTest)
+
+BOOST_AUTO_TEST_CASE(CompareToPrimGridTest) {
+
+  Eigen::Matrix3d L;
+  L << 0.0, 2.0, 2.0,
+  2.0, 0.0, 2.0,
+  2.0, 2.0, 0.0;
+  Lattice fcc(L);
+
+  // a non-diagonal supercell, volume 13
+  Eigen::Matrix3i T;
+  T << 2, 1, 0,
+  0, 3, 1,
+  1, 0, 2;
+  Lattice scel(Eigen::Matrix3d(L * T.cast<double>()));
+
+  Index basis_size = 2;
+  PrimGrid prim_grid(fcc, scel, basis_size);
+  BOOST_REQUIRE_EQUAL(prim_grid.size(), 13);
+
+  // the unit cell sites first, as in PrimClex
+  Array<UnitCellCoord> prim_nlist;
+  for(Index b = 0; b < basis_size; b++) {
+    prim_nlist.push_back(UnitCellCoord(b, 0, 0, 0));
+  }
+  for(int i = -2; i <= 2; i++) {
+    for(int j = -2; j <= 2; j++) {
+      for(int k = -2; k <= 2; k++) {
+        prim_nlist.push_back(UnitCellCoord((i + j + k + 6) % basis_size, i, j, k));
+      }
+    }
+  }
+
+  SuperNeighborList tabulated(prim_grid, prim_nlist);
+  SuperNeighborList calculated(prim_grid, prim_nlist, 0);
+  BOOST_CHECK(tabulated.tabulated());
+  BOOST_CHECK(!calculated.tabulated());
+  BOOST_REQUIRE_EQUAL(tabulated.nlist_size(), prim_nlist.size());
+
+  std::vector<SuperNeighborList::value_type> buffer(prim_nlist.size());
+  for(Index v = 0; v < prim_grid.size(); v++) {
+    const SuperNeighborList::value_type *tab = tabulated.sites(v, nullptr);
+    const SuperNeighborList::value_type *calc = calculated.sites(v, buffer.data());
+    BOOST_CHECK(calc == buffer.data());
+
+    for(Index n = 0; n < prim_nlist.size(); n++) {
+      Index expected = prim_nlist[n][0] * prim_grid.size() + prim_grid.find(prim_grid.uccoord(v) + prim_nlist[n]);
+      BOOST_CHECK_EQUAL(tab[n], expected);
+      BOOST_CHECK_EQUAL(calc[n], expected);
+      BOOST_CHECK_EQUAL(tabulated.site(v, n), expected);
+      BOOST_CHECK_EQUAL(calculated.site(v, n), expected);
+    }
+  }
+
+  // a neighborhood of 5x5x5 unit cells does not fit in 13 unit cells
+  BOOST_CHECK(tabulated.overlaps(basis_size));
+  BOOST_CHECK(calculated.overlaps(basis_size));
+
+  Array<UnitCellCoord> unit_cell_nlist;
+  for(Index b = 0; b < basis_size; b++) {
+    unit_cell_nlist.push_back(UnitCellCoord(b, 0, 0, 0));
+  }
+  unit_cell_nlist.push_back(UnitCellCoord(0, 1, 0, 0));
+  BOOST_CHECK(!SuperNeighborList(prim_grid, unit_cell_nlist).overlaps(basis_size));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
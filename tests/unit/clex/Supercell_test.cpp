@@ -0,0 +1,90 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/Supercell.hh"
+
+/// Dependencies
+#include "casm/clex/PrimClex.hh"
+#include "casm/clex/Configuration.hh"
+
+/// What is being used to test it:
+#include <boost/filesystem.hpp>
+
+using namespace CASM;
+
+namespace {
+
+  /// An occupation of 'scel' that is not the occupation of any of its configurations
+  Array<int> unused_occupation(const Supercell &scel) {
+    Array<int> occ(scel.num_sites(), 0);
+    while(true) {
+      bool used = false;
+      for(Index i = 0; i < scel.get_config_list().size(); i++) {
+        if(scel.get_config(i).occupation() == occ) {
+          used = true;
+          break;
+        }
+      }
+      if(!used) {
+        return occ;
+      }
+
+      // next occupation, counting in base 3
+      Index l = 0;
+      while(occ[l] == 2) {
+        occ[l++] = 0;
+      }
+      occ[l]++;
+    }
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(SupercellTest)
+
+/// Configurations are found by the config index, also after they are modified through non-const
+///   access
+BOOST_AUTO_TEST_CASE(ConfigIndexTest) {
+
+  // ternary FCC
+  Structure prim(fs::path("tests/unit/crystallography/PRIM1"));
+  PrimClex primclex(prim);
+
+  Matrix3<int> T(0);
+  T(0, 0) = 2;
+  T(1, 1) = 1;
+  T(2, 2) = 1;
+  Supercell &scel = primclex.get_supercell(primclex.add_supercell(Lattice(prim.lattice().lat_column_mat() * T)));
+  const Supercell &const_scel = scel;
+  scel.enumerate_all_occupation_configurations();
+  Index N = const_scel.get_config_list().size();
+  BOOST_REQUIRE(N > 2);
+
+  Index index;
+  for(Index i = 0; i < N; i++) {
+    BOOST_CHECK(const_scel.contains_config(const_scel.get_config(i), index));
+    BOOST_CHECK_EQUAL(index, i);
+  }
+
+  // modify a configuration through get_config
+  Configuration orig0(const_scel.get_config(0));
+  Configuration changed(scel, jsonParser(), ConfigDoF(unused_occupation(const_scel)));
+  scel.get_config(0).set_occupation(changed.occupation());
+
+  BOOST_CHECK(const_scel.contains_config(changed, index));
+  BOOST_CHECK_EQUAL(index, 0);
+  BOOST_CHECK(!const_scel.contains_config(orig0, index));
+  BOOST_CHECK(!scel.add_config(changed));
+  BOOST_CHECK_EQUAL(const_scel.get_config_list().size(), N);
+
+  // modify a configuration through get_config_list
+  scel.get_config_list()[1].set_occupation(orig0.occupation());
+
+  BOOST_CHECK(const_scel.contains_config(orig0, index));
+  BOOST_CHECK_EQUAL(index, 1);
+  BOOST_CHECK(!scel.add_config(orig0));
+  BOOST_CHECK_EQUAL(const_scel.get_config_list().size(), N);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,121 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/TableClexulator.hh"
+
+/// Dependencies
+#include "casm/clex/PrimClex.hh"
+
+/// What is being used to test it:
+#include <cstdlib>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+using namespace CASM;
+
+namespace {
+
+  /// Compare a TableClexulator to the compiled Clexulator printed for the same basis set, which
+  ///   must give bit-identical correlations
+  void compare_to_compiled(const fs::path &prim_path, const jsonParser &bspecs_json, std::string name) {
+
+    // chebychev site basis functions
+    Structure prim(prim_path);
+    prim.fill_occupant_bases('c');
+
+    // print_clexulator and TableClexulator both change neighbor list indices, so use separate trees
+    SiteOrbitree compiled_tree = make_orbitree(prim, bspecs_json);
+    compiled_tree.collect_basis_info(prim);
+    compiled_tree.generate_clust_bases();
+    Array<UnitCellCoord> nlist;
+    expand_nlist(prim, compiled_tree, nlist);
+
+    fs::ofstream outfile(fs::path("tests/unit/clex") / (name + ".cc"));
+    print_clexulator(prim, compiled_tree, nlist, name, outfile);
+    outfile.close();
+
+    Clexulator compiled(name,
+                        "tests/unit/clex",
+                        RuntimeLibrary::default_compile_options() + " --std=c++11 -Iinclude",
+                        RuntimeLibrary::default_so_options() + " -lboost_filesystem -lboost_system");
+
+    SiteOrbitree table_tree = make_orbitree(prim, bspecs_json);
+    table_tree.collect_basis_info(prim);
+    table_tree.generate_clust_bases();
+    Array<UnitCellCoord> table_nlist;
+    expand_nlist(prim, table_tree, table_nlist);
+
+    Clexulator table(name,
+                     std::unique_ptr<Clexulator_impl::Base>(new TableClexulator(prim, table_tree, table_nlist)));
+
+    BOOST_CHECK_EQUAL(table.corr_size(), compiled.corr_size());
+    BOOST_REQUIRE_EQUAL(table.nlist_size(), compiled.nlist_size());
+
+    // the neighborhood is the neighbor list itself, with pseudo-random occupants
+    std::vector<Clexulator::nlist_index_type> config_nlist(nlist.size());
+    std::vector<int> occ(nlist.size());
+    for(Index i = 0; i < nlist.size(); i++) {
+      config_nlist[i] = i;
+    }
+
+    std::vector<double> compiled_corr(compiled.corr_size()), table_corr(table.corr_size());
+    std::vector<Clexulator::size_type> ind_list = {1, 3, 4};
+
+    for(int trial = 0; trial < 20; trial++) {
+      for(Index i = 0; i < nlist.size(); i++) {
+        occ[i] = (7 * trial + 3 * i + i * i) % prim.basis[nlist[i][0]].site_occupant().size();
+      }
+      for(Clexulator *clex : {&compiled, &table}) {
+        clex->set_config_occ(occ.data());
+        clex->set_nlist(config_nlist.data());
+      }
+
+      compiled.calc_global_corr_contribution(compiled_corr.data());
+      table.calc_global_corr_contribution(table_corr.data());
+      BOOST_CHECK(compiled_corr == table_corr);
+
+      compiled.calc_restricted_global_corr_contribution(compiled_corr.data(), ind_list.data(), ind_list.data() + ind_list.size());
+      table.calc_restricted_global_corr_contribution(table_corr.data(), ind_list.data(), ind_list.data() + ind_list.size());
+      BOOST_CHECK(compiled_corr == table_corr);
+
+      for(int b = 0; b < prim.basis.size(); b++) {
+        compiled.calc_point_corr(b, compiled_corr.data());
+        table.calc_point_corr(b, table_corr.data());
+        BOOST_CHECK(compiled_corr == table_corr);
+
+        for(int occ_f = 0; occ_f < prim.basis[b].site_occupant().size(); occ_f++) {
+          compiled.calc_delta_point_corr(b, occ[b], occ_f, compiled_corr.data());
+          table.calc_delta_point_corr(b, occ[b], occ_f, table_corr.data());
+          BOOST_CHECK(compiled_corr == table_corr);
+        }
+      }
+    }
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(TableClexulatorTest)
+
+BOOST_AUTO_TEST_CASE(CompareToCompiledTest) {
+
+  // build in a cache in the test directory, removed by 'scons -c TableClexulator'
+  setenv("CASM_CLEXULATOR_CACHE", "tests/unit/clex/TableClexulator_cache", 1);
+
+  // ternary FCC
+  jsonParser fcc_bspecs;
+  fcc_bspecs["orbit_branch_specs"]["2"]["max_length"] = 4.01;
+  fcc_bspecs["orbit_branch_specs"]["3"]["max_length"] = 3.01;
+  fcc_bspecs["orbit_branch_specs"]["4"]["max_length"] = 3.01;
+  compare_to_compiled("tests/unit/crystallography/PRIM1", fcc_bspecs, "test_TableClexulator");
+
+  // rocksalt, with a binary and a ternary sublattice
+  jsonParser rocksalt_bspecs;
+  rocksalt_bspecs["orbit_branch_specs"]["2"]["max_length"] = 4.01;
+  rocksalt_bspecs["orbit_branch_specs"]["3"]["max_length"] = 2.9;
+  compare_to_compiled("tests/unit/crystallography/PRIM3", rocksalt_bspecs, "test_Rocksalt_TableClexulator");
+
+  unsetenv("CASM_CLEXULATOR_CACHE");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,100 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/crystallography/SupercellEnumerator.hh"
+
+/// What is being used to test it:
+#include <vector>
+
+using namespace CASM;
+
+namespace {
+
+  /// supercell matrices visited by SupercellEnumerator iterators
+  std::vector<Eigen::Matrix3i> iterator_matrices(const SupercellEnumerator<Lattice> &enumerator) {
+    std::vector<Eigen::Matrix3i> result;
+    for(auto it = enumerator.begin(); it != enumerator.end(); ++it) {
+      result.push_back(it.matrix());
+    }
+    return result;
+  }
+
+  bool same_matrices(const std::vector<Eigen::Matrix3i> &A, const std::vector<Eigen::Matrix3i> &B) {
+    if(A.size() != B.size()) {
+      return false;
+    }
+    for(Index i = 0; i < A.size(); i++) {
+      if(A[i] != B[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(SupercellEnumeratorTest)
+
+BOOST_AUTO_TEST_CASE(FCCCounts) {
+
+  Eigen::Matrix3d L;
+  L << 0.0, 2.0, 2.0,
+  2.0, 0.0, 2.0,
+  2.0, 2.0, 0.0;
+  Lattice fcc(L);
+
+  // number of symmetrically unique FCC supercells of volume 1 to 12
+  int expected[12] = {1, 2, 3, 7, 5, 10, 7, 20, 14, 18, 11, 41};
+
+  for(int vol = 1; vol <= 12; vol++) {
+    SupercellEnumerator<Lattice> enumerator(fcc, TOL, vol, vol + 1);
+    BOOST_CHECK_EQUAL(enumerate_supercell_matrices(enumerator).size(), expected[vol - 1]);
+    BOOST_CHECK_EQUAL(iterator_matrices(enumerator).size(), expected[vol - 1]);
+  }
+
+}
+
+BOOST_AUTO_TEST_CASE(SameOrderAsIterators) {
+
+  Eigen::Matrix3d L;
+  L << 3.1, 0.4, 0.7,
+  0.2, 4.3, 0.5,
+  0.3, 0.1, 5.2;
+  Lattice triclinic(L);
+
+  L << 3.1, 0.0, 0.7,
+  0.0, 4.3, 0.0,
+  0.0, 0.0, 5.2;
+  Lattice monoclinic(L);
+
+  L << 0.0, 2.0, 2.0,
+  2.0, 0.0, 2.0,
+  2.0, 2.0, 0.0;
+  Lattice fcc(L);
+
+  std::vector<Lattice> lat {triclinic, monoclinic, fcc};
+
+  for(const auto &unit : lat) {
+    SupercellEnumerator<Lattice> enumerator(unit, TOL, 1, 16);
+    std::vector<Eigen::Matrix3i> expected = iterator_matrices(enumerator);
+
+    BOOST_CHECK(same_matrices(enumerate_supercell_matrices(enumerator, 1), expected));
+    BOOST_CHECK(same_matrices(enumerate_supercell_matrices(enumerator, 3), expected));
+
+    std::vector<Eigen::Matrix3i> streamed;
+    for_each_supercell_matrix(enumerator, [&](const Eigen::Matrix3i & T) {
+      streamed.push_back(T);
+    }, 2);
+    BOOST_CHECK(same_matrices(streamed, expected));
+  }
+
+  // with only identity and inversion, every matrix in hermite normal form is canonical,
+  // and for volume n there are sum_{a*b*c == n} a*a*b of them
+  SupercellEnumerator<Lattice> enumerator(triclinic, TOL, 1, 13);
+  BOOST_CHECK_EQUAL(enumerator.point_group().size(), 2);
+  BOOST_CHECK_EQUAL(enumerate_supercell_matrices(enumerator).size(), 1 + 7 + 13 + 35 + 31 + 91 + 57 + 155 + 130 + 217 + 133 + 455);
+
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,119 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/BP_C++/BP_Geo.hh"
+
+/// Dependencies
+
+/// What is being used to test it:
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+  /// points (x, y, E) on a 'n' x 'n' grid over the unit square, with E on a paraboloid, so that
+  ///   each grid square is a planar facet that may be split either way, and each vertex is shared by several facets
+  Eigen::MatrixXd make_grid(int n) {
+    Eigen::MatrixXd pos(3, n * n);
+    for(int i = 0; i < n; i++) {
+      for(int j = 0; j < n; j++) {
+        double x = double(i) / (n - 1);
+        double y = double(j) / (n - 1);
+        pos.col(i * n + j) << x, y, (x - 0.5) * (x - 0.5) + (y - 0.5) * (y - 0.5);
+      }
+    }
+    return pos;
+  }
+
+  /// points on the hull and points above vertices, edges and facets of the grid hull, so that many
+  ///   are equally far from several facets, and some points at random
+  Eigen::MatrixXd make_query(int n) {
+    std::vector<Eigen::Vector3d> points;
+    double h = 1.0 / (n - 1);
+    for(int i = 0; i < n; i++) {
+      for(int j = 0; j < n; j++) {
+        for(double dx : {0.0, 0.5}) {
+          for(double dy : {0.0, 0.5}) {
+            double x = std::min((i + dx) * h, 1.0);
+            double y = std::min((j + dy) * h, 1.0);
+            double E = (x - 0.5) * (x - 0.5) + (y - 0.5) * (y - 0.5);
+            points.push_back(Eigen::Vector3d(x, y, E));
+            points.push_back(Eigen::Vector3d(x, y, E + 0.1));
+          }
+        }
+      }
+    }
+    srand(1);
+    for(int i = 0; i < 200; i++) {
+      double x = double(rand()) / RAND_MAX;
+      double y = double(rand()) / RAND_MAX;
+      double E = 0.5 * double(rand()) / RAND_MAX;
+      points.push_back(Eigen::Vector3d(x, y, E));
+    }
+
+    Eigen::MatrixXd result(3, points.size());
+    for(int i = 0; i < points.size(); i++) {
+      result.col(i) = points[i];
+    }
+    return result;
+  }
+
+  /// check that the distances of all points in 'query' at once are the same as one by one
+  void check_batch(BP::Geo &geo, const Eigen::MatrixXd &query) {
+    Eigen::VectorXd dist;
+    Eigen::VectorXi facet;
+    geo.CH_dist_to_hull(query, dist, facet);
+    BOOST_REQUIRE_EQUAL(dist.size(), query.cols());
+    BOOST_REQUIRE_EQUAL(facet.size(), query.cols());
+
+    for(int i = 0; i < query.cols(); i++) {
+      BOOST_CHECK_SMALL(dist(i) - geo.CH_dist_to_hull(Eigen::VectorXd(query.col(i))), 1e-12);
+      BOOST_CHECK(facet(i) >= 0);
+      BOOST_CHECK(facet(i) < geo.CH_facets_size());
+    }
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(GeoTest)
+
+BOOST_AUTO_TEST_CASE(BatchDistToHullTest) {
+
+  Eigen::MatrixXd pos = make_grid(5);
+  Eigen::MatrixXd query = make_query(5);
+
+  BP::Geo geo;
+  geo.set_verbosity(0);
+  geo.reset_points(pos, true);
+  BOOST_REQUIRE(geo.calc_CH());
+
+  // distance along the bottom vector, to the bottom of the hull
+  Eigen::VectorXd down(3);
+  down << 0.0, 0.0, -1.0;
+  geo.CH_bottom(down);
+  check_batch(geo, query);
+
+  // the hull vertices are on the hull
+  Eigen::VectorXd dist;
+  Eigen::VectorXi facet;
+  geo.CH_dist_to_hull(pos, dist, facet);
+  for(int i = 0; i < pos.cols(); i++) {
+    BOOST_CHECK_SMALL(dist(i), 1e-12);
+  }
+
+  // closest distance, to the whole hull
+  geo.CH_wholehull();
+  check_batch(geo, query);
+
+  // more points than fit in one block
+  Eigen::MatrixXd many(3, 5 * query.cols());
+  for(int i = 0; i < 5; i++) {
+    many.middleCols(i * query.cols(), query.cols()) = query;
+  }
+  geo.CH_bottom(down);
+  check_batch(geo, many);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
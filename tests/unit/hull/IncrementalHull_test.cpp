@@ -0,0 +1,202 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/hull/IncrementalHull.hh"
+
+/// Dependencies
+
+/// What is being used to test it:
+#include <cmath>
+#include <ctime>
+#include <set>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+using namespace CASM;
+
+namespace {
+
+  /// points (x, y, E) with a random E above a convex bowl, labeled "0", "1", ...
+  void make_points(Index N, std::vector<std::string> &labels, Eigen::MatrixXd &pos) {
+    srand(1);
+    labels.clear();
+    pos.resize(3, N);
+    for(Index i = 0; i < N; i++) {
+      labels.push_back(std::to_string(i));
+      double x = double(rand()) / RAND_MAX;
+      double y = double(rand()) / RAND_MAX;
+      double r = double(rand()) / RAND_MAX;
+      pos.col(i) << x, y, x *(x - 1.0) + y *(y - 1.0) + 0.1 * r;
+    }
+  }
+
+  Eigen::VectorXd down() {
+    Eigen::VectorXd result(3);
+    result << 0.0, 0.0, -1.0;
+    return result;
+  }
+
+  /// check distances to 'hull' and its vertices against a hull built from scratch
+  void check_hull(const IncrementalHull &hull, const std::vector<std::string> &labels, const Eigen::MatrixXd &pos) {
+    BP::Geo geo;
+    geo.set_verbosity(0);
+    geo.reset_points(pos, true);
+    BOOST_REQUIRE(geo.calc_CH());
+    geo.CH_bottom(down());
+
+    for(Index i = 0; i < pos.cols(); i++) {
+      Eigen::VectorXd x = pos.col(i);
+      BOOST_CHECK_SMALL(hull.geo().CH_dist_to_hull(x) - geo.CH_dist_to_hull(x), 1e-10);
+    }
+
+    std::set<std::string> expected;
+    BP::BP_Vec<int> index = geo.CH_verts_indices();
+    for(Index i = 0; i < index.size(); i++) {
+      expected.insert(labels[index[i]]);
+    }
+    std::vector<std::string> vertices = hull.vertices();
+    std::set<std::string> found(vertices.begin(), vertices.end());
+    BOOST_CHECK(found == expected);
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(IncrementalHullTest)
+
+BOOST_AUTO_TEST_CASE(UpdateTest) {
+
+  std::vector<std::string> labels;
+  Eigen::MatrixXd pos;
+  make_points(200, labels, pos);
+
+  IncrementalHull hull(down());
+  hull.assign(std::vector<std::string>(labels.begin(), labels.begin() + 100), pos.leftCols(100));
+  BOOST_REQUIRE(hull.update());
+  BOOST_CHECK_EQUAL(hull.num_full_builds(), 1);
+  check_hull(hull, std::vector<std::string>(labels.begin(), labels.begin() + 100), pos.leftCols(100));
+
+  // points strictly inside the hull do not cause a rebuild
+  Eigen::VectorXd inside = pos.leftCols(100).rowwise().mean();
+  hull.insert("inside", inside);
+  BOOST_REQUIRE(hull.update());
+  BOOST_CHECK_EQUAL(hull.num_full_builds(), 1);
+  BOOST_CHECK_EQUAL(hull.num_partial_builds(), 0);
+  hull.erase("inside");
+
+  // add the remaining points
+  hull.assign(labels, pos);
+  BOOST_REQUIRE(hull.update());
+  BOOST_CHECK_EQUAL(hull.num_full_builds(), 1);
+  check_hull(hull, labels, pos);
+
+  // erase a vertex of the bottom of the hull
+  std::string vertex = hull.vertices()[0];
+  Index i_vertex = std::stoi(vertex);
+  hull.erase(vertex);
+  std::vector<std::string> remaining_labels;
+  Eigen::MatrixXd remaining_pos(3, pos.cols() - 1);
+  for(Index i = 0; i < pos.cols(); i++) {
+    if(i != i_vertex) {
+      remaining_pos.col(remaining_labels.size()) = pos.col(i);
+      remaining_labels.push_back(labels[i]);
+    }
+  }
+  BOOST_REQUIRE(hull.update());
+  BOOST_CHECK_EQUAL(hull.num_full_builds(), 2);
+  check_hull(hull, remaining_labels, remaining_pos);
+}
+
+BOOST_AUTO_TEST_CASE(ReadWriteTest) {
+
+  boost::filesystem::path filename("hull/IncrementalHull_test_out/test.hull");
+  boost::filesystem::remove_all(filename.parent_path());
+
+  std::vector<std::string> labels;
+  Eigen::MatrixXd pos;
+  make_points(100, labels, pos);
+
+  {
+    IncrementalHull hull(down());
+    BOOST_CHECK(!hull.read(filename, 7));
+    hull.assign(labels, pos);
+    BOOST_REQUIRE(hull.update());
+    BOOST_CHECK(hull.modified());
+    hull.write(filename, 7);
+    BOOST_CHECK(!hull.modified());
+  }
+
+  {
+    // a different key is not read
+    IncrementalHull hull(down());
+    BOOST_CHECK(!hull.read(filename, 8));
+    BOOST_CHECK_EQUAL(hull.size(), 0);
+  }
+
+  {
+    // the stored hull is rebuilt from its support points only
+    IncrementalHull hull(down());
+    BOOST_REQUIRE(hull.read(filename, 7));
+    BOOST_CHECK_EQUAL(hull.size(), 100);
+    hull.assign(labels, pos);
+    BOOST_CHECK(!hull.modified());
+    BOOST_REQUIRE(hull.update());
+    BOOST_CHECK_EQUAL(hull.num_full_builds(), 0);
+    BOOST_CHECK_EQUAL(hull.num_partial_builds(), 1);
+    check_hull(hull, labels, pos);
+
+    // copies rebuild the hull
+    IncrementalHull copy(hull);
+    check_hull(copy, labels, pos);
+  }
+
+  boost::filesystem::remove_all(filename.parent_path());
+}
+
+BOOST_AUTO_TEST_CASE(RemoveStaleTest) {
+
+  boost::filesystem::path dir("hull/IncrementalHull_test_out");
+  boost::filesystem::remove_all(dir);
+
+  std::vector<std::string> labels;
+  Eigen::MatrixXd pos;
+  make_points(20, labels, pos);
+  IncrementalHull hull(down());
+  hull.assign(labels, pos);
+  BOOST_REQUIRE(hull.update());
+
+  // hull files last used an hour ago and earlier, oldest first, and a file that is not a hull file
+  std::time_t now = std::time(nullptr);
+  std::vector<boost::filesystem::path> files;
+  for(Index i = 0; i < 10; i++) {
+    files.push_back(dir / (std::to_string(i) + ".hull"));
+    hull.write(files.back(), i);
+    boost::filesystem::last_write_time(files.back(), now - 3600 * (20 - i));
+  }
+  boost::filesystem::ofstream(dir / "other") << "other";
+  boost::filesystem::last_write_time(dir / "other", now - 3600 * 100);
+
+  // reading marks a file as used
+  IncrementalHull read_hull(down());
+  BOOST_REQUIRE(read_hull.read(files[1], 1));
+  BOOST_CHECK(boost::filesystem::last_write_time(files[1]) >= now);
+
+  // keep the 8 most recently used, and 'keep', which is the oldest
+  remove_stale_hull_files(dir, 8, files[0]);
+  std::set<Index> removed = {2, 3};
+  for(Index i = 0; i < files.size(); i++) {
+    BOOST_CHECK_EQUAL(boost::filesystem::exists(files[i]), !removed.count(i));
+  }
+  BOOST_CHECK(boost::filesystem::exists(dir / "other"));
+
+  // nothing is removed if there are no more than 'max_files'
+  remove_stale_hull_files(dir, 8, files[0]);
+  BOOST_CHECK(boost::filesystem::exists(files[0]));
+  BOOST_CHECK(boost::filesystem::exists(files[4]));
+
+  boost::filesystem::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
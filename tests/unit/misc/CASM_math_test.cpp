@@ -0,0 +1,135 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/misc/CASM_math.hh"
+
+/// Dependencies
+
+/// What is being used to test it:
+#include <random>
+#include <vector>
+
+using namespace CASM;
+
+namespace {
+
+  /// sparse matrix of the entries of 'dense' that are < max_cost
+  SparseCostMatrix sparsify(const Eigen::MatrixXd &dense, double max_cost) {
+    SparseCostMatrix sparse;
+    sparse.clear();
+    for(Index i = 0; i < dense.rows(); i++) {
+      for(Index j = 0; j < dense.cols(); j++) {
+        if(dense(i, j) < max_cost) {
+          sparse.col.push_back(j);
+          sparse.cost.push_back(dense(i, j));
+        }
+      }
+      sparse.row_begin.push_back(sparse.col.size());
+    }
+    return sparse;
+  }
+
+  /// squared distances between random points in the unit cube and the same points, displaced
+  Eigen::MatrixXd random_cost_matrix(Index N, double displacement, std::mt19937 &rng) {
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    Eigen::MatrixXd ideal(3, N), relaxed(3, N);
+    for(Index j = 0; j < N; j++) {
+      for(Index k = 0; k < 3; k++) {
+        ideal(k, j) = U(rng);
+        relaxed(k, j) = ideal(k, j) + displacement * (U(rng) - 0.5);
+      }
+    }
+    Eigen::MatrixXd cost(N, N);
+    for(Index i = 0; i < N; i++) {
+      for(Index j = 0; j < N; j++) {
+        cost(i, j) = (ideal.col(i) - relaxed.col(j)).squaredNorm();
+      }
+    }
+    return cost;
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(CASM_mathTest)
+
+BOOST_AUTO_TEST_CASE(SparseAssignmentDenseTest) {
+
+  std::mt19937 rng(1234);
+  for(Index N : {1, 2, 5, 20, 60}) {
+    Eigen::MatrixXd cost = random_cost_matrix(N, 0.3, rng);
+
+    std::vector<Index> hungarian_assignment;
+    double hungarian_cost = hungarian_method(cost, hungarian_assignment, 1e-8);
+
+    std::vector<Index> assignment;
+    Eigen::VectorXd u, v;
+    double tot_cost;
+    BOOST_CHECK(sparse_assignment(sparsify(cost, 1e10), assignment, u, v, tot_cost));
+    BOOST_CHECK_CLOSE(tot_cost + 1.0, hungarian_cost + 1.0, 1e-8);
+
+    // assignment is a permutation, and the potentials are a certificate of optimality
+    std::vector<bool> used(N, false);
+    for(Index i = 0; i < N; i++) {
+      BOOST_CHECK(!used[assignment[i]]);
+      used[assignment[i]] = true;
+      BOOST_CHECK_SMALL(cost(i, assignment[i]) - u[i] - v[assignment[i]], 1e-10);
+      for(Index j = 0; j < N; j++) {
+        BOOST_CHECK(cost(i, j) - u[i] - v[j] > -1e-10);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(SparseAssignmentWarmStartTest) {
+
+  std::mt19937 rng(5678);
+  Index N = 40;
+  Eigen::MatrixXd cost = random_cost_matrix(N, 0.2, rng);
+
+  std::vector<Index> assignment;
+  Eigen::VectorXd u, v;
+  double tot_cost;
+  BOOST_CHECK(sparse_assignment(sparsify(cost, 1e10), assignment, u, v, tot_cost));
+
+  // perturb the costs and start from the previous solution
+  Eigen::MatrixXd cost2 = cost + 0.01 * Eigen::MatrixXd::Random(N, N).cwiseAbs();
+  std::vector<Index> hungarian_assignment;
+  double hungarian_cost = hungarian_method(cost2, hungarian_assignment, 1e-8);
+  BOOST_CHECK(sparse_assignment(sparsify(cost2, 1e10), assignment, u, v, tot_cost));
+  BOOST_CHECK_CLOSE(tot_cost + 1.0, hungarian_cost + 1.0, 1e-8);
+}
+
+BOOST_AUTO_TEST_CASE(SparseAssignmentRestrictedTest) {
+
+  std::mt19937 rng(91011);
+  Index N = 60;
+  Eigen::MatrixXd cost = random_cost_matrix(N, 0.05, rng);
+  std::vector<Index> hungarian_assignment;
+  double hungarian_cost = hungarian_method(cost, hungarian_assignment, 1e-8);
+
+  // only near pairs: if the omitted costs are >= max(u) + max(v), the result is optimal
+  double max_cost = 0.05;
+  std::vector<Index> assignment;
+  Eigen::VectorXd u, v;
+  double tot_cost;
+  SparseCostMatrix near = sparsify(cost, max_cost);
+  BOOST_CHECK(near.col.size() < N * N / 4);
+  BOOST_CHECK(sparse_assignment(near, assignment, u, v, tot_cost));
+  BOOST_CHECK(u.maxCoeff() + v.maxCoeff() <= max_cost);
+  BOOST_CHECK_CLOSE(tot_cost + 1.0, hungarian_cost + 1.0, 1e-8);
+
+  // no assignment is possible if a row has no entries
+  SparseCostMatrix sparse = sparsify(cost, 1e10);
+  Index n_first = sparse.row_begin[1];
+  sparse.col.erase(sparse.col.begin(), sparse.col.begin() + n_first);
+  sparse.cost.erase(sparse.cost.begin(), sparse.cost.begin() + n_first);
+  for(Index i = 1; i < sparse.row_begin.size(); i++) {
+    sparse.row_begin[i] -= n_first;
+  }
+  assignment.clear();
+  v.resize(0);
+  BOOST_CHECK(!sparse_assignment(sparse, assignment, u, v, tot_cost));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
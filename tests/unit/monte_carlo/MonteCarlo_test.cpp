@@ -0,0 +1,140 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/monte_carlo/MonteCarlo.hh"
+
+/// Dependencies
+#include "casm/clex/PrimClex.hh"
+#include "casm/clex/Supercell.hh"
+#include "casm/clex/TableClexulator.hh"
+#include "casm/clex/CompositionConverter.hh"
+
+/// What is being used to test it:
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+using namespace CASM;
+
+namespace {
+
+  /// Number of each component in the occupation of 'mc', counted from scratch
+  Eigen::VectorXd count_components(const MonteCarlo &mc) {
+    const Structure &prim = mc.supercell().get_prim();
+    Eigen::VectorXd result = Eigen::VectorXd::Zero(mc.components().size());
+    for(Index l = 0; l < mc.num_sites(); l++) {
+      const std::string &name = prim.basis[mc.supercell().get_b(l)].site_occupant()[mc.configdof().occ(l)].name;
+      for(Index i = 0; i < mc.components().size(); i++) {
+        if(mc.components()[i] == name) {
+          result(i) += 1.0;
+        }
+      }
+    }
+    return result;
+  }
+
+  /// Run passes of 'mc', checking after each that the energy accumulated from changes in energy
+  ///   equals the energy recalculated from scratch, and that the composition is kept track of
+  void check_passes(MonteCarlo &mc, bool fixed_composition) {
+    Eigen::VectorXd init_comp = count_components(mc);
+    double init_energy = mc.energy();
+
+    MonteConditions cond;
+    cond.temperature = 2000.0;
+    cond.param_chem_pot = Eigen::VectorXd::Constant(mc.components().size() - 1, 0.05);
+    mc.set_conditions(cond);
+
+    for(int pass = 0; pass < 20; pass++) {
+      mc.pass();
+      double energy = mc.energy();
+      BOOST_CHECK_SMALL(mc.recalculate_energy(), 1e-10);
+      BOOST_CHECK_SMALL(mc.energy() - energy, 1e-10);
+
+      BOOST_CHECK(mc.num_each_component() == count_components(mc));
+      if(fixed_composition) {
+        BOOST_CHECK(mc.num_each_component() == init_comp);
+      }
+    }
+
+    BOOST_CHECK(mc.accepted() > 0);
+    BOOST_CHECK(mc.accepted() < mc.proposed());
+    BOOST_CHECK(mc.energy() != init_energy);
+    if(!fixed_composition) {
+      BOOST_CHECK(mc.num_each_component() != init_comp);
+    }
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(MonteCarloTest)
+
+BOOST_AUTO_TEST_CASE(EnergyAndCompositionTest) {
+  namespace fs = boost::filesystem;
+
+  fs::path testdir("tests/unit/monte_carlo/MonteCarlo_test_out");
+  fs::remove_all(testdir);
+  fs::create_directories(testdir);
+
+  // ternary FCC, with chebychev site basis functions
+  Structure prim(fs::path("tests/unit/crystallography/PRIM1"));
+  prim.fill_occupant_bases('c');
+
+  jsonParser bspecs_json;
+  bspecs_json["orbit_branch_specs"]["2"]["max_length"] = 4.01;
+  bspecs_json["orbit_branch_specs"]["3"]["max_length"] = 3.01;
+  bspecs_json["orbit_branch_specs"]["4"]["max_length"] = 3.01;
+
+  SiteOrbitree tree = make_orbitree(prim, bspecs_json);
+  tree.collect_basis_info(prim);
+  tree.generate_clust_bases();
+  Array<UnitCellCoord> nlist;
+  expand_nlist(prim, tree, nlist);
+  Clexulator clexulator("test_MonteCarlo", std::unique_ptr<Clexulator_impl::Base>(new TableClexulator(prim, tree, nlist)));
+
+  PrimClex primclex(prim);
+  primclex.set_prim_nlist(nlist);
+  std::vector<CompositionConverter> axes;
+  standard_composition_axes(primclex.get_prim(), std::back_inserter(axes));
+  BOOST_REQUIRE(axes.size() > 0);
+  primclex.set_composition_axes(axes[0]);
+
+  // ECI for some of the basis functions, in the eci.out format
+  fs::ofstream ecifile(testdir / "eci.out");
+  for(int i = 0; i < 7; i++) {
+    ecifile << "# header\n";
+  }
+  for(Index i = 0; i < clexulator.corr_size(); i += 2) {
+    double eci = 0.05 * std::cos(1.0 + i);
+    ecifile << std::setprecision(17) << eci << " " << eci << " " << i << "\n";
+  }
+  ecifile.close();
+  ECIContainer eci(testdir / "eci.out");
+
+  // a 3x3x3 supercell of the primitive cell, with a random occupation
+  Matrix3<double> T(0.0);
+  T(0, 0) = 3.0;
+  T(1, 1) = 3.0;
+  T(2, 2) = 3.0;
+  const Supercell &scel = primclex.get_supercell(primclex.add_supercell(Lattice(prim.lattice().lat_column_mat() * T)));
+  MTRand twister(MTRand::uint32(1));
+  ConfigDoF configdof(Array<int>(scel.num_sites(), 0));
+  for(Index l = 0; l < scel.num_sites(); l++) {
+    configdof.occ(l) = twister.randInt(2);
+  }
+
+  // swaps conserve composition
+  Canonical canonical(scel, configdof, clexulator, eci, 2);
+  check_passes(canonical, true);
+
+  // flips change composition
+  SemiGrandCanonical grand_canonical(scel, configdof, clexulator, eci, 3);
+  check_passes(grand_canonical, false);
+
+  fs::remove_all(testdir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,83 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/monte_carlo/MonteStatistics.hh"
+
+/// Dependencies
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+
+/// What is being used to test it:
+#include <cmath>
+#include <vector>
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(MonteStatisticsTest)
+
+BOOST_AUTO_TEST_CASE(EquilibrationTest) {
+
+  MTRand twister(MTRand::uint32(0));
+
+  // relaxes from 10.0 to 1.0, then fluctuates about 1.0
+  std::vector<double> samples;
+  for(int i = 0; i < 1000; i++) {
+    samples.push_back(1.0 + 9.0 * std::exp(-i / 20.0) + 0.1 * (twister.rand() - 0.5));
+  }
+
+  Index equil = equilibration_index(samples);
+  BOOST_CHECK(equil > 50);
+  BOOST_CHECK(equil < 200);
+
+  MonteStats stats = statistics(samples, equil);
+  BOOST_CHECK_EQUAL(stats.count, samples.size() - equil);
+  BOOST_CHECK(std::abs(stats.mean - 1.0) < 0.01);
+
+  // already equilibrated
+  std::vector<double> flat;
+  for(int i = 0; i < 1000; i++) {
+    flat.push_back(twister.rand());
+  }
+  BOOST_CHECK(equilibration_index(flat) < 10);
+
+  // never equilibrated
+  std::vector<double> drift;
+  for(int i = 0; i < 1000; i++) {
+    drift.push_back(-i);
+  }
+  BOOST_CHECK_EQUAL(equilibration_index(drift), drift.size());
+}
+
+BOOST_AUTO_TEST_CASE(StatisticsTest) {
+
+  MTRand twister(MTRand::uint32(0));
+
+  // independent samples, uniform on [0, 1]: variance 1/12, standard error sqrt(1/12/N)
+  std::vector<double> samples;
+  for(int i = 0; i < 10000; i++) {
+    samples.push_back(twister.rand());
+  }
+  MonteStats stats = statistics(samples);
+  double expected_err = std::sqrt(1.0 / 12.0 / samples.size());
+  BOOST_CHECK_EQUAL(stats.count, samples.size());
+  BOOST_CHECK(std::abs(stats.mean - 0.5) < 5.0 * expected_err);
+  BOOST_CHECK(std::abs(stats.var - 1.0 / 12.0) < 0.005);
+  BOOST_CHECK(stats.std_err > 0.5 * expected_err);
+  BOOST_CHECK(stats.std_err < 2.0 * expected_err);
+
+  // correlated samples, each value repeated 50 times: the error should be about sqrt(50) larger
+  std::vector<double> correlated;
+  for(int i = 0; i < 10000; i++) {
+    correlated.push_back(samples[i / 50]);
+  }
+  MonteStats corr_stats = statistics(correlated);
+  BOOST_CHECK(corr_stats.std_err > 3.0 * stats.std_err);
+
+  // too few samples to estimate the error
+  std::vector<double> few = {1.0, 2.0, 3.0};
+  MonteStats few_stats = statistics(few);
+  BOOST_CHECK_CLOSE(few_stats.mean, 2.0, 1e-10);
+  BOOST_CHECK(std::isinf(few_stats.std_err));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
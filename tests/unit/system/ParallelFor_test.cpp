@@ -0,0 +1,57 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/system/ParallelFor.hh"
+
+/// Dependencies
+
+/// What is being used to test it:
+#include <stdexcept>
+#include <vector>
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(ParallelForTest)
+
+BOOST_AUTO_TEST_CASE(ChunksTest) {
+
+  long N = 1001;
+
+  for(long num_threads = 1; num_threads <= 4; ++num_threads) {
+
+    std::vector<long> result(N, -1);
+    std::vector<long> count(num_threads, 0);
+
+    parallel_for_chunks(N, 64, num_threads, [&](long thread, long begin, long end) {
+      for(long i = begin; i < end; ++i) {
+        result[i] = i * i;
+        count[thread]++;
+      }
+    });
+
+    long total = 0;
+    for(long i = 0; i < N; ++i) {
+      BOOST_CHECK_EQUAL(result[i], i * i);
+    }
+    for(long t = 0; t < num_threads; ++t) {
+      total += count[t];
+    }
+    BOOST_CHECK_EQUAL(total, N);
+  }
+
+}
+
+BOOST_AUTO_TEST_CASE(ExceptionTest) {
+
+  BOOST_CHECK_THROW(
+    parallel_for_chunks(100, 1, 4, [&](long thread, long begin, long end) {
+      if(begin == 50) {
+        throw std::runtime_error("test");
+      }
+    }),
+    std::runtime_error);
+
+}
+
+BOOST_AUTO_TEST_SUITE_END()
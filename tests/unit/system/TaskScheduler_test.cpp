@@ -0,0 +1,107 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/system/TaskScheduler.hh"
+
+/// Dependencies
+
+/// What is being used to test it:
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(TaskSchedulerTest)
+
+BOOST_AUTO_TEST_CASE(TaskGroupTest) {
+
+  long N = 1000;
+
+  for(long num_threads = 1; num_threads <= 4; ++num_threads) {
+
+    TaskScheduler scheduler(num_threads);
+    BOOST_CHECK_EQUAL(scheduler.size(), num_threads);
+
+    std::vector<long> result(N, -1);
+    TaskGroup group(scheduler);
+    for(long i = 0; i < N; ++i) {
+      group.run([&, i]() {
+        result[i] = i * i;
+      });
+    }
+    group.wait();
+    BOOST_CHECK(group.is_finished());
+
+    for(long i = 0; i < N; ++i) {
+      BOOST_CHECK_EQUAL(result[i], i * i);
+    }
+    BOOST_CHECK_EQUAL(scheduler.stats().tasks, N);
+  }
+
+}
+
+BOOST_AUTO_TEST_CASE(NestedTest) {
+
+  // more outer tasks than workers, each waiting on inner tasks, must not deadlock
+  long N_outer = 16;
+  long N_inner = 100;
+
+  TaskScheduler scheduler(2);
+  std::vector<long> sum(N_outer, 0);
+
+  TaskGroup group(scheduler);
+  for(long i = 0; i < N_outer; ++i) {
+    group.run([&, i]() {
+      std::vector<long> value(N_inner, 0);
+      parallel_for_chunks(scheduler, N_inner, 8, [&](long begin, long end) {
+        for(long j = begin; j < end; ++j) {
+          value[j] = i + j;
+        }
+      });
+      for(long j = 0; j < N_inner; ++j) {
+        sum[i] += value[j];
+      }
+    });
+  }
+  group.wait();
+
+  for(long i = 0; i < N_outer; ++i) {
+    BOOST_CHECK_EQUAL(sum[i], i * N_inner + N_inner * (N_inner - 1) / 2);
+  }
+
+  TaskSchedulerStats stats = scheduler.stats();
+  BOOST_CHECK_EQUAL(stats.num_threads, 2);
+  BOOST_CHECK_EQUAL(stats.tasks, N_outer + N_outer * ((N_inner + 7) / 8));
+  BOOST_CHECK(stats.steals >= 0);
+  BOOST_CHECK(stats.idle_seconds >= 0.0);
+
+  scheduler.reset_stats();
+  BOOST_CHECK_EQUAL(scheduler.stats().tasks, 0);
+
+}
+
+BOOST_AUTO_TEST_CASE(ExceptionTest) {
+
+  TaskScheduler scheduler(4);
+  std::atomic<long> count(0);
+
+  TaskGroup group(scheduler);
+  for(long i = 0; i < 100; ++i) {
+    group.run([&, i]() {
+      if(i == 50) {
+        throw std::runtime_error("test");
+      }
+      ++count;
+    });
+  }
+  BOOST_CHECK_THROW(group.wait(), std::runtime_error);
+
+  // other tasks still run, and the exception is only rethrown once
+  BOOST_CHECK_EQUAL(count, 99);
+  BOOST_CHECK_NO_THROW(group.wait());
+
+}
+
+BOOST_AUTO_TEST_SUITE_END()